@@ -22,6 +22,22 @@ bool al_event_cnf(iolinke_device_handle_t device_id) {
     return true;
 }
 
+bool al_read_ind(iolinke_device_handle_t device_id, uint16_t request_id, uint16_t index, uint8_t sub_index) {
+    printf("AL: Read indication %u for device %d, index 0x%04X, subindex %d\n", request_id, device_id, index, sub_index);
+    /* No application parameters, answer later with al_read_rsp(device_id, request_id, ...) if the read is started */
+    return false;
+}
+
+bool al_write_ind(iolinke_device_handle_t device_id, uint16_t request_id, uint16_t index, uint8_t sub_index, uint8_t len, const uint8_t *data) {
+    printf("AL: Write indication %u for device %d, index 0x%04X, subindex %d, length %d\n", request_id, device_id, index, sub_index, len);
+    /* No application parameters, answer later with al_write_rsp(device_id, request_id) if the write is started */
+    return false;
+}
+
+void al_abort_ind(iolinke_device_handle_t device_id, uint16_t request_id) {
+    printf("AL: Abort indication %u for device %d\n", request_id, device_id);
+}
+
 bool pl_set_mode_req(iolinke_device_handle_t device_id, enum iolink_mode_t mode) {
     printf("PL: Set mode request for device %d, mode %d\n", device_id, mode);
     return true;
@@ -42,8 +42,8 @@ All services and interfaces are implemented according to the IO-Link Interface S
 
 use heapless::Vec;
 use iolinke_device::{
-    AlControlReq, AlEventCnf, ApplicationLayerServicesInd, DeviceCom, DeviceIdent, DeviceMode,
-    DlControlCode, DlControlInd, IoLinkDevice,
+    AlControlReq, AlEventCnf, AlEventQueue, ApplicationLayerServicesInd, DeviceCom, DeviceIdent,
+    DeviceMode, DlControlCode, DlControlInd, IoLinkDevice, PdIn, PdOut,
 };
 use iolinke_types::{
     custom::IoLinkResult,
@@ -54,6 +54,7 @@ use iolinke_types::{
     page,
 };
 
+use core::mem::MaybeUninit;
 use core::option::{
     Option,
     Option::{None, Some},
@@ -62,6 +63,7 @@ pub use core::result::{
     Result,
     Result::{Err, Ok},
 };
+use core::sync::atomic::{AtomicUsize, Ordering, fence};
 
 use crate::c::{
     self,
@@ -196,6 +198,85 @@ unsafe extern "C" {
     /// - Annex D for permitted values of `EventCode`
     fn al_event_cnf(device_id: IOLinkeDeviceHandle) -> bool;
 
+    /// # `Integrator Implemented Function`
+    /// Indicates an ISDU read of a parameter which is not in the local parameter storage (AL_Read service).
+    ///
+    /// This function must implement the AL_Read service as specified in IO-Link Interface Spec v1.1.4 Section 8.2.2.1.
+    /// It must not block, e.g. it starts a transfer from an external EEPROM or sensor ASIC and returns. The read is
+    /// completed from any context with `al_read_rsp` or `al_read_error_rsp`, until then the master is answered
+    /// "busy" and Process Data keeps flowing.
+    ///
+    /// # Parameters
+    ///
+    /// * `device_id` - The instance of the device generated from `io_linke_device_create`.
+    /// * `request_id` - Id of the read, has to be passed to the response.
+    /// * `index` - Index of the parameter.
+    /// * `sub_index` - Subindex of the parameter, 0 addresses the whole index.
+    ///
+    /// # Returns
+    ///
+    /// * `true` if the read was started, a response follows.
+    /// * `false` if the application has no such parameter, the master is answered "index not available".
+    ///
+    /// # Specification Reference
+    ///
+    /// - IO-Link Interface Spec v1.1.4 Section 8.2.2.1: AL_Read
+    /// - Table 62: AL_Read service parameters
+    fn al_read_ind(
+        device_id: IOLinkeDeviceHandle,
+        request_id: u16,
+        index: u16,
+        sub_index: u8,
+    ) -> bool;
+
+    /// # `Integrator Implemented Function`
+    /// Indicates an ISDU write of a parameter which is not in the local parameter storage (AL_Write service).
+    ///
+    /// This function must implement the AL_Write service as specified in IO-Link Interface Spec v1.1.4 Section 8.2.2.2.
+    /// It must not block. `data` is only valid during the call. The write is completed from any context with
+    /// `al_write_rsp` or `al_write_error_rsp`.
+    ///
+    /// # Parameters
+    ///
+    /// * `device_id` - The instance of the device generated from `io_linke_device_create`.
+    /// * `request_id` - Id of the write, has to be passed to the response.
+    /// * `index` - Index of the parameter.
+    /// * `sub_index` - Subindex of the parameter, 0 addresses the whole index.
+    /// * `len` - Length of the data to be written.
+    /// * `data` - Pointer to the data to be written.
+    ///
+    /// # Returns
+    ///
+    /// * `true` if the write was started, a response follows.
+    /// * `false` if the application has no such parameter, the master is answered "index not available".
+    ///
+    /// # Specification Reference
+    ///
+    /// - IO-Link Interface Spec v1.1.4 Section 8.2.2.2: AL_Write
+    /// - Table 63: AL_Write service parameters
+    fn al_write_ind(
+        device_id: IOLinkeDeviceHandle,
+        request_id: u16,
+        index: u16,
+        sub_index: u8,
+        len: u8,
+        data: *const u8,
+    ) -> bool;
+
+    /// # `Integrator Implemented Function`
+    /// Indicates that the master aborted the read or write indicated through `al_read_ind` or `al_write_ind`
+    /// (AL_Abort service). A response given afterwards is dropped.
+    ///
+    /// # Parameters
+    ///
+    /// * `device_id` - The instance of the device generated from `io_linke_device_create`.
+    /// * `request_id` - Id of the aborted read or write.
+    ///
+    /// # Specification Reference
+    ///
+    /// - IO-Link Interface Spec v1.1.4 Section 8.2.2.3: AL_Abort
+    fn al_abort_ind(device_id: IOLinkeDeviceHandle, request_id: u16);
+
     /// # `Integrator Implemented Function`
     /// This function is a response for the sm_set_device_com_req
     /// checkout `sm_set_device_com_req` for detailed documentation
@@ -271,14 +352,158 @@ unsafe extern "C" {
     fn sm_set_device_mode_cnf(device_id: IOLinkeDeviceHandle, result: SmResultWrapper);
 }
 
-/// Number of devices which can be created, //! For now only 1 device is supported.
-static NUM_OF_DEVICES: usize = 1;
+/// Number of device ports which can be created, configured by `IODevice.Ports.Count`
+/// in `device_config.toon` (see `tasks/configuration`).
+pub const NUM_OF_DEVICES: usize = iolinke_derived_config::device::ports::port_count();
+
+/// Device stack instance of one port
+pub type BindingDevice = IoLinkDevice<BindingPhysicalLayer, BindingApplicationLayer>;
+
+/// Global static table holding the IO-Link device instances, one per port.
+/// The handle returned by `io_linke_device_create` is the index into this table.
+///
+/// The table is left uninitialized until the devices are created, so it is placed in
+/// `.bss` and costs no flash for an initialization image.
+pub static mut IOLINKE_DEVICES: [MaybeUninit<BindingDevice>; NUM_OF_DEVICES] =
+    [const { MaybeUninit::uninit() }; NUM_OF_DEVICES];
+
+/// Action states of the devices in `IOLINKE_DEVICES`, indexed by the device handle.
+static mut IOLINKE_DEVICE_STATES: [DeviceActionState; NUM_OF_DEVICES] =
+    [const { DeviceActionState::NoDevice }; NUM_OF_DEVICES];
 
-/// Global static array to hold the IO-Link device instances and their action states.
-pub static mut IOLINKE_DEVICES: [Option<(
-    IoLinkDevice<BindingPhysicalLayer, BindingApplicationLayer>,
-    DeviceActionState,
-)>; NUM_OF_DEVICES] = [None; NUM_OF_DEVICES];
+// The device instances of all ports have to fit the RAM budget of `IODevice.Budget.RamBytes`,
+// see `iolinke_device::footprint` for the share of each component
+const _: () = {
+    let budget = iolinke_derived_config::device::budget::ram_bytes();
+    let ram = core::mem::size_of::<[MaybeUninit<BindingDevice>; NUM_OF_DEVICES]>()
+        + core::mem::size_of::<[DeviceActionState; NUM_OF_DEVICES]>();
+    if budget != 0 && ram > budget {
+        core::panic!("The device instances exceed IODevice.Budget.RamBytes");
+    }
+};
+
+/// Number of created devices. Devices are created in table order, so every handle
+/// below this count refers to an initialized device. Atomic because the entry points
+/// which may be called from an interrupt read it too, e.g. [`al_event_push_req`].
+static NUM_OF_CREATED_DEVICES: AtomicUsize = AtomicUsize::new(0);
+
+/// Returns the number of created devices, the devices below it are initialized
+#[inline(always)]
+pub(crate) fn created_devices() -> usize {
+    NUM_OF_CREATED_DEVICES.load(Ordering::Acquire)
+}
+
+/// A created device, found from its handle by [`device_slot`]. The handle is checked
+/// once at the FFI boundary and the slot is passed on, so the tables of the device
+/// are indexed without checking the handle again.
+pub(crate) struct DeviceSlot {
+    index: usize,
+    pub(crate) device: &'static mut BindingDevice,
+    pub(crate) state: &'static mut DeviceActionState,
+}
+
+impl DeviceSlot {
+    /// Returns the index of the device in the device tables
+    #[inline(always)]
+    pub(crate) fn index(&self) -> usize {
+        self.index
+    }
+
+    /// Returns the Event queue of the device
+    #[inline(always)]
+    fn event_queue(&self) -> &'static AlEventQueue {
+        // SAFETY: `index` is below the number of created devices
+        unsafe { AL_EVENT_QUEUES.get_unchecked(self.index) }
+    }
+}
+
+/// Returns the device and its action state for `device_id` in O(1).
+///
+/// A handle is valid if it is below the number of created devices, so the lookup is a
+/// single bounds check followed by direct indexing.
+///
+/// # Returns
+///
+/// * `Some(slot)` for a created device.
+/// * `None` for an invalid handle.
+///
+/// # Safety
+///
+/// The caller must not hold another reference to the same device.
+#[allow(static_mut_refs)]
+#[inline(always)]
+unsafe fn device_slot(device_id: IOLinkeDeviceHandle) -> Option<DeviceSlot> {
+    let index = device_id as usize;
+    unsafe {
+        if index >= created_devices() {
+            return None;
+        }
+        // SAFETY: Devices below `NUM_OF_CREATED_DEVICES` are initialized.
+        let device = IOLINKE_DEVICES.get_unchecked_mut(index).assume_init_mut();
+        let state = IOLINKE_DEVICE_STATES.get_unchecked_mut(index);
+        Some(DeviceSlot {
+            index,
+            device,
+            state,
+        })
+    }
+}
+
+/// Runs `f` on the device of `device_id`, or returns `no_device` for an invalid handle.
+///
+/// Used by the entry points which are called from the context of
+/// `iolinke_device_poll`, which therefore never hold another reference to the device.
+#[inline(always)]
+pub(crate) fn with_device<R>(
+    device_id: IOLinkeDeviceHandle,
+    no_device: R,
+    f: impl FnOnce(DeviceSlot) -> R,
+) -> R {
+    // SAFETY: The entry points of one device are not called concurrently
+    match unsafe { device_slot(device_id) } {
+        Some(slot) => f(slot),
+        None => no_device,
+    }
+}
+
+/// Runs the service `f` on the device of `device_id` unless a previous operation is
+/// still in progress.
+///
+/// # Returns
+///
+/// * `Done` if `f` ran.
+/// * `Busy` if a previous operation is still in progress.
+/// * `NoDevice` for an invalid handle.
+#[inline(always)]
+pub(crate) fn with_ready_device(
+    device_id: IOLinkeDeviceHandle,
+    f: impl FnOnce(DeviceSlot),
+) -> DeviceActionState {
+    with_device(device_id, DeviceActionState::NoDevice, |slot| {
+        if matches!(slot.state, DeviceActionState::Done) {
+            f(slot);
+            DeviceActionState::Done
+        } else {
+            DeviceActionState::Busy // Previous operation still in progress
+        }
+    })
+}
+
+/// Events raised through [`al_event_push_req`], one queue per device. Kept outside of
+/// `IOLINKE_DEVICES` so an interrupt pushing an Event never creates a reference to the
+/// device while the main loop polls it, `iolinke_device_poll` takes the Events.
+static AL_EVENT_QUEUES: [AlEventQueue; NUM_OF_DEVICES] =
+    [const { AlEventQueue::new() }; NUM_OF_DEVICES];
+
+/// Returns the Event queue of a created device, for the entry points which may be
+/// called from an interrupt and must not touch the device
+fn event_queue(device_id: IOLinkeDeviceHandle) -> Option<&'static AlEventQueue> {
+    let index = device_id as usize;
+    if index >= created_devices() {
+        return None;
+    }
+    AL_EVENT_QUEUES.get(index)
+}
 
 const PD_OUTPUT_LENGTH: usize =
     iolinke_derived_config::device::process_data::pd_out::config_length_in_bytes() as usize;
@@ -363,23 +588,38 @@ pub struct BindingApplicationLayer {
 #[allow(static_mut_refs)]
 #[unsafe(no_mangle)]
 pub extern "C" fn iolinke_device_poll(device_id: IOLinkeDeviceHandle) -> DeviceActionState {
-    let (device, state) = unsafe {
-        if let Some((device, state)) = IOLINKE_DEVICES
-            .get_mut(device_id as usize)
-            .and_then(|opt| opt.as_mut())
-        {
-            (device, state)
-        } else {
-            return DeviceActionState::NoDevice;
-        }
-    };
-    match state {
-        DeviceActionState::Done => {
-            let _ = device.poll();
-            DeviceActionState::Done
-        }
-        _ => DeviceActionState::Busy, // Previous operation still in progress
-    }
+    with_ready_device(device_id, |mut slot| {
+        c::backend::deliver_response(&mut slot);
+        slot.device.al_event_take_req(slot.event_queue());
+        let _ = slot.device.poll();
+    })
+}
+
+/// Checks whether the device has work pending for the next `iolinke_device_poll`.
+///
+/// Every indication and service request (`pl_transfer_ind`, `pl_timer_elapsed`,
+/// `al_set_input_req`, ...) marks the affected layer as pending, `iolinke_device_poll`
+/// only advances the pending state machines. When this returns `false`, the firmware
+/// can sleep (e.g. `WFI`) until the next interrupt instead of spinning on
+/// `iolinke_device_poll`.
+///
+/// # Parameters
+///
+/// * `device_id` - The instance of the device which is generated from `io_linke_device_create`.
+///
+/// # Returns
+///
+/// * `true` if the device has pending work.
+/// * `false` if nothing is pending or the device does not exist.
+///
+#[allow(static_mut_refs)]
+#[unsafe(no_mangle)]
+pub extern "C" fn iolinke_device_has_pending_work(device_id: IOLinkeDeviceHandle) -> bool {
+    with_device(device_id, false, |slot| {
+        slot.device.has_pending_work()
+            || c::backend::has_response(&slot)
+            || slot.device.has_queued_events(slot.event_queue())
+    })
 }
 
 /// Creates a new instance of IOLinke device.
@@ -401,18 +641,19 @@ pub extern "C" fn iolinke_device_poll(device_id: IOLinkeDeviceHandle) -> DeviceA
 #[unsafe(no_mangle)]
 pub extern "C" fn io_linke_device_create() -> IOLinkeDeviceHandle {
     unsafe {
-        for (i, device_option) in IOLINKE_DEVICES.iter_mut().enumerate() {
-            if device_option.is_none() {
-                let pl = BindingPhysicalLayer::new(i as i16);
-                let al = BindingApplicationLayer::new(i as i16);
-                let device = IoLinkDevice::new(pl, al);
-                *device_option = Some((device, DeviceActionState::Done));
-                return i as i16;
-            }
+        let index = NUM_OF_CREATED_DEVICES.load(Ordering::Relaxed);
+        if index >= NUM_OF_DEVICES {
+            // No available slot
+            return -1;
         }
+        let pl = BindingPhysicalLayer::new(index as i16);
+        let al = BindingApplicationLayer::new(index as i16);
+        IOLINKE_DEVICES[index].write(IoLinkDevice::new(pl, al));
+        IOLINKE_DEVICE_STATES[index] = DeviceActionState::Done;
+        // Publishes the initialized device to the other contexts
+        NUM_OF_CREATED_DEVICES.store(index + 1, Ordering::Release);
+        index as i16
     }
-    // No available slot
-    -1
 }
 
 /// Updates the input data within the Process Data of the device (AL_SetInput service).
@@ -447,26 +688,251 @@ pub extern "C" fn al_set_input_req(
     len: u8,
     data: *const u8,
 ) -> DeviceActionState {
-    let (device, state, pd_in_slice) = unsafe {
-        if let Some((device, state)) = IOLINKE_DEVICES
-            .get_mut(device_id as usize)
-            .and_then(|opt| opt.as_mut())
-        {
-            let pd_in_slice = core::slice::from_raw_parts(data, len as usize);
-            (device, state, pd_in_slice)
-        } else {
-            return DeviceActionState::NoDevice; // Invalid device ID
+    with_ready_device(device_id, |slot| {
+        let pd_in_slice = unsafe { core::slice::from_raw_parts(data, len as usize) };
+        let _ = slot.device.al_set_input_req(len, pd_in_slice);
+    })
+}
+
+/// Returns the input Process Data slot of the device for in place update (zero-copy AL_SetInput).
+///
+/// The application writes the input Process Data directly into the returned buffer and
+/// publishes it with [`commit_pd_in_buffer`]. Until then the device keeps responding with the
+/// previously committed Process Data, so the Master always receives a consistent snapshot.
+///
+/// # Parameters
+///
+/// * `device_id` - The instance of the device which is generated from `io_linke_device_create`.
+/// * `len` - Output, set to the length of the returned buffer. May be null.
+///
+/// # Returns
+///
+/// * Pointer to the input Process Data buffer.
+/// * Null if the device does not exist or the buffer is still in use by the device, retry later.
+///
+#[allow(static_mut_refs)]
+#[unsafe(no_mangle)]
+pub extern "C" fn acquire_pd_in_buffer(device_id: IOLinkeDeviceHandle, len: *mut u8) -> *mut u8 {
+    with_device(device_id, core::ptr::null_mut(), |slot| {
+        match slot.device.acquire_pd_in_buffer() {
+            Some(pd_in) => {
+                if !len.is_null() {
+                    unsafe { *len = pd_in.len() as u8 };
+                }
+                pd_in.as_mut_ptr()
+            }
+            None => core::ptr::null_mut(),
         }
-    };
-    match state {
-        DeviceActionState::Done => {
-            let _ = device.al_set_input_req(len, pd_in_slice);
-            DeviceActionState::Done
+    })
+}
+
+/// Publishes the input Process Data buffer returned by [`acquire_pd_in_buffer`].
+///
+/// Has the same effect as [`al_set_input_req`] with the content of the buffer.
+///
+/// # Memory ordering
+///
+/// The call starts with a release fence. All writes of the application to the buffer
+/// made before the call are therefore visible before the buffer is published, also to
+/// an interrupt or another core that compiles the response from it. Do not write to
+/// the buffer after the call until [`acquire_pd_in_buffer`] returns it again.
+///
+/// # Parameters
+///
+/// * `device_id` - The instance of the device which is generated from `io_linke_device_create`.
+///
+/// # Specification Reference
+///
+/// - IO-Link Interface Spec v1.1.4 Section 8.2.2.6: AL_SetInput
+///
+#[allow(static_mut_refs)]
+#[unsafe(no_mangle)]
+pub extern "C" fn commit_pd_in_buffer(device_id: IOLinkeDeviceHandle) -> DeviceActionState {
+    // The buffer was written by C code through a raw pointer, order those writes
+    // before the buffer is published
+    fence(Ordering::Release);
+    with_ready_device(device_id, |slot| {
+        let _ = slot.device.commit_pd_in_buffer();
+    })
+}
+
+/// Returns the last output Process Data received from the Master without copying it.
+///
+/// The buffer stays unchanged until [`release_pd_out_buffer`] is called. Output Process Data
+/// received in the mean time is dropped, so the buffer should be released quickly.
+///
+/// # Parameters
+///
+/// * `device_id` - The instance of the device which is generated from `io_linke_device_create`.
+/// * `len` - Output, set to the length of the returned buffer. May be null.
+///
+/// # Returns
+///
+/// * Pointer to the output Process Data buffer, or null if the device does not exist.
+///
+#[allow(static_mut_refs)]
+#[unsafe(no_mangle)]
+pub extern "C" fn acquire_pd_out_buffer(device_id: IOLinkeDeviceHandle, len: *mut u8) -> *const u8 {
+    with_device(device_id, core::ptr::null(), |slot| {
+        if !len.is_null() {
+            unsafe { *len = PD_OUTPUT_LENGTH as u8 };
         }
-        _ => DeviceActionState::Busy, // Previous operation still in progress
+        slot.device.acquire_pd_out_buffer() as *const u8
+    })
+}
+
+/// Releases the output Process Data buffer returned by [`acquire_pd_out_buffer`].
+///
+/// # Parameters
+///
+/// * `device_id` - The instance of the device which is generated from `io_linke_device_create`.
+///
+#[allow(static_mut_refs)]
+#[unsafe(no_mangle)]
+pub extern "C" fn release_pd_out_buffer(device_id: IOLinkeDeviceHandle) -> DeviceActionState {
+    with_device(device_id, DeviceActionState::NoDevice, |slot| {
+        slot.device.release_pd_out_buffer();
+        DeviceActionState::Done
+    })
+}
+
+/// Packs the typed input Process Data into the input Process Data slot and publishes it.
+///
+/// The bit offsets of the fields are the ones of `IODevice.Operate.PdIn` in
+/// `device_config.toon`, see [`acquire_pd_in_buffer`] for the slot.
+///
+/// # Parameters
+///
+/// * `device_id` - The instance of the device which is generated from `io_linke_device_create`.
+/// * `pd_in` - The input Process Data.
+///
+/// # Returns
+///
+/// * `Busy` if the slot is still in use by the device, retry later.
+///
+/// # Example
+///
+/// ```c
+/// pd_in_t pd_in = { .alarm = false, .level = 3, .temperature = 215 };
+/// set_pd_in(device_id, &pd_in);
+/// ```
+#[allow(static_mut_refs)]
+#[unsafe(no_mangle)]
+pub extern "C" fn set_pd_in(
+    device_id: IOLinkeDeviceHandle,
+    pd_in: *const PdIn,
+) -> DeviceActionState {
+    with_device(device_id, DeviceActionState::NoDevice, |slot| {
+        match slot.device.set_pd_in(unsafe { &*pd_in }) {
+            Ok(()) => DeviceActionState::Done,
+            Err(_) => DeviceActionState::Busy,
+        }
+    })
+}
+
+/// Unpacks the last output Process Data received from the Master.
+///
+/// The bit offsets of the fields are the ones of `IODevice.Operate.PdOut` in
+/// `device_config.toon`.
+///
+/// # Parameters
+///
+/// * `device_id` - The instance of the device which is generated from `io_linke_device_create`.
+/// * `pd_out` - Output, set to the output Process Data.
+///
+#[allow(static_mut_refs)]
+#[unsafe(no_mangle)]
+pub extern "C" fn get_pd_out(
+    device_id: IOLinkeDeviceHandle,
+    pd_out: *mut PdOut,
+) -> DeviceActionState {
+    with_device(device_id, DeviceActionState::NoDevice, |slot| {
+        unsafe { *pd_out = slot.device.get_pd_out() };
+        DeviceActionState::Done
+    })
+}
+
+/// Raises an Event of the device application (AL_Event).
+///
+/// Can be called from one interrupt context (e.g. over-temperature or short-circuit
+/// interrupt) while `iolinke_device_poll` runs in the main loop. The Event is queued
+/// outside of the device instance, without accessing it, and reported to the Master by
+/// the next polls. `al_event_cnf` is called after the Master read the Events.
+///
+/// # Parameters
+///
+/// * `device_id` - The instance of the device which is generated from `io_linke_device_create`.
+/// * `event_qualifier` - EventQualifier (mode, type, source, instance), see IO-Link Interface
+///   Spec v1.1.4 Annex A.6.4.
+/// * `event_code` - EventCode, see IO-Link Interface Spec v1.1.4 Annex D.
+///
+/// # Returns
+///
+/// * `Done` if the Event was queued.
+/// * `Busy` if the queue is full, the Event is dropped and counted in [`al_event_overflow_count`].
+/// * `NoDevice` for an invalid device ID.
+///
+/// # Specification Reference
+///
+/// - IO-Link Interface Spec v1.1.4 Section 8.2.2.11: AL_Event
+///
+#[unsafe(no_mangle)]
+pub extern "C" fn al_event_push_req(
+    device_id: IOLinkeDeviceHandle,
+    event_qualifier: u8,
+    event_code: u16,
+) -> DeviceActionState {
+    // The main loop may hold the device meanwhile, only its queue is touched
+    let Some(queue) = event_queue(device_id) else {
+        return DeviceActionState::NoDevice; // Invalid device ID
+    };
+    let event_entry = handlers::event::EventEntry::new(
+        handlers::event::EventQualifier::from_bits(event_qualifier),
+        event_code,
+    );
+    if queue.push(&event_entry) {
+        DeviceActionState::Done
+    } else {
+        DeviceActionState::Busy
     }
 }
 
+/// Returns the number of Events dropped by [`al_event_push_req`] because the queue was full.
+///
+/// # Parameters
+///
+/// * `device_id` - The instance of the device which is generated from `io_linke_device_create`.
+///
+/// # Returns
+///
+/// * The number of dropped Events, 0 for an invalid device ID. The counter wraps around.
+///
+#[unsafe(no_mangle)]
+pub extern "C" fn al_event_overflow_count(device_id: IOLinkeDeviceHandle) -> u32 {
+    event_queue(device_id).map_or(0, AlEventQueue::overflow_count)
+}
+
+/// Returns the number of Events merged into an Event of the same EventQualifier and
+/// EventCode which was still waiting to be reported.
+///
+/// Repeated Events are merged and every EventCode is reported at most once per
+/// `IODevice.Events.RateLimitCycles` Master cycles, see `device_config.toon`. Must be
+/// called from the context of `iolinke_device_poll`, unlike [`al_event_overflow_count`].
+///
+/// # Parameters
+///
+/// * `device_id` - The instance of the device which is generated from `io_linke_device_create`.
+///
+/// # Returns
+///
+/// * The number of merged Events, 0 for an invalid device ID. The counter wraps around.
+///
+#[allow(static_mut_refs)]
+#[unsafe(no_mangle)]
+pub extern "C" fn al_event_coalesced_count(device_id: IOLinkeDeviceHandle) -> u32 {
+    with_device(device_id, 0, |slot| slot.device.al_event_coalesced_count())
+}
+
 /// The `AlControlReq` trait defines the interface for the AL_Control service,
 /// which transmits Process Data qualifier status information to and from the Device application.
 /// This service should be synchronized with AL_GetInput and AL_SetOutput respectively.
@@ -487,23 +953,9 @@ pub extern "C" fn al_control_req(
     device_id: IOLinkeDeviceHandle,
     control_code: DlControlCode,
 ) -> DeviceActionState {
-    let (device, state) = unsafe {
-        if let Some((device, state)) = IOLINKE_DEVICES
-            .get_mut(device_id as usize)
-            .and_then(|opt| opt.as_mut())
-        {
-            (device, state)
-        } else {
-            return DeviceActionState::NoDevice; // Invalid device ID
-        }
-    };
-    match state {
-        DeviceActionState::Done => {
-            let _ = device.al_control_req(control_code);
-            DeviceActionState::Done
-        }
-        _ => DeviceActionState::Busy, // Previous operation still in progress
-    }
+    with_ready_device(device_id, |slot| {
+        let _ = slot.device.al_control_req(control_code);
+    })
 }
 
 /// Sets the device communication parameters according to IO-Link SM_SetDeviceCom service.
@@ -536,16 +988,6 @@ pub extern "C" fn al_control_req(
 #[allow(static_mut_refs)]
 #[unsafe(no_mangle)]
 pub extern "C" fn sm_set_device_com_req(device_id: IOLinkeDeviceHandle, com: &c::types::DeviceCom) {
-    let (device, _state) = unsafe {
-        if let Some((device, state)) = IOLINKE_DEVICES
-            .get_mut(device_id as usize)
-            .and_then(|opt| opt.as_mut())
-        {
-            (device, state)
-        } else {
-            return; // Invalid device ID
-        }
-    };
     let mut min_cycle_time = page::page1::CycleTime::new();
     min_cycle_time.set_multiplier(com.min_cycle_time.multiplier);
     min_cycle_time.set_time_base(com.min_cycle_time.time_base);
@@ -578,7 +1020,9 @@ pub extern "C" fn sm_set_device_com_req(device_id: IOLinkeDeviceHandle, com: &c:
         process_data_out: process_data_out,
     };
 
-    let _ = device.sm_set_device_com_req(&com);
+    with_device(device_id, (), |slot| {
+        let _ = slot.device.sm_set_device_com_req(&com);
+    })
 }
 
 /// Sets the device identification parameters according to IO-Link SM_SetDeviceIdent service.
@@ -609,17 +1053,9 @@ pub extern "C" fn sm_set_device_com_req(device_id: IOLinkeDeviceHandle, com: &c:
 #[allow(static_mut_refs)]
 #[unsafe(no_mangle)]
 pub extern "C" fn sm_set_device_ident_req(device_id: IOLinkeDeviceHandle, ident: &DeviceIdent) {
-    let (device, _state) = unsafe {
-        if let Some((device, state)) = IOLINKE_DEVICES
-            .get_mut(device_id as usize)
-            .and_then(|opt| opt.as_mut())
-        {
-            (device, state)
-        } else {
-            return; // Invalid device ID
-        }
-    };
-    let _ = device.sm_set_device_ident_req(ident);
+    with_device(device_id, (), |slot| {
+        let _ = slot.device.sm_set_device_ident_req(ident);
+    })
 }
 
 /// Sets the device operational mode according to the IO-Link SM_SetDeviceMode service.
@@ -648,17 +1084,9 @@ pub extern "C" fn sm_set_device_ident_req(device_id: IOLinkeDeviceHandle, ident:
 #[allow(static_mut_refs)]
 #[unsafe(no_mangle)]
 pub extern "C" fn sm_set_device_mode_req(device_id: IOLinkeDeviceHandle, mode: DeviceMode) {
-    let (device, _state) = unsafe {
-        if let Some((device, state)) = IOLINKE_DEVICES
-            .get_mut(device_id as usize)
-            .and_then(|opt| opt.as_mut())
-        {
-            (device, state)
-        } else {
-            return; // Invalid device ID
-        }
-    };
-    let _ = device.sm_set_device_mode_req(mode);
+    with_device(device_id, (), |slot| {
+        let _ = slot.device.sm_set_device_mode_req(mode);
+    })
 }
 
 /// Reads the current communication properties of the device according to the IO-Link SM_GetDeviceCom service.
@@ -691,17 +1119,9 @@ pub extern "C" fn sm_set_device_mode_req(device_id: IOLinkeDeviceHandle, mode: D
 #[allow(static_mut_refs)]
 #[unsafe(no_mangle)]
 pub extern "C" fn sm_get_device_com_req(device_id: IOLinkeDeviceHandle) {
-    let (device, _state) = unsafe {
-        if let Some((device, state)) = IOLINKE_DEVICES
-            .get_mut(device_id as usize)
-            .and_then(|opt| opt.as_mut())
-        {
-            (device, state)
-        } else {
-            return; // Invalid device ID
-        }
-    };
-    let _ = device.sm_get_device_com_req();
+    with_device(device_id, (), |slot| {
+        let _ = slot.device.sm_get_device_com_req();
+    })
 }
 
 /// Reads the device identification parameters according to the IO-Link SM_GetDeviceIdent service.
@@ -731,18 +1151,10 @@ pub extern "C" fn sm_get_device_com_req(device_id: IOLinkeDeviceHandle) {
 #[allow(static_mut_refs)]
 #[unsafe(no_mangle)]
 pub extern "C" fn sm_get_device_ident_req(device_id: IOLinkeDeviceHandle) {
-    let (device, _state) = unsafe {
-        if let Some((device, state)) = IOLINKE_DEVICES
-            .get_mut(device_id as usize)
-            .and_then(|opt| opt.as_mut())
-        {
-            (device, state)
-        } else {
-            return; // Invalid device ID
-        }
-    };
-    let result = device.sm_get_device_ident_req();
-    let _ = result;
+    with_device(device_id, (), |slot| {
+        let result = slot.device.sm_get_device_ident_req();
+        let _ = result;
+    })
 }
 
 impl BindingApplicationLayer {
@@ -760,19 +1172,43 @@ impl DlControlInd for BindingApplicationLayer {
 }
 
 impl ApplicationLayerServicesInd for BindingApplicationLayer {
-    fn al_read_ind(&mut self, _index: u16, _sub_index: u8) -> IoLinkResult<()> {
-        // This api is here for the future use, currently not expected to be called
-        Err(iolinke_types::custom::IoLinkError::NoImplFound)
+    fn al_read_ind(&mut self, index: u16, sub_index: u8) -> IoLinkResult<()> {
+        // A response of an earlier, aborted request must not complete this one
+        let request_id = c::backend::begin_request(self.device_id);
+        match unsafe { al_read_ind(self.device_id, request_id, index, sub_index) } {
+            true => Ok(()),
+            false => {
+                c::backend::end_request(self.device_id);
+                Err(iolinke_types::custom::IoLinkError::InvalidIndex)
+            }
+        }
     }
 
-    fn al_write_ind(&mut self, _index: u16, _sub_index: u8, _data: &[u8]) -> IoLinkResult<()> {
-        // This api is here for the future use, currently not expected to be called
-        Err(iolinke_types::custom::IoLinkError::NoImplFound)
+    fn al_write_ind(&mut self, index: u16, sub_index: u8, data: &[u8]) -> IoLinkResult<()> {
+        let request_id = c::backend::begin_request(self.device_id);
+        let started = unsafe {
+            al_write_ind(
+                self.device_id,
+                request_id,
+                index,
+                sub_index,
+                data.len() as u8,
+                data.as_ptr(),
+            )
+        };
+        match started {
+            true => Ok(()),
+            false => {
+                c::backend::end_request(self.device_id);
+                Err(iolinke_types::custom::IoLinkError::InvalidIndex)
+            }
+        }
     }
 
     fn al_abort_ind(&mut self) -> IoLinkResult<()> {
-        // This api is here for the future use, currently not expected to be called
-        Err(iolinke_types::custom::IoLinkError::NoImplFound)
+        let request_id = c::backend::end_request(self.device_id);
+        unsafe { al_abort_ind(self.device_id, request_id) };
+        Ok(())
     }
 
     fn al_pd_cycle_ind(&mut self) {
@@ -0,0 +1,385 @@
+//! Asynchronous AL_Read / AL_Write responses of the application
+//!
+//! Parameters which are not in the local parameter storage are indicated to the
+//! application with `al_read_ind` / `al_write_ind`. The application answers later,
+//! from any context (e.g. the DMA complete interrupt of an external EEPROM), with
+//! `al_read_rsp`, `al_read_error_rsp`, `al_write_rsp` or `al_write_error_rsp`.
+//!
+//! The response is placed in a per-device mailbox and handed to the device stack
+//! by the next `iolinke_device_poll`, the device itself is never touched from the
+//! responding context. Only one ISDU is in progress per device, so one mailbox slot
+//! suffices. The mailbox only uses atomic loads and stores, like the pending work mask
+//! of the device stack, so it works on ARMv6-M (Cortex-M0+) too.
+//!
+//! Every indication carries a request id which the response has to repeat. A response
+//! to an aborted or superseded request is dropped, so a late answer never completes
+//! the next AL_Read or AL_Write. The value of a positive AL_Read response is borrowed
+//! from the application until the response is delivered instead of copied into the
+//! mailbox, which keeps the mailbox at a few octets per device.
+
+use iolinke_device::{AlReadRsp, AlRspError, AlWriteRsp};
+use iolinke_types::handlers::isdu::MAX_ISDU_LENGTH;
+
+use core::cell::UnsafeCell;
+use core::option::{
+    Option,
+    Option::{None, Some},
+};
+use core::result::Result::{Err, Ok};
+use core::sync::atomic::{AtomicU16, Ordering};
+
+use crate::c::{
+    app::{self, DeviceSlot, NUM_OF_DEVICES},
+    types::{DeviceActionState, IOLinkeDeviceHandle},
+};
+
+/// Request id which never refers to a request
+const NO_REQUEST: u16 = 0;
+
+/// Response of the application waiting in a mailbox
+#[derive(Clone, Copy)]
+pub enum AlResponse {
+    /// Positive AL_Read response (data, length), `data` stays valid until delivered
+    Read(*const u8, u8),
+    /// Negative AL_Read response (error code, additional error code)
+    ReadError(u8, u8),
+    /// Positive AL_Write response
+    Write,
+    /// Negative AL_Write response (error code, additional error code)
+    WriteError(u8, u8),
+}
+
+/// Single slot mailbox of one device
+///
+/// `begin_request`, `end_request` and `deliver` are called from the context of
+/// `iolinke_device_poll`, `post` from the responding context.
+pub struct AlResponseMailbox {
+    /// Id of the last indicated request, only written by the polling context
+    last_request_id: AtomicU16,
+    /// Id of the request the application may answer, [`NO_REQUEST`] if none is
+    /// outstanding
+    request_id: AtomicU16,
+    /// Id of the request `response` answers, [`NO_REQUEST`] while the mailbox is empty
+    response_id: AtomicU16,
+    response: UnsafeCell<AlResponse>,
+}
+
+// SAFETY: `response` is only written while `response_id` is `NO_REQUEST` (by the
+// responding context) and only read while it is not (by `iolinke_device_poll`). The
+// borrowed AL_Read value is only read by `deliver`, the application keeps it valid
+// until then.
+unsafe impl Sync for AlResponseMailbox {}
+
+impl AlResponseMailbox {
+    /// Creates an empty mailbox without an outstanding request
+    pub const fn new() -> Self {
+        Self {
+            last_request_id: AtomicU16::new(NO_REQUEST),
+            request_id: AtomicU16::new(NO_REQUEST),
+            response_id: AtomicU16::new(NO_REQUEST),
+            response: UnsafeCell::new(AlResponse::Write),
+        }
+    }
+
+    /// Starts a new request and returns its id, a response to an earlier request is
+    /// dropped from now on
+    pub fn begin_request(&self) -> u16 {
+        let request_id = match self.last_request_id.load(Ordering::Relaxed).wrapping_add(1) {
+            NO_REQUEST => NO_REQUEST + 1,
+            request_id => request_id,
+        };
+        self.last_request_id.store(request_id, Ordering::Relaxed);
+        self.request_id.store(request_id, Ordering::Release);
+        // An undelivered response to the earlier request must not block this one
+        self.response_id.store(NO_REQUEST, Ordering::Release);
+        request_id
+    }
+
+    /// Ends the outstanding request without a response, e.g. on AL_Abort
+    ///
+    /// # Returns
+    ///
+    /// The id of the ended request, 0 if none was outstanding.
+    pub fn end_request(&self) -> u16 {
+        let request_id = self.request_id.load(Ordering::Relaxed);
+        self.request_id.store(NO_REQUEST, Ordering::Release);
+        self.response_id.store(NO_REQUEST, Ordering::Release);
+        request_id
+    }
+
+    /// Places `response` to the request `request_id` in the mailbox
+    ///
+    /// # Returns
+    ///
+    /// * `Done` if the response was accepted, or dropped because `request_id` is not
+    ///   the outstanding request.
+    /// * `Busy` if a response to the request already waits for delivery.
+    pub fn post(&self, request_id: u16, response: AlResponse) -> DeviceActionState {
+        if request_id == NO_REQUEST || request_id != self.request_id.load(Ordering::Acquire) {
+            // Aborted or superseded by a later request
+            return DeviceActionState::Done;
+        }
+        if self.response_id.load(Ordering::Acquire) != NO_REQUEST {
+            return DeviceActionState::Busy;
+        }
+        // SAFETY: The mailbox is empty, `iolinke_device_poll` does not read it
+        unsafe { *self.response.get() = response };
+        self.response_id.store(request_id, Ordering::Release);
+        DeviceActionState::Done
+    }
+
+    /// Returns `true` if a response waits for the next `deliver`
+    pub fn has_response(&self) -> bool {
+        self.response_id.load(Ordering::Acquire) != NO_REQUEST
+    }
+
+    /// Hands a waiting response to `device` if it answers the outstanding request
+    pub fn deliver<D: AlReadRsp + AlWriteRsp>(&self, device: &mut D) {
+        let response_id = self.response_id.load(Ordering::Acquire);
+        if response_id == NO_REQUEST {
+            return;
+        }
+        // SAFETY: The mailbox is full, the responding context does not write it
+        let response = unsafe { *self.response.get() };
+        self.response_id.store(NO_REQUEST, Ordering::Release);
+        if response_id != self.request_id.load(Ordering::Relaxed) {
+            // The request was superseded after the response was posted
+            return;
+        }
+        // The request is answered, a second response is dropped
+        self.request_id.store(NO_REQUEST, Ordering::Release);
+        let _ = match response {
+            AlResponse::Read(data, length) => {
+                let value = match length {
+                    0 => &[][..],
+                    // SAFETY: The application keeps `length` octets at `data` valid
+                    // until the response is delivered
+                    _ => unsafe { core::slice::from_raw_parts(data, length as usize) },
+                };
+                device.al_read_rsp(Ok((length, value)))
+            }
+            AlResponse::ReadError(error, additional_error) => {
+                device.al_read_rsp(Err(AlRspError::Error(error, additional_error)))
+            }
+            AlResponse::Write => device.al_write_rsp(Ok(())),
+            AlResponse::WriteError(error, additional_error) => {
+                device.al_write_rsp(Err(AlRspError::Error(error, additional_error)))
+            }
+        };
+    }
+}
+
+impl Default for AlResponseMailbox {
+    fn default() -> Self {
+        Self::new()
+    }
+}
+
+static AL_RESPONSE_MAILBOXES: [AlResponseMailbox; NUM_OF_DEVICES] =
+    [const { AlResponseMailbox::new() }; NUM_OF_DEVICES];
+
+/// Returns the mailbox of a created device
+fn mailbox(device_id: IOLinkeDeviceHandle) -> Option<&'static AlResponseMailbox> {
+    let index = device_id as usize;
+    if index >= app::created_devices() {
+        return None;
+    }
+    AL_RESPONSE_MAILBOXES.get(index)
+}
+
+/// Places `response` to `request_id` in the mailbox of `device_id`
+fn post(
+    device_id: IOLinkeDeviceHandle,
+    request_id: u16,
+    response: AlResponse,
+) -> DeviceActionState {
+    match mailbox(device_id) {
+        Some(mailbox) => mailbox.post(request_id, response),
+        None => DeviceActionState::NoDevice,
+    }
+}
+
+/// Starts a request indicated to the application, see [`AlResponseMailbox::begin_request`]
+pub(crate) fn begin_request(device_id: IOLinkeDeviceHandle) -> u16 {
+    mailbox(device_id).map_or(NO_REQUEST, AlResponseMailbox::begin_request)
+}
+
+/// Ends the outstanding request, see [`AlResponseMailbox::end_request`]
+pub(crate) fn end_request(device_id: IOLinkeDeviceHandle) -> u16 {
+    mailbox(device_id).map_or(NO_REQUEST, AlResponseMailbox::end_request)
+}
+
+/// Returns the mailbox of a device passed on from its entry point
+fn slot_mailbox(slot: &DeviceSlot) -> &'static AlResponseMailbox {
+    // SAFETY: The index of a slot is below the number of created devices
+    unsafe { AL_RESPONSE_MAILBOXES.get_unchecked(slot.index()) }
+}
+
+/// Returns `true` if a response waits for the next `iolinke_device_poll`
+pub(crate) fn has_response(slot: &DeviceSlot) -> bool {
+    slot_mailbox(slot).has_response()
+}
+
+/// Hands a waiting response to the device, called from `iolinke_device_poll`
+pub(crate) fn deliver_response(slot: &mut DeviceSlot) {
+    slot_mailbox(slot).deliver(slot.device);
+}
+
+/// Completes the read indicated through `al_read_ind` (AL_Read response).
+///
+/// Can be called from any context, the response is handed to the device by the next
+/// `iolinke_device_poll`.
+///
+/// # Parameters
+///
+/// * `device_id` - The instance of the device which is generated from `io_linke_device_create`.
+/// * `request_id` - The request id passed to `al_read_ind`.
+/// * `len` - Length of the parameter value.
+/// * `data` - Pointer to the parameter value. It is not copied, the octets have to stay
+///   valid and unchanged until the next `iolinke_device_poll` of the device returned.
+///
+/// # Returns
+///
+/// * `Done` if the response was accepted, or dropped because the request was aborted
+///   or superseded.
+/// * `Busy` if a response is not yet delivered or `len` is too long.
+/// * `NoDevice` for an invalid device ID.
+///
+/// # Specification Reference
+///
+/// - IO-Link Interface Spec v1.1.4 Section 8.2.2.1: AL_Read
+#[unsafe(no_mangle)]
+pub extern "C" fn al_read_rsp(
+    device_id: IOLinkeDeviceHandle,
+    request_id: u16,
+    len: u8,
+    data: *const u8,
+) -> DeviceActionState {
+    if len as usize > MAX_ISDU_LENGTH {
+        return DeviceActionState::Busy;
+    }
+    post(device_id, request_id, AlResponse::Read(data, len))
+}
+
+/// Rejects the read indicated through `al_read_ind` (negative AL_Read response).
+///
+/// # Parameters
+///
+/// * `device_id` - The instance of the device which is generated from `io_linke_device_create`.
+/// * `request_id` - The request id passed to the indication.
+/// * `error_code` - ISDU ErrorCode, see IO-Link Interface Spec v1.1.4 Annex C.
+/// * `additional_code` - ISDU AdditionalCode, see IO-Link Interface Spec v1.1.4 Annex C.
+///
+/// # Returns
+///
+/// Same as [`al_read_rsp`].
+#[unsafe(no_mangle)]
+pub extern "C" fn al_read_error_rsp(
+    device_id: IOLinkeDeviceHandle,
+    request_id: u16,
+    error_code: u8,
+    additional_code: u8,
+) -> DeviceActionState {
+    post(
+        device_id,
+        request_id,
+        AlResponse::ReadError(error_code, additional_code),
+    )
+}
+
+/// Completes the write indicated through `al_write_ind` (AL_Write response).
+///
+/// # Parameters
+///
+/// * `device_id` - The instance of the device which is generated from `io_linke_device_create`.
+/// * `request_id` - The request id passed to `al_write_ind`.
+///
+/// # Returns
+///
+/// Same as [`al_read_rsp`].
+#[unsafe(no_mangle)]
+pub extern "C" fn al_write_rsp(
+    device_id: IOLinkeDeviceHandle,
+    request_id: u16,
+) -> DeviceActionState {
+    post(device_id, request_id, AlResponse::Write)
+}
+
+/// Rejects the write indicated through `al_write_ind` (negative AL_Write response).
+///
+/// # Parameters
+///
+/// * `device_id` - The instance of the device which is generated from `io_linke_device_create`.
+/// * `request_id` - The request id passed to the indication.
+/// * `error_code` - ISDU ErrorCode, see IO-Link Interface Spec v1.1.4 Annex C.
+/// * `additional_code` - ISDU AdditionalCode, see IO-Link Interface Spec v1.1.4 Annex C.
+///
+/// # Returns
+///
+/// Same as [`al_read_rsp`].
+#[unsafe(no_mangle)]
+pub extern "C" fn al_write_error_rsp(
+    device_id: IOLinkeDeviceHandle,
+    request_id: u16,
+    error_code: u8,
+    additional_code: u8,
+) -> DeviceActionState {
+    post(
+        device_id,
+        request_id,
+        AlResponse::WriteError(error_code, additional_code),
+    )
+}
+
+/// Prefetches the value of a parameter served through `al_read_ind`.
+///
+/// ISDU reads of the parameter are answered from the stored value without calling
+/// `al_read_ind`. The value is kept until it is replaced, dropped with
+/// [`al_invalidate_req`] or the master writes the parameter. Must be called from the
+/// context of `iolinke_device_poll`.
+///
+/// # Parameters
+///
+/// * `device_id` - The instance of the device which is generated from `io_linke_device_create`.
+/// * `index` - Index of the parameter.
+/// * `sub_index` - Subindex of the parameter.
+/// * `len` - Length of the value, at most 16 octets.
+/// * `data` - Pointer to the value, copied before the function returns.
+///
+/// # Returns
+///
+/// * `true` if the value was stored.
+/// * `false` if the value is too long, 4 other parameters are prefetched already or
+///   the device ID is invalid.
+#[unsafe(no_mangle)]
+pub extern "C" fn al_prefetch_req(
+    device_id: IOLinkeDeviceHandle,
+    index: u16,
+    sub_index: u8,
+    len: u8,
+    data: *const u8,
+) -> bool {
+    app::with_device(device_id, false, |slot| {
+        let value = match len {
+            0 => &[][..],
+            // SAFETY: The caller provides `len` readable octets at `data`
+            _ => unsafe { core::slice::from_raw_parts(data, len as usize) },
+        };
+        slot.device.al_prefetch_req(index, sub_index, value).is_ok()
+    })
+}
+
+/// Drops a value stored with [`al_prefetch_req`], e.g. when it changed.
+/// Subindex 0 drops all subindexes of `index`.
+///
+/// # Parameters
+///
+/// * `device_id` - The instance of the device which is generated from `io_linke_device_create`.
+/// * `index` - Index of the parameter.
+/// * `sub_index` - Subindex of the parameter.
+#[unsafe(no_mangle)]
+pub extern "C" fn al_invalidate_req(device_id: IOLinkeDeviceHandle, index: u16, sub_index: u8) {
+    app::with_device(device_id, (), |slot| {
+        slot.device.al_invalidate_req(index, sub_index);
+    });
+}
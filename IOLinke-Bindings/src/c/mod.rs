@@ -1,11 +1,22 @@
 //! This module provides the core C bindings for the IO-Link project.
 //!
-//! It exposes submodules for application logic (`app`), physical layer interactions (`phy`),
-//! common type definitions (`types`), and customizable hooks (`hooks`).
+//! It exposes submodules for application logic (`app`), the asynchronous parameter
+//! responses of the application (`backend`), physical layer interactions (`phy`),
+//! common type definitions (`types`), customizable hooks (`hooks`), with the
+//! `profiling` feature the state machine cycle count statistics (`profiling`), with the
+//! `trace` feature the binary state transition trace (`trace`) and, with the
+//! `timer_service` feature, the shared software timers of all devices (`timer_service`).
 //!
 //! These bindings facilitate interoperability between Rust and C components within the IO-Link ecosystem.
 
 pub mod app;
+pub mod backend;
 pub mod hooks;
 pub mod phy;
+#[cfg(feature = "profiling")]
+pub mod profiling;
+#[cfg(feature = "timer_service")]
+pub mod timer_service;
+#[cfg(feature = "trace")]
+pub mod trace;
 pub mod types;
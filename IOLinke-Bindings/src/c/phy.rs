@@ -34,10 +34,11 @@
 //! device.pl_transfer_ind(0x55)?; // Handle received byte 0x55
 //! device.pl_wake_up_ind()?;      // Handle wake-up indication
 //! ```
-use crate::c::app::{BindingApplicationLayer, IOLINKE_DEVICES};
+use crate::c::app::{BindingApplicationLayer, with_ready_device};
+#[cfg(feature = "timer_service")]
+use crate::c::timer_service;
 use crate::c::types::{DeviceActionState, IOLinkeDeviceHandle};
 
-use core::option::Option::Some;
 pub use core::result::{
     Result,
     Result::{Err, Ok},
@@ -97,6 +98,12 @@ unsafe extern "C" {
     ///     - `FRAMING_ERROR`: Invalid UART stop bit detected.
     ///     - `OVERRUN`: Octet collision within the UART.
     ///
+    /// # Non-blocking transfer
+    /// With the `non_blocking_tx` feature the function may return as soon as the transfer
+    /// is started, e.g. the UART TX DMA sends straight from `data`. The buffer stays valid
+    /// and unchanged until the integrator calls `pl_transfer_cnf`, which must follow
+    /// every started transfer.
+    ///
     fn pl_transfer_req(device_id: IOLinkeDeviceHandle, len: u8, data: *const u8) -> bool;
 
     /// # `Integrator Implemented Function`
@@ -188,23 +195,79 @@ unsafe extern "C" {
 #[allow(static_mut_refs)]
 #[unsafe(no_mangle)]
 pub extern "C" fn pl_transfer_ind(device_id: IOLinkeDeviceHandle, data: u8) -> DeviceActionState {
-    let (device, state) = unsafe {
-        if let Some((device, state)) = IOLINKE_DEVICES
-            .get_mut(device_id as usize)
-            .and_then(|opt| opt.as_mut())
-        {
-            (device, state)
-        } else {
-            return DeviceActionState::NoDevice;
-        }
-    };
-    match state {
-        DeviceActionState::Done => {
-            let _ = device.pl_transfer_ind(data);
-            DeviceActionState::Done
-        }
-        _ => DeviceActionState::Busy, // Previous operation still in progress
-    }
+    with_ready_device(device_id, |slot| {
+        let _ = slot.device.pl_transfer_ind(data);
+    })
+}
+
+/// Handles a span of bytes received by the Physical Layer from the master.
+///
+/// This function is called when the Physical Layer receives several bytes at once,
+/// e.g. on a DMA UART transfer complete or idle line interrupt.
+/// It behaves like calling `pl_transfer_ind` for every byte of the span.
+///
+/// # Parameters
+///
+/// * `len` - Number of received bytes
+/// * `data` - Pointer to the received bytes, in reception order
+///
+/// # Returns
+///
+/// * `Done` if the bytes were forwarded to the Data Link Layer
+/// * `Busy` if a previous operation is still in progress
+/// * `NoDevice` if `device_id` does not belong to a created device
+///
+/// # Specification Reference
+///
+/// - IO-Link Interface Spec v1.1.4 Section 5.2.2.3: PL_Transfer Service
+///
+/// # Example
+///
+/// ```c
+/// pl_transfer_ind_burst(device_id, received, dma_rx_buffer);
+/// ```
+#[allow(static_mut_refs)]
+#[unsafe(no_mangle)]
+pub extern "C" fn pl_transfer_ind_burst(
+    device_id: IOLinkeDeviceHandle,
+    len: u8,
+    data: *const u8,
+) -> DeviceActionState {
+    with_ready_device(device_id, |slot| {
+        let rx_bytes = unsafe { core::slice::from_raw_parts(data, len as usize) };
+        let _ = slot.device.pl_transfer_ind_burst(rx_bytes);
+    })
+}
+
+/// Confirms a transfer started through `pl_transfer_req`.
+///
+/// This function is called when the frame handed to `pl_transfer_req` is sent,
+/// e.g. on the UART TX DMA transfer complete interrupt. The stack releases the TX buffer
+/// and sends the next response from it later. Only available with the `non_blocking_tx`
+/// feature.
+///
+/// # Returns
+///
+/// * `Done` if the confirmation was forwarded to the Data Link Layer
+/// * `Busy` if a previous operation is still in progress
+/// * `NoDevice` if `device_id` does not belong to a created device
+///
+/// # Specification Reference
+///
+/// - IO-Link Interface Spec v1.1.4 Section 5.2.2.3: PL_Transfer Service
+///
+/// # Example
+///
+/// ```c
+/// void DMA_TX_Complete_IRQHandler(void) { pl_transfer_cnf(device_id); }
+/// ```
+#[cfg(feature = "non_blocking_tx")]
+#[allow(static_mut_refs)]
+#[unsafe(no_mangle)]
+pub extern "C" fn pl_transfer_cnf(device_id: IOLinkeDeviceHandle) -> DeviceActionState {
+    with_ready_device(device_id, |slot| {
+        let _ = slot.device.pl_transfer_cnf();
+    })
 }
 
 /// Handles Physical Layer wake-up indication from the master.
@@ -237,23 +300,31 @@ pub extern "C" fn pl_transfer_ind(device_id: IOLinkeDeviceHandle, data: u8) -> D
 #[allow(static_mut_refs)]
 #[unsafe(no_mangle)]
 pub extern "C" fn pl_wake_up_ind(device_id: IOLinkeDeviceHandle) -> DeviceActionState {
-    let (device, state) = unsafe {
-        if let Some((device, state)) = IOLINKE_DEVICES
-            .get_mut(device_id as usize)
-            .and_then(|opt| opt.as_mut())
-        {
-            (device, state)
-        } else {
-            return DeviceActionState::NoDevice; // Invalid device ID
-        }
-    };
-    match state {
-        DeviceActionState::Done => {
-            let _ = device.pl_wake_up_ind();
-            DeviceActionState::Done
-        }
-        _ => DeviceActionState::Busy, // Previous operation still in progress
-    }
+    with_ready_device(device_id, |slot| {
+        let _ = slot.device.pl_wake_up_ind();
+    })
+}
+
+/// Indicates the expiry of a timer started through `pl_start_timer_req` or `pl_restart_timer_req`.
+///
+/// This function must be called by the integrator's timer interrupt when a timer elapses.
+///
+/// # Parameters
+///
+/// * `device_id` - The instance of the device which is generated from `io_linke_device_create`.
+/// * `timer` - The timer that has elapsed.
+///
+/// # Specification Reference
+///
+/// - IO-Link Interface Spec v1.1.4 Table 42: Wake-up procedure and retry characteristics
+/// - IO-Link Interface Spec v1.1.4 Table 47: Internal items
+///
+#[allow(static_mut_refs)]
+#[unsafe(no_mangle)]
+pub extern "C" fn pl_timer_elapsed(device_id: IOLinkeDeviceHandle, timer: Timer) -> DeviceActionState {
+    with_ready_device(device_id, |slot| {
+        let _ = slot.device.timer_elapsed(timer);
+    })
 }
 
 /// This function is called when the communication is successful.
@@ -269,23 +340,9 @@ pub extern "C" fn pl_successful_com(
     device_id: IOLinkeDeviceHandle,
     transmission_rate: TransmissionRate,
 ) -> DeviceActionState {
-    let (device, state) = unsafe {
-        if let Some((device, state)) = IOLINKE_DEVICES
-            .get_mut(device_id as usize)
-            .and_then(|opt| opt.as_mut())
-        {
-            (device, state)
-        } else {
-            return DeviceActionState::NoDevice;
-        }
-    };
-    match state {
-        DeviceActionState::Done => {
-            let _ = device.successful_com(transmission_rate);
-            DeviceActionState::Done
-        }
-        _ => DeviceActionState::Busy, // Previous operation still in progress
-    }
+    with_ready_device(device_id, |slot| {
+        let _ = slot.device.successful_com(transmission_rate);
+    })
 }
 
 /// Mock physical layer implementation for testing
@@ -338,17 +395,37 @@ impl PhysicalLayerReq for BindingPhysicalLayer {
         Ok(())
     }
 
+    #[cfg(not(feature = "timer_service"))]
     fn pl_stop_timer_req(&self, timer: Timer) -> IoLinkResult<()> {
         unsafe { pl_stop_timer_req(self.device_id, timer) };
         Ok(())
     }
 
+    #[cfg(not(feature = "timer_service"))]
     fn pl_start_timer_req(&self, timer: Timer, duration_us: u32) -> IoLinkResult<()> {
         unsafe { pl_start_timer_req(self.device_id, timer, duration_us) };
         Ok(())
     }
+    #[cfg(not(feature = "timer_service"))]
     fn pl_restart_timer_req(&self, timer: Timer, duration_us: u32) -> IoLinkResult<()> {
         unsafe { pl_restart_timer_req(self.device_id, timer, duration_us) };
         Ok(())
     }
+
+    #[cfg(feature = "timer_service")]
+    fn pl_stop_timer_req(&self, timer: Timer) -> IoLinkResult<()> {
+        timer_service::TIMER_SERVICE.stop(self.device_id as usize, timer);
+        Ok(())
+    }
+
+    #[cfg(feature = "timer_service")]
+    fn pl_start_timer_req(&self, timer: Timer, duration_us: u32) -> IoLinkResult<()> {
+        timer_service::TIMER_SERVICE.start(self.device_id as usize, timer, duration_us);
+        Ok(())
+    }
+    #[cfg(feature = "timer_service")]
+    fn pl_restart_timer_req(&self, timer: Timer, duration_us: u32) -> IoLinkResult<()> {
+        timer_service::TIMER_SERVICE.start(self.device_id as usize, timer, duration_us);
+        Ok(())
+    }
 }
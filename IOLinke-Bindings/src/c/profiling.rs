@@ -0,0 +1,102 @@
+//! # IO-Link Profiling C Bindings
+//!
+//! Exposes the cycle count statistics of the device stack state machines to C.
+//! Only available with the `profiling` feature.
+//!
+//! The statistics are process-global: all devices created with
+//! `io_linke_device_create` record into the same counters, so with several ports
+//! they sum up the state machines of all of them.
+//!
+//! ## Usage
+//!
+//! ```c
+//! static uint32_t read_cyccnt(void) { return DWT->CYCCNT; }
+//!
+//! iolinke_profile_set_cycle_counter(read_cyccnt);
+//! ...
+//! profile_stats_t stats;
+//! if (iolinke_profile_stats(profile_id_t_DlMessageHandler, &stats)) {
+//!     printf("%u calls, max %u cycles\n", stats.count, stats.max);
+//! }
+//! profile_histogram_t histogram;
+//! if (iolinke_profile_histogram(profile_id_t_DlMessageHandler, &histogram)) {
+//!     printf("%u calls of 512 to 1023 cycles\n", histogram.buckets[10]);
+//! }
+//! ```
+pub use iolinke_device::profiling::{CycleCounter, ProfileHistogram, ProfileId, ProfileStats};
+use iolinke_device::profiling;
+
+use core::option::Option::Some;
+
+/// Registers the cycle counter used to time the state machines.
+///
+/// # Parameters
+///
+/// * `counter` - Returns a free running, wrapping 32 bit counter, e.g. DWT `CYCCNT`.
+///
+#[unsafe(no_mangle)]
+pub extern "C" fn iolinke_profile_set_cycle_counter(counter: CycleCounter) {
+    profiling::set_cycle_counter(counter);
+}
+
+/// Reads the statistics recorded for one instrumented state machine.
+///
+/// # Parameters
+///
+/// * `id` - The instrumented state machine or service, a `profile_id_t` value. Taken
+///   as an integer, an out of range enum value passed from C is undefined behavior.
+/// * `stats` - Filled with the number of samples and the min/max/avg cycles, of all
+///   devices.
+///
+/// # Returns
+///
+/// * `true` if `stats` was filled.
+/// * `false` if `stats` is null or `id` is no `profile_id_t`.
+///
+#[unsafe(no_mangle)]
+pub extern "C" fn iolinke_profile_stats(id: u8, stats: *mut ProfileStats) -> bool {
+    let Some(id) = ProfileId::from_index(id) else {
+        return false;
+    };
+    if stats.is_null() {
+        return false;
+    }
+    unsafe {
+        *stats = profiling::stats(id);
+    }
+    true
+}
+
+/// Reads the cycle histogram recorded for one instrumented state machine.
+///
+/// # Parameters
+///
+/// * `id` - The instrumented state machine or service, a `profile_id_t` value.
+/// * `histogram` - Filled with the number of samples per power of two bucket, of all
+///   devices. Bucket n counts the samples of 2^(n-1) to 2^n - 1 cycles, the last
+///   bucket also all longer ones.
+///
+/// # Returns
+///
+/// * `true` if `histogram` was filled.
+/// * `false` if `histogram` is null or `id` is no `profile_id_t`.
+///
+#[unsafe(no_mangle)]
+pub extern "C" fn iolinke_profile_histogram(id: u8, histogram: *mut ProfileHistogram) -> bool {
+    let Some(id) = ProfileId::from_index(id) else {
+        return false;
+    };
+    if histogram.is_null() {
+        return false;
+    }
+    unsafe {
+        *histogram = profiling::histogram(id);
+    }
+    true
+}
+
+/// Clears the statistics of all instrumented state machines, of all devices.
+#[unsafe(no_mangle)]
+pub extern "C" fn iolinke_profile_reset() {
+    profiling::reset();
+}
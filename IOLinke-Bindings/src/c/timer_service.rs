@@ -0,0 +1,80 @@
+//! Shared software timers of all devices
+//!
+//! Without this module every device needs its own hardware timers behind
+//! `pl_start_timer_req`, `pl_restart_timer_req` and `pl_stop_timer_req`. With the
+//! `timer_service` feature the stack runs the timers of all devices off one free-running
+//! microsecond counter and one compare channel instead. The integrator implements
+//! `iolinke_timer_now_us`, `iolinke_timer_set_compare` and `iolinke_timer_disable_compare`
+//! and calls `iolinke_timer_compare_isr` from the compare interrupt, the timer requests
+//! of `phy` are no longer called.
+//!
+//! The compare interrupt must have the same priority as the interrupts which indicate
+//! received data with `pl_transfer_ind`, see [`iolinke_device::TimerService`].
+
+use iolinke_device::{TimerHardware, TimerService};
+
+use crate::c::{app::NUM_OF_DEVICES, phy, types::IOLinkeDeviceHandle};
+
+unsafe extern "C" {
+    /// # `Integrator Implemented Function`
+    /// Returns the value of the free-running counter in microseconds.
+    ///
+    /// The counter counts up and wraps around after `0xFFFF_FFFF`.
+    fn iolinke_timer_now_us() -> u32;
+
+    /// # `Integrator Implemented Function`
+    /// Programs the compare channel of the counter.
+    ///
+    /// `iolinke_timer_compare_isr` must be called when the counter reaches `deadline_us`,
+    /// or as soon as possible if it has passed already.
+    ///
+    /// # Parameters
+    ///
+    /// * `deadline_us` - Counter value of the compare interrupt
+    fn iolinke_timer_set_compare(deadline_us: u32);
+
+    /// # `Integrator Implemented Function`
+    /// Disables the compare interrupt, no timer is running.
+    fn iolinke_timer_disable_compare();
+}
+
+/// Counter and compare channel implemented by the integrator
+pub struct IntegratorTimer;
+
+impl TimerHardware for IntegratorTimer {
+    fn now_us(&self) -> u32 {
+        unsafe { iolinke_timer_now_us() }
+    }
+
+    fn set_compare(&self, deadline_us: u32) {
+        unsafe { iolinke_timer_set_compare(deadline_us) }
+    }
+
+    fn disable_compare(&self) {
+        unsafe { iolinke_timer_disable_compare() }
+    }
+}
+
+/// Timers of all devices, indexed by the device handle
+pub(crate) static TIMER_SERVICE: TimerService<IntegratorTimer, NUM_OF_DEVICES> =
+    TimerService::new(IntegratorTimer);
+
+/// Handles the compare interrupt of the timer service.
+///
+/// Indicates every elapsed timer to its device like `pl_timer_elapsed` and programs the
+/// next deadline.
+///
+/// # Example
+///
+/// ```c
+/// void TIM2_IRQHandler(void) {
+///     TIM2->SR = ~TIM_SR_CC1IF;
+///     iolinke_timer_compare_isr();
+/// }
+/// ```
+#[unsafe(no_mangle)]
+pub extern "C" fn iolinke_timer_compare_isr() {
+    TIMER_SERVICE.on_compare(|port, timer| {
+        let _ = phy::pl_timer_elapsed(port as IOLinkeDeviceHandle, timer);
+    });
+}
@@ -0,0 +1,59 @@
+//! # IO-Link Trace C Bindings
+//!
+//! Exposes the binary state transition trace of the device stack to C.
+//! Only available with the `trace` feature.
+//!
+//! The records are decoded off-target with the symbol tables of the same firmware, see
+//! `iolinke_device::trace::decode`.
+//!
+//! ## Usage
+//!
+//! ```c
+//! static uint32_t read_cyccnt(void) { return DWT->CYCCNT; }
+//!
+//! iolinke_trace_set_clock(read_cyccnt);
+//! ...
+//! trace_record_t records[64];
+//! size_t count = iolinke_trace_dump(records, 64);
+//! uart_send(records, count * sizeof(trace_record_t));
+//! ```
+use iolinke_device::trace;
+pub use iolinke_device::trace::{TraceClock, TraceRecord};
+
+/// Registers the clock of the trace timestamps.
+///
+/// # Parameters
+///
+/// * `clock` - Returns a free running, wrapping 32 bit counter, e.g. DWT `CYCCNT`.
+///
+#[unsafe(no_mangle)]
+pub extern "C" fn iolinke_trace_set_clock(clock: TraceClock) {
+    trace::set_trace_clock(clock);
+}
+
+/// Copies the newest records of the trace ring, the oldest first.
+///
+/// # Parameters
+///
+/// * `records` - Filled with up to `capacity` records.
+/// * `capacity` - Number of records `records` can hold.
+///
+/// # Returns
+///
+/// * The number of records copied.
+/// * `0` if `records` is null.
+///
+#[unsafe(no_mangle)]
+pub extern "C" fn iolinke_trace_dump(records: *mut TraceRecord, capacity: usize) -> usize {
+    if records.is_null() {
+        return 0;
+    }
+    let records = unsafe { core::slice::from_raw_parts_mut(records, capacity) };
+    trace::dump(records)
+}
+
+/// Discards all records of the trace ring.
+#[unsafe(no_mangle)]
+pub extern "C" fn iolinke_trace_reset() {
+    trace::reset();
+}
@@ -0,0 +1,103 @@
+//! Read cache of the application parameter backend
+//!
+//! Parameters which are not in the local parameter storage are read from the device
+//! application through AL_Read (e.g. from an external EEPROM or sensor ASIC), which can
+//! take many master cycles. The application can prefetch frequently read parameters
+//! into this cache, ISDU reads of a cached parameter are then answered directly
+//! without indicating AL_Read to the application.
+//!
+//! The cache is only filled by the application, the device never caches a backend
+//! response on its own. A write of the master to a cached parameter drops the entry.
+
+use heapless::Vec;
+use iolinke_types::custom::{IoLinkError, IoLinkResult};
+
+use core::default::Default;
+use core::iter::Iterator;
+use core::option::{
+    Option,
+    Option::{None, Some},
+};
+use core::result::Result::{Err, Ok};
+
+/// Number of parameters which can be prefetched
+pub const BACKEND_CACHE_ENTRIES: usize = 4;
+/// Maximum length of a prefetched parameter value
+pub const BACKEND_CACHE_DATA_LENGTH: usize = 16;
+
+/// Prefetched value of one parameter
+#[derive(Debug, Clone)]
+struct BackendCacheEntry {
+    index: u16,
+    sub_index: u8,
+    data: Vec<u8, BACKEND_CACHE_DATA_LENGTH>,
+}
+
+/// Cache of parameter values prefetched by the application
+#[derive(Debug, Clone)]
+pub struct BackendCache {
+    entries: Vec<BackendCacheEntry, BACKEND_CACHE_ENTRIES>,
+}
+
+impl BackendCache {
+    /// Creates a new, empty cache
+    pub const fn new() -> Self {
+        Self {
+            entries: Vec::new(),
+        }
+    }
+
+    /// Returns the prefetched value of `index`/`sub_index`
+    pub fn get(&self, index: u16, sub_index: u8) -> Option<&[u8]> {
+        self.position(index, sub_index)
+            .map(|position| self.entries[position].data.as_slice())
+    }
+
+    /// Stores the value of `index`/`sub_index`, replacing a previous value.
+    ///
+    /// # Errors
+    /// - `IoLinkError::InvalidLength` if `data` is longer than [`BACKEND_CACHE_DATA_LENGTH`].
+    /// - `IoLinkError::NotEnoughMemory` if all [`BACKEND_CACHE_ENTRIES`] are used by
+    ///   other parameters.
+    pub fn insert(&mut self, index: u16, sub_index: u8, data: &[u8]) -> IoLinkResult<()> {
+        let data = Vec::from_slice(data).map_err(|_| IoLinkError::InvalidLength)?;
+        match self.position(index, sub_index) {
+            Some(position) => self.entries[position].data = data,
+            None => self
+                .entries
+                .push(BackendCacheEntry {
+                    index,
+                    sub_index,
+                    data,
+                })
+                .map_err(|_| IoLinkError::NotEnoughMemory)?,
+        }
+        Ok(())
+    }
+
+    /// Drops the value of `index`/`sub_index`.
+    ///
+    /// A write to subindex 0 addresses the whole index, so it drops all subindexes.
+    pub fn invalidate(&mut self, index: u16, sub_index: u8) {
+        self.entries.retain(|entry| {
+            entry.index != index || (sub_index != 0 && entry.sub_index != sub_index)
+        });
+    }
+
+    /// Drops all values
+    pub fn clear(&mut self) {
+        self.entries.clear();
+    }
+
+    fn position(&self, index: u16, sub_index: u8) -> Option<usize> {
+        self.entries
+            .iter()
+            .position(|entry| entry.index == index && entry.sub_index == sub_index)
+    }
+}
+
+impl Default for BackendCache {
+    fn default() -> Self {
+        Self::new()
+    }
+}
@@ -9,6 +9,8 @@ use iolinke_types::{
     custom::{IoLinkError, IoLinkResult},
     handlers,
 };
+#[cfg(feature = "trace")]
+use iolinke_util::trace::TraceModule;
 use iolinke_util::{log_state_transition, log_state_transition_error};
 
 pub use core::result::Result::{Err, Ok};
@@ -17,6 +19,7 @@ use crate::al::{event_handler, parameter_manager};
 
 /// See 8.3.3.2 Event state machine of the Device AL
 #[derive(Debug, Clone, Copy, PartialEq, Eq)]
+#[cfg_attr(feature = "trace", derive(iolinke_macros::TraceId))]
 pub enum DtatStorageStateMachineState {
     /// {DSLocked_1}
     /// Waiting on Data Storage state machine to become unlocked.
@@ -85,6 +88,7 @@ pub enum DataStorageTransition {
 }
 
 #[derive(Debug, Clone, Copy, PartialEq, Eq)]
+#[cfg_attr(feature = "trace", derive(iolinke_macros::TraceId))]
 pub enum DataStorageStateMachineEvent {
     /// [Unlocked] Event for DSStateCheck_0 (Triggers T1 or T6)
     /// ! {Obsolete} This event is not used in v1.1.4.
@@ -111,6 +115,11 @@ pub enum DataStorageStateMachineEvent {
     TransmissionBreak,
 }
 
+/// Names of the states and events of the state machine, see [`crate::trace`]
+#[cfg(feature = "trace")]
+pub(crate) const TRACE_MODULE: TraceModule =
+    TraceModule::new::<DtatStorageStateMachineState, DataStorageStateMachineEvent>(module_path!());
+
 pub struct DataStorage {
     state: DtatStorageStateMachineState,
     exec_transition: DataStorageTransition,
@@ -168,6 +177,11 @@ impl DataStorage {
         Ok(())
     }
 
+    /// Returns `true` while a transition is pending for the next poll
+    pub fn has_pending_transition(&self) -> bool {
+        self.exec_transition != DataStorageTransition::Tn
+    }
+
     pub fn poll(
         &mut self,
         event_handler: &mut event_handler::EventHandler,
@@ -355,6 +369,8 @@ impl DataStorage {
         parameter_manager: &mut parameter_manager::ParameterManager,
     ) -> IoLinkResult<()> {
         parameter_manager.set_upload_flag(false)?;
+        // The Master holds the current parameter set now
+        parameter_manager.clear_data_storage_changes();
         // Unlock local parameter access
         parameter_manager.unlock_local_parameter_access()?;
         parameter_manager.set_state_property(handlers::pm::DsState::Inactive)?;
@@ -0,0 +1,174 @@
+//! Event aggregation ahead of the AL Event handler
+//!
+//! Every reported Event starts its own Event signaling: the Event flag is set, the
+//! Master reads the Event memory through the on-request channel and confirms it. When a
+//! fault flaps, the device application raises the same Event over and over and the
+//! signalings use up the on-request bandwidth the ISDU traffic needs.
+//!
+//! The aggregator sits between the Event queue and the DL Event memory:
+//!
+//! - An occurrence of an Event (same EventQualifier and EventCode) which is still waiting
+//!   to be reported is merged into it and counted.
+//! - An EventCode is reported at most once per [`rate_limit_cycles`] Master cycles.
+//!   Occurrences within the interval are kept and reported when it expired, they are
+//!   delayed, not dropped.
+//! - Waiting Events are reported in the order of their last occurrence, so of a flapping
+//!   fault (appearing / disappearing Events of one EventCode) the last state is reported
+//!   last.
+//!
+//! The table keeps reported Events as long as it has room, for the rate limit. A new
+//! Event replaces a reported one, which only shortens the interval of that EventCode.
+//!
+//! [`rate_limit_cycles`]: iolinke_derived_config::device::events::rate_limit_cycles
+
+use heapless::Vec;
+
+use core::iter::Iterator;
+use core::option::{
+    Option,
+    Option::{None, Some},
+};
+
+use crate::storage::event_memory::EVENT_ENTRY_SIZE;
+
+/// Event entry in the wire format of the Event memory
+pub type EventEntryBytes = [u8; EVENT_ENTRY_SIZE];
+
+/// One distinct Event of the aggregation table
+#[derive(Debug, Clone, Copy)]
+struct AggregatedEvent {
+    entry: EventEntryBytes,
+    /// Occurrences since the last report, 0 while nothing is waiting
+    pending_count: u16,
+    /// Sequence number of the last occurrence
+    last_occurrence: u32,
+    /// Master cycle of the last report
+    reported_at: Option<u32>,
+}
+
+impl AggregatedEvent {
+    /// EventCode of the entry, see [`EventEntry::to_bytes`]
+    ///
+    /// [`EventEntry::to_bytes`]: iolinke_types::handlers::event::EventEntry::to_bytes
+    fn event_code(&self) -> [u8; 2] {
+        [self.entry[1], self.entry[2]]
+    }
+}
+
+/// Aggregation table of up to `N` distinct Events
+#[derive(Debug, Clone)]
+pub struct EventAggregator<const N: usize> {
+    events: Vec<AggregatedEvent, N>,
+    /// Minimum number of Master cycles between two reports of an EventCode
+    rate_limit_cycles: u32,
+    /// Sequence number of the next occurrence
+    sequence: u32,
+    /// Number of occurrences merged into a waiting Event
+    coalesced_count: u32,
+}
+
+impl<const N: usize> EventAggregator<N> {
+    /// Creates an empty table with the given rate limit, 0 disables the rate limit
+    pub const fn new(rate_limit_cycles: u32) -> Self {
+        Self {
+            events: Vec::new(),
+            rate_limit_cycles,
+            sequence: 0,
+            coalesced_count: 0,
+        }
+    }
+
+    /// Returns `true` if `entry` can be added without dropping it
+    pub fn can_add(&self, entry: &EventEntryBytes) -> bool {
+        !self.events.is_full()
+            || self
+                .events
+                .iter()
+                .any(|event| event.entry == *entry || event.pending_count == 0)
+    }
+
+    /// Adds an occurrence of `entry`.
+    ///
+    /// # Returns
+    /// - `true` if the occurrence was merged or added.
+    /// - `false` if the table holds `N` other Events waiting to be reported.
+    pub fn add(&mut self, entry: &EventEntryBytes) -> bool {
+        let sequence = self.sequence;
+        if let Some(event) = self.events.iter_mut().find(|event| event.entry == *entry) {
+            if event.pending_count > 0 {
+                self.coalesced_count = self.coalesced_count.wrapping_add(1);
+            }
+            event.pending_count = event.pending_count.saturating_add(1);
+            event.last_occurrence = sequence;
+            self.sequence = sequence.wrapping_add(1);
+            return true;
+        }
+        if self.events.is_full() {
+            // Replace the Event reported the longest time ago
+            let Some(position) = self
+                .events
+                .iter()
+                .enumerate()
+                .filter(|(_, event)| event.pending_count == 0)
+                .min_by_key(|(_, event)| event.reported_at)
+                .map(|(position, _)| position)
+            else {
+                return false;
+            };
+            self.events.swap_remove(position);
+        }
+        let added = self
+            .events
+            .push(AggregatedEvent {
+                entry: *entry,
+                pending_count: 1,
+                last_occurrence: sequence,
+                reported_at: None,
+            })
+            .is_ok();
+        self.sequence = sequence.wrapping_add(1);
+        added
+    }
+
+    /// Returns `true` if an Event can be reported in Master cycle `cycle`
+    pub fn has_reportable(&self, cycle: u32) -> bool {
+        self.reportable_position(cycle).is_some()
+    }
+
+    /// Takes the next Event which can be reported in Master cycle `cycle`, all its
+    /// occurrences are reported with it.
+    pub fn take_reportable(&mut self, cycle: u32) -> Option<EventEntryBytes> {
+        let position = self.reportable_position(cycle)?;
+        let event = &mut self.events[position];
+        event.pending_count = 0;
+        event.reported_at = Some(cycle);
+        Some(event.entry)
+    }
+
+    /// Returns the number of occurrences merged into a waiting Event, wraps around
+    pub fn coalesced_count(&self) -> u32 {
+        self.coalesced_count
+    }
+
+    /// Position of the reportable Event with the oldest last occurrence
+    fn reportable_position(&self, cycle: u32) -> Option<usize> {
+        self.events
+            .iter()
+            .enumerate()
+            .filter(|(_, event)| event.pending_count > 0 && !self.is_rate_limited(event, cycle))
+            .max_by_key(|(_, event)| self.sequence.wrapping_sub(event.last_occurrence))
+            .map(|(position, _)| position)
+    }
+
+    /// `true` while an Event with the same EventCode was reported less than
+    /// `rate_limit_cycles` Master cycles ago
+    fn is_rate_limited(&self, event: &AggregatedEvent, cycle: u32) -> bool {
+        self.rate_limit_cycles > 0
+            && self.events.iter().any(|other| {
+                other.event_code() == event.event_code()
+                    && other.reported_at.is_some_and(|reported_at| {
+                        cycle.wrapping_sub(reported_at) < self.rate_limit_cycles
+                    })
+            })
+    }
+}
@@ -10,7 +10,8 @@
 //!
 //! ## State Machine
 //!
-//! - **EventInactive**: The initial state where no events are processed.
+//! - **EventInactive**: The initial state where no events are processed, left when System
+//!   Management indicates PREOPERATE or OPERATE.
 //! - **EventIdle**: Ready to process AL_Event requests.
 //! - **AwaitEventResponse**: Waiting for confirmation from the Data Link Layer (DL).
 //!
@@ -24,8 +25,28 @@
 //! ## Integration
 //!
 //! The module provides an `EventHandler` struct implementing the state machine logic, and integrates with
-//! AL and DL services via trait implementations. It uses heapless vectors for event entry storage to support
-//! embedded environments.
+//! AL and DL services via trait implementations.
+//!
+//! ## Event queue
+//!
+//! Events of the device application are pushed into a lock-free single producer / single
+//! consumer ring, an [`AlEventQueue`], in the wire format of the Event memory (see
+//! [`EventEntry::to_bytes`]). Events pushed while the ring is full are dropped and counted.
+//! The Event handler owns one queue for Events raised from the poll context. Events raised
+//! from interrupt context (e.g. over-temperature, short-circuit) go to a queue kept outside
+//! of the device, e.g. in a `static`, so the interrupt never creates a reference to the
+//! device while the main loop holds it. The poll context hands that queue over with
+//! [`EventHandler::al_event_take_req`], without disabling interrupts.
+//!
+//! The poll moves the queued Events into the [`EventAggregator`], which merges repeated
+//! Events and rate limits every EventCode (see `IODevice.Events` in `device_config.toon`).
+//! Events of the stack itself (e.g. DS_UPLOAD_REQ of the Data Storage) are raised through
+//! [`AlEventReq`] from the poll context and are added to the aggregator directly, so each
+//! queue has a single producer.
+//!
+//! In EventIdle the poll writes up to [`MAX_EVENT_ENTRIES`] reportable Events straight
+//! into the DL Event memory and triggers the Event signaling, the remaining Events are
+//! reported after the Master confirmed the current ones.
 //!
 //! # Usage
 //!
@@ -37,27 +58,26 @@
 //! - IO-Link Specification, Section 8.3.3.2: Event State Machine of the Device AL
 //! - Table 77: State and transitions of the Event state machine
 
-use heapless::Vec;
-use iolinke_types::handlers::event::DlEventReq;
+use iolinke_derived_config::device::events;
 use iolinke_types::{
     custom::{IoLinkError, IoLinkResult},
-    handlers::event::EventEntry,
+    handlers::{event::EventEntry, sm::DeviceMode},
 };
+use iolinke_util::spsc_ring::SpscRing;
 
 use core::default::Default;
-use core::option::{
-    Option,
-    Option::{None, Some},
-};
+use core::iter::Iterator;
+use core::option::Option::Some;
 pub use core::result::Result::{Err, Ok};
 
+use crate::al::event_aggregator::{EventAggregator, EventEntryBytes};
 use crate::al::services;
+use crate::storage::event_memory::MAX_EVENT_ENTRIES;
 use crate::{al::services::AlEventReq, dl};
 
-struct Events {
-    event_code: u8,
-    event_entries: heapless::Vec<EventEntry, 6>,
-}
+/// Number of application Events which can be queued, and number of distinct Events
+/// which can wait to be reported
+pub const EVENT_QUEUE_DEPTH: usize = events::queue_depth();
 
 /// See 8.3.3.2 Event state machine of the Device AL
 #[derive(Debug, Clone, Copy, PartialEq, Eq)]
@@ -96,20 +116,60 @@ enum Transition {
 #[derive(Debug, Clone, Copy, PartialEq, Eq)]
 pub enum EventStateMachineEvent {
     /// {Activate} See 8.3.3.2 , Triggers T1
-    _Activate,
+    Activate,
     /// {Deactivate} See 8.3.3.2, Triggers T2
-    _Deactivate,
+    Deactivate,
     /// {AL_Event_request} See 8.3.3.2, Triggers T3
     AlEventRequest,
     /// {DL_EventTrigger_conf} See 8.3.3.2, Triggers T4
     DlEventTriggerConf,
 }
 
+/// Queue of Events raised by the device application, see the [module](self) documentation.
+///
+/// Lock-free, one context may push while the poll context takes the Events.
+pub struct AlEventQueue {
+    ring: SpscRing<EventEntryBytes, EVENT_QUEUE_DEPTH>,
+}
+
+impl AlEventQueue {
+    /// Creates a new, empty queue
+    pub const fn new() -> Self {
+        Self {
+            ring: SpscRing::new(),
+        }
+    }
+
+    /// Queues an Event, producer side. Only one context may push into a queue.
+    ///
+    /// # Returns
+    /// - `true` if the Event was queued.
+    /// - `false` if [`EVENT_QUEUE_DEPTH`] Events are queued already, the Event is dropped
+    ///   and counted in [`AlEventQueue::overflow_count`].
+    pub fn push(&self, event_entry: &EventEntry) -> bool {
+        self.ring.push(event_entry.to_bytes())
+    }
+
+    /// Returns the number of Events dropped because the queue was full. Wraps around.
+    pub fn overflow_count(&self) -> u32 {
+        self.ring.overflow_count()
+    }
+}
+
+impl Default for AlEventQueue {
+    fn default() -> Self {
+        Self::new()
+    }
+}
+
 /// Event State Machine implementation
 pub struct EventHandler {
     state: EventStateMachineState,
     exec_transition: Transition,
-    events: Option<Events>,
+    /// Events raised by the device application from the poll context
+    event_queue: AlEventQueue,
+    /// Events waiting to be reported, merged and rate limited
+    aggregator: EventAggregator<EVENT_QUEUE_DEPTH>,
 }
 
 impl EventHandler {
@@ -118,7 +178,8 @@ impl EventHandler {
         Self {
             state: EventStateMachineState::EventInactive,
             exec_transition: Transition::Tn,
-            events: None,
+            event_queue: AlEventQueue::new(),
+            aggregator: EventAggregator::new(events::rate_limit_cycles()),
         }
     }
 
@@ -129,8 +190,13 @@ impl EventHandler {
 
         let (new_transition, new_state) = match (self.state.clone(), event) {
             // Valid transitions according to Table 77
-            (State::EventInactive, Event::_Activate) => (Transition::T1, State::EventIdle),
-            (State::EventIdle, Event::_Deactivate) => (Transition::T2, State::EventInactive),
+            (State::EventInactive, Event::Activate) => (Transition::T1, State::EventIdle),
+            (State::EventIdle, Event::Deactivate) => (Transition::T2, State::EventInactive),
+            // The DL discards a frozen Event memory when it is deactivated, the
+            // DL_EventTrigger is never confirmed
+            (State::AwaitEventResponse, Event::Deactivate) => {
+                (Transition::T2, State::EventInactive)
+            }
             (State::EventIdle, Event::AlEventRequest) => {
                 (Transition::T3, State::AwaitEventResponse)
             }
@@ -147,12 +213,92 @@ impl EventHandler {
         Ok(())
     }
 
+    /// Returns `true` while a transition is pending for the next poll, including Events
+    /// which can be reported in Master cycle `cycle`
+    pub fn has_pending_transition(&self, cycle: u32) -> bool {
+        if self.exec_transition != Transition::Tn {
+            return true;
+        }
+        self.has_queued_event(&self.event_queue)
+            || (self.state == EventStateMachineState::EventIdle
+                && self.aggregator.has_reportable(cycle))
+    }
+
+    /// Activates the state machine when the Master opened the Event channel, i.e. in
+    /// PREOPERATE and OPERATE, and deactivates it in every other device mode
+    pub fn sm_device_mode_ind(&mut self, mode: DeviceMode) -> IoLinkResult<()> {
+        use EventStateMachineState as State;
+
+        match (self.state, mode) {
+            (State::EventInactive, DeviceMode::Preoperate | DeviceMode::Operate) => {
+                self.process_event(EventStateMachineEvent::Activate)
+            }
+            (State::EventInactive, _) | (_, DeviceMode::Preoperate | DeviceMode::Operate) => Ok(()),
+            _ => self.process_event(EventStateMachineEvent::Deactivate),
+        }
+    }
+
+    /// Queues an Event of the device application raised from the poll context.
+    ///
+    /// # Returns
+    /// - `true` if the Event was queued.
+    /// - `false` if [`EVENT_QUEUE_DEPTH`] Events are queued already, the Event is dropped
+    ///   and counted in [`EventHandler::event_overflow_count`].
+    pub fn al_event_push_req(&mut self, event_entry: &EventEntry) -> bool {
+        self.event_queue.push(event_entry)
+    }
+
+    /// Moves the Events of `queue` into the aggregator, consumer side of `queue`. Events
+    /// stay queued while the aggregator has no room for them.
+    pub fn al_event_take_req(&mut self, queue: &AlEventQueue) {
+        Self::drain(&mut self.aggregator, queue);
+    }
+
+    /// Returns `true` if `queue` holds an Event the aggregator has room for
+    pub fn has_queued_event(&self, queue: &AlEventQueue) -> bool {
+        queue
+            .ring
+            .peek()
+            .is_some_and(|entry| self.aggregator.can_add(&entry))
+    }
+
+    /// Returns the number of application Events dropped because the queue was full
+    pub fn event_overflow_count(&self) -> u32 {
+        self.event_queue.overflow_count()
+    }
+
+    /// Returns the number of Events merged into an Event waiting to be reported
+    pub fn event_coalesced_count(&self) -> u32 {
+        self.aggregator.coalesced_count()
+    }
+
+    /// Moves the Events of `queue` into `aggregator`, consumer side of `queue`. Events
+    /// stay queued while the aggregator has no room for them.
+    fn drain(aggregator: &mut EventAggregator<EVENT_QUEUE_DEPTH>, queue: &AlEventQueue) {
+        while let Some(entry) = queue.ring.peek() {
+            if !aggregator.add(&entry) {
+                break;
+            }
+            let _ = queue.ring.pop();
+        }
+    }
+
     /// Poll the state machine
-    pub fn poll<ALS: services::AlEventCnf>(
+    pub fn poll<ALS: services::AlEventCnf, DL: dl::DataLinkLayerReq>(
         &mut self,
         application: &mut ALS,
-        data_link_layer: &mut dl::DataLinkLayer,
+        data_link_layer: &mut DL,
     ) -> IoLinkResult<()> {
+        Self::drain(&mut self.aggregator, &self.event_queue);
+        // Waiting Events are reported as soon as the previous ones are confirmed
+        if self.exec_transition == Transition::Tn
+            && self.state == EventStateMachineState::EventIdle
+            && self
+                .aggregator
+                .has_reportable(data_link_layer.master_cycle_count())
+        {
+            self.process_event(EventStateMachineEvent::AlEventRequest)?;
+        }
         // Process pending transitions
         match self.exec_transition {
             Transition::Tn => {
@@ -160,18 +306,22 @@ impl EventHandler {
             }
             Transition::T1 => {
                 // Transition T1: Activate -> EventIdle
+                self.exec_transition = Transition::Tn;
                 self.execute_t1()?;
             }
             Transition::T2 => {
                 // Transition T2: Deactivate -> EventInactive
+                self.exec_transition = Transition::Tn;
                 self.execute_t2()?;
             }
             Transition::T3 => {
                 // Transition T3: AlEventRequest -> AwaitEventResponse
+                self.exec_transition = Transition::Tn;
                 self.execute_t3(data_link_layer)?;
             }
             Transition::T4 => {
                 // Transition T4: DlEventTriggerConf -> EventIdle
+                self.exec_transition = Transition::Tn;
                 self.execute_t4(application)?;
             }
         }
@@ -193,18 +343,28 @@ impl EventHandler {
     }
 
     /// Execute transition T3: EventIdle -> AwaitEventResponse
-    fn execute_t3(&mut self, data_link_layer: &mut dl::DataLinkLayer) -> IoLinkResult<()> {
+    fn execute_t3<DL: dl::DataLinkLayerReq>(
+        &mut self,
+        data_link_layer: &mut DL,
+    ) -> IoLinkResult<()> {
         // T3: AlEventRequest -> AwaitEventResponse
         // Action: An AL_Event request triggers a DL_Event and the corresponding
         // DL_EventTrigger service. The DL_Event carries the diagnosis information
         // from AL to DL. The DL_EventTrigger sets the Event flag within the cyclic
         // data exchange.
 
-        // DL_Event and DL_EventTrigger service calls
-        if let Some(events) = &self.events {
-            let _ = data_link_layer.dl_event_req(events.event_code, &events.event_entries);
-            let _ = data_link_layer.dl_event_trigger_req();
+        // DL_Event for up to 6 entries, written straight into the Event memory
+        let cycle = data_link_layer.master_cycle_count();
+        let mut entry_count = 0;
+        while entry_count < MAX_EVENT_ENTRIES {
+            let Some(entry) = self.aggregator.take_reportable(cycle) else {
+                break;
+            };
+            let _ = data_link_layer.dl_event_entry_req(&entry);
+            entry_count += 1;
         }
+        // DL_EventTrigger service call
+        let _ = data_link_layer.dl_event_trigger_req();
 
         Ok(())
     }
@@ -221,14 +381,18 @@ impl EventHandler {
 }
 
 impl AlEventReq for EventHandler {
-    fn al_event_req(&mut self, event_count: u8, event_entries: &[EventEntry]) -> IoLinkResult<()> {
-        let mut event_entries_vec: Vec<EventEntry, 6> = Vec::new();
-        let _ = event_entries_vec.extend_from_slice(event_entries);
-        self.events = Some(Events {
-            event_code: event_count,
-            event_entries: event_entries_vec,
-        });
-        self.process_event(EventStateMachineEvent::AlEventRequest)
+    /// Raises Events of the stack itself, they are reported by the next poll in
+    /// EventIdle. The DL counts the reported entries, so `_event_count` is not used.
+    fn al_event_req(&mut self, _event_count: u8, event_entries: &[EventEntry]) -> IoLinkResult<()> {
+        if self.state == EventStateMachineState::EventInactive {
+            return Err(IoLinkError::InvalidEvent);
+        }
+        for event_entry in event_entries.iter() {
+            if !self.aggregator.add(&event_entry.to_bytes()) {
+                return Err(IoLinkError::EventMemoryFull);
+            }
+        }
+        Ok(())
     }
 }
 
@@ -21,19 +21,43 @@
 //! - Annex B: Parameter Definitions and Access
 
 use crate::dl;
+use crate::footprint::Component;
+#[cfg(feature = "profiling")]
+use crate::profiling::ProfileId;
+use crate::profiling::profile_scope;
 
+mod backend_cache;
+#[cfg(feature = "data_storage")]
 mod data_storage;
+#[cfg(not(feature = "data_storage"))]
+#[path = "no_data_storage.rs"]
+mod data_storage;
+#[cfg(feature = "events")]
+pub mod event_aggregator;
+#[cfg(feature = "events")]
+mod event_handler;
+#[cfg(not(feature = "events"))]
+#[path = "no_event_handler.rs"]
 mod event_handler;
 pub mod od_handler;
 pub mod parameter_manager;
 mod pd_handler;
 pub mod services;
 
+pub use event_handler::AlEventQueue;
+pub use pd_handler::OutputIndication;
+
 use heapless::Vec;
+use iolinke_derived_config::device::vendor_specifics::storage_config::ParameterStorage;
 use iolinke_types::custom::IoLinkResult;
 use iolinke_types::handlers;
+#[cfg(feature = "trace")]
+use iolinke_util::trace::TraceModule;
 
 use core::result::Result::Ok;
+
+use services::{AlReadRsp, AlWriteRsp};
+
 /// Application Layer Read/Write Interface for parameter access.
 ///
 /// This trait defines the interface that the data link layer uses to
@@ -130,6 +154,23 @@ pub struct ApplicationLayer<
     pde: pd_handler::ProcessDataHandler,
 }
 
+/// RAM of the Application Layer components, see [`crate::footprint`]
+pub(crate) const FOOTPRINT: [Component; 5] = [
+    Component::of::<event_handler::EventHandler>("AL Event Handler"),
+    Component::of::<od_handler::OnRequestDataHandler>("AL On-request Data Handler"),
+    Component::of::<parameter_manager::ParameterManager>("AL Parameter Manager"),
+    Component::of::<data_storage::DataStorage>("AL Data Storage"),
+    Component::of::<pd_handler::ProcessDataHandler>("AL Process Data Handler"),
+];
+
+/// Symbol tables of the Application Layer state machines, see [`crate::trace`]
+#[cfg(feature = "trace")]
+pub(crate) const TRACE_MODULES: &[TraceModule] = &[
+    parameter_manager::TRACE_MODULE,
+    #[cfg(feature = "data_storage")]
+    data_storage::TRACE_MODULE,
+];
+
 impl<
     ALS: services::ApplicationLayerServicesInd
         + handlers::sm::SystemManagementCnf
@@ -158,18 +199,94 @@ impl<
     /// - `IoLinkError::NoImplFound` - Feature not yet implemented
     /// - `IoLinkError::InvalidParameter` - Invalid parameter value
     /// - `IoLinkError::FuncNotAvailable` - Function not available in current state
-    pub fn poll(&mut self, data_link_layer: &mut dl::DataLinkLayer) -> IoLinkResult<()> {
+    pub fn poll<DL: dl::DataLinkLayerReq>(&mut self, data_link_layer: &mut DL) -> IoLinkResult<()> {
         // Poll all components in dependency order
-        self.event_handler
-            .poll(&mut self.services, data_link_layer)?;
-        self.od_handler
-            .poll(&mut self.parameter_manager, data_link_layer)?;
-        self.parameter_manager
-            .poll(&mut self.od_handler, &mut self.data_storage)?;
-        self.data_storage
-            .poll(&mut self.event_handler, &mut self.parameter_manager)?;
+        profile_scope!(
+            ProfileId::AlEventHandler,
+            self.event_handler
+                .poll(&mut self.services, data_link_layer)
+        )?;
+        profile_scope!(
+            ProfileId::AlOdHandler,
+            self.od_handler.poll(
+                &mut self.parameter_manager,
+                &mut self.services,
+                data_link_layer,
+            )
+        )?;
+        profile_scope!(
+            ProfileId::AlParameterManager,
+            self.parameter_manager
+                .poll(&mut self.od_handler, &mut self.data_storage)
+        )?;
+        profile_scope!(
+            ProfileId::AlDataStorage,
+            self.data_storage
+                .poll(&mut self.event_handler, &mut self.parameter_manager)
+        )?;
+        self.pde.poll(&mut self.services)?;
         Ok(())
     }
+
+    /// Stores a value of a parameter served by the device application, ISDU reads of
+    /// it are answered without AL_Read.
+    pub fn al_prefetch_req(&mut self, index: u16, sub_index: u8, data: &[u8]) -> IoLinkResult<()> {
+        self.od_handler.al_prefetch_req(index, sub_index, data)
+    }
+
+    /// Drops a value stored with [`Self::al_prefetch_req`]
+    pub fn al_invalidate_req(&mut self, index: u16, sub_index: u8) {
+        self.od_handler.al_invalidate_req(index, sub_index);
+    }
+
+    /// Replaces the filtering of AL_NewOutput and AL_PDCycle
+    pub fn set_output_indication(&mut self, output_indication: OutputIndication) {
+        self.pde.set_output_indication(output_indication);
+    }
+
+    /// Queues an Event of the device application, see [`IoLinkDevice::al_event_push_req`]
+    ///
+    /// [`IoLinkDevice::al_event_push_req`]: crate::IoLinkDevice::al_event_push_req
+    pub fn al_event_push_req(&mut self, event_entry: &handlers::event::EventEntry) -> bool {
+        self.event_handler.al_event_push_req(event_entry)
+    }
+
+    /// Takes the Events of `queue`, see [`IoLinkDevice::al_event_take_req`]
+    ///
+    /// [`IoLinkDevice::al_event_take_req`]: crate::IoLinkDevice::al_event_take_req
+    pub fn al_event_take_req(&mut self, queue: &AlEventQueue) {
+        self.event_handler.al_event_take_req(queue);
+    }
+
+    /// Returns `true` if `queue` holds an Event which can be taken
+    pub fn has_queued_event(&self, queue: &AlEventQueue) -> bool {
+        self.event_handler.has_queued_event(queue)
+    }
+
+    /// Returns the number of application Events dropped because the queue was full
+    pub fn event_overflow_count(&self) -> u32 {
+        self.event_handler.event_overflow_count()
+    }
+
+    /// Returns the number of Events merged into an Event waiting to be reported
+    pub fn event_coalesced_count(&self) -> u32 {
+        self.event_handler.event_coalesced_count()
+    }
+
+    /// Returns the local parameter storage of the Parameter Manager
+    pub fn parameter_storage_mut(&mut self) -> &mut ParameterStorage {
+        self.parameter_manager.param_storage_mut()
+    }
+
+    /// Returns `true` if any Application Layer state machine has a pending transition
+    pub fn has_pending_work<DL: dl::DataLinkLayerReq>(&self, data_link_layer: &DL) -> bool {
+        self.event_handler
+            .has_pending_transition(data_link_layer.master_cycle_count())
+            || self.od_handler.has_pending_transition()
+            || self.parameter_manager.has_pending_transition()
+            || self.data_storage.has_pending_transition()
+            || self.pde.has_pending_transition()
+    }
 }
 
 impl<
@@ -178,15 +295,37 @@ impl<
         + services::AlEventCnf,
 > services::AlSetInputReq for ApplicationLayer<ALS>
 {
-    fn al_set_input_req(
+    fn al_set_input_req<DL: dl::DataLinkLayerReq>(
         &mut self,
         pd_data: &[u8],
-        data_link_layer: &mut dl::DataLinkLayer,
+        data_link_layer: &mut DL,
     ) -> IoLinkResult<()> {
         self.pde.al_set_input_req(pd_data, data_link_layer)
     }
 }
 
+impl<
+    ALS: services::ApplicationLayerServicesInd
+        + handlers::sm::SystemManagementCnf
+        + services::AlEventCnf,
+> services::AlReadRsp for ApplicationLayer<ALS>
+{
+    fn al_read_rsp(&mut self, result: services::AlResult<(u8, &[u8])>) -> IoLinkResult<()> {
+        self.od_handler.al_read_rsp(result)
+    }
+}
+
+impl<
+    ALS: services::ApplicationLayerServicesInd
+        + handlers::sm::SystemManagementCnf
+        + services::AlEventCnf,
+> services::AlWriteRsp for ApplicationLayer<ALS>
+{
+    fn al_write_rsp(&mut self, result: services::AlResult<()>) -> IoLinkResult<()> {
+        self.od_handler.al_write_rsp(result)
+    }
+}
+
 impl<
     ALS: services::ApplicationLayerServicesInd
         + handlers::sm::SystemManagementCnf
@@ -238,6 +377,7 @@ impl<
     fn sm_device_mode_ind(&mut self, mode: handlers::sm::DeviceMode) -> handlers::sm::SmResult<()> {
         let _ = self.parameter_manager.sm_device_mode_ind(mode);
         let _ = self.data_storage.sm_device_mode_ind(mode);
+        let _ = self.event_handler.sm_device_mode_ind(mode);
         Ok(())
     }
 }
@@ -335,6 +475,17 @@ impl<
     }
 }
 
+impl<
+    ALS: services::ApplicationLayerServicesInd
+        + handlers::sm::SystemManagementCnf
+        + services::AlEventCnf,
+> dl::DlEventTriggerConf for ApplicationLayer<ALS>
+{
+    fn event_trigger_conf(&mut self) -> IoLinkResult<()> {
+        dl::DlEventTriggerConf::event_trigger_conf(&mut self.event_handler)
+    }
+}
+
 impl<
     ALS: services::ApplicationLayerServicesInd
         + handlers::sm::SystemManagementCnf
@@ -389,6 +540,7 @@ impl<
         &mut self,
         control_code: handlers::command::DlControlCode,
     ) -> IoLinkResult<()> {
+        self.pde.dl_control_ind(control_code);
         self.services.al_control_ind(control_code)
     }
 }
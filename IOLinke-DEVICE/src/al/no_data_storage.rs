@@ -0,0 +1,52 @@
+//! Data Storage stub of devices without Data Storage
+//!
+//! Built instead of the Data Storage state machine (see IO-Link Specification v1.1.4
+//! Section 10.4) when the `data_storage` feature is disabled. The device never requests
+//! an upload, DS_Commands of the Master are accepted and discarded and the Data Storage
+//! parameter (index 0x0003) is kept in the parameter storage like any other parameter.
+use iolinke_types::handlers::ds::DsCommand;
+use iolinke_types::{custom::IoLinkResult, handlers};
+
+pub use core::result::Result::{Err, Ok};
+
+use crate::al::{event_handler, parameter_manager};
+
+/// Data Storage without Data Storage support, zero-sized
+pub struct DataStorage;
+
+impl DataStorage {
+    pub fn new() -> Self {
+        Self
+    }
+
+    /// Returns `true` while a transition is pending for the next poll, never
+    pub fn has_pending_transition(&self) -> bool {
+        false
+    }
+
+    /// Poll the state machine, there is nothing to process
+    pub fn poll(
+        &mut self,
+        _event_handler: &mut event_handler::EventHandler,
+        _parameter_manager: &mut parameter_manager::ParameterManager,
+    ) -> IoLinkResult<()> {
+        Ok(())
+    }
+
+    pub fn ds_command(&mut self, _command: DsCommand) -> IoLinkResult<()> {
+        Ok(())
+    }
+
+    pub fn ds_par_upload_ind(&mut self) -> IoLinkResult<()> {
+        Ok(())
+    }
+}
+
+impl handlers::sm::SystemManagementInd for DataStorage {
+    fn sm_device_mode_ind(
+        &mut self,
+        _device_mode: handlers::sm::DeviceMode,
+    ) -> handlers::sm::SmResult<()> {
+        Ok(())
+    }
+}
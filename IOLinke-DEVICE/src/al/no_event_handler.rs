@@ -0,0 +1,123 @@
+//! Event Handler stub of devices without Events
+//!
+//! Built instead of the Event state machine, the Event queue and the Event aggregator
+//! (see IO-Link Specification v1.1.4 Section 8.3.3.2) when the `events` feature is
+//! disabled. Events of the device application are rejected, nothing is ever reported to
+//! the Master.
+
+use iolinke_types::{
+    custom::{IoLinkError, IoLinkResult},
+    handlers::{event::EventEntry, sm::DeviceMode},
+};
+
+use core::default::Default;
+pub use core::result::Result::{Err, Ok};
+
+use crate::al::services;
+use crate::{al::services::AlEventReq, dl};
+
+/// Queue of Events raised by the device application without Event support, zero-sized
+pub struct AlEventQueue;
+
+impl AlEventQueue {
+    /// Creates a new queue
+    pub const fn new() -> Self {
+        Self
+    }
+
+    /// Rejects an Event of the device application.
+    ///
+    /// # Returns
+    /// - `false`, the Event is dropped without being counted.
+    pub fn push(&self, _event_entry: &EventEntry) -> bool {
+        false
+    }
+
+    /// Returns the number of Events dropped because the queue was full, 0
+    pub fn overflow_count(&self) -> u32 {
+        0
+    }
+}
+
+impl Default for AlEventQueue {
+    fn default() -> Self {
+        Self::new()
+    }
+}
+
+/// Event State Machine without Event support, zero-sized
+pub struct EventHandler;
+
+impl EventHandler {
+    /// Create a new Event State Machine
+    pub fn new() -> Self {
+        Self
+    }
+
+    /// Returns `true` while a transition is pending for the next poll, never
+    pub fn has_pending_transition(&self, _cycle: u32) -> bool {
+        false
+    }
+
+    /// Device mode change, there is no state to activate
+    pub fn sm_device_mode_ind(&mut self, _mode: DeviceMode) -> IoLinkResult<()> {
+        Ok(())
+    }
+
+    /// Rejects an Event of the device application.
+    ///
+    /// # Returns
+    /// - `false`, the Event is dropped without being counted.
+    pub fn al_event_push_req(&mut self, _event_entry: &EventEntry) -> bool {
+        false
+    }
+
+    /// Takes the Events of `queue`, which never holds one
+    pub fn al_event_take_req(&mut self, _queue: &AlEventQueue) {}
+
+    /// Returns `true` if `queue` holds an Event, never
+    pub fn has_queued_event(&self, _queue: &AlEventQueue) -> bool {
+        false
+    }
+
+    /// Returns the number of application Events dropped because the queue was full, 0
+    pub fn event_overflow_count(&self) -> u32 {
+        0
+    }
+
+    /// Returns the number of Events merged into an Event waiting to be reported, 0
+    pub fn event_coalesced_count(&self) -> u32 {
+        0
+    }
+
+    /// Poll the state machine, there is nothing to process
+    pub fn poll<ALS: services::AlEventCnf, DL: dl::DataLinkLayerReq>(
+        &mut self,
+        _application: &mut ALS,
+        _data_link_layer: &mut DL,
+    ) -> IoLinkResult<()> {
+        Ok(())
+    }
+}
+
+impl AlEventReq for EventHandler {
+    fn al_event_req(
+        &mut self,
+        _event_count: u8,
+        _event_entries: &[EventEntry],
+    ) -> IoLinkResult<()> {
+        Err(IoLinkError::FuncNotAvailable)
+    }
+}
+
+impl dl::DlEventTriggerConf for EventHandler {
+    fn event_trigger_conf(&mut self) -> IoLinkResult<()> {
+        Err(IoLinkError::InvalidEvent)
+    }
+}
+
+impl Default for EventHandler {
+    fn default() -> Self {
+        Self::new()
+    }
+}
@@ -11,6 +11,14 @@
 //! - Provides transition execution logic for AL_Read, AL_Write, DL_ReadParam, DL_WriteParam, and ISDU transport services.
 //! - Ensures correct state transitions and error handling according to the IO-Link protocol.
 //!
+//! # Application backend
+//! ISDU requests for indices in the local parameter storage are served by the parameter
+//! manager. All other indices are indicated to the device application through
+//! [`services::ApplicationLayerServicesInd::al_read_ind`] / `al_write_ind`, which may
+//! answer later with AL_Read.rsp / AL_Write.rsp (see [`services::AlReadRsp`]). Until then
+//! the DL answers "busy" and Process Data keeps flowing. Values the application
+//! prefetched into the [`backend_cache::BackendCache`] are answered without AL_Read.
+//!
 //! # Usage
 //! The main entry point is [`OnRequestDataHandler`], which should be integrated with the device's
 //! parameter manager and data link layer. Events are processed via trait implementations, and the
@@ -29,15 +37,14 @@
 
 use iolinke_types::custom::{IoLinkError, IoLinkResult};
 use iolinke_types::handlers;
-use iolinke_types::handlers::isdu::DlIsduTransportRsp;
-use iolinke_types::handlers::od::DlParamRsp;
 
 use core::default::Default;
+use core::option::Option::Some;
 use core::result::Result::{Err, Ok};
 
 use crate::al::ApplicationLayerReadWriteInd;
 use crate::{
-    al::{parameter_manager, services},
+    al::{backend_cache, parameter_manager, services},
     dl,
 };
 
@@ -80,9 +87,15 @@ enum Transition {
     /// T7: State: AwaitAlRwRsp (3) -> Idle (0)
     /// Action: Invoke DL_ISDUTransport (read)
     T7(u16, u8, u8, [u8; handlers::isdu::MAX_ISDU_LENGTH]), // (index, sub_index, length, data)
+    /// T7 with a negative AL_Read response
+    /// Action: Invoke DL_ISDUTransport (read) with error
+    T7Error(u8, u8), // (error code, additional error code)
     /// T8: State: AwaitAlRwRsp (3) -> Idle (0)
     /// Action: Invoke DL_ISDUTransport (write)
     T8,
+    /// T8 with a negative AL_Write response
+    /// Action: Invoke DL_ISDUTransport (write) with error
+    T8Error(u8, u8), // (error code, additional error code)
     /// T9: State: AwaitAlRwRsp (3) -> Idle (0)
     /// Action: Current AL_Read or AL_Write abandoned
     /// upon this asynchronous AL_Abort service call.
@@ -105,10 +118,14 @@ enum OnRequestHandlerEvent {
     DlWriteParamInd(u8, u8), // (index, data)
     /// {AL_Write_rsp}
     AlWriteRsp,
+    /// {AL_Write_rsp} negative
+    AlWriteErrorRsp(u8, u8), // (error code, additional error code)
     /// {DL_ReadParam_ind}
     DlReadParamInd(u8), // (address)
     /// {AL_Read_rsp}
     AlReadRsp(u8, [u8; handlers::isdu::MAX_ISDU_LENGTH]), // (length, data)
+    /// {AL_Read_rsp} negative
+    AlReadErrorRsp(u8, u8), // (error code, additional error code)
     /// {DL_ISDUTransport_ind[DirRead]}
     DlIsduTransportIndDirRead(dl::IsduMessage),
     /// {DL_ISDUTransport_ind[DirWrite]}
@@ -117,12 +134,26 @@ enum OnRequestHandlerEvent {
     DlIsduAbort,
 }
 
+/// Returns the octets a poll of the handler keeps on the stack at most, see
+/// [`crate::footprint::stack_estimate`]. A T5 answered from the backend cache builds the
+/// AL_Read response, its event and the next transition while the T5 is still held.
+pub(crate) const fn stack_estimate() -> usize {
+    2 * core::mem::size_of::<Transition>()
+        + core::mem::size_of::<OnRequestHandlerEvent>()
+        + handlers::isdu::MAX_ISDU_LENGTH
+        + backend_cache::BACKEND_CACHE_DATA_LENGTH
+}
+
 /// On-request Data Handler implementation
 #[derive(Debug, Clone)]
 pub struct OnRequestDataHandler {
     state: OnRequestDataHandlerState,
     exec_transition: Transition,
     read_cycle: bool,
+    /// `true` while the current request waits for the response of the application
+    backend_request: bool,
+    /// Parameter values prefetched by the application
+    backend_cache: backend_cache::BackendCache,
 }
 
 impl OnRequestDataHandler {
@@ -132,9 +163,22 @@ impl OnRequestDataHandler {
             state: OnRequestDataHandlerState::Idle,
             exec_transition: Transition::Tn,
             read_cycle: false,
+            backend_request: false,
+            backend_cache: backend_cache::BackendCache::new(),
         }
     }
 
+    /// Stores a parameter value of the application, ISDU reads of it are answered
+    /// without AL_Read. See [`backend_cache::BackendCache::insert`].
+    pub fn al_prefetch_req(&mut self, index: u16, sub_index: u8, data: &[u8]) -> IoLinkResult<()> {
+        self.backend_cache.insert(index, sub_index, data)
+    }
+
+    /// Drops a parameter value stored by [`Self::al_prefetch_req`]
+    pub fn al_invalidate_req(&mut self, index: u16, sub_index: u8) {
+        self.backend_cache.invalidate(index, sub_index);
+    }
+
     /// Process an event
     fn process_event(&mut self, event: OnRequestHandlerEvent) -> IoLinkResult<()> {
         use OnRequestDataHandlerState as State;
@@ -155,15 +199,27 @@ impl OnRequestDataHandler {
             (State::Idle, Event::DlIsduTransportIndDirWrite(isdu)) => {
                 (Transition::T6(isdu), State::AwaitAlRwRsp)
             }
-            (State::AwaitAlWriteRsp, Event::AlWriteRsp) => (Transition::T2, State::Idle),
+            (State::AwaitAlWriteRsp, Event::AlWriteRsp | Event::AlWriteErrorRsp(..)) => {
+                (Transition::T2, State::Idle)
+            }
             (State::AwaitAlReadRsp, Event::AlReadRsp(length, data)) => {
                 (Transition::T4(length, data), State::Idle)
             }
+            (State::AwaitAlReadRsp, Event::AlReadErrorRsp(..)) => (
+                Transition::T4(0, [0; handlers::isdu::MAX_ISDU_LENGTH]),
+                State::Idle,
+            ),
             (State::AwaitAlRwRsp, Event::DlIsduAbort) => (Transition::T10, State::Idle),
             (State::AwaitAlRwRsp, Event::AlReadRsp(length, data)) => {
                 (Transition::T7(0, 0, length, data), State::Idle)
             }
+            (State::AwaitAlRwRsp, Event::AlReadErrorRsp(error, additional_error)) => {
+                (Transition::T7Error(error, additional_error), State::Idle)
+            }
             (State::AwaitAlRwRsp, Event::AlWriteRsp) => (Transition::T8, State::Idle),
+            (State::AwaitAlRwRsp, Event::AlWriteErrorRsp(error, additional_error)) => {
+                (Transition::T8Error(error, additional_error), State::Idle)
+            }
             (State::AwaitAlRwRsp, Event::AlAbort) => (Transition::T9, State::Idle),
             // Invalid transitions - no state change
             _ => return Err(IoLinkError::InvalidEvent),
@@ -174,61 +230,62 @@ impl OnRequestDataHandler {
         Ok(())
     }
 
+    /// Returns `true` while a transition is pending for the next poll
+    pub fn has_pending_transition(&self) -> bool {
+        self.exec_transition != Transition::Tn
+    }
+
     /// Poll the state machine
-    pub fn poll(
+    pub fn poll<ALS: services::ApplicationLayerServicesInd, DL: dl::DataLinkLayerReq>(
         &mut self,
         parameter_manager: &mut parameter_manager::ParameterManager,
-        data_link_layer: &mut dl::DataLinkLayer,
+        services: &mut ALS,
+        data_link_layer: &mut DL,
     ) -> IoLinkResult<()> {
-        let exec_transition = self.exec_transition.clone();
-        // Process pending transitions
+        // Process pending transitions, the transition is moved out instead of cloned as
+        // T4 and T7 carry a response payload of `MAX_ISDU_LENGTH` octets
+        let exec_transition = core::mem::replace(&mut self.exec_transition, Transition::Tn);
         match exec_transition {
             Transition::Tn => {
-                self.exec_transition = Transition::Tn;
                 // No transition, do nothing
             }
             Transition::T1(index, data) => {
-                self.exec_transition = Transition::Tn;
                 self.execute_t1(index, data, parameter_manager)?;
             }
             Transition::T2 => {
-                self.exec_transition = Transition::Tn;
                 self.execute_t2(data_link_layer)?;
             }
             Transition::T3(address) => {
-                self.exec_transition = Transition::Tn;
                 self.execute_t3(address, parameter_manager)?;
             }
             Transition::T4(_length, data) => {
-                self.exec_transition = Transition::Tn;
                 self.execute_t4(&data, data_link_layer)?;
             }
             Transition::T5(isdu) => {
-                self.exec_transition = Transition::Tn;
-                self.execute_t5(isdu, parameter_manager)?;
+                self.execute_t5(isdu, parameter_manager, services)?;
             }
             Transition::T6(isdu) => {
-                self.exec_transition = Transition::Tn;
-                self.execute_t6(isdu, parameter_manager)?;
+                self.execute_t6(isdu, parameter_manager, services)?;
             }
             Transition::T7(index, _sub_index, length, data) => {
-                self.exec_transition = Transition::Tn;
                 self.execute_t7(index, length, &data, data_link_layer)?;
             }
+            Transition::T7Error(error, additional_error) => {
+                self.execute_t7_error(error, additional_error, data_link_layer)?;
+            }
             Transition::T8 => {
-                self.exec_transition = Transition::Tn;
                 self.execute_t8(data_link_layer)?;
             }
+            Transition::T8Error(error, additional_error) => {
+                self.execute_t8_error(error, additional_error, data_link_layer)?;
+            }
             Transition::T9 => {
-                self.exec_transition = Transition::Tn;
                 self.execute_t9(data_link_layer)?;
             }
             Transition::T10 => {
-                self.exec_transition = Transition::Tn;
-                self.execute_t10()?; // Current waiting on AL_Read or AL_Write abandoned
+                self.execute_t10(services)?; // Current waiting on AL_Read or AL_Write abandoned
             }
             Transition::T11 => {
-                self.exec_transition = Transition::Tn;
                 self.execute_t11()?; // Current DL_ISDUTransport abandoned. All OD are set to "0"
             }
         }
@@ -249,7 +306,10 @@ impl OnRequestDataHandler {
     }
 
     /// Execute transition T2: Invoke DL_WriteParam (16 to 31)
-    fn execute_t2(&mut self, data_link_layer: &mut dl::DataLinkLayer) -> IoLinkResult<()> {
+    fn execute_t2<DL: dl::DataLinkLayerReq>(
+        &mut self,
+        data_link_layer: &mut DL,
+    ) -> IoLinkResult<()> {
         // TODO: Invoke DL_WriteParam (16 to 31)?
         data_link_layer.dl_write_param_rsp()?;
         Ok(())
@@ -270,10 +330,10 @@ impl OnRequestDataHandler {
     }
 
     /// Execute transition T4: Invoke DL_ReadParam (0 to 31)
-    fn execute_t4(
+    fn execute_t4<DL: dl::DataLinkLayerReq>(
         &mut self,
         data: &[u8; handlers::isdu::MAX_ISDU_LENGTH],
-        data_link_layer: &mut dl::DataLinkLayer,
+        data_link_layer: &mut DL,
     ) -> IoLinkResult<()> {
         // TODO: Invoke DL_ReadParam (0 to 31)
         data_link_layer.dl_read_param_rsp(1, data[0])?;
@@ -281,51 +341,111 @@ impl OnRequestDataHandler {
     }
 
     /// Execute transition T5: Invoke AL_Read
-    fn execute_t5(
+    ///
+    /// Local parameters are read from the parameter manager, prefetched values are
+    /// answered at once, all other indices are indicated to the application.
+    fn execute_t5<ALS: services::ApplicationLayerServicesInd>(
         &mut self,
         isdu: dl::IsduMessage,
         parameter_manager: &mut parameter_manager::ParameterManager,
+        services: &mut ALS,
     ) -> IoLinkResult<()> {
+        use services::AlReadRsp;
+
         self.read_cycle = true;
-        // TODO: Invoke AL_Read
-        parameter_manager.al_read_ind(isdu.index, isdu.sub_index)?;
+        if parameter_manager.is_local_index(isdu.index) {
+            return parameter_manager.al_read_ind(isdu.index, isdu.sub_index);
+        }
+        if let Some(cached) = self.backend_cache.get(isdu.index, isdu.sub_index) {
+            let mut data = [0; backend_cache::BACKEND_CACHE_DATA_LENGTH];
+            let length = cached.len();
+            data[..length].copy_from_slice(cached);
+            return self.al_read_rsp(Ok((length as u8, &data[..length])));
+        }
+        if services.al_read_ind(isdu.index, isdu.sub_index).is_err() {
+            // The application has no backend for this index
+            return self.al_read_rsp(Err(services::AlRspError::NoData));
+        }
+        self.backend_request = true;
         Ok(())
     }
 
     /// Execute transition T6: Invoke AL_Write
-    fn execute_t6(
+    ///
+    /// Local parameters are written to the parameter manager, all other indices are
+    /// indicated to the application.
+    fn execute_t6<ALS: services::ApplicationLayerServicesInd>(
         &mut self,
         isdu: dl::IsduMessage,
         parameter_manager: &mut parameter_manager::ParameterManager,
+        services: &mut ALS,
     ) -> IoLinkResult<()> {
+        use services::AlWriteRsp;
+
         self.read_cycle = false;
-        // TODO: Invoke AL_Write
-        parameter_manager.al_write_ind(isdu.index, isdu.sub_index, &isdu.data)?;
+        if parameter_manager.is_local_index(isdu.index) {
+            return parameter_manager.al_write_ind(isdu.index, isdu.sub_index, &isdu.data);
+        }
+        self.backend_cache.invalidate(isdu.index, isdu.sub_index);
+        if services
+            .al_write_ind(isdu.index, isdu.sub_index, &isdu.data)
+            .is_err()
+        {
+            // The application has no backend for this index
+            return self.al_write_rsp(Err(services::AlRspError::NoData));
+        }
+        self.backend_request = true;
         Ok(())
     }
 
     /// Execute transition T7: Invoke DL_ISDUTransport (read)
-    fn execute_t7(
+    fn execute_t7<DL: dl::DataLinkLayerReq>(
         &mut self,
         _index: u16,
         length: u8,
         data: &[u8; handlers::isdu::MAX_ISDU_LENGTH],
-        data_link_layer: &mut dl::DataLinkLayer,
+        data_link_layer: &mut DL,
     ) -> IoLinkResult<()> {
         // TODO: Invoke DL_ISDUTransport (read)
         data_link_layer.dl_isdu_transport_read_rsp(length, data)?;
         Ok(())
     }
 
+    /// Execute transition T7 with a negative AL_Read response
+    fn execute_t7_error<DL: dl::DataLinkLayerReq>(
+        &mut self,
+        error: u8,
+        additional_error: u8,
+        data_link_layer: &mut DL,
+    ) -> IoLinkResult<()> {
+        data_link_layer.dl_isdu_transport_read_error_rsp(error, additional_error)
+    }
+
     /// Execute transition T8: Invoke DL_ISDUTransport (write)
-    fn execute_t8(&mut self, data_link_layer: &mut dl::DataLinkLayer) -> IoLinkResult<()> {
+    fn execute_t8<DL: dl::DataLinkLayerReq>(
+        &mut self,
+        data_link_layer: &mut DL,
+    ) -> IoLinkResult<()> {
         // TODO: Invoke DL_ISDUTransport (write)
         data_link_layer.dl_isdu_transport_write_rsp()?;
         Ok(())
     }
 
+    /// Execute transition T8 with a negative AL_Write response
+    fn execute_t8_error<DL: dl::DataLinkLayerReq>(
+        &mut self,
+        error: u8,
+        additional_error: u8,
+        data_link_layer: &mut DL,
+    ) -> IoLinkResult<()> {
+        data_link_layer.dl_isdu_transport_write_error_rsp(error, additional_error)
+    }
+
     /// Execute transition T9: Handle abort scenarios
-    fn execute_t9(&mut self, data_link_layer: &mut dl::DataLinkLayer) -> IoLinkResult<()> {
+    fn execute_t9<DL: dl::DataLinkLayerReq>(
+        &mut self,
+        data_link_layer: &mut DL,
+    ) -> IoLinkResult<()> {
         // TODO: Current AL_Read or AL_Write abandoned upon AL_Abort service call
         const ABORT_APP_ERROR_CODE: (u8, u8) = iolinke_macros::isdu_error_code!(APP_DEV);
         if self.read_cycle {
@@ -341,8 +461,17 @@ impl OnRequestDataHandler {
     }
 
     /// Execute transition T10: Handle abort scenarios
-    fn execute_t10(&mut self) -> IoLinkResult<()> {
-        // TODO: Current waiting on AL_Read or AL_Write abandoned
+    ///
+    /// A request pending in the application is aborted with AL_Abort, a late
+    /// response of the application is dropped in state Idle.
+    fn execute_t10<ALS: services::ApplicationLayerServicesInd>(
+        &mut self,
+        services: &mut ALS,
+    ) -> IoLinkResult<()> {
+        if self.backend_request {
+            self.backend_request = false;
+            let _ = services.al_abort_ind();
+        }
         Ok(())
     }
 
@@ -393,30 +522,52 @@ impl dl::DlIsduTransportInd for OnRequestDataHandler {
     }
 }
 
+/// Returns the ISDU error code pair of a negative AL response
+fn al_rsp_error_code(error: services::AlRspError) -> (u8, u8) {
+    match error {
+        services::AlRspError::Error(error, additional_error) => (error, additional_error),
+        services::AlRspError::StateConflict => iolinke_macros::isdu_error_code!(SERV_NOTAVAIL),
+        services::AlRspError::NoData => iolinke_macros::isdu_error_code!(IDX_NOTAVAIL),
+    }
+}
+
 impl services::AlReadRsp for OnRequestDataHandler {
     fn al_read_rsp(&mut self, result: services::AlResult<(u8, &[u8])>) -> IoLinkResult<()> {
         // Handle AL_Read response
-        let (length, data) = result.map_err(|_| IoLinkError::InvalidData)?;
-        let mut data_array = [0; handlers::isdu::MAX_ISDU_LENGTH];
-        data_array[..length as usize].copy_from_slice(data);
-        self.process_event(OnRequestHandlerEvent::AlReadRsp(length, data_array))?;
-        Ok(())
+        self.backend_request = false;
+        let event = match result {
+            Ok((length, data)) => {
+                let data = data
+                    .get(..length as usize)
+                    .ok_or(IoLinkError::InvalidLength)?;
+                let mut data_array = [0; handlers::isdu::MAX_ISDU_LENGTH];
+                data_array
+                    .get_mut(..data.len())
+                    .ok_or(IoLinkError::InvalidLength)?
+                    .copy_from_slice(data);
+                OnRequestHandlerEvent::AlReadRsp(length, data_array)
+            }
+            Err(error) => {
+                let (error, additional_error) = al_rsp_error_code(error);
+                OnRequestHandlerEvent::AlReadErrorRsp(error, additional_error)
+            }
+        };
+        self.process_event(event)
     }
 }
 
 impl services::AlWriteRsp for OnRequestDataHandler {
     fn al_write_rsp(&mut self, result: services::AlResult<()>) -> IoLinkResult<()> {
         // Handle AL_Write response
-        match result {
-            Ok(_) => {
-                self.process_event(OnRequestHandlerEvent::AlWriteRsp)?;
-            }
-            Err(_) => {
-                return Err(IoLinkError::InvalidData);
+        self.backend_request = false;
+        let event = match result {
+            Ok(()) => OnRequestHandlerEvent::AlWriteRsp,
+            Err(error) => {
+                let (error, additional_error) = al_rsp_error_code(error);
+                OnRequestHandlerEvent::AlWriteErrorRsp(error, additional_error)
             }
-        }
-        self.process_event(OnRequestHandlerEvent::AlWriteRsp)?;
-        Ok(())
+        };
+        self.process_event(event)
     }
 }
 
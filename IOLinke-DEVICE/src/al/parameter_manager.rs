@@ -13,6 +13,8 @@ use iolinke_types::handlers::pm::ValidityCheckResult;
 use iolinke_types::handlers::pm::{
     DataStorageIndexSubIndex, DeviceParametersIndex, DsState, StateProperty, SubIndex,
 };
+#[cfg(feature = "trace")]
+use iolinke_util::trace::TraceModule;
 use iolinke_util::{log_state_transition, log_state_transition_error};
 
 use core::convert::TryFrom;
@@ -178,6 +180,7 @@ enum Transition {
 /// On request Data Handler states
 /// See Figure 86 – The Parameter Manager (PM) state machine
 #[derive(Debug, Clone, Copy, PartialEq, Eq)]
+#[cfg_attr(feature = "trace", derive(iolinke_macros::TraceId))]
 pub enum ParameterManagerState {
     /// {Idle_0}
     Idle,
@@ -190,6 +193,7 @@ pub enum ParameterManagerState {
 }
 
 #[derive(Debug, Clone, Copy, PartialEq, Eq)]
+#[cfg_attr(feature = "trace", derive(iolinke_macros::TraceId))]
 pub enum ParameterManagerEvent {
     /// {[Single Parameter]}
     SingleParameter,
@@ -218,6 +222,11 @@ pub enum ParameterManagerEvent {
     /// {[SysCmdReset]}
     SysCmdReset,
 }
+
+/// Names of the states and events of the state machine, see [`crate::trace`]
+#[cfg(feature = "trace")]
+pub(crate) const TRACE_MODULE: TraceModule =
+    TraceModule::new::<ParameterManagerState, ParameterManagerEvent>(module_path!());
 /// Process Data Handler implementation
 pub struct ParameterManager {
     state: ParameterManagerState,
@@ -351,6 +360,11 @@ impl ParameterManager {
         Ok(())
     }
 
+    /// Returns `true` while a transition is pending for the next poll
+    pub fn has_pending_transition(&self) -> bool {
+        self.exec_transition != Transition::Tn
+    }
+
     /// Poll the process data handler
     /// See IO-Link v1.1.4 Section 7.2
     pub fn poll(
@@ -563,6 +577,15 @@ impl ParameterManager {
         Ok(())
     }
 
+    /// Discards the state of the current Block Parameterization
+    ///
+    /// Parameters are written through to the parameter storage, there is no separate
+    /// buffer of the download. Only the validity of the transferred set is discarded,
+    /// the stored values and their Data Storage dirty bits are kept.
+    fn discard_parameter_buffer(&mut self) {
+        self.data_valid = ValidityCheckResult::YetToBeValidated;
+    }
+
     /// Executes transition T1: Idle -> ValidityCheck on [Single Parameter]
     ///
     /// Action: -
@@ -600,8 +623,11 @@ impl ParameterManager {
     ) -> IoLinkResult<()> {
         // Mark parameter set as valid
         self.data_valid = ValidityCheckResult::Valid;
-        // Invoke DS_ParUpload.req to DS.
-        data_storage.ds_par_upload_ind()?;
+        // Invoke DS_ParUpload.req to DS, unless the Data Storage parameter set is unchanged
+        // since the last upload or download and the Master already holds it
+        if self.param_storage.is_data_storage_dirty() {
+            data_storage.ds_par_upload_ind()?;
+        }
         // Send positive acknowledge of transmission
         od_handler.al_write_rsp(Ok(()))?;
         // Reset StoreRequest flag to false.
@@ -635,9 +661,8 @@ impl ParameterManager {
         od_handler.al_write_rsp(Err(services::AlRspError::Error(0x81, 0xFF)))?; // TODO: Check if this is the correct error code
         // Reset StoreRequest flag to false.
         self.store_request = false;
-        // Discard parameter buffer
-        self.data_valid = ValidityCheckResult::YetToBeValidated;
-        self.param_storage.clear();
+        // Discard parameter buffer.
+        self.discard_parameter_buffer();
         Ok(())
     }
 
@@ -656,9 +681,8 @@ impl ParameterManager {
     pub fn execute_t8(&mut self) -> IoLinkResult<()> {
         // Unlock local parameter access.
         self.local_parameter_access = LockState::Unlocked;
-        self.data_valid = ValidityCheckResult::YetToBeValidated;
         // Discard parameter buffer.
-        self.param_storage.clear();
+        self.discard_parameter_buffer();
         Ok(())
     }
 
@@ -668,9 +692,8 @@ impl ParameterManager {
     pub fn execute_t9(&mut self) -> IoLinkResult<()> {
         // Unlock local parameter access.
         self.local_parameter_access = LockState::Unlocked;
-        self.data_valid = ValidityCheckResult::YetToBeValidated;
         // Discard parameter buffer.
-        self.param_storage.clear();
+        self.discard_parameter_buffer();
         Ok(())
     }
 
@@ -699,9 +722,8 @@ impl ParameterManager {
     pub fn execute_t12(&mut self) -> IoLinkResult<()> {
         // Unlock local parameter access.
         self.local_parameter_access = LockState::Unlocked;
-        self.data_valid = ValidityCheckResult::YetToBeValidated;
         // Discard parameter buffer.
-        self.param_storage.clear();
+        self.discard_parameter_buffer();
         Ok(())
     }
 
@@ -738,9 +760,8 @@ impl ParameterManager {
     ///
     /// Action: Discard parameter buffer, so that a possible second start will not be blocked
     pub fn execute_t16(&mut self) -> IoLinkResult<()> {
-        self.data_valid = ValidityCheckResult::YetToBeValidated;
         // Discard parameter buffer.
-        self.param_storage.clear();
+        self.discard_parameter_buffer();
         Ok(())
     }
 
@@ -759,9 +780,8 @@ impl ParameterManager {
     ///
     /// Action: Discard parameter buffer, so that a possible second start will not be blocked
     pub fn execute_t18(&mut self) -> IoLinkResult<()> {
-        self.data_valid = ValidityCheckResult::YetToBeValidated;
         // Discard parameter buffer.
-        self.param_storage.clear();
+        self.discard_parameter_buffer();
         Ok(())
     }
 
@@ -803,8 +823,7 @@ impl ParameterManager {
         // Unlock local parameter access.
         self.local_parameter_access = LockState::Unlocked;
         // Discard parameter buffer.
-        self.data_valid = ValidityCheckResult::YetToBeValidated;
-        self.param_storage.clear();
+        self.discard_parameter_buffer();
         Ok(())
     }
 
@@ -927,6 +946,23 @@ impl ParameterManager {
         Ok(())
     }
 
+    /// Marks the Data Storage parameter set as exchanged with the Master, called when a
+    /// Data Storage upload or download ended
+    pub fn clear_data_storage_changes(&mut self) {
+        self.param_storage.clear_dirty();
+    }
+
+    /// Returns the local parameter storage, e.g. to save and restore it in non-volatile memory
+    pub fn param_storage_mut(&mut self) -> &mut ParameterStorage {
+        &mut self.param_storage
+    }
+
+    /// Returns `true` if `index` is held in the local parameter storage, all other
+    /// indices are served by the device application
+    pub fn is_local_index(&self, index: u16) -> bool {
+        self.param_storage.contains_index(index)
+    }
+
     pub fn lock_local_parameter_access(&mut self) -> IoLinkResult<()> {
         self.local_parameter_access = LockState::Locked;
         Ok(())
@@ -5,17 +5,81 @@
 
 use crate::{al::services, dl};
 use heapless::Vec;
+use iolinke_derived_config::device::output_indication;
 use iolinke_types::custom::IoLinkResult;
-use iolinke_types::handlers::pd::DlPDInputUpdate;
+use iolinke_types::handlers::command::DlControlCode;
 
+use core::clone::Clone;
 use core::default::Default;
+use core::iter::Iterator;
+use core::option::{
+    Option,
+    Option::{None, Some},
+};
 use core::result::Result::Ok;
 
-pub struct ProcessDataHandler {}
+/// Filtering of AL_NewOutput and AL_PDCycle, see `IODevice.OutputIndication` in
+/// `device_config.toon`
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub struct OutputIndication {
+    /// AL_NewOutput only for output Process Data which differs from the last indicated
+    pub on_change: bool,
+    /// Received output Process Data between two AL_NewOutput, 0 disables the throttling
+    pub min_interval_cycles: u32,
+    /// The DL_PDCycle indications between two Application Layer polls raise one
+    /// AL_PDCycle. Only has an effect with the `split_layers` feature, an `IoLinkDevice`
+    /// polls its Application Layer right after every DL_PDCycle.
+    pub coalesce_pd_cycle: bool,
+}
+
+impl OutputIndication {
+    /// Returns the filtering configured in `device_config.toon`
+    pub const fn configured() -> Self {
+        Self {
+            on_change: output_indication::on_change(),
+            min_interval_cycles: output_indication::min_interval_cycles(),
+            coalesce_pd_cycle: output_indication::coalesce_pd_cycle(),
+        }
+    }
+
+    /// Returns `true` if AL_NewOutput is filtered
+    const fn filters_output(&self) -> bool {
+        self.on_change || self.min_interval_cycles > 0
+    }
+}
+
+impl Default for OutputIndication {
+    fn default() -> Self {
+        Self::configured()
+    }
+}
+
+pub struct ProcessDataHandler {
+    output_indication: OutputIndication,
+    /// Output Process Data of the last AL_NewOutput, `None` until the first one and
+    /// after a PDOUTVALID / PDOUTINVALID indication
+    indicated_output: Option<Vec<u8, { dl::PD_OUTPUT_LENGTH }>>,
+    /// Output Process Data received since the last AL_NewOutput
+    outputs_since_indication: u32,
+    /// A coalesced DL_PDCycle waits to be indicated by the next poll
+    pd_cycle_pending: bool,
+}
 
 impl ProcessDataHandler {
     pub fn new() -> Self {
-        Self {}
+        Self {
+            output_indication: OutputIndication::configured(),
+            indicated_output: None,
+            outputs_since_indication: 0,
+            pd_cycle_pending: false,
+        }
+    }
+
+    /// Replaces the filtering, the next output Process Data is indicated
+    pub fn set_output_indication(&mut self, output_indication: OutputIndication) {
+        self.output_indication = output_indication;
+        self.indicated_output = None;
+        self.outputs_since_indication = 0;
     }
 
     pub fn dl_pd_output_transport_ind<
@@ -25,14 +89,39 @@ impl ProcessDataHandler {
         pd_out: &Vec<u8, { dl::PD_OUTPUT_LENGTH }>,
         services: &mut ALS,
     ) -> IoLinkResult<()> {
+        if self.output_indication.filters_output() {
+            self.outputs_since_indication = self.outputs_since_indication.saturating_add(1);
+            if let Some(indicated_output) = &self.indicated_output {
+                let unchanged =
+                    self.output_indication.on_change && indicated_output[..] == pd_out[..];
+                let throttled =
+                    self.outputs_since_indication < self.output_indication.min_interval_cycles;
+                if unchanged || throttled {
+                    return Ok(());
+                }
+            }
+            self.indicated_output = Some(pd_out.clone());
+            self.outputs_since_indication = 0;
+        }
         services.al_new_output_ind(pd_out)
     }
 
-    fn dl_pd_input_update_req(
+    /// A change of the output Process Data validity is indicated with the next output
+    /// Process Data, regardless of the filter
+    pub fn dl_control_ind(&mut self, control_code: DlControlCode) {
+        if matches!(
+            control_code,
+            DlControlCode::PDOUTVALID | DlControlCode::PDOUTINVALID
+        ) {
+            self.indicated_output = None;
+        }
+    }
+
+    fn dl_pd_input_update_req<DL: dl::DataLinkLayerReq>(
         &mut self,
         length: u8,
         input_data: &[u8],
-        data_link_layer: &mut dl::DataLinkLayer,
+        data_link_layer: &mut DL,
     ) -> IoLinkResult<()> {
         data_link_layer.dl_pd_input_update_req(length, input_data)
     }
@@ -41,16 +130,37 @@ impl ProcessDataHandler {
         &mut self,
         services: &mut ALS,
     ) -> IoLinkResult<()> {
+        if self.output_indication.coalesce_pd_cycle {
+            self.pd_cycle_pending = true;
+            return Ok(());
+        }
         services.al_pd_cycle_ind();
         Ok(())
     }
+
+    /// Indicates the coalesced DL_PDCycle indications with one AL_PDCycle
+    pub fn poll<ALS: services::ApplicationLayerServicesInd + services::AlEventCnf>(
+        &mut self,
+        services: &mut ALS,
+    ) -> IoLinkResult<()> {
+        if self.pd_cycle_pending {
+            self.pd_cycle_pending = false;
+            services.al_pd_cycle_ind();
+        }
+        Ok(())
+    }
+
+    /// Returns `true` while a coalesced AL_PDCycle waits for the next poll
+    pub fn has_pending_transition(&self) -> bool {
+        self.pd_cycle_pending
+    }
 }
 
 impl services::AlSetInputReq for ProcessDataHandler {
-    fn al_set_input_req(
+    fn al_set_input_req<DL: dl::DataLinkLayerReq>(
         &mut self,
         pd_data: &[u8],
-        data_link_layer: &mut dl::DataLinkLayer,
+        data_link_layer: &mut DL,
     ) -> IoLinkResult<()> {
         self.dl_pd_input_update_req(pd_data.len() as u8, pd_data, data_link_layer)
     }
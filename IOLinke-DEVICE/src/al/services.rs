@@ -16,7 +16,9 @@ pub trait ApplicationLayerServicesInd {
     /// Handles read requests from the master for device parameters.
     ///
     /// This method is called when the master requests to read a parameter
-    /// from the device's object dictionary.
+    /// which is not held in the local parameter storage of the device.
+    /// The application completes the request later with `IoLinkDevice::al_read_rsp`,
+    /// until then the master is answered "busy" and Process Data keeps flowing.
     ///
     /// # Parameters
     ///
@@ -25,14 +27,17 @@ pub trait ApplicationLayerServicesInd {
     ///
     /// # Returns
     ///
-    /// - `Ok(())` if read request was processed successfully
-    /// - `Err(IoLinkError)` if an error occurred
+    /// - `Ok(())` if the read request was accepted, a response follows
+    /// - `Err(IoLinkError)` if the application has no such parameter, the master is
+    ///   answered "index not available"
     fn al_read_ind(&mut self, index: u16, sub_index: u8) -> IoLinkResult<()>;
 
     /// Handles write requests from the master for device parameters.
     ///
     /// This method is called when the master requests to write a parameter
-    /// to the device's object dictionary.
+    /// which is not held in the local parameter storage of the device.
+    /// The application completes the request later with `IoLinkDevice::al_write_rsp`.
+    /// `data` is only valid during the call.
     ///
     /// # Parameters
     ///
@@ -42,14 +47,15 @@ pub trait ApplicationLayerServicesInd {
     ///
     /// # Returns
     ///
-    /// - `Ok(())` if write request was processed successfully
-    /// - `Err(IoLinkError)` if an error occurred
+    /// - `Ok(())` if the write request was accepted, a response follows
+    /// - `Err(IoLinkError)` if the application has no such parameter, the master is
+    ///   answered "index not available"
     fn al_write_ind(&mut self, index: u16, sub_index: u8, data: &[u8]) -> IoLinkResult<()>;
 
     /// Handles an abort request from the master.
     ///
-    /// This method is called when the master aborts an ongoing
-    /// read or write operation.
+    /// This method is called when the master aborts a read or write operation
+    /// indicated through `al_read_ind` or `al_write_ind` before it was answered.
     ///
     /// # Returns
     ///
@@ -164,10 +170,14 @@ pub enum AlRspError {
 }
 pub type AlResult<T> = Result<T, AlRspError>;
 
+/// AL_Read response of the device application
 pub trait AlReadRsp {
+    /// Completes an AL_Read with `(length, data)` or a negative response
     fn al_read_rsp(&mut self, result: AlResult<(u8, &[u8])>) -> IoLinkResult<()>;
 }
+/// AL_Write response of the device application
 pub trait AlWriteRsp {
+    /// Completes an AL_Write with a positive or negative response
     fn al_write_rsp(&mut self, result: AlResult<()>) -> IoLinkResult<()>;
 }
 
@@ -217,10 +227,10 @@ pub trait AlControlReq {
 }
 
 pub trait AlSetInputReq {
-    fn al_set_input_req(
+    fn al_set_input_req<DL: dl::DataLinkLayerReq>(
         &mut self,
         pd_data: &[u8],
-        data_link_layer: &mut dl::DataLinkLayer,
+        data_link_layer: &mut DL,
     ) -> IoLinkResult<()>;
 }
 
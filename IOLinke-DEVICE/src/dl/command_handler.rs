@@ -3,19 +3,17 @@
 //! This module implements the Command Handler state machine as defined in
 //! IO-Link Specification v1.1.4
 
-use iolinke_types::handlers::command::{DlControlInd, DlControlReq, MasterCommandInd};
+use iolinke_types::handlers::command::{DlControlReq, MasterCommandInd};
 use iolinke_types::{
     custom::{IoLinkError, IoLinkResult},
     handlers,
     page::page1,
 };
+#[cfg(feature = "trace")]
+use iolinke_util::trace::TraceModule;
 use iolinke_util::{log_state_transition, log_state_transition_error};
 
-use crate::services;
-use crate::{
-    al,
-    dl::{message_handler, mode_handler},
-};
+use crate::dl::{ApplicationLayerInd, message_handler, mode_handler};
 
 use core::convert::TryInto;
 use core::default::Default;
@@ -23,6 +21,7 @@ use core::result::Result::{Err, Ok};
 
 /// See 7.3.7.3 State machine of the Device command handler
 #[derive(Debug, Clone, Copy, PartialEq, Eq)]
+#[cfg_attr(feature = "trace", derive(iolinke_macros::TraceId))]
 enum CommandHandlerState {
     ///{Inactive_0} Waiting on activation
     Inactive,
@@ -69,6 +68,7 @@ enum Transition {
 
 /// See Table 57 – State transition tables of the Device command handler
 #[derive(Debug, Clone, Copy, PartialEq, Eq)]
+#[cfg_attr(feature = "trace", derive(iolinke_macros::TraceId))]
 pub enum CommandHandlerEvent {
     /// {CH_Conf_ACTIVE} See Table 57, Triggers T1
     ChConfActive,
@@ -84,6 +84,11 @@ pub enum CommandHandlerEvent {
     ChConfInactive,
 }
 
+/// Names of the states and events of the state machine, see [`crate::trace`]
+#[cfg(feature = "trace")]
+pub(crate) const TRACE_MODULE: TraceModule =
+    TraceModule::new::<CommandHandlerState, CommandHandlerEvent>(module_path!());
+
 /// Command Handler implementation
 pub struct CommandHandler {
     /// Current state of the Command Handler
@@ -136,15 +141,16 @@ impl CommandHandler {
         Ok(())
     }
 
+    /// Returns `true` while a transition is pending for the next poll
+    pub fn has_pending_transition(&self) -> bool {
+        self.exec_transition != Transition::Tn
+    }
+
     /// Poll the handler
-    pub fn poll<
-        ALS: services::ApplicationLayerServicesInd
-            + handlers::sm::SystemManagementCnf
-            + services::AlEventCnf,
-    >(
+    pub fn poll<AL: ApplicationLayerInd>(
         &mut self,
         message_handler: &mut message_handler::MessageHandler,
-        application_layer: &mut al::ApplicationLayer<ALS>,
+        application_layer: &mut AL,
         mode_handler: &mut mode_handler::DlModeHandler,
     ) -> IoLinkResult<()> {
         // Process pending events
@@ -187,14 +193,10 @@ impl CommandHandler {
     }
 
     /// Execute transition T2: Idle -> Idle (PDOUT commands)
-    fn execute_t2<
-        ALS: services::ApplicationLayerServicesInd
-            + handlers::sm::SystemManagementCnf
-            + services::AlEventCnf,
-    >(
+    fn execute_t2<AL: ApplicationLayerInd>(
         &mut self,
         master_command: page1::MasterCommand,
-        application_layer: &mut al::ApplicationLayer<ALS>,
+        application_layer: &mut AL,
         mode_handler: &mut mode_handler::DlModeHandler,
     ) -> IoLinkResult<()> {
         use handlers::command::DlControlCode;
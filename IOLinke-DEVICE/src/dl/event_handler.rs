@@ -7,6 +7,8 @@ use iolinke_types::{
     custom::{IoLinkError, IoLinkResult},
     handlers,
 };
+#[cfg(feature = "trace")]
+use iolinke_util::trace::TraceModule;
 use iolinke_util::{log_state_transition, log_state_transition_error};
 
 use core::default::Default;
@@ -16,6 +18,7 @@ use crate::{dl::message_handler, storage};
 
 /// See Table 60 – State transition tables of the Device Event handler
 #[derive(Debug, Clone, Copy, PartialEq, Eq)]
+#[cfg_attr(feature = "trace", derive(iolinke_macros::TraceId))]
 enum EventHandlerState {
     /// - Inactive_0: Waiting on activation
     Inactive,
@@ -63,6 +66,7 @@ enum Transition {
 
 /// Figure 56 – State machine of the Device Event handler
 #[derive(Debug, Clone, Copy, PartialEq, Eq)]
+#[cfg_attr(feature = "trace", derive(iolinke_macros::TraceId))]
 enum EventHandlerEvent {
     /// {EH_Conf_ACTIVE} See Table 60, Tiggers T1
     EhConfActive,
@@ -78,6 +82,11 @@ enum EventHandlerEvent {
     EhConfInactive,
 }
 
+/// Names of the states and events of the state machine, see [`crate::trace`]
+#[cfg(feature = "trace")]
+pub(crate) const TRACE_MODULE: TraceModule =
+    TraceModule::new::<EventHandlerState, EventHandlerEvent>(module_path!());
+
 /// Event Handler implementation
 pub struct EventHandler {
     /// Current state of the Event Handler
@@ -136,10 +145,16 @@ impl EventHandler {
         Ok(())
     }
 
+    /// Returns `true` while a transition is pending for the next poll
+    pub fn has_pending_transition(&self) -> bool {
+        self.exec_transition != Transition::Tn
+    }
+
     /// Poll the handler
-    pub fn poll(
+    pub fn poll<AL: handlers::event::DlEventTriggerConf>(
         &mut self,
         message_handler: &mut message_handler::MessageHandler,
+        application_layer: &mut AL,
     ) -> IoLinkResult<()> {
         // Process pending events
         match self.exec_transition {
@@ -164,7 +179,7 @@ impl EventHandler {
             }
             Transition::T5 => {
                 self.exec_transition = Transition::Tn;
-                let _ = self.execute_t5(message_handler);
+                let _ = self.execute_t5(message_handler, application_layer);
             }
             Transition::T6(address_ctrl, data_length) => {
                 self.exec_transition = Transition::Tn;
@@ -227,13 +242,19 @@ impl EventHandler {
 
     /// Execute T5 transition: FreezeEventMemory (2) -> Idle (1)
     /// Action: Invoke service EventFlag.req (Flag = FALSE) to indicate Event deactivation to the Master via the "Event flag" bit. Mark all Event slots in memory as invalid according to A.6.3.
-    fn execute_t5(
+    fn execute_t5<AL: handlers::event::DlEventTriggerConf>(
         &mut self,
         message_handler: &mut message_handler::MessageHandler,
+        application_layer: &mut AL,
     ) -> IoLinkResult<()> {
         message_handler.event_flag(false);
         self.event_memory.set_read_only(false);
         self.event_memory.clear_all_event()?;
+        self.active_event_count = 0;
+        // Acknowledge the write of the StatusCode
+        let _ = message_handler.od_rsp(0, &[]);
+        // The activated Events are processed, see 7.2.1.17 DL_EventTrigger
+        application_layer.event_trigger_conf()?;
         Ok(())
     }
 
@@ -262,6 +283,7 @@ impl EventHandler {
     fn execute_t8(&mut self) -> IoLinkResult<()> {
         self.event_memory.set_read_only(false);
         self.event_memory.clear_all_event()?;
+        self.active_event_count = 0;
         Ok(())
     }
 
@@ -295,6 +317,18 @@ impl EventHandler {
         Ok(())
     }
 
+    /// DL_Event with one event entry in the wire format of the Event memory, see
+    /// [`storage::event_memory::EventMemory::add_event_entry`]
+    pub fn dl_event_entry_req(
+        &mut self,
+        entry: &[u8; storage::event_memory::EVENT_ENTRY_SIZE],
+    ) -> IoLinkResult<()> {
+        self.event_memory.add_event_entry(entry)?;
+        self.active_event_count = self.active_event_count.saturating_add(1);
+        let _ = self.process_event(EventHandlerEvent::DlEvent);
+        Ok(())
+    }
+
     /// See 7.2.1.17 DL_EventTrigger
     /// The DL_EventTrigger request starts the Event signaling (see Event flag in Figure A.3) and
     /// freezes the Event memory within the DL. The confirmation is returned after the activated
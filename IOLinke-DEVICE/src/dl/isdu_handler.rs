@@ -5,26 +5,27 @@
 use heapless::Vec;
 use iolinke_derived_config::device as derived_config;
 use iolinke_types::frame::isdu::IsduFlowCtrl;
-use iolinke_types::handlers::isdu::DlIsduAbort;
-use iolinke_types::handlers::isdu::DlIsduTransportInd;
 use iolinke_types::handlers::isdu::MAX_ISDU_LENGTH;
 use iolinke_types::{
     custom::{IoLinkError, IoLinkResult},
     handlers,
 };
+use iolinke_util::frame_fromat::isdu::IsduSegmentEncoder;
 use iolinke_util::frame_fromat::isdu::RxIsduMessageBuffer;
-use iolinke_util::frame_fromat::isdu::TxIsduMessageBuffer;
+use iolinke_util::frame_fromat::isdu::{ISDU_BUSY_RESPONSE, ISDU_NO_SERVICE_RESPONSE};
+#[cfg(feature = "trace")]
+use iolinke_util::trace::TraceModule;
 use iolinke_util::{log_state_transition, log_state_transition_error};
 
 use core::default::Default;
 use core::option::Option::Some;
 use core::result::Result::{Err, Ok};
 
-use crate::services;
-use crate::{al, dl::message_handler};
+use crate::dl::{ApplicationLayerInd, message_handler};
 
 /// See 7.3.6.4 State machine of the Device ISDU handler
 #[derive(Debug, Clone, Copy, PartialEq, Eq)]
+#[cfg_attr(feature = "trace", derive(iolinke_macros::TraceId))]
 enum IsduHandlerState {
     /// {Inactive_0}
     Inactive,
@@ -95,6 +96,7 @@ enum Transition {
 
 /// See Figure 52 – State machine of the Device ISDU handler
 #[derive(Debug, Clone, Copy, PartialEq, Eq)]
+#[cfg_attr(feature = "trace", derive(iolinke_macros::TraceId))]
 enum IsduHandlerEvent {
     /// {ISDURead}
     IsduRead(u8, u8), // (Segment number , Number of bytes) to read
@@ -118,9 +120,19 @@ enum IsduHandlerEvent {
     IsduRespStart(u8, u8), // (Segment number, Number of bytes)
 }
 
+/// Names of the states and events of the state machine, see [`crate::trace`]
+#[cfg(feature = "trace")]
+pub(crate) const TRACE_MODULE: TraceModule =
+    TraceModule::new::<IsduHandlerState, IsduHandlerEvent>(module_path!());
+
+/// ISDU buffering of the handler
+///
+/// The request is received into `rx_buffer`. Once it is handed to the AL (T4) the
+/// buffer is free, so it keeps the data octets of the read response. `encoder` produces
+/// the response segments from it on demand, the complete response is never built.
 #[derive(Clone, Debug, PartialEq, Eq)]
 struct MessageBuffer {
-    tx_buffer: TxIsduMessageBuffer,
+    encoder: IsduSegmentEncoder,
     rx_buffer: RxIsduMessageBuffer,
 }
 
@@ -140,7 +152,7 @@ impl IsduHandler {
             state: IsduHandlerState::Inactive,
             exec_transition: Transition::Tn,
             message_buffer: MessageBuffer {
-                tx_buffer: TxIsduMessageBuffer::new(),
+                encoder: IsduSegmentEncoder::new(),
                 rx_buffer: RxIsduMessageBuffer::new(),
             },
             expected_segment: 0,
@@ -189,16 +201,17 @@ impl IsduHandler {
 
         Ok(())
     }
+    /// Returns `true` while a transition is pending for the next poll
+    pub fn has_pending_transition(&self) -> bool {
+        self.exec_transition != Transition::Tn
+    }
+
     /// Poll the ISDU handler
     /// See IO-Link v1.1.4 Section 8.4.3
-    pub fn poll<
-        ALS: services::ApplicationLayerServicesInd
-            + handlers::sm::SystemManagementCnf
-            + services::AlEventCnf,
-    >(
+    pub fn poll<AL: ApplicationLayerInd>(
         &mut self,
         message_handler: &mut message_handler::MessageHandler,
-        application_layer: &mut al::ApplicationLayer<ALS>,
+        application_layer: &mut AL,
     ) -> IoLinkResult<()> {
         match self.exec_transition {
             Transition::Tn => {
@@ -292,7 +305,7 @@ impl IsduHandler {
     /// Action: -
     fn execute_t1(&mut self) -> IoLinkResult<()> {
         self.expected_segment = 0;
-        self.message_buffer.tx_buffer.clear();
+        self.message_buffer.encoder.clear();
         Ok(())
     }
 
@@ -303,7 +316,7 @@ impl IsduHandler {
         message_handler: &mut message_handler::MessageHandler,
     ) -> IoLinkResult<()> {
         self.expected_segment = 0;
-        self.message_buffer.tx_buffer.clear();
+        self.message_buffer.encoder.clear();
         // Hanled in od_ind function
         let _ = message_handler.od_rsp(0, &[]);
         Ok(())
@@ -322,13 +335,9 @@ impl IsduHandler {
 
     /// Execute transition T4: ISDURequest (2) -> ISDUWait (3)
     /// Action: Invoke DL_ISDUTransport.ind to AL (see 7.2.1.6)
-    fn execute_t4<
-        ALS: services::ApplicationLayerServicesInd
-            + handlers::sm::SystemManagementCnf
-            + services::AlEventCnf,
-    >(
+    fn execute_t4<AL: ApplicationLayerInd>(
         &mut self,
-        application_layer: &mut al::ApplicationLayer<ALS>,
+        application_layer: &mut AL,
         message_handler: &mut message_handler::MessageHandler,
     ) -> IoLinkResult<()> {
         use iolinke_types::frame::isdu::IsduIServiceCode;
@@ -336,9 +345,7 @@ impl IsduHandler {
         use iolinke_types::handlers::isdu::IsduMessage;
 
         self.expected_segment = 0;
-        self.message_buffer.tx_buffer.compile_isdu_busy_response();
-        let isdu_busy = self.message_buffer.tx_buffer.get_as_slice();
-        let _ = message_handler.od_rsp(isdu_busy.len() as u8, &isdu_busy);
+        let _ = message_handler.od_rsp(ISDU_BUSY_RESPONSE.len() as u8, &ISDU_BUSY_RESPONSE);
         // self.invoke_dl_isdu_transport_ind(od_ind_data)
         let (i_service, index, sub_index, isdu_data) =
             match &self.message_buffer.rx_buffer.extract_isdu_data() {
@@ -379,9 +386,7 @@ impl IsduHandler {
         &mut self,
         message_handler: &mut message_handler::MessageHandler,
     ) -> IoLinkResult<()> {
-        self.message_buffer.tx_buffer.compile_isdu_busy_response();
-        let isdu_busy = self.message_buffer.tx_buffer.get_as_slice();
-        message_handler.od_rsp(isdu_busy.len() as u8, &isdu_busy)
+        message_handler.od_rsp(ISDU_BUSY_RESPONSE.len() as u8, &ISDU_BUSY_RESPONSE)
     }
 
     /// Execute transition T6: ISDUWait (3) -> ISDUResponse (4)
@@ -410,34 +415,27 @@ impl IsduHandler {
             return Err(IoLinkError::InvalidIndex);
         }
         const MAX_POSSIBLE_OD_SIZE: u8 = derived_config::on_req_data::max_possible_od_length();
-        // Extract ISDU response segment from self.message_buffer.tx_buffer
+        if data_length > MAX_POSSIBLE_OD_SIZE {
+            return Err(IoLinkError::InvalidLength);
+        }
+        // Produce the ISDU response segment, past the end of the response it is padded with zeros
         let from = (data_length as usize) * (self.expected_segment as usize);
-        let to = from + (data_length as usize);
-        let buffer_len = self.message_buffer.tx_buffer.len();
         self.expected_segment += 1; // Next expected segment number
 
-        // If 'to' exceeds buffer length, pad with zeros
-        let isdu_response = if from < buffer_len {
-            if to > buffer_len {
-                // Not enough data, pad with zeros
-                let mut segment_data: Vec<u8, { MAX_POSSIBLE_OD_SIZE as usize }> =
-                    Vec::from_slice(&self.message_buffer.tx_buffer[from..buffer_len])
-                        .map_err(|_| IoLinkError::InvalidLength)?;
-                segment_data
-                    .resize(data_length as usize, 0)
-                    .map_err(|_| IoLinkError::InvalidLength)?;
-                segment_data
-            } else {
-                Vec::from_slice(&self.message_buffer.tx_buffer[from..to])
-                    .map_err(|_| IoLinkError::InvalidLength)?
-            }
-        } else {
+        let mut segment_data = [0u8; MAX_POSSIBLE_OD_SIZE as usize];
+        let isdu_response = &mut segment_data[..data_length as usize];
+        let message_buffer = &mut self.message_buffer;
+        if message_buffer
+            .encoder
+            .encode_segment(message_buffer.rx_buffer.get_as_slice(), from, isdu_response)
+            .is_err()
+        {
             // No data left, this should not happen, So create ISDUerror event
             self.process_event(IsduHandlerEvent::IsduError)?;
             return Err(IoLinkError::InvalidEvent);
-        };
+        }
 
-        let _ = message_handler.od_rsp(isdu_response.len() as u8, &isdu_response);
+        let _ = message_handler.od_rsp(isdu_response.len() as u8, isdu_response);
 
         Ok(())
     }
@@ -449,11 +447,11 @@ impl IsduHandler {
         message_handler: &mut message_handler::MessageHandler,
     ) -> IoLinkResult<()> {
         self.expected_segment = 0;
-        self.message_buffer
-            .tx_buffer
-            .compile_isdu_no_service_response();
-        let isdu_no_service = self.message_buffer.tx_buffer.get_as_slice();
-        message_handler.od_rsp(isdu_no_service.len() as u8, &isdu_no_service)?;
+        self.message_buffer.encoder.clear();
+        message_handler.od_rsp(
+            ISDU_NO_SERVICE_RESPONSE.len() as u8,
+            &ISDU_NO_SERVICE_RESPONSE,
+        )?;
         Ok(())
     }
 
@@ -461,37 +459,29 @@ impl IsduHandler {
     /// Action: -
     fn execute_t9(&mut self) -> IoLinkResult<()> {
         self.expected_segment = 0;
-        self.message_buffer.tx_buffer.clear();
+        self.message_buffer.encoder.clear();
         Ok(())
     }
 
     /// Execute transition T10: ISDUWait (3) -> Idle (1)
     /// Action: Invoke DL_ISDUAbort
-    fn execute_t10<
-        ALS: services::ApplicationLayerServicesInd
-            + handlers::sm::SystemManagementCnf
-            + services::AlEventCnf,
-    >(
+    fn execute_t10<AL: ApplicationLayerInd>(
         &mut self,
-        application_layer: &mut al::ApplicationLayer<ALS>,
+        application_layer: &mut AL,
     ) -> IoLinkResult<()> {
         self.expected_segment = 0;
-        self.message_buffer.tx_buffer.clear();
+        self.message_buffer.encoder.clear();
         application_layer.dl_isdu_abort()
     }
 
     /// Execute transition T11: ISDUResponse (4) -> Idle (1)
     /// Action: Invoke DL_ISDUAbort
-    fn execute_t11<
-        ALS: services::ApplicationLayerServicesInd
-            + handlers::sm::SystemManagementCnf
-            + services::AlEventCnf,
-    >(
+    fn execute_t11<AL: ApplicationLayerInd>(
         &mut self,
-        application_layer: &mut al::ApplicationLayer<ALS>,
+        application_layer: &mut AL,
     ) -> IoLinkResult<()> {
         self.expected_segment = 0;
-        self.message_buffer.tx_buffer.clear();
+        self.message_buffer.encoder.clear();
         application_layer.dl_isdu_abort()
     }
 
@@ -503,16 +493,12 @@ impl IsduHandler {
 
     /// Execute transition T13: ISDURequest (2) -> Idle (1)
     /// Action: Invoke DL_ISDUAbort
-    fn execute_t13<
-        ALS: services::ApplicationLayerServicesInd
-            + handlers::sm::SystemManagementCnf
-            + services::AlEventCnf,
-    >(
+    fn execute_t13<AL: ApplicationLayerInd>(
         &mut self,
-        application_layer: &mut al::ApplicationLayer<ALS>,
+        application_layer: &mut AL,
     ) -> IoLinkResult<()> {
         self.expected_segment = 0;
-        self.message_buffer.tx_buffer.clear();
+        self.message_buffer.encoder.clear();
         application_layer.dl_isdu_abort()
     }
 
@@ -522,58 +508,46 @@ impl IsduHandler {
         &mut self,
         message_handler: &mut message_handler::MessageHandler,
     ) -> IoLinkResult<()> {
-        self.message_buffer
-            .tx_buffer
-            .compile_isdu_no_service_response();
-        let isdu_no_service = self.message_buffer.tx_buffer.get_as_slice();
-        message_handler.od_rsp(isdu_no_service.len() as u8, &isdu_no_service)
+        message_handler.od_rsp(
+            ISDU_NO_SERVICE_RESPONSE.len() as u8,
+            &ISDU_NO_SERVICE_RESPONSE,
+        )
     }
 
     /// Execute transition T15: ISDUWait (3) -> Idle (1)
     /// Action: Invoke DL_ISDUAbort
-    fn execute_t15<
-        ALS: services::ApplicationLayerServicesInd
-            + handlers::sm::SystemManagementCnf
-            + services::AlEventCnf,
-    >(
+    fn execute_t15<AL: ApplicationLayerInd>(
         &mut self,
-        application_layer: &mut al::ApplicationLayer<ALS>,
+        application_layer: &mut AL,
     ) -> IoLinkResult<()> {
         self.expected_segment = 0;
-        self.message_buffer.tx_buffer.clear();
+        self.message_buffer.encoder.clear();
         application_layer.dl_isdu_abort()
     }
 
     /// Execute transition T16: ISDUResponse (4) -> Idle (1)
     /// Action: Invoke DL_ISDUAbort
-    fn execute_t16<
-        ALS: services::ApplicationLayerServicesInd
-            + handlers::sm::SystemManagementCnf
-            + services::AlEventCnf,
-    >(
+    fn execute_t16<AL: ApplicationLayerInd>(
         &mut self,
-        application_layer: &mut al::ApplicationLayer<ALS>,
+        application_layer: &mut AL,
     ) -> IoLinkResult<()> {
         self.expected_segment = 0;
-        self.message_buffer.tx_buffer.clear();
+        self.message_buffer.encoder.clear();
         application_layer.dl_isdu_abort()
     }
 
     pub fn dl_isdu_transport_read_rsp(&mut self, length: u8, data: &[u8]) -> IoLinkResult<()> {
-        self.message_buffer.tx_buffer.clear();
-        let _ = self
-            .message_buffer
-            .tx_buffer
-            .compile_isdu_read_success_response(length, data);
-
-        Ok(())
+        let data = data.get(..length as usize).ok_or(IoLinkError::InvalidLength)?;
+        // The request is already handed to the AL, its buffer keeps the response data
+        self.message_buffer.rx_buffer.clear();
+        self.message_buffer.rx_buffer.extend(data);
+        self.message_buffer
+            .encoder
+            .start_read_success_response(length)
     }
 
     pub fn dl_isdu_transport_write_rsp(&mut self) -> IoLinkResult<()> {
-        let _ = self
-            .message_buffer
-            .tx_buffer
-            .compile_isdu_write_success_response();
+        self.message_buffer.encoder.start_write_success_response();
         Ok(())
     }
 
@@ -582,10 +556,9 @@ impl IsduHandler {
         error: u8,
         additional_error: u8,
     ) -> IoLinkResult<()> {
-        let _ = self
-            .message_buffer
-            .tx_buffer
-            .compile_isdu_read_failure_response(error, additional_error);
+        self.message_buffer
+            .encoder
+            .start_read_failure_response(error, additional_error);
         Ok(())
     }
 
@@ -594,10 +567,9 @@ impl IsduHandler {
         error: u8,
         additional_error: u8,
     ) -> IoLinkResult<()> {
-        let _ = self
-            .message_buffer
-            .tx_buffer
-            .compile_isdu_write_failure_response(error, additional_error);
+        self.message_buffer
+            .encoder
+            .start_write_failure_response(error, additional_error);
         Ok(())
     }
 
@@ -631,10 +603,13 @@ impl handlers::od::OdInd for IsduHandler {
             // ISDUWrite: OD.ind(W, ISDU, FlowCtrl, Data)
             (Write, IsduFlowCtrl::Count(0x00..=0x0F)) => {
                 let isdu_data = &od_ind_data.data;
-                if isdu_data.len() + self.message_buffer.rx_buffer.len() > 238 {
-                    return Err(IoLinkError::InvalidLength);
+                // Outside of ISDURequest the buffer may hold the response data
+                if self.state == IsduHandlerState::ISDURequest {
+                    if isdu_data.len() + self.message_buffer.rx_buffer.len() > 238 {
+                        return Err(IoLinkError::InvalidLength);
+                    }
+                    self.message_buffer.rx_buffer.extend(isdu_data);
                 }
-                self.message_buffer.rx_buffer.extend(isdu_data);
                 return self.process_event(IsduHandlerEvent::IsduWrite);
             }
 
@@ -657,7 +632,7 @@ impl handlers::od::OdInd for IsduHandler {
                 if self.state == IsduHandlerState::ISDURequest {
                     return self.process_event(IsduHandlerEvent::IsduRecComplete);
                 } else if self.state == IsduHandlerState::ISDUWait {
-                    if self.message_buffer.tx_buffer.is_ready() {
+                    if self.message_buffer.encoder.is_ready() {
                         return self.process_event(IsduHandlerEvent::IsduRespStart(
                             0,
                             od_ind_data.req_length,
@@ -13,9 +13,11 @@ use iolinke_types::{
         od::OdInd,
     },
 };
+#[cfg(feature = "trace")]
+use iolinke_util::trace::TraceModule;
 use iolinke_util::{
     frame_fromat::message::{
-        DeviceOperationMode, MAX_RX_FRAME_SIZE, MAX_TX_FRAME_SIZE, MessageBufferError,
+        DeviceOperationMode, FrameCodec, MAX_RX_FRAME_SIZE, MAX_TX_FRAME_SIZE, MessageBufferError,
         RxMessageBuffer, TxMessageBuffer, calculate_max_uart_frame_time,
     },
     log_state_transition, log_state_transition_error,
@@ -34,6 +36,7 @@ use crate::{
 };
 /// Message Handler states
 #[derive(Clone, Copy, Debug, PartialEq, Eq)]
+#[cfg_attr(feature = "trace", derive(iolinke_macros::TraceId))]
 enum MessageHandlerState {
     /// Waiting for activation by the Device DL-mode handler through MH_Conf_ACTIVE
     /// (see Table 45, Transition T1).
@@ -85,6 +88,7 @@ enum Transition {
 
 /// Message Handler events
 #[derive(Debug, Clone, Copy, PartialEq, Eq)]
+#[cfg_attr(feature = "trace", derive(iolinke_macros::TraceId))]
 enum MessageHandlerEvent {
     /// Table 47 – T1
     MhConfActive,
@@ -109,19 +113,56 @@ enum MessageHandlerEvent {
     TimerMaxUARTFrame,
 }
 
-#[derive(Debug, Clone)]
+/// Names of the states and events of the state machine, see [`crate::trace`]
+#[cfg(feature = "trace")]
+pub(crate) const TRACE_MODULE: TraceModule =
+    TraceModule::new::<MessageHandlerState, MessageHandlerEvent>(module_path!());
+
+/// Frame codec of the message handler buffers
+type Codec = FrameCodec<{ MAX_RX_FRAME_SIZE }, { MAX_TX_FRAME_SIZE }>;
+
+/// Number of TX buffers. With `non_blocking_tx` the Physical Layer sends a response
+/// straight from one buffer while the next response is compiled in the other.
+const TX_BUFFER_COUNT: usize = if cfg!(feature = "non_blocking_tx") {
+    2
+} else {
+    1
+};
+
+#[derive(Debug)]
 struct Buffers {
     rx_buffer: RxMessageBuffer<{ MAX_RX_FRAME_SIZE }>,
-    tx_buffer: TxMessageBuffer<{ MAX_TX_FRAME_SIZE }>,
+    tx_buffers: [TxMessageBuffer<{ MAX_TX_FRAME_SIZE }>; TX_BUFFER_COUNT],
+    /// TX buffer the next response is compiled in
+    tx_index: usize,
+    /// `true` from PL_Transfer.req until PL_Transfer.cnf, the other TX buffer is lent
+    /// to the Physical Layer meanwhile
+    tx_in_flight: bool,
+}
+
+impl Buffers {
+    /// TX buffer the next response is compiled in
+    fn tx_buffer(&self) -> &TxMessageBuffer<{ MAX_TX_FRAME_SIZE }> {
+        &self.tx_buffers[self.tx_index]
+    }
+
+    /// TX buffer the next response is compiled in
+    fn tx_buffer_mut(&mut self) -> &mut TxMessageBuffer<{ MAX_TX_FRAME_SIZE }> {
+        &mut self.tx_buffers[self.tx_index]
+    }
 }
 
 /// Message Handler implementation
-#[derive(Debug, Clone)]
+///
+/// Not `Clone`, a copy would duplicate both frame buffers.
+#[derive(Debug)]
 pub struct MessageHandler {
     state: MessageHandlerState,
     exec_transition: Transition,
     buffers: Buffers,
-    device_operate_state: DeviceOperationMode,
+    /// Codec of the current device operation mode, selected by DL_Mode, receives the
+    /// next Master message
+    codec: &'static Codec,
     pd_in_valid_status: PdStatus,
 
     transmission_rate: TransmissionRate,
@@ -129,7 +170,11 @@ pub struct MessageHandler {
 
     event_flag: bool,
     pd_status: PdStatus,
-    rx_frame_operation_state: DeviceOperationMode,
+    /// Codec of the mode the last Master message was received in, it is validated and
+    /// its response is compiled in the same mode
+    rx_frame_codec: &'static Codec,
+    /// Number of valid Master messages, the time base of the Event rate limit
+    master_cycle_count: u32,
 }
 
 impl MessageHandler {
@@ -140,15 +185,18 @@ impl MessageHandler {
             exec_transition: Transition::Tn,
             buffers: Buffers {
                 rx_buffer: RxMessageBuffer::new(),
-                tx_buffer: TxMessageBuffer::new(),
+                tx_buffers: core::array::from_fn(|_| TxMessageBuffer::new()),
+                tx_index: 0,
+                tx_in_flight: false,
             },
-            device_operate_state: DeviceOperationMode::Startup,
+            codec: Codec::of(DeviceOperationMode::Startup),
             pd_in_valid_status: PdStatus::INVALID,
             transmission_rate: TransmissionRate::default(),
             expected_rx_bytes: 0, // 0 means not set
             event_flag: false,
             pd_status: PdStatus::INVALID,
-            rx_frame_operation_state: DeviceOperationMode::Startup,
+            rx_frame_codec: Codec::of(DeviceOperationMode::Startup),
+            master_cycle_count: 0,
         }
     }
 
@@ -200,6 +248,25 @@ impl MessageHandler {
         Ok(())
     }
 
+    /// Returns `true` while a transition is pending for the next poll.
+    ///
+    /// A received message waiting in {CheckMessage} and a compiled response waiting in
+    /// {CreateMessage} are pending as well. The response is completed by OD.rsp / PD.rsp
+    /// of handlers polled after the message handler, it is sent by the next poll.
+    pub fn has_pending_transition(&self) -> bool {
+        match self.state {
+            _ if self.exec_transition != Transition::Tn => true,
+            MessageHandlerState::CheckMessage => true,
+            MessageHandlerState::CreateMessage(_) => self.is_response_ready(),
+            _ => false,
+        }
+    }
+
+    /// Returns `true` if the response is compiled and the previous one is sent
+    fn is_response_ready(&self) -> bool {
+        !self.buffers.tx_in_flight && self.rx_frame_codec.is_ready(self.buffers.tx_buffer())
+    }
+
     /// Poll the message handler
     /// See IO-Link v1.1.4 Section 6.3
     pub fn poll<PHY: pl::physical_layer::PhysicalLayerReq>(
@@ -273,12 +340,8 @@ impl MessageHandler {
                 self.execute_check_message()?;
             }
             MessageHandlerState::CreateMessage(rw_req_dir) => {
-                // Check the response is ready to be sent
-                if self
-                    .buffers
-                    .tx_buffer
-                    .is_ready(self.rx_frame_operation_state)
-                {
+                // Check the response is ready to be sent and the previous one is sent
+                if self.is_response_ready() {
                     let _ = self.execute_create_message(rw_req_dir);
                     self.process_event(MessageHandlerEvent::Ready)?;
                 }
@@ -328,14 +391,66 @@ impl MessageHandler {
         let rx_buffer_len = self.buffers.rx_buffer.len();
         // Find the number of UART frames to be received using first two bytes of the message
         if rx_buffer_len == 2 {
-            self.expected_rx_bytes = self
-                .buffers
-                .rx_buffer
-                .calculate_expected_rx_bytes(self.device_operate_state);
+            self.expected_rx_bytes = self.codec.expected_rx_bytes(&self.buffers.rx_buffer);
         }
         if self.expected_rx_bytes == rx_buffer_len as u8 {
-            self.rx_frame_operation_state = self.device_operate_state;
-            let _ = self.process_event(MessageHandlerEvent::Completed);
+            self.complete_rx_message(physical_layer)?;
+        }
+        Ok(())
+    }
+
+    /// Transition T3 for a span of received bytes: GetMessage -> GetMessage
+    /// Same as `execute_t3` for every byte of the span, but the bytes are copied as a whole
+    /// and timer "MaxUARTframeTime" is restarted once for the last byte of the span.
+    /// Bytes following the end of the Master message are not part of the message and dropped.
+    fn execute_t3_burst<PHY: pl::physical_layer::PhysicalLayerReq>(
+        &mut self,
+        physical_layer: &PHY,
+        rx_bytes: &[u8],
+    ) -> IoLinkResult<()> {
+        let mut rx_bytes = rx_bytes;
+        // Find the number of UART frames to be received using first two bytes of the message
+        let rx_buffer_len = self.buffers.rx_buffer.len();
+        if rx_buffer_len < 2 {
+            let (header, rest) = rx_bytes.split_at((2 - rx_buffer_len).min(rx_bytes.len()));
+            let _ = self.buffers.rx_buffer.push_slice(header);
+            if self.buffers.rx_buffer.len() == 2 {
+                self.expected_rx_bytes = self.codec.expected_rx_bytes(&self.buffers.rx_buffer);
+            }
+            rx_bytes = rest;
+        }
+        let rx_buffer_len = self.buffers.rx_buffer.len();
+        let expected_rx_bytes = self.expected_rx_bytes as usize;
+        if expected_rx_bytes > rx_buffer_len {
+            let missing_rx_bytes = (expected_rx_bytes - rx_buffer_len).min(rx_bytes.len());
+            rx_bytes = &rx_bytes[..missing_rx_bytes];
+        }
+        let _ = self.buffers.rx_buffer.push_slice(rx_bytes);
+        let max_uart_frame_time = calculate_max_uart_frame_time(self.transmission_rate);
+        let _ = physical_layer
+            .pl_restart_timer_req(handlers::pl::Timer::MaxUARTframeTime, max_uart_frame_time);
+        if self.expected_rx_bytes == self.buffers.rx_buffer.len() as u8 {
+            self.complete_rx_message(physical_layer)?;
+        }
+        Ok(())
+    }
+
+    /// All UART frames of the Master message are received, {Completed}
+    fn complete_rx_message<PHY: pl::physical_layer::PhysicalLayerReq>(
+        &mut self,
+        physical_layer: &PHY,
+    ) -> IoLinkResult<()> {
+        let _ = physical_layer;
+        self.rx_frame_codec = self.codec;
+        let _ = self.process_event(MessageHandlerEvent::Completed);
+        // The checksum was accumulated byte by byte in the rx buffer, so T4 and
+        // the {CheckMessage} state are handled right here instead of waiting for
+        // the next poll. T5 is then executed through 'poll_received_message'.
+        #[cfg(feature = "inline_rx_validation")]
+        {
+            self.exec_transition = Transition::Tn;
+            self.execute_t4(physical_layer)?;
+            let _ = self.execute_check_message();
         }
         Ok(())
     }
@@ -344,7 +459,7 @@ impl MessageHandler {
     /// Reset timer "MaxUARTframeTime"
     fn execute_t4<PHY: pl::physical_layer::PhysicalLayerReq>(
         &mut self,
-        physical_layer: &mut PHY,
+        physical_layer: &PHY,
     ) -> IoLinkResult<()> {
         physical_layer.pl_stop_timer_req(handlers::pl::Timer::MaxUARTframeTime)?;
         Ok(())
@@ -357,15 +472,14 @@ impl MessageHandler {
         od_handler: &mut od_handler::OnRequestDataHandler,
         pd_handler: &mut pd_handler::ProcessDataHandler,
     ) -> IoLinkResult<()> {
-        if self.device_operate_state == DeviceOperationMode::Operate {
+        self.master_cycle_count = self.master_cycle_count.wrapping_add(1);
+        // The message and its response are in the mode it was received in, even if
+        // DL_Mode changed since
+        if self.rx_frame_codec.mode() == DeviceOperationMode::Operate {
             let pd_out_data = match self.buffers.rx_buffer.extract_pd() {
                 Ok(pd_out_data) => pd_out_data,
                 Err(_) => &[],
             };
-            let pd_out_data = match Vec::from_slice(pd_out_data) {
-                Ok(pd_out_data) => pd_out_data,
-                Err(_) => Vec::new(),
-            };
             const PD_OUT_LENGTH: u8 =
                 derived_config::process_data::pd_out::config_length_in_bytes() as u8;
             const PD_IN_LENGTH: u8 =
@@ -375,15 +489,9 @@ impl MessageHandler {
             if pd_out_len != PD_OUT_LENGTH {
                 return Err(IoLinkError::InvalidLength);
             }
-            let _ = pd_handler.pd_ind(0, PD_IN_LENGTH, 0, &pd_out_data);
+            let _ = pd_handler.pd_ind(0, PD_IN_LENGTH, 0, pd_out_data);
         }
-        let od_data_len = match self.rx_frame_operation_state {
-            DeviceOperationMode::Startup => 1,
-            DeviceOperationMode::PreOperate => {
-                derived_config::on_req_data::pre_operate::od_length() as u8
-            }
-            DeviceOperationMode::Operate => derived_config::on_req_data::operate::od_length() as u8,
-        };
+        let od_data_len = self.rx_frame_codec.od_length();
         let mc = self
             .buffers
             .rx_buffer
@@ -393,9 +501,8 @@ impl MessageHandler {
         let channel = mc.comm_channel();
         let addr_ctrl = mc.address_fctrl();
         let od_data = match self
-            .buffers
-            .rx_buffer
-            .extract_od_from_write_req(self.rx_frame_operation_state)
+            .rx_frame_codec
+            .extract_od_from_write_req(&self.buffers.rx_buffer)
         {
             Ok(od_data) => od_data,
             Err(_) => &[],
@@ -412,7 +519,6 @@ impl MessageHandler {
             data: od_data,
         };
         let _ = od_handler.od_ind(&od_ind_data);
-        self.rx_frame_operation_state = self.device_operate_state;
         Ok(())
     }
 
@@ -423,8 +529,13 @@ impl MessageHandler {
         physical_layer: &mut PHY,
     ) -> IoLinkResult<()> {
         // Compiled and send response via PL_Transfer.rsp (handled externally)
-        physical_layer.pl_transfer_req(self.buffers.tx_buffer.get_as_slice())?;
-        self.buffers.tx_buffer.clear();
+        physical_layer.pl_transfer_req(self.buffers.tx_buffer().get_as_slice())?;
+        if TX_BUFFER_COUNT > 1 {
+            // The buffer stays lent to the Physical Layer until PL_Transfer.cnf
+            self.buffers.tx_in_flight = true;
+            self.buffers.tx_index = (self.buffers.tx_index + 1) % TX_BUFFER_COUNT;
+        }
+        self.buffers.tx_buffer_mut().clear();
 
         Ok(())
     }
@@ -473,8 +584,8 @@ impl MessageHandler {
 
     /// State {CreateMessage}
     fn execute_create_message(&mut self, rw_req_dir: RwDirection) -> Result<(), IoLinkError> {
-        self.buffers.tx_buffer.compile_message_rsp(
-            self.rx_frame_operation_state,
+        self.rx_frame_codec.compile_message_rsp(
+            self.buffers.tx_buffer_mut(),
             rw_req_dir,
             self.event_flag,
             self.pd_status,
@@ -505,6 +616,34 @@ impl MessageHandler {
         Ok(())
     }
 
+    /// Executes transition T5 right after a Master message is received and validated
+    /// in 'pl_transfer_ind', so the OD.ind and PD.ind service indications are invoked
+    /// in the same call as the last received byte.
+    #[cfg(feature = "inline_rx_validation")]
+    pub fn poll_received_message(
+        &mut self,
+        od_handler: &mut od_handler::OnRequestDataHandler,
+        pd_handler: &mut pd_handler::ProcessDataHandler,
+    ) -> IoLinkResult<()> {
+        if self.exec_transition == Transition::T5 {
+            self.exec_transition = Transition::Tn;
+            self.execute_t5(od_handler, pd_handler)?;
+        }
+        Ok(())
+    }
+
+    /// PL_Transfer.cnf, the Physical Layer sent the response handed to it with
+    /// PL_Transfer.req and releases its TX buffer
+    #[cfg(feature = "non_blocking_tx")]
+    pub fn pl_transfer_cnf(&mut self) {
+        self.buffers.tx_in_flight = false;
+    }
+
+    /// Returns the number of valid Master messages received, wraps around
+    pub fn master_cycle_count(&self) -> u32 {
+        self.master_cycle_count
+    }
+
     /// This call causes the message handler to send a message with the
     /// requested transmission rate of COMx and with M-sequence TYPE_0 (see Table 46).
     pub fn mh_conf_update(&mut self, mh_conf: MhConfState) {
@@ -529,12 +668,11 @@ impl MessageHandler {
     /// turn, the confirmation of the service contains the data from the receiver. The parameters of
     /// the service primitives are listed in Table 35.
     pub fn od_rsp(&mut self, length: u8, data: &[u8]) -> IoLinkResult<()> {
-        self.buffers
-            .tx_buffer
+        self.rx_frame_codec
             .insert_od(
+                self.buffers.tx_buffer_mut(),
                 length as usize,
                 &data[..length as usize],
-                self.rx_frame_operation_state,
             )
             .map_err(|_| IoLinkError::InvalidParameter)?;
         Ok(())
@@ -546,9 +684,8 @@ impl MessageHandler {
     /// The parameters of the service primitives are listed in Table 36.
     pub fn pd_rsp(&mut self, length: usize, data: &[u8]) -> IoLinkResult<()> {
         self.pd_status = self.pd_in_valid_status;
-        self.buffers
-            .tx_buffer
-            .insert_pd(&data[..length as usize], self.rx_frame_operation_state)
+        self.rx_frame_codec
+            .insert_pd(self.buffers.tx_buffer_mut(), &data[..length as usize])
             .map_err(|_| IoLinkError::InvalidParameter)?;
         Ok(())
     }
@@ -563,7 +700,7 @@ impl MessageHandler {
     /// Parse IO-Link message from buffer
     /// See IO-Link v1.1.4 Section 6.1
     fn parse_message(&mut self) -> IoLinkResult<RwDirection> {
-        match self.buffers.rx_buffer.valid_req(self.device_operate_state) {
+        match self.rx_frame_codec.valid_req(&mut self.buffers.rx_buffer) {
             Ok(rw_req_dir) => Ok(rw_req_dir),
             Err(e) => match e {
                 MessageBufferError::InvalidChecksum => {
@@ -585,7 +722,7 @@ impl<PHY: pl::physical_layer::PhysicalLayerReq> pl::physical_layer::PhysicalLaye
 {
     fn pl_transfer_ind(&mut self, physical_layer: &PHY, rx_byte: u8) -> IoLinkResult<()> {
         use MessageHandlerState as State;
-        let current_state = self.state.clone();
+        let current_state = self.state;
         let event = MessageHandlerEvent::PlTransfer;
         let _ = self.process_event(event);
         match current_state {
@@ -602,6 +739,31 @@ impl<PHY: pl::physical_layer::PhysicalLayerReq> pl::physical_layer::PhysicalLaye
         }
         Ok(())
     }
+
+    /// Handles a span of received bytes, e.g. from a DMA UART reception.
+    /// Behaves like 'pl_transfer_ind' for every byte of the span, with a single
+    /// {PL_Transfer} transition for the span.
+    fn pl_transfer_ind_burst(&mut self, physical_layer: &PHY, rx_bytes: &[u8]) -> IoLinkResult<()> {
+        use MessageHandlerState as State;
+        let Some((&first_rx_byte, rest)) = rx_bytes.split_first() else {
+            return Ok(());
+        };
+        let mut rx_bytes = rx_bytes;
+        if self.state == State::Idle {
+            let _ = self.process_event(MessageHandlerEvent::PlTransfer);
+            self.execute_t2(physical_layer, first_rx_byte)?;
+            rx_bytes = rest;
+            if rx_bytes.is_empty() {
+                return Ok(());
+            }
+        }
+        let current_state = self.state;
+        let _ = self.process_event(MessageHandlerEvent::PlTransfer);
+        if current_state == State::GetMessage {
+            self.execute_t3_burst(physical_layer, rx_bytes)?;
+        }
+        Ok(())
+    }
 }
 
 impl pl::physical_layer::IoLinkTimer for MessageHandler {
@@ -627,16 +789,16 @@ impl handlers::mode::DlModeInd for MessageHandler {
         use handlers::mode::DlMode;
         match mode {
             DlMode::Startup => {
-                self.device_operate_state = DeviceOperationMode::Startup;
+                self.codec = Codec::of(DeviceOperationMode::Startup);
             }
             DlMode::PreOperate => {
-                self.device_operate_state = DeviceOperationMode::PreOperate;
+                self.codec = Codec::of(DeviceOperationMode::PreOperate);
             }
             DlMode::Operate => {
-                self.device_operate_state = DeviceOperationMode::Operate;
+                self.codec = Codec::of(DeviceOperationMode::Operate);
             }
             DlMode::Inactive => {
-                self.device_operate_state = DeviceOperationMode::Startup;
+                self.codec = Codec::of(DeviceOperationMode::Startup);
             }
             DlMode::Com1 => {
                 self.transmission_rate = TransmissionRate::Com1;
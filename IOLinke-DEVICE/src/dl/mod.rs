@@ -20,14 +20,27 @@
 //! - Section 7.3: Device Identification and Communication
 //! - Section 7.4: Message Handling and Transmission
 //! - Annex A: Protocol Details and Timing
-use crate::{al, services};
+use crate::footprint::Component;
 use crate::{pl, system_management};
+#[cfg(feature = "profiling")]
+use crate::profiling::ProfileId;
+use crate::profiling::profile_scope;
 use iolinke_types::custom::IoLinkResult;
 use iolinke_types::frame;
 use iolinke_types::handlers;
+#[cfg(feature = "trace")]
+use iolinke_util::trace::TraceModule;
 
 mod command_handler;
+#[cfg(feature = "events")]
 mod event_handler;
+#[cfg(not(feature = "events"))]
+#[path = "no_event_handler.rs"]
+mod event_handler;
+#[cfg(feature = "isdu")]
+mod isdu_handler;
+#[cfg(not(feature = "isdu"))]
+#[path = "no_isdu_handler.rs"]
 mod isdu_handler;
 pub mod message_handler;
 mod mode_handler;
@@ -39,12 +52,63 @@ pub use handlers::event::{DlEventReq, DlEventTriggerConf};
 pub use handlers::isdu::{DlIsduAbort, DlIsduTransportInd, DlIsduTransportRsp, IsduMessage};
 pub use handlers::mode::DlModeInd;
 pub use handlers::od::{DlParamRsp, DlReadParamInd, DlWriteParamInd};
-pub use handlers::pd::{DlPDInputUpdate, DlPDOutputTransportInd, PD_OUTPUT_LENGTH};
+pub use handlers::pd::{
+    DlPDInputUpdate, DlPDOutputTransportInd, PD_INPUT_LENGTH, PD_OUTPUT_LENGTH,
+};
 use iolinke_types::handlers::command::DlControlReq;
 
 use core::default::Default;
+use core::option::Option;
 use core::result::Result::Ok;
 
+/// Services of the Application Layer indicated by the Data Link Layer and System
+/// Management.
+///
+/// Implemented by every type with the single indication traits, i.e. by
+/// `al::ApplicationLayer` when both layers run in one context and by the mailbox of the
+/// `split_layers` feature which forwards the indications to another context.
+pub trait ApplicationLayerInd:
+    DlControlInd
+    + DlEventTriggerConf
+    + DlReadParamInd
+    + DlWriteParamInd
+    + DlIsduAbort
+    + DlIsduTransportInd
+    + DlPDOutputTransportInd
+    + handlers::sm::SystemManagementInd
+    + handlers::sm::SystemManagementCnf
+{
+}
+
+impl<
+    T: DlControlInd
+        + DlEventTriggerConf
+        + DlReadParamInd
+        + DlWriteParamInd
+        + DlIsduAbort
+        + DlIsduTransportInd
+        + DlPDOutputTransportInd
+        + handlers::sm::SystemManagementInd
+        + handlers::sm::SystemManagementCnf,
+> ApplicationLayerInd for T
+{
+}
+
+/// Services of the Data Link Layer requested by the Application Layer.
+///
+/// Implemented by [`DataLinkLayer`] when both layers run in one context and by the
+/// mailbox of the `split_layers` feature which forwards the requests to another context.
+pub trait DataLinkLayerReq: DlParamRsp + DlIsduTransportRsp + DlEventReq + DlPDInputUpdate {
+    /// Returns the number of valid Master messages received, wraps around
+    fn master_cycle_count(&self) -> u32;
+
+    /// DL_Event with one event entry in the wire format of the Event memory
+    fn dl_event_entry_req(
+        &mut self,
+        entry: &[u8; crate::storage::event_memory::EVENT_ENTRY_SIZE],
+    ) -> IoLinkResult<()>;
+}
+
 /// Main Data Link Layer implementation that orchestrates all DL services.
 ///
 /// The Data Link Layer manages the complete data link functionality
@@ -97,6 +161,31 @@ pub struct DataLinkLayer {
     od_handler: od_handler::OnRequestDataHandler,
 }
 
+/// RAM of the Data Link Layer components, see [`crate::footprint`]
+pub(crate) const FOOTPRINT: [Component; 7] = [
+    Component::of::<command_handler::CommandHandler>("DL Command Handler"),
+    Component::of::<mode_handler::DlModeHandler>("DL Mode Handler"),
+    Component::of::<event_handler::EventHandler>("DL Event Handler"),
+    Component::of::<message_handler::MessageHandler>("DL Message Handler"),
+    Component::of::<pd_handler::ProcessDataHandler>("DL Process Data Handler"),
+    Component::of::<isdu_handler::IsduHandler>("DL ISDU Handler"),
+    Component::of::<od_handler::OnRequestDataHandler>("DL On-request Data Handler"),
+];
+
+/// Symbol tables of the Data Link Layer state machines, see [`crate::trace`]
+#[cfg(feature = "trace")]
+pub(crate) const TRACE_MODULES: &[TraceModule] = &[
+    command_handler::TRACE_MODULE,
+    mode_handler::TRACE_MODULE,
+    #[cfg(feature = "events")]
+    event_handler::TRACE_MODULE,
+    message_handler::TRACE_MODULE,
+    pd_handler::TRACE_MODULE,
+    #[cfg(feature = "isdu")]
+    isdu_handler::TRACE_MODULE,
+    od_handler::TRACE_MODULE,
+];
+
 impl DataLinkLayer {
     /// This function is called when the communication is successful.
     /// It will change the DL mode to the corresponding communication mode.
@@ -109,6 +198,49 @@ impl DataLinkLayer {
         let _ = self.mode_handler.successful_com(transmission_rate);
     }
 
+    /// Returns the input Process Data slot the next frames are built from after
+    /// [`DataLinkLayer::commit_pd_in_buffer`], for in place update by the application.
+    /// # Returns
+    /// * `Some(slot)` the input Process Data slot
+    /// * `None` if the slot is still in use by the message handler
+    pub fn acquire_pd_in_buffer(&mut self) -> Option<&mut [u8; PD_INPUT_LENGTH]> {
+        self.pd_handler.acquire_pd_in_buffer()
+    }
+
+    /// Publishes the input Process Data slot returned by
+    /// [`DataLinkLayer::acquire_pd_in_buffer`]
+    pub fn commit_pd_in_buffer(&mut self) -> IoLinkResult<()> {
+        self.pd_handler.commit_pd_in_buffer()
+    }
+
+    /// Returns the last received output Process Data, unchanged until
+    /// [`DataLinkLayer::release_pd_out_buffer`] is called
+    pub fn acquire_pd_out_buffer(&self) -> *const [u8; PD_OUTPUT_LENGTH] {
+        self.pd_handler.acquire_pd_out_buffer()
+    }
+
+    /// Releases the output Process Data returned by [`DataLinkLayer::acquire_pd_out_buffer`]
+    pub fn release_pd_out_buffer(&self) {
+        self.pd_handler.release_pd_out_buffer()
+    }
+
+    /// Returns the number of valid Master messages received, wraps around.
+    /// Used as time base where the device has no clock, e.g. the Event rate limit.
+    pub fn master_cycle_count(&self) -> u32 {
+        self.message_handler.master_cycle_count()
+    }
+
+    /// DL_Event with one event entry in the wire format of [`EventEntry::to_bytes`],
+    /// written straight into the Event memory. Each entry counts as one active event.
+    ///
+    /// [`EventEntry::to_bytes`]: handlers::event::EventEntry::to_bytes
+    pub fn dl_event_entry_req(
+        &mut self,
+        entry: &[u8; crate::storage::event_memory::EVENT_ENTRY_SIZE],
+    ) -> IoLinkResult<()> {
+        self.event_handler.dl_event_entry_req(entry)
+    }
+
     /// Polls all data link layer components to advance their state.
     ///
     /// This method must be called regularly to:
@@ -155,80 +287,121 @@ impl DataLinkLayer {
     ///     }
     /// }
     /// ```
-    pub fn poll<
-        PHY: pl::physical_layer::PhysicalLayerReq,
-        ALS: services::ApplicationLayerServicesInd
-            + handlers::sm::SystemManagementCnf
-            + services::AlEventCnf,
-    >(
+    pub fn poll<PHY: pl::physical_layer::PhysicalLayerReq, AL: ApplicationLayerInd>(
         &mut self,
         system_management: &mut system_management::SystemManagement,
         physical_layer: &mut PHY,
-        application_layer: &mut al::ApplicationLayer<ALS>,
+        application_layer: &mut AL,
     ) -> IoLinkResult<()> {
         // Command handler poll - handles master commands
         {
-            let _ = self.command_handler.poll(
-                &mut self.message_handler,
-                application_layer,
-                &mut self.mode_handler,
+            let _ = profile_scope!(
+                ProfileId::DlCommandHandler,
+                self.command_handler.poll(
+                    &mut self.message_handler,
+                    application_layer,
+                    &mut self.mode_handler,
+                )
             );
         }
 
         // Mode handler poll - manages protocol state machines
         {
-            let _ = self.mode_handler.poll(
-                &mut self.isdu_handler,
-                &mut self.event_handler,
-                &mut self.command_handler,
-                &mut self.od_handler,
-                &mut self.pd_handler,
-                &mut self.message_handler,
-                system_management,
+            let _ = profile_scope!(
+                ProfileId::DlModeHandler,
+                self.mode_handler.poll(
+                    &mut self.isdu_handler,
+                    &mut self.event_handler,
+                    &mut self.command_handler,
+                    &mut self.od_handler,
+                    &mut self.pd_handler,
+                    &mut self.message_handler,
+                    system_management,
+                )
             );
         }
 
         // Event handler poll - processes device events
         {
-            let _ = self.event_handler.poll(&mut self.message_handler);
+            let _ = profile_scope!(
+                ProfileId::DlEventHandler,
+                self.event_handler
+                    .poll(&mut self.message_handler, application_layer)
+            );
         }
 
         // Process data handler poll - handles real-time data exchange
         {
-            let _ = self
-                .pd_handler
-                .poll(&mut self.message_handler, application_layer);
+            let _ = profile_scope!(
+                ProfileId::DlPdHandler,
+                self.pd_handler.poll(&mut self.message_handler, application_layer)
+            );
         }
 
         // ISDU handler poll - manages service data unit communication
         {
             let isdu_handler = &mut self.isdu_handler;
-            let _ = isdu_handler.poll(&mut self.message_handler, application_layer);
+            let _ = profile_scope!(
+                ProfileId::DlIsduHandler,
+                isdu_handler.poll(&mut self.message_handler, application_layer)
+            );
         }
 
         // Message handler poll - coordinates all message operations
         {
-            let _ = self.message_handler.poll(
-                &mut self.od_handler,
-                &mut self.pd_handler,
-                &mut self.mode_handler,
-                physical_layer,
+            let _ = profile_scope!(
+                ProfileId::DlMessageHandler,
+                self.message_handler.poll(
+                    &mut self.od_handler,
+                    &mut self.pd_handler,
+                    &mut self.mode_handler,
+                    physical_layer,
+                )
             );
         }
 
         // On-request data handler poll - manages parameter operations
         {
-            let _ = self.od_handler.poll(
-                &mut self.command_handler,
-                &mut self.isdu_handler,
-                &mut self.event_handler,
-                application_layer,
-                system_management,
+            let _ = profile_scope!(
+                ProfileId::DlOdHandler,
+                self.od_handler.poll(
+                    &mut self.command_handler,
+                    &mut self.isdu_handler,
+                    &mut self.event_handler,
+                    &mut self.message_handler,
+                    application_layer,
+                    system_management,
+                )
             );
         }
 
         Ok(())
     }
+
+    /// Returns `true` if any Data Link Layer state machine has a pending transition
+    pub fn has_pending_work(&self) -> bool {
+        self.command_handler.has_pending_transition()
+            || self.mode_handler.has_pending_transition()
+            || self.event_handler.has_pending_transition()
+            || self.pd_handler.has_pending_transition()
+            || self.isdu_handler.has_pending_transition()
+            || self.message_handler.has_pending_transition()
+            || self.od_handler.has_pending_transition()
+    }
+
+    /// Indicates the expiry of a DL timer started through the Physical Layer
+    /// # Parameters
+    /// * `timer` - The timer that has elapsed
+    pub fn timer_elapsed(&mut self, timer: handlers::pl::Timer) -> IoLinkResult<()> {
+        self.mode_handler.timer_elapsed(timer);
+        pl::physical_layer::IoLinkTimer::timer_elapsed(&mut self.message_handler, timer)
+    }
+
+    /// Indicates that the Physical Layer sent the last response and released its TX buffer
+    #[cfg(feature = "non_blocking_tx")]
+    pub fn pl_transfer_cnf(&mut self) {
+        self.message_handler.pl_transfer_cnf();
+    }
 }
 
 impl handlers::od::DlParamRsp for DataLinkLayer {
@@ -408,6 +581,19 @@ impl handlers::pd::DlPDInputUpdate for DataLinkLayer {
     }
 }
 
+impl DataLinkLayerReq for DataLinkLayer {
+    fn master_cycle_count(&self) -> u32 {
+        DataLinkLayer::master_cycle_count(self)
+    }
+
+    fn dl_event_entry_req(
+        &mut self,
+        entry: &[u8; crate::storage::event_memory::EVENT_ENTRY_SIZE],
+    ) -> IoLinkResult<()> {
+        DataLinkLayer::dl_event_entry_req(self, entry)
+    }
+}
+
 impl DlModeInd for DataLinkLayer {
     fn dl_mode_ind(&mut self, mode: handlers::mode::DlMode) -> IoLinkResult<()> {
         let _ = self.message_handler.dl_mode_ind(mode);
@@ -473,6 +659,29 @@ impl<PHY: pl::physical_layer::PhysicalLayerReq> pl::physical_layer::PhysicalLaye
     /// - `Err(IoLinkError)` if an error occurred
     fn pl_transfer_ind(&mut self, physical_layer: &PHY, rx_byte: u8) -> IoLinkResult<()> {
         self.message_handler
-            .pl_transfer_ind(physical_layer, rx_byte)
+            .pl_transfer_ind(physical_layer, rx_byte)?;
+        #[cfg(feature = "inline_rx_validation")]
+        self.message_handler
+            .poll_received_message(&mut self.od_handler, &mut self.pd_handler)?;
+        Ok(())
+    }
+
+    /// Handles a span of bytes received from the master, e.g. by a DMA UART reception.
+    ///
+    /// # Parameters
+    ///
+    /// * `rx_bytes` - The received bytes in reception order
+    ///
+    /// # Returns
+    ///
+    /// - `Ok(())` if data transfer was processed successfully
+    /// - `Err(IoLinkError)` if an error occurred
+    fn pl_transfer_ind_burst(&mut self, physical_layer: &PHY, rx_bytes: &[u8]) -> IoLinkResult<()> {
+        self.message_handler
+            .pl_transfer_ind_burst(physical_layer, rx_bytes)?;
+        #[cfg(feature = "inline_rx_validation")]
+        self.message_handler
+            .poll_received_message(&mut self.od_handler, &mut self.pd_handler)?;
+        Ok(())
     }
 }
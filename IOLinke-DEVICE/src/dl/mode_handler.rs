@@ -9,6 +9,8 @@ use iolinke_types::{
     frame,
     handlers::{self, mode::DlMode},
 };
+#[cfg(feature = "trace")]
+use iolinke_util::trace::TraceModule;
 use iolinke_util::{log_state_transition, log_state_transition_error};
 
 use crate::{
@@ -23,6 +25,7 @@ use core::result::Result::{Err, Ok};
 /// See IO-Link v1.1.4 Section 7.3.2.5
 /// See Table 45 – State transition tables of the Device DL-mode handler
 #[derive(Debug, Clone, Copy, PartialEq, Eq)]
+#[cfg_attr(feature = "trace", derive(iolinke_macros::TraceId))]
 enum DlModeState {
     /// Inactive state
     Idle,
@@ -105,6 +108,7 @@ enum Transition {
 }
 /// DL-Mode Handler events
 #[derive(Debug, Clone, Copy, PartialEq, Eq)]
+#[cfg_attr(feature = "trace", derive(iolinke_macros::TraceId))]
 enum DlModeEvent {
     /// Table 45 – T1
     PlWakeUp,
@@ -125,6 +129,11 @@ enum DlModeEvent {
     MHInfoIllegalMessagetype,
 }
 
+/// Names of the states and events of the state machine, see [`crate::trace`]
+#[cfg(feature = "trace")]
+pub(crate) const TRACE_MODULE: TraceModule =
+    TraceModule::new::<DlModeState, DlModeEvent>(module_path!());
+
 /// DL-Mode Handler state machine
 #[derive(Debug)]
 pub struct DlModeHandler {
@@ -183,6 +192,11 @@ impl DlModeHandler {
         Ok(())
     }
 
+    /// Returns `true` while a transition is pending for the next poll
+    pub fn has_pending_transition(&self) -> bool {
+        self.exec_transition != Transition::Tn
+    }
+
     /// Poll the state machine
     /// See IO-Link v1.1.4 Section 7.3.2.5
     pub fn poll(
@@ -0,0 +1,107 @@
+//! Event Handler stub of devices without Events
+//!
+//! Built instead of the Event Handler state machine (see IO-Link Specification v1.1.4
+//! Section 7.3.8.4) when the `events` feature is disabled. The Event flag is never set,
+//! so a Master has no reason to read the Event memory. A read of the Diagnosis channel
+//! which arrives anyway is answered with an empty Event memory (StatusCode 0x00, no
+//! Event details), a write (EventConf) is confirmed with an empty response and
+//! discarded.
+use iolinke_types::{
+    custom::{IoLinkError, IoLinkResult},
+    handlers,
+};
+
+use core::default::Default;
+use core::option::{
+    Option,
+    Option::{None, Some},
+};
+use core::result::Result::{Err, Ok};
+
+use crate::{dl::message_handler, storage};
+
+/// Contents of an empty Event memory
+const EMPTY_EVENT_MEMORY: [u8; handlers::od::OD_LENGTH] = [0; handlers::od::OD_LENGTH];
+
+/// Event Handler without Event support
+pub struct EventHandler {
+    /// Length of the response to a Diagnosis channel access, 0 for a write
+    response_pending: Option<u8>,
+}
+
+impl EventHandler {
+    /// Create a new Event Handler
+    pub fn new() -> Self {
+        Self {
+            response_pending: None,
+        }
+    }
+
+    /// Returns `true` while a response is pending for the next poll
+    pub fn has_pending_transition(&self) -> bool {
+        self.response_pending.is_some()
+    }
+
+    /// Poll the handler, answers a pending Diagnosis channel access
+    pub fn poll<AL: handlers::event::DlEventTriggerConf>(
+        &mut self,
+        message_handler: &mut message_handler::MessageHandler,
+        _application_layer: &mut AL,
+    ) -> IoLinkResult<()> {
+        if let Some(length) = self.response_pending.take() {
+            let length = (length as usize).min(EMPTY_EVENT_MEMORY.len());
+            message_handler.od_rsp(length as u8, &EMPTY_EVENT_MEMORY[..length])?;
+        }
+        Ok(())
+    }
+
+    /// Event handler conf, there is no state to activate
+    pub fn eh_conf(&mut self, _state: handlers::event::EhConfState) -> IoLinkResult<()> {
+        self.response_pending = None;
+        Ok(())
+    }
+
+    /// See 7.2.1.15 DL_Event, not available without Event support
+    pub fn dl_event_req(
+        &mut self,
+        _event_count: u8,
+        _event_entries: &[handlers::event::EventEntry],
+    ) -> IoLinkResult<()> {
+        Err(IoLinkError::FuncNotAvailable)
+    }
+
+    /// DL_Event with one event entry, not available without Event support
+    pub fn dl_event_entry_req(
+        &mut self,
+        _entry: &[u8; storage::event_memory::EVENT_ENTRY_SIZE],
+    ) -> IoLinkResult<()> {
+        Err(IoLinkError::FuncNotAvailable)
+    }
+
+    /// See 7.2.1.17 DL_EventTrigger, not available without Event support
+    pub fn dl_event_trigger_req(&mut self) -> IoLinkResult<()> {
+        Err(IoLinkError::FuncNotAvailable)
+    }
+}
+
+impl handlers::od::OdInd for EventHandler {
+    /// Handle the OD.ind event
+    fn od_ind(&mut self, od_ind_data: &handlers::od::OdIndData) -> IoLinkResult<()> {
+        use iolinke_types::frame::msequence::{ComChannel, RwDirection};
+
+        if od_ind_data.com_channel != ComChannel::Diagnosis {
+            return Err(IoLinkError::InvalidEvent);
+        }
+        self.response_pending = Some(match od_ind_data.rw_direction {
+            RwDirection::Read => od_ind_data.req_length,
+            RwDirection::Write => 0,
+        });
+        Ok(())
+    }
+}
+
+impl Default for EventHandler {
+    fn default() -> Self {
+        Self::new()
+    }
+}
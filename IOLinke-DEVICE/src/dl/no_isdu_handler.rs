@@ -0,0 +1,105 @@
+//! ISDU Handler stub of devices without ISDU
+//!
+//! Built instead of the ISDU Handler state machine (see IO-Link Specification v1.1.4
+//! Section 7.3.6.4) when the `isdu` feature is disabled. The M-sequenceCapability of
+//! such a device does not announce ISDU, so a Master does not start ISDU transfers.
+//! Every ISDU read which arrives anyway is answered with the "no service" response of
+//! Table A.14, ISDU writes are accepted and discarded.
+use iolinke_types::{
+    custom::{IoLinkError, IoLinkResult},
+    handlers,
+};
+use iolinke_util::frame_fromat::isdu::ISDU_NO_SERVICE_RESPONSE;
+
+use core::default::Default;
+use core::result::Result::{Err, Ok};
+
+use crate::dl::{ApplicationLayerInd, message_handler};
+
+/// ISDU Handler without ISDU support
+#[derive(Debug, Clone, PartialEq, Eq)]
+pub struct IsduHandler {
+    /// An ISDU read waits for the "no service" response
+    read_pending: bool,
+}
+
+impl IsduHandler {
+    /// Create a new ISDU Handler
+    pub fn new() -> Self {
+        Self {
+            read_pending: false,
+        }
+    }
+
+    /// Returns `true` while a response is pending for the next poll
+    pub fn has_pending_transition(&self) -> bool {
+        self.read_pending
+    }
+
+    /// Poll the ISDU handler, answers a pending ISDU read with "no service"
+    pub fn poll<AL: ApplicationLayerInd>(
+        &mut self,
+        message_handler: &mut message_handler::MessageHandler,
+        _application_layer: &mut AL,
+    ) -> IoLinkResult<()> {
+        if self.read_pending {
+            self.read_pending = false;
+            message_handler.od_rsp(
+                ISDU_NO_SERVICE_RESPONSE.len() as u8,
+                &ISDU_NO_SERVICE_RESPONSE,
+            )?;
+        }
+        Ok(())
+    }
+
+    pub fn dl_isdu_transport_read_rsp(&mut self, _length: u8, _data: &[u8]) -> IoLinkResult<()> {
+        Err(IoLinkError::FuncNotAvailable)
+    }
+
+    pub fn dl_isdu_transport_write_rsp(&mut self) -> IoLinkResult<()> {
+        Err(IoLinkError::FuncNotAvailable)
+    }
+
+    pub fn dl_isdu_transport_read_error_rsp(
+        &mut self,
+        _error: u8,
+        _additional_error: u8,
+    ) -> IoLinkResult<()> {
+        Err(IoLinkError::FuncNotAvailable)
+    }
+
+    pub fn dl_isdu_transport_write_error_rsp(
+        &mut self,
+        _error: u8,
+        _additional_error: u8,
+    ) -> IoLinkResult<()> {
+        Err(IoLinkError::FuncNotAvailable)
+    }
+
+    /// Handle ISDU configuration changes, there is no state to activate
+    pub fn ih_conf(&mut self, _state: handlers::isdu::IhConfState) -> IoLinkResult<()> {
+        self.read_pending = false;
+        Ok(())
+    }
+}
+
+impl handlers::od::OdInd for IsduHandler {
+    fn od_ind(&mut self, od_ind_data: &handlers::od::OdIndData) -> IoLinkResult<()> {
+        use iolinke_types::frame::msequence::{ComChannel, RwDirection};
+
+        // Only handle ISDU channel
+        if od_ind_data.com_channel != ComChannel::Isdu {
+            return Err(IoLinkError::InvalidEvent);
+        }
+        if od_ind_data.rw_direction == RwDirection::Read {
+            self.read_pending = true;
+        }
+        Ok(())
+    }
+}
+
+impl Default for IsduHandler {
+    fn default() -> Self {
+        Self::new()
+    }
+}
@@ -4,27 +4,29 @@
 //! IO-Link Specification v1.1.4 Section 7.3.5.3
 use iolinke_macros::direct_parameter_address;
 use iolinke_types::handlers::mode::DlReadWriteInd;
-use iolinke_types::handlers::od::{DlReadParamInd, DlWriteParamInd, OdInd};
+use iolinke_types::handlers::od::OdInd;
 use iolinke_types::{
     custom::{IoLinkError, IoLinkResult},
     frame,
     handlers::{self, od::OdIndData},
 };
+#[cfg(feature = "trace")]
+use iolinke_util::trace::TraceModule;
 use iolinke_util::{log_state_transition, log_state_transition_error};
 
 use core::clone::Clone;
 use core::default::Default;
+use core::option::Option::{None, Some};
 use core::result::Result::{Err, Ok};
 
-use crate::services;
 use crate::{
-    al,
-    dl::{command_handler, event_handler, isdu_handler, message_handler},
+    dl::{ApplicationLayerInd, command_handler, event_handler, isdu_handler, message_handler},
     system_management,
 };
 
 /// On request Data Handler states
 #[derive(Debug, Clone, Copy, PartialEq, Eq)]
+#[cfg_attr(feature = "trace", derive(iolinke_macros::TraceId))]
 enum OnRequestHandlerState {
     /// {Inactive_0}
     Inactive,
@@ -57,6 +59,7 @@ enum Transition {
 }
 
 #[derive(Debug, Clone, Copy, PartialEq, Eq)]
+#[cfg_attr(feature = "trace", derive(iolinke_macros::TraceId))]
 enum OnRequestHandlerEvent {
     /// {OD_ind_Command}
     OdIndCommand,
@@ -72,6 +75,11 @@ enum OnRequestHandlerEvent {
     OdIndEvent,
 }
 
+/// Names of the states and events of the state machine, see [`crate::trace`]
+#[cfg(feature = "trace")]
+pub(crate) const TRACE_MODULE: TraceModule =
+    TraceModule::new::<OnRequestHandlerState, OnRequestHandlerEvent>(module_path!());
+
 /// Process Data Handler implementation
 pub struct OnRequestDataHandler {
     state: OnRequestHandlerState,
@@ -119,18 +127,20 @@ impl OnRequestDataHandler {
         Ok(())
     }
 
+    /// Returns `true` while a transition is pending for the next poll
+    pub fn has_pending_transition(&self) -> bool {
+        self.exec_transition != Transition::Tn
+    }
+
     /// Poll the process data handler
     /// See IO-Link v1.1.4 Section 7.2
-    pub fn poll<
-        ALS: services::ApplicationLayerServicesInd
-            + handlers::sm::SystemManagementCnf
-            + services::AlEventCnf,
-    >(
+    pub fn poll<AL: ApplicationLayerInd>(
         &mut self,
         command_handler: &mut command_handler::CommandHandler,
         isdu_handler: &mut isdu_handler::IsduHandler,
         event_handler: &mut event_handler::EventHandler,
-        application_layer: &mut al::ApplicationLayer<ALS>,
+        message_handler: &mut message_handler::MessageHandler,
+        application_layer: &mut AL,
         system_management: &mut system_management::SystemManagement,
     ) -> IoLinkResult<()> {
         match self.exec_transition {
@@ -150,6 +160,7 @@ impl OnRequestDataHandler {
                 self.execute_t2(
                     &od_ind_data,
                     command_handler,
+                    message_handler,
                     application_layer,
                     system_management,
                 )?;
@@ -194,21 +205,24 @@ impl OnRequestDataHandler {
 
     /// Handle transition T2: Idle (1) -> Idle (1)
     /// Action: Provide data content of requested parameter or perform appropriate write action
-    fn execute_t2<
-        ALS: services::ApplicationLayerServicesInd
-            + handlers::sm::SystemManagementCnf
-            + services::AlEventCnf,
-    >(
+    fn execute_t2<AL: ApplicationLayerInd>(
         &self,
         od_ind_data: &OdIndData,
         command_handler: &mut command_handler::CommandHandler,
-        application_layer: &mut al::ApplicationLayer<ALS>,
+        message_handler: &mut message_handler::MessageHandler,
+        application_layer: &mut AL,
         system_management: &mut system_management::SystemManagement,
     ) -> IoLinkResult<()> {
         if od_ind_data.com_channel == frame::msequence::ComChannel::Page {
             if od_ind_data.rw_direction == frame::msequence::RwDirection::Read {
-                // Provide data content of requested parameter
-                let _ = application_layer.dl_read_param_ind(od_ind_data.address_ctrl);
+                // Provide data content of requested parameter, the identification
+                // parameters read during startup come from the page image of SM
+                match system_management.direct_parameter(od_ind_data.address_ctrl) {
+                    Some(value) => self.dl_read_param_rsp(1, value, message_handler)?,
+                    None => {
+                        let _ = application_layer.dl_read_param_ind(od_ind_data.address_ctrl);
+                    }
+                }
                 // Informing system management about MinCycleTime is read.
                 let _ = system_management.dl_read_ind(od_ind_data.address_ctrl);
             } else if od_ind_data.rw_direction == frame::msequence::RwDirection::Write {
@@ -217,6 +231,10 @@ impl OnRequestDataHandler {
                     .dl_write_param_ind(od_ind_data.address_ctrl, od_ind_data.data[0])?;
                 if od_ind_data.address_ctrl == direct_parameter_address!(MasterCommand) {
                     command_handler.od_ind(&od_ind_data)?;
+                } else {
+                    // RevisionID and DeviceID1 to DeviceID3 update the page image of SM
+                    let _ = system_management
+                        .dl_write_ind(od_ind_data.address_ctrl, od_ind_data.data[0]);
                 }
             }
         } else {
@@ -227,15 +245,11 @@ impl OnRequestDataHandler {
 
     /// Handle transition T3: Idle (1) -> Idle (1)
     /// Action: Redirect to command handler
-    fn execute_t3<
-        ALS: services::ApplicationLayerServicesInd
-            + handlers::sm::SystemManagementCnf
-            + services::AlEventCnf,
-    >(
+    fn execute_t3<AL: ApplicationLayerInd>(
         &self,
         od_ind_data: &OdIndData,
         command_handler: &mut command_handler::CommandHandler,
-        application_layer: &mut al::ApplicationLayer<ALS>,
+        application_layer: &mut AL,
         system_management: &mut system_management::SystemManagement,
     ) -> IoLinkResult<()> {
         let address = od_ind_data.address_ctrl;
@@ -5,21 +5,24 @@
 use heapless::Vec;
 use iolinke_derived_config as derived_config;
 use iolinke_types::handlers;
-use iolinke_types::handlers::pd::DlPDOutputTransportInd;
 use iolinke_types::{
-    custom::IoLinkResult,
-    handlers::pd::{PD_OUTPUT_LENGTH, PdConfState, ProcessData},
+    custom::{IoLinkError, IoLinkResult},
+    handlers::pd::{PD_INPUT_LENGTH, PD_OUTPUT_LENGTH, PdConfState},
 };
+use iolinke_util::double_buffer::DoubleBuffer;
+#[cfg(feature = "trace")]
+use iolinke_util::trace::TraceModule;
 use iolinke_util::{log_state_transition, log_state_transition_error};
 
-use core::clone::Clone;
 use core::default::Default;
+use core::option::Option;
 use core::result::Result::{Err, Ok};
 
-use crate::{al, dl::message_handler, services};
+use crate::dl::{ApplicationLayerInd, message_handler};
 
 /// Process Data Handler states
 #[derive(Debug, Clone, Copy, PartialEq, Eq)]
+#[cfg_attr(feature = "trace", derive(iolinke_macros::TraceId))]
 enum ProcessDataHandlerState {
     /// {Inactive_0}
     Inactive,
@@ -60,6 +63,7 @@ enum Transition {
 }
 
 #[derive(Debug, Clone, Copy, PartialEq, Eq)]
+#[cfg_attr(feature = "trace", derive(iolinke_macros::TraceId))]
 enum ProcessDataHandlerEvent {
     /// {PD_ind}
     PDInd(u8), // (pd_in demand length)
@@ -77,11 +81,27 @@ enum ProcessDataHandlerEvent {
     _CycleComplete,
 }
 
+/// Names of the states and events of the state machine, see [`crate::trace`]
+#[cfg(feature = "trace")]
+pub(crate) const TRACE_MODULE: TraceModule =
+    TraceModule::new::<ProcessDataHandlerState, ProcessDataHandlerEvent>(module_path!());
+
 /// Process Data Handler implementation
+///
+/// The input and output Process Data are kept in lock-free double buffers.
+/// The application writes input PD straight into the back slot of `pd_in`
+/// (see [`ProcessDataHandler::acquire_pd_in_buffer`]), the message handler
+/// builds every frame from the last committed snapshot.
 pub struct ProcessDataHandler {
     state: ProcessDataHandlerState,
     exec_transition: Transition,
-    process_data: ProcessData,
+    /// Input Process Data `Device to Master`
+    pd_in: DoubleBuffer<PD_INPUT_LENGTH>,
+    /// Output Process Data `Master to Device`
+    pd_out: DoubleBuffer<PD_OUTPUT_LENGTH>,
+    /// `false` if the output Process Data of the last PD.ind was dropped, because the
+    /// application still held the slot
+    pd_out_updated: bool,
 }
 
 impl ProcessDataHandler {
@@ -90,7 +110,9 @@ impl ProcessDataHandler {
         Self {
             state: ProcessDataHandlerState::Inactive,
             exec_transition: Transition::Tn,
-            process_data: ProcessData::default(),
+            pd_in: DoubleBuffer::new(),
+            pd_out: DoubleBuffer::new(),
+            pd_out_updated: false,
         }
     }
 
@@ -128,16 +150,17 @@ impl ProcessDataHandler {
         Ok(())
     }
 
+    /// Returns `true` while a transition is pending for the next poll
+    pub fn has_pending_transition(&self) -> bool {
+        self.exec_transition != Transition::Tn
+    }
+
     /// Poll the process data handler
     /// See IO-Link v1.1.4 Section 7.2
-    pub fn poll<
-        ALS: services::ApplicationLayerServicesInd
-            + handlers::sm::SystemManagementCnf
-            + services::AlEventCnf,
-    >(
+    pub fn poll<AL: ApplicationLayerInd>(
         &mut self,
         message_handler: &mut message_handler::MessageHandler,
-        application_layer: &mut al::ApplicationLayer<ALS>,
+        application_layer: &mut AL,
     ) -> IoLinkResult<()> {
         match self.exec_transition {
             Transition::Tn => {
@@ -163,7 +186,7 @@ impl ProcessDataHandler {
             Transition::T4(pd_in_length) => {
                 // State: PDActive (1) -> HandlePD (2)
                 self.exec_transition = Transition::Tn;
-                self.execute_t4(pd_in_length, application_layer, message_handler)?;
+                self.execute_t4(pd_in_length, message_handler)?;
             }
             Transition::T5 => {
                 // State: HandlePD (2) -> PDActive (1)
@@ -209,20 +232,17 @@ impl ProcessDataHandler {
         Ok(())
     }
 
-    fn execute_t4<
-        ALS: services::ApplicationLayerServicesInd
-            + handlers::sm::SystemManagementCnf
-            + services::AlEventCnf,
-    >(
+    fn execute_t4(
         &mut self,
         _pd_in_length: u8,
-        application_layer: &mut al::ApplicationLayer<ALS>,
         message_handler: &mut message_handler::MessageHandler,
     ) -> IoLinkResult<()> {
         // State: PDActive (1) -> HandlePD (2)
         // Action: Message handler demands input PD via a PD.ind service and delivers output PD or segment of output PD. Invoke PD.rsp with input Process Data when in non-interleave mode (see 7.2.2.3).
-        let _ = message_handler.pd_rsp(self.process_data.input.len(), &self.process_data.input);
-        let _ = application_layer.dl_pd_output_transport_ind(&self.process_data.output);
+        let _ = self
+            .pd_in
+            .read(|pd_in| message_handler.pd_rsp(PD_INPUT_LENGTH, pd_in));
+        // The output Process Data is indicated once, by T6
         let _ = self.process_event(ProcessDataHandlerEvent::PDComplete);
         Ok(())
     }
@@ -232,18 +252,31 @@ impl ProcessDataHandler {
         Ok(())
     }
 
-    fn execute_t6<
-        ALS: services::ApplicationLayerServicesInd
-            + handlers::sm::SystemManagementCnf
-            + services::AlEventCnf,
-    >(
+    fn execute_t6<AL: ApplicationLayerInd>(
         &mut self,
-        application_layer: &mut al::ApplicationLayer<ALS>,
+        application_layer: &mut AL,
     ) -> IoLinkResult<()> {
         // State: HandlePD (2) -> PDActive (1)
-        // Action: Invoke DL_PDOutputTransport.ind
-        let _ = application_layer.dl_pd_output_transport_ind(&self.process_data.output);
-        Ok(())
+        // Action: Invoke DL_PDOutputTransport.ind, unless the output Process Data was
+        // dropped and the application still reads the previous one
+        if self.pd_out_updated {
+            let _ = self.pd_output_transport_ind(application_layer);
+        }
+        // In non-interleave mode the Process Data cycle completes with every PD message
+        application_layer.dl_pd_cycle_ind()
+    }
+
+    /// Invoke DL_PDOutputTransport.ind with the last committed output Process Data
+    fn pd_output_transport_ind<AL: ApplicationLayerInd>(
+        &mut self,
+        application_layer: &mut AL,
+    ) -> IoLinkResult<()> {
+        // Read as the writer, the slot held by the application stays protected
+        let pd_out: Vec<u8, PD_OUTPUT_LENGTH> = self
+            .pd_out
+            .read_committed(|pd_out| Vec::from_slice(pd_out))
+            .map_err(|_| IoLinkError::BufferOverflow)?;
+        application_layer.dl_pd_output_transport_ind(&pd_out)
     }
 
     fn execute_t7(&mut self) -> IoLinkResult<()> {
@@ -279,12 +312,15 @@ impl ProcessDataHandler {
         _pd_in_address: u8,  // Not required, because of legacy specification
         pd_in_length: u8,    // pd_in demands length
         _pd_out_address: u8, // Not required, because of legacy specification
-        pd_out: &Vec<u8, PD_OUTPUT_LENGTH>,
+        pd_out: &[u8],
     ) -> IoLinkResult<()> {
         if pd_in_length > derived_config::device::process_data::max_pd_len() {
-            return Err(iolinke_types::custom::IoLinkError::InvalidParameter);
+            return Err(IoLinkError::InvalidParameter);
         }
-        self.process_data.output = pd_out.clone();
+        // If the application still holds the slot, its snapshot is kept consistent and
+        // the new output Process Data is dropped. The input Process Data is sent anyway,
+        // a slow application must not silence the Device.
+        self.pd_out_updated = self.pd_out.write(pd_out);
         self.process_event(ProcessDataHandlerEvent::PDInd(pd_in_length))?;
 
         Ok(())
@@ -295,15 +331,47 @@ impl ProcessDataHandler {
     /// (Process Data from Device to Master) on the data link layer. The parameters of the service
     /// primitives are listed in Table 25.
     pub fn dl_pd_input_update_req(&mut self, length: u8, input_data: &[u8]) -> IoLinkResult<()> {
-        let _ = length;
-        self.process_data.input.clear();
-        self.process_data
-            .input
-            .extend_from_slice(input_data)
-            .map_err(|_| iolinke_types::custom::IoLinkError::InvalidParameter)?;
+        let length = length as usize;
+        if length > PD_INPUT_LENGTH || length > input_data.len() {
+            return Err(IoLinkError::InvalidParameter);
+        }
+        if !self.pd_in.write(&input_data[..length]) {
+            return Err(IoLinkError::NotReady);
+        }
         self.process_event(ProcessDataHandlerEvent::DlPDInputUpdate)?;
         Ok(())
     }
+
+    /// Returns the back slot of the input Process Data for in place update.
+    /// The slot is published to the message handler by
+    /// [`ProcessDataHandler::commit_pd_in_buffer`].
+    ///
+    /// # Returns
+    /// - `Some(slot)` the slot, valid until the commit.
+    /// - `None` if the message handler is still building a frame from that slot.
+    pub fn acquire_pd_in_buffer(&mut self) -> Option<&mut [u8; PD_INPUT_LENGTH]> {
+        // SAFETY: The back slot is only handed out to the writer, `&mut self`
+        // prevents a second acquire while the returned borrow is alive.
+        self.pd_in.acquire().map(|slot| unsafe { &mut *slot })
+    }
+
+    /// Publishes the slot returned by [`ProcessDataHandler::acquire_pd_in_buffer`].
+    /// Equivalent to a DL_PDInputUpdate request carrying the slot content.
+    pub fn commit_pd_in_buffer(&mut self) -> IoLinkResult<()> {
+        self.pd_in.commit();
+        self.process_event(ProcessDataHandlerEvent::DlPDInputUpdate)
+    }
+
+    /// Marks the last received output Process Data as held by the application and
+    /// returns it. The data stays unchanged until [`ProcessDataHandler::release_pd_out_buffer`].
+    pub fn acquire_pd_out_buffer(&self) -> *const [u8; PD_OUTPUT_LENGTH] {
+        self.pd_out.read_begin()
+    }
+
+    /// Releases the slot returned by [`ProcessDataHandler::acquire_pd_out_buffer`]
+    pub fn release_pd_out_buffer(&self) {
+        self.pd_out.read_end();
+    }
 }
 
 impl Default for ProcessDataHandler {
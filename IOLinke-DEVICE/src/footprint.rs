@@ -0,0 +1,99 @@
+//! Static RAM footprint of the IO-Link Device Stack.
+//!
+//! The state machines and buffers of a device stack are sized at compile time from
+//! `device_config.toon`: the frame buffers of the Message Handler from the OD and PD
+//! lengths, the Event queue from `IODevice.Events.QueueDepth`, the parameter storage
+//! from the vendor parameters, and so on. [`components`] lists the size of every
+//! component of one device port, as `core::mem::size_of` of the current target.
+//! `cargo configuration` prints the list for the written configuration.
+//!
+//! The physical layer, the application services and the non-volatile memory backend are
+//! provided by the application and are not included. [`port_ram`] sums the
+//! components, so it leaves out the padding between the fields of the device.
+//!
+//! ## Stack estimate
+//!
+//! [`stack_estimate`] is the largest set of values a poll keeps on the stack at once,
+//! e.g. the ISDU request handed to the Application Layer or the pending transition of
+//! the AL On-request Data Handler with its response payload. The call frames of the poll
+//! come on top, so it is a lower bound for the stack of the poll loop.
+
+use heapless::Vec;
+use iolinke_types::handlers::{isdu, od, pd};
+
+use core::iter::Iterator;
+
+use crate::{al, dl, scheduler, storage, system_management};
+
+/// RAM of one component of the device stack
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub struct Component {
+    /// Name of the state machine or buffer
+    pub name: &'static str,
+    /// Size in octets
+    pub size: usize,
+}
+
+impl Component {
+    /// Component of type `T`
+    pub(crate) const fn of<T>(name: &'static str) -> Self {
+        Self {
+            name,
+            size: core::mem::size_of::<T>(),
+        }
+    }
+}
+
+/// Components of the device outside of the layers
+const DEVICE_COMPONENTS: [Component; 3] = [
+    Component::of::<system_management::SystemManagement>("System Management"),
+    Component::of::<scheduler::PendingWorkMask>("Pending work mask"),
+    Component::of::<storage::nvm::ParameterJournal<storage::nvm::NoNvm>>("Parameter journal"),
+];
+
+/// Returns the components of one device port
+pub fn components() -> impl Iterator<Item = Component> {
+    dl::FOOTPRINT
+        .into_iter()
+        .chain(al::FOOTPRINT)
+        .chain(DEVICE_COMPONENTS)
+}
+
+/// Sum of the component sizes
+const fn sum(components: &[Component]) -> usize {
+    let mut size = 0;
+    let mut i = 0;
+    while i < components.len() {
+        size += components[i].size;
+        i += 1;
+    }
+    size
+}
+
+/// Returns the RAM of the components of one device port in octets
+pub const fn port_ram() -> usize {
+    sum(&dl::FOOTPRINT) + sum(&al::FOOTPRINT) + sum(&DEVICE_COMPONENTS)
+}
+
+/// Returns the largest value a poll keeps on the stack in octets, see the module
+/// documentation
+pub const fn stack_estimate() -> usize {
+    const fn max(a: usize, b: usize) -> usize {
+        if a > b { a } else { b }
+    }
+    // DL_ISDUTransport.ind, the request data and the ISDU message are built after another
+    let isdu_request = core::mem::size_of::<Vec<u8, { isdu::MAX_ISDU_LENGTH }>>()
+        + core::mem::size_of::<isdu::IsduMessage>();
+    // OD.ind of a received Master message
+    let od_ind = core::mem::size_of::<od::OdIndData>();
+    // PD.ind, the output Process Data copied out of the frame
+    let pd_ind = core::mem::size_of::<Vec<u8, { pd::PD_OUTPUT_LENGTH }>>();
+    // ISDU response segment
+    let isdu_segment = od::OD_LENGTH;
+    // AL_Read.rsp of the AL On-request Data Handler, with the transitions carrying it
+    let al_read_rsp = al::od_handler::stack_estimate();
+    max(
+        max(max(isdu_request, od_ind), max(pd_ind, isdu_segment)),
+        al_read_rsp,
+    )
+}
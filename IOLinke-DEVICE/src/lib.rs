@@ -28,6 +28,30 @@
 //! - **State Machine Based**: Clean separation of protocol states and transitions
 //! - **Event Driven**: Efficient event handling and queuing system
 //!
+//! ## Optional Services
+//!
+//! ISDU, Events and Data Storage are selected with `IODevice.Services` in
+//! `device_config.toon` and built with the Cargo features `isdu`, `events` and
+//! `data_storage` (all enabled by default). Without a feature the state machines of the
+//! service are replaced by zero-sized stubs which answer the Master with the "no service"
+//! responses, e.g. a binary switching sensor does without all three. The features have to
+//! match the configuration, a mismatch is a compile error.
+//!
+//! ## Tracing
+//!
+//! With the `std` feature every state transition is printed as text. The `trace` feature
+//! records them as 12 octet binary records into a RAM ring instead, which is dumped from
+//! the target and decoded off-target, see the `trace` module.
+//!
+//! ## Split layers
+//!
+//! With the `split_layers` feature the Data Link Layer and System Management
+//! ([`split::DataLinkSide`]) can be polled from the UART interrupt or a high priority
+//! task, and the Application Layer ([`split::ApplicationSide`]) from a low priority task
+//! or a second core. The two sides exchange their services through a static
+//! [`split::LayerMailbox`], so a slow parameter access never delays an M-sequence
+//! response.
+//!
 //! ## Macros
 //!
 //! This crate integrates with `iolinke-macros` to provide convenient procedural
@@ -47,6 +71,16 @@
 //! }
 //! ```
 //!
+//! With the `async` feature and a physical layer implementing [`AsyncPhysicalLayer`],
+//! the device runs as a task of an async executor instead:
+//!
+//! ```ignore
+//! #[embassy_executor::task]
+//! async fn io_link_task(mut device: IoLinkDevice<Phy, App>) {
+//!     device.run().await
+//! }
+//! ```
+//!
 //! ## Specification Compliance
 //!
 //! This implementation follows IO-Link Specification v1.1.4 (June 2024):
@@ -67,22 +101,50 @@ use iolinke_types::{
 };
 
 use core::default::Default;
+use core::option::Option;
 pub use core::result::{
     Result,
     Result::{Err, Ok},
 };
 
+// The optional services of `device_config.toon` select the stubs through Cargo features
+const _: () = {
+    use iolinke_derived_config::device::services;
+    if cfg!(feature = "isdu") != services::isdu() {
+        core::panic!("The `isdu` feature does not match IODevice.Services.Isdu");
+    }
+    if cfg!(feature = "events") != services::events() {
+        core::panic!("The `events` feature does not match IODevice.Services.Events");
+    }
+    if cfg!(feature = "data_storage") != services::data_storage() {
+        core::panic!("The `data_storage` feature does not match IODevice.Services.DataStorage");
+    }
+};
+
 mod al;
 mod dl;
+pub mod footprint;
 mod pl;
+pub mod profiling;
+mod scheduler;
+#[cfg(feature = "split_layers")]
+pub mod split;
 mod storage;
 mod system_management;
+#[cfg(feature = "trace")]
+pub mod trace;
 
+pub use al::OutputIndication;
+pub use al::AlEventQueue;
+#[cfg(feature = "events")]
+pub use al::event_aggregator::{EventAggregator, EventEntryBytes};
 pub use al::services::AlControlReq;
 pub use al::services::AlEventCnf;
+pub use al::services::{AlReadRsp, AlResult, AlRspError, AlWriteRsp};
 pub use al::services::ApplicationLayerServicesInd;
 pub use handlers::command::{DlControlCode, DlControlInd};
 pub use handlers::pl::Timer;
+pub use iolinke_derived_config::device::process_data_layout::{PdIn, PdOut};
 pub use iolinke_types::frame::msequence::TransmissionRate;
 pub use iolinke_types::handlers::sm::DeviceCom;
 pub use iolinke_types::handlers::sm::DeviceMode;
@@ -94,9 +156,18 @@ pub use iolinke_types::page::page1::MsequenceCapability;
 pub use iolinke_types::page::page1::ProcessDataIn;
 pub use iolinke_types::page::page1::ProcessDataOut;
 pub use iolinke_types::page::page1::RevisionId;
+#[cfg(feature = "async")]
+pub use pl::async_physical_layer::{AsyncPhysicalLayer, PlInd};
 pub use pl::physical_layer::{PhysicalLayerInd, PhysicalLayerReq};
+#[cfg(feature = "timer_service")]
+pub use pl::timer_service::{TimerHardware, TimerService};
+pub use scheduler::PendingWork;
+pub use storage::nvm::{MAX_PROGRAM_LENGTH, NoNvm, NvmBackend, NvmStatus, ParameterJournal};
 
 use crate::al::services::AlSetInputReq;
+#[cfg(feature = "profiling")]
+use crate::profiling::ProfileId;
+use crate::profiling::profile_scope;
 
 /// Main IO-Link device implementation that orchestrates all protocol layers.
 ///
@@ -136,6 +207,7 @@ pub struct IoLinkDevice<
     ALS: al::services::ApplicationLayerServicesInd
         + handlers::sm::SystemManagementCnf
         + services::AlEventCnf,
+    NVM: storage::nvm::NvmBackend = storage::nvm::NoNvm,
 > {
     /// Data link layer managing protocol state machines and message handling
     data_link_layer: dl::DataLinkLayer,
@@ -145,6 +217,10 @@ pub struct IoLinkDevice<
     application_layer: al::ApplicationLayer<ALS>,
     /// Physical layer managing communication, timing, and mode switching
     physical_layer: PHY,
+    /// Layers with work pending for the next poll
+    pending_work: scheduler::PendingWorkMask,
+    /// Journal of the persistent parameters in non-volatile memory
+    parameter_journal: storage::nvm::ParameterJournal<NVM>,
 }
 
 impl<
@@ -157,7 +233,8 @@ impl<
     /// Creates a new IO-Link device with the provided implementations.
     ///
     /// The device starts in the **Idle** state and must be configured with
-    /// device identification before entering operational modes.
+    /// device identification before entering operational modes. Parameters are kept in
+    /// RAM only, see [`IoLinkDevice::new_with_nvm`] to keep them over a power cycle.
     ///
     /// # Parameters
     ///
@@ -176,14 +253,63 @@ impl<
     /// let device = IoLinkDevice::new(physical_layer, al_services);
     /// ```
     pub fn new(physical_layer: PHY, al_services: ALS) -> Self {
+        Self::new_with_nvm(physical_layer, al_services, NoNvm)
+    }
+}
+
+impl<
+    PHY: pl::physical_layer::PhysicalLayerReq,
+    ALS: al::services::ApplicationLayerServicesInd
+        + handlers::sm::SystemManagementCnf
+        + services::AlEventCnf,
+    NVM: storage::nvm::NvmBackend,
+> IoLinkDevice<PHY, ALS, NVM>
+{
+    /// Creates a new IO-Link device whose persistent parameters are saved in `nvm`.
+    ///
+    /// Call [`IoLinkDevice::restore_parameters`] once before the first poll to load the
+    /// saved parameters, parameter writes are then saved in the background by
+    /// [`IoLinkDevice::poll`].
+    ///
+    /// # Parameters
+    ///
+    /// * `physical_layer` - Physical layer implementation
+    /// * `al_services` - Application layer services implementation
+    /// * `nvm` - Non-volatile memory of the parameter journal
+    ///
+    /// # Example
+    ///
+    /// ```ignore
+    /// let mut device = IoLinkDevice::new_with_nvm(physical_layer, al_services, flash);
+    /// device.restore_parameters()?;
+    /// ```
+    pub fn new_with_nvm(physical_layer: PHY, al_services: ALS, nvm: NVM) -> Self {
         Self {
             system_management: system_management::SystemManagement::default(),
             data_link_layer: dl::DataLinkLayer::default(),
             application_layer: al::ApplicationLayer::new(al_services),
             physical_layer,
+            pending_work: scheduler::PendingWorkMask::new(),
+            parameter_journal: storage::nvm::ParameterJournal::new(nvm),
         }
     }
 
+    /// Restores the parameters saved in the [`NvmBackend`] and starts saving parameter
+    /// writes to it, in a wear-levelled journal of one record per changed parameter.
+    ///
+    /// # Errors
+    ///
+    /// - `IoLinkError::InvalidParameter` - The geometry of the memory is not supported
+    /// - `IoLinkError::NotEnoughMemory` - The persistent parameters do not fit in one sector
+    /// - Any error of the [`NvmBackend`]
+    pub fn restore_parameters(&mut self) -> IoLinkResult<()> {
+        let result = self
+            .parameter_journal
+            .mount(self.application_layer.parameter_storage_mut());
+        self.pending_work.mark(PendingWork::ParameterStorage);
+        result
+    }
+
     /// Sets the device identification parameters as required by IO-Link v1.1.4.
     ///
     /// This method configures the mandatory device identification parameters
@@ -219,6 +345,47 @@ impl<
     /// * `Err(IoLinkError)` if an error occurred
     pub fn successful_com(&mut self, transmission_rate: TransmissionRate) {
         let _ = self.data_link_layer.successful_com(transmission_rate);
+        self.pending_work.mark(PendingWork::DataLinkLayer);
+    }
+
+    /// Indicates the expiry of a timer started through `pl_start_timer_req`.
+    ///
+    /// # Parameters
+    ///
+    /// * `timer` - The timer that has elapsed
+    ///
+    /// # Returns
+    ///
+    /// * `Ok(())` if the timer expiry was processed successfully
+    /// * `Err(IoLinkError)` if an error occurred during processing
+    pub fn timer_elapsed(&mut self, timer: Timer) -> IoLinkResult<()> {
+        self.pending_work.mark(PendingWork::DataLinkLayer);
+        self.data_link_layer.timer_elapsed(timer)
+    }
+
+    /// Returns `true` if a state machine has work pending for the next [`IoLinkDevice::poll`].
+    ///
+    /// When this returns `false`, calling `poll` does nothing until the next service call
+    /// or indication, firmware can sleep until the next interrupt.
+    ///
+    /// # Example
+    ///
+    /// ```ignore
+    /// loop {
+    ///     device.poll()?;
+    ///     if !device.has_pending_work() {
+    ///         cortex_m::asm::wfi();
+    ///     }
+    /// }
+    /// ```
+    pub fn has_pending_work(&self) -> bool {
+        self.pending_work.has_pending_work()
+    }
+
+    /// Marks `work` as pending, so the next [`IoLinkDevice::poll`] polls that layer.
+    /// Only required when the state of a layer is changed outside of the device services.
+    pub fn mark_pending_work(&self, work: PendingWork) {
+        self.pending_work.mark(work);
     }
 
     /// Main polling function that advances all protocol state machines.
@@ -267,15 +434,64 @@ impl<
     /// }
     /// ```
     pub fn poll(&mut self) -> IoLinkResult<()> {
-        // Poll all state machines in dependency order
-        self.application_layer.poll(&mut self.data_link_layer)?;
-        self.data_link_layer.poll(
-            &mut self.system_management,
-            &mut self.physical_layer,
-            &mut self.application_layer,
-        )?;
-        self.system_management
-            .poll(&mut self.application_layer, &mut self.physical_layer)?;
+        let result = profile_scope!(ProfileId::DevicePoll, self.poll_pending());
+        // Keep the layers which still have a transition pending scheduled
+        if self
+            .application_layer
+            .has_pending_work(&self.data_link_layer)
+        {
+            self.pending_work.mark(PendingWork::ApplicationLayer);
+        }
+        if self.data_link_layer.has_pending_work() {
+            self.pending_work.mark(PendingWork::DataLinkLayer);
+        }
+        if self.system_management.has_pending_transition() {
+            self.pending_work.mark(PendingWork::SystemManagement);
+        }
+        if self
+            .parameter_journal
+            .has_pending_work(self.application_layer.parameter_storage_mut())
+        {
+            self.pending_work.mark(PendingWork::ParameterStorage);
+        }
+        result
+    }
+
+    /// Polls the pending state machines in dependency order.
+    /// A layer is also polled if a layer before it in this poll created work for it.
+    fn poll_pending(&mut self) -> IoLinkResult<()> {
+        if self.pending_work.take(PendingWork::ApplicationLayer)
+            || self
+                .application_layer
+                .has_pending_work(&self.data_link_layer)
+        {
+            self.application_layer.poll(&mut self.data_link_layer)?;
+        }
+        if self.pending_work.take(PendingWork::DataLinkLayer)
+            || self.data_link_layer.has_pending_work()
+        {
+            self.data_link_layer.poll(
+                &mut self.system_management,
+                &mut self.physical_layer,
+                &mut self.application_layer,
+            )?;
+        }
+        if self.pending_work.take(PendingWork::SystemManagement)
+            || self.system_management.has_pending_transition()
+        {
+            profile_scope!(
+                ProfileId::SystemManagement,
+                self.system_management
+                    .poll(&mut self.application_layer, &mut self.physical_layer)
+            )?;
+        }
+        // Saving parameters goes last, it is not on the path of a response to the Master
+        let parameter_storage = self.application_layer.parameter_storage_mut();
+        if self.pending_work.take(PendingWork::ParameterStorage)
+            || self.parameter_journal.has_pending_work(parameter_storage)
+        {
+            self.parameter_journal.poll(parameter_storage)?;
+        }
         Ok(())
     }
 
@@ -304,8 +520,66 @@ impl<
     /// device.pl_transfer_ind(0x55)?; // Handle received byte 0x55
     /// ```
     pub fn pl_transfer_ind(&mut self, rx_byte: u8) -> IoLinkResult<()> {
-        self.data_link_layer
-            .pl_transfer_ind(&self.physical_layer, rx_byte)?;
+        self.pending_work.mark(PendingWork::DataLinkLayer);
+        profile_scope!(
+            ProfileId::PlTransferInd,
+            self.data_link_layer
+                .pl_transfer_ind(&self.physical_layer, rx_byte)
+        )?;
+        Ok(())
+    }
+
+    /// Handles a span of bytes received by the Physical Layer from the master.
+    ///
+    /// Behaves like calling [`IoLinkDevice::pl_transfer_ind`] for every byte, but the span is
+    /// copied into the receive buffer at once and a single state transition is made per span.
+    /// Intended for DMA UART reception where whole or half frames arrive at once.
+    ///
+    /// # Parameters
+    ///
+    /// * `rx_bytes` - The received bytes in reception order
+    ///
+    /// # Returns
+    ///
+    /// * `Ok(())` if the bytes were processed successfully
+    /// * `Err(IoLinkError)` if an error occurred during processing
+    ///
+    /// # Specification Reference
+    ///
+    /// - IO-Link Interface Spec v1.1.4 Section 5.2.2.3: PL_Transfer Service
+    ///
+    /// # Example
+    ///
+    /// ```ignore
+    /// device.pl_transfer_ind_burst(&dma_buffer[..received])?;
+    /// ```
+    pub fn pl_transfer_ind_burst(&mut self, rx_bytes: &[u8]) -> IoLinkResult<()> {
+        self.pending_work.mark(PendingWork::DataLinkLayer);
+        profile_scope!(
+            ProfileId::PlTransferInd,
+            self.data_link_layer
+                .pl_transfer_ind_burst(&self.physical_layer, rx_bytes)
+        )?;
+        Ok(())
+    }
+
+    /// Handles the Physical Layer confirmation of a non-blocking transfer.
+    ///
+    /// Called when the octets handed to [`PhysicalLayerReq::pl_transfer_req`] are sent,
+    /// e.g. from the UART TX DMA complete interrupt. The TX buffer is released and the
+    /// next response can be sent.
+    ///
+    /// # Returns
+    ///
+    /// * `Ok(())` if the confirmation was processed successfully
+    ///
+    /// # Specification Reference
+    ///
+    /// - IO-Link Interface Spec v1.1.4 Section 5.2.2.3: PL_Transfer Service
+    #[cfg(feature = "non_blocking_tx")]
+    pub fn pl_transfer_cnf(&mut self) -> IoLinkResult<()> {
+        self.pending_work.mark(PendingWork::DataLinkLayer);
+        self.data_link_layer.pl_transfer_cnf();
         Ok(())
     }
 
@@ -337,6 +611,7 @@ impl<
     /// device.pl_wake_up_ind()?; // Handle wake-up indication
     /// ```
     pub fn pl_wake_up_ind(&mut self) -> IoLinkResult<()> {
+        self.pending_work.mark(PendingWork::DataLinkLayer);
         let _ = self.data_link_layer.pl_wake_up_ind(&self.physical_layer);
         Ok(())
     }
@@ -374,9 +649,225 @@ impl<
     /// device.al_set_input_req(input_data.len() as u8, &input_data)?;
     /// ```
     pub fn al_set_input_req(&mut self, _length: u8, input_data: &[u8]) -> IoLinkResult<()> {
+        self.pending_work.mark(PendingWork::DataLinkLayer);
         self.application_layer
             .al_set_input_req(input_data, &mut self.data_link_layer)
     }
+
+    /// Returns the input Process Data slot for in place update (zero-copy AL_SetInput).
+    ///
+    /// The application writes the input Process Data directly into the returned slot and
+    /// publishes it with [`IoLinkDevice::commit_pd_in_buffer`]. Until the commit, the
+    /// message handler keeps building frames from the previously committed snapshot, so
+    /// the Master never sees a partially updated Process Data.
+    ///
+    /// # Returns
+    ///
+    /// * `Some(slot)` the slot of `PD_INPUT_LENGTH` bytes.
+    /// * `None` if the slot is still in use by the message handler, retry later.
+    ///
+    /// # Example
+    ///
+    /// ```ignore
+    /// if let Some(pd_in) = device.acquire_pd_in_buffer() {
+    ///     pd_in[0] = sample;
+    ///     device.commit_pd_in_buffer()?;
+    /// }
+    /// ```
+    pub fn acquire_pd_in_buffer(&mut self) -> Option<&mut [u8; dl::PD_INPUT_LENGTH]> {
+        self.data_link_layer.acquire_pd_in_buffer()
+    }
+
+    /// Publishes the slot returned by [`IoLinkDevice::acquire_pd_in_buffer`].
+    /// Has the same effect as [`IoLinkDevice::al_set_input_req`] with the slot content.
+    pub fn commit_pd_in_buffer(&mut self) -> IoLinkResult<()> {
+        self.pending_work.mark(PendingWork::DataLinkLayer);
+        self.data_link_layer.commit_pd_in_buffer()
+    }
+
+    /// Returns the last received output Process Data without copying it.
+    ///
+    /// The data stays unchanged until [`IoLinkDevice::release_pd_out_buffer`] is called,
+    /// output Process Data received in the mean time is dropped.
+    pub fn acquire_pd_out_buffer(&self) -> *const [u8; dl::PD_OUTPUT_LENGTH] {
+        self.data_link_layer.acquire_pd_out_buffer()
+    }
+
+    /// Releases the output Process Data returned by [`IoLinkDevice::acquire_pd_out_buffer`]
+    pub fn release_pd_out_buffer(&self) {
+        self.data_link_layer.release_pd_out_buffer()
+    }
+
+    /// Packs `pd_in` into the input Process Data slot and publishes it, see
+    /// [`IoLinkDevice::acquire_pd_in_buffer`]. The layout is `IODevice.Operate.PdIn`.
+    ///
+    /// # Errors
+    ///
+    /// - `IoLinkError::DeviceNotReady` if the slot is still in use by the message handler
+    pub fn set_pd_in(&mut self, pd_in: &PdIn) -> IoLinkResult<()> {
+        let slot = self
+            .acquire_pd_in_buffer()
+            .ok_or(IoLinkError::DeviceNotReady)?;
+        pd_in.pack(slot);
+        self.commit_pd_in_buffer()
+    }
+
+    /// Unpacks the last received output Process Data, the layout is
+    /// `IODevice.Operate.PdOut`.
+    pub fn get_pd_out(&self) -> PdOut {
+        // SAFETY: The slot stays unchanged until it is released
+        let pd_out = PdOut::unpack(unsafe { &*self.acquire_pd_out_buffer() });
+        self.release_pd_out_buffer();
+        pd_out
+    }
+
+    /// Prefetches the value of a parameter served by the device application.
+    ///
+    /// ISDU reads of `index`/`sub_index` are answered from the stored value without
+    /// indicating AL_Read, so frequently read parameters never wait for a slow backend.
+    /// The value is kept until it is replaced, dropped with
+    /// [`IoLinkDevice::al_invalidate_req`] or the master writes the parameter.
+    ///
+    /// # Errors
+    ///
+    /// - `IoLinkError::InvalidLength` if `data` is longer than 16 octets
+    /// - `IoLinkError::NotEnoughMemory` if 4 other parameters are prefetched already
+    pub fn al_prefetch_req(&mut self, index: u16, sub_index: u8, data: &[u8]) -> IoLinkResult<()> {
+        self.application_layer
+            .al_prefetch_req(index, sub_index, data)
+    }
+
+    /// Drops a value stored with [`IoLinkDevice::al_prefetch_req`], e.g. when it changed.
+    ///
+    /// Sub-index 0 drops all sub-indices of `index`.
+    pub fn al_invalidate_req(&mut self, index: u16, sub_index: u8) {
+        self.application_layer.al_invalidate_req(index, sub_index);
+    }
+
+    /// Replaces the filtering of AL_NewOutput and AL_PDCycle configured by
+    /// `IODevice.OutputIndication` in `device_config.toon`, e.g. for device variants
+    /// sharing one firmware. The next output Process Data is indicated.
+    pub fn set_output_indication(&mut self, output_indication: OutputIndication) {
+        self.application_layer
+            .set_output_indication(output_indication);
+    }
+
+    /// Raises an Event of the device application (AL_Event).
+    ///
+    /// The Event is queued in the wire format of the Event memory and reported to the
+    /// Master by the next polls, up to 6 Events with one Event signaling. Repeated Events
+    /// are merged while they wait and every EventCode is reported at most once per
+    /// `IODevice.Events.RateLimitCycles` Master cycles, see `device_config.toon`.
+    ///
+    /// Called from the context polling the device. Events of an interrupt context (e.g. an
+    /// over-temperature or short-circuit interrupt) are pushed into an [`AlEventQueue`]
+    /// kept outside of the device, e.g. in a `static`, and handed over with
+    /// [`IoLinkDevice::al_event_take_req`], so the interrupt never accesses the device.
+    ///
+    /// # Returns
+    ///
+    /// - `true` if the Event was queued
+    /// - `false` if the queue is full, the Event is dropped and counted in
+    ///   [`IoLinkDevice::al_event_overflow_count`]
+    ///
+    /// # Specification Reference
+    ///
+    /// - IO-Link v1.1.4 Section 8.2.2.11: AL_Event
+    pub fn al_event_push_req(&mut self, event_entry: &handlers::event::EventEntry) -> bool {
+        let queued = self.application_layer.al_event_push_req(event_entry);
+        self.pending_work.mark(PendingWork::ApplicationLayer);
+        queued
+    }
+
+    /// Takes the Events pushed into `queue` by another context (AL_Event), the consumer
+    /// side of `queue`. Called from the context polling the device, before
+    /// [`IoLinkDevice::poll`]. Events stay in `queue` while the device has no room for
+    /// them, see [`IoLinkDevice::has_queued_events`].
+    pub fn al_event_take_req(&mut self, queue: &AlEventQueue) {
+        self.application_layer.al_event_take_req(queue);
+        self.pending_work.mark(PendingWork::ApplicationLayer);
+    }
+
+    /// Returns `true` if `queue` holds an Event which [`IoLinkDevice::al_event_take_req`]
+    /// can take, i.e. the device has work to do besides [`IoLinkDevice::has_pending_work`]
+    pub fn has_queued_events(&self, queue: &AlEventQueue) -> bool {
+        self.application_layer.has_queued_event(queue)
+    }
+
+    /// Returns the number of Events dropped by [`IoLinkDevice::al_event_push_req`]
+    /// because the queue was full. The counter is never reset and wraps around.
+    pub fn al_event_overflow_count(&self) -> u32 {
+        self.application_layer.event_overflow_count()
+    }
+
+    /// Returns the number of Events merged into an Event of the same EventQualifier and
+    /// EventCode which was still waiting to be reported. Wraps around.
+    pub fn al_event_coalesced_count(&self) -> u32 {
+        self.application_layer.event_coalesced_count()
+    }
+}
+
+#[cfg(feature = "async")]
+impl<
+    PHY: pl::async_physical_layer::AsyncPhysicalLayer,
+    ALS: al::services::ApplicationLayerServicesInd
+        + handlers::sm::SystemManagementCnf
+        + services::AlEventCnf,
+    NVM: storage::nvm::NvmBackend,
+> IoLinkDevice<PHY, ALS, NVM>
+{
+    /// Runs the device stack, never returns.
+    ///
+    /// Awaits the indications of the physical layer while no state machine has work
+    /// pending, so the executor can sleep between M-sequences. After a poll which left
+    /// work pending the task yields once, other tasks of the executor are not starved.
+    /// Errors of a single step are dropped like in a [`IoLinkDevice::poll`] loop, the
+    /// state machines recover on the next message of the Master.
+    pub async fn run(&mut self) -> ! {
+        loop {
+            let had_work = self.has_pending_work();
+            let _ = self.run_once().await;
+            if had_work && self.has_pending_work() {
+                pl::async_physical_layer::yield_now().await;
+            }
+        }
+    }
+
+    /// Awaits the next indication of the physical layer if no work is pending, then
+    /// polls the state machines once.
+    ///
+    /// For applications which run the stack from their own loop, e.g. in a `select`
+    /// with other futures. Dropping the future before it completed loses no indication
+    /// as [`AsyncPhysicalLayer::wait_ind`] is required to be cancel safe. No indication
+    /// is awaited while a compiled response waits to be sent. With `non_blocking_tx` a
+    /// response waiting for the TX buffer of the previous one is no pending work,
+    /// [`PlInd::TransferCnf`] is awaited instead of polling until the buffer is free.
+    ///
+    /// # Returns
+    ///
+    /// * `Ok(())` if the indication and the poll were processed successfully
+    /// * `Err(IoLinkError)` if an error occurred during processing
+    pub async fn run_once(&mut self) -> IoLinkResult<()> {
+        if !self.has_pending_work() && !self.data_link_layer.has_pending_work() {
+            match self.physical_layer.wait_ind().await {
+                PlInd::Transfer(length) => {
+                    self.pending_work.mark(PendingWork::DataLinkLayer);
+                    let rx_bytes = self.physical_layer.rx_buffer();
+                    let rx_bytes = &rx_bytes[..length.min(rx_bytes.len())];
+                    profile_scope!(
+                        ProfileId::PlTransferInd,
+                        self.data_link_layer
+                            .pl_transfer_ind_burst(&self.physical_layer, rx_bytes)
+                    )?;
+                }
+                PlInd::TimerElapsed(timer) => self.timer_elapsed(timer)?,
+                PlInd::WakeUp => self.pl_wake_up_ind()?,
+                #[cfg(feature = "non_blocking_tx")]
+                PlInd::TransferCnf => self.pl_transfer_cnf()?,
+            }
+        }
+        self.poll()
+    }
 }
 
 impl<
@@ -384,7 +875,8 @@ impl<
     ALS: al::services::ApplicationLayerServicesInd
         + handlers::sm::SystemManagementCnf
         + services::AlEventCnf,
-> al::ApplicationLayerReadWriteInd for IoLinkDevice<PHY, ALS>
+    NVM: storage::nvm::NvmBackend,
+> al::ApplicationLayerReadWriteInd for IoLinkDevice<PHY, ALS, NVM>
 {
     /// Handles read requests from the master for device parameters.
     ///
@@ -401,6 +893,7 @@ impl<
     /// - `Ok(())` if read request was processed successfully
     /// - `Err(IoLinkError)` if an error occurred
     fn al_read_ind(&mut self, index: u16, sub_index: u8) -> IoLinkResult<()> {
+        self.pending_work.mark(PendingWork::ApplicationLayer);
         self.application_layer.al_read_ind(index, sub_index)
     }
 
@@ -420,6 +913,7 @@ impl<
     /// - `Ok(())` if write request was processed successfully
     /// - `Err(IoLinkError)` if an error occurred
     fn al_write_ind(&mut self, index: u16, sub_index: u8, data: &[u8]) -> IoLinkResult<()> {
+        self.pending_work.mark(PendingWork::ApplicationLayer);
         self.application_layer.al_write_ind(index, sub_index, data)
     }
 
@@ -442,7 +936,8 @@ impl<
     ALS: al::services::ApplicationLayerServicesInd
         + handlers::sm::SystemManagementCnf
         + services::AlEventCnf,
-> IoLinkDevice<PHY, ALS>
+    NVM: storage::nvm::NvmBackend,
+> IoLinkDevice<PHY, ALS, NVM>
 {
     /// Sets the device communication parameters according to IO-Link SM_SetDeviceCom service.
     ///
@@ -472,6 +967,7 @@ impl<
     ///
     /// - IO-Link Specification, Table 89 – SM_SetDeviceCom
     pub fn sm_set_device_com_req(&mut self, device_com: &handlers::sm::DeviceCom) -> SmResult<()> {
+        self.pending_work.mark(PendingWork::SystemManagement);
         // Set the device communication parameters
         <system_management::SystemManagement as handlers::sm::SystemManagementReq<
             al::ApplicationLayer<ALS>,
@@ -507,6 +1003,7 @@ impl<
     ///
     /// - IO-Link Specification, Table 90 – SM_GetDeviceCom
     pub fn sm_get_device_com_req(&mut self) -> SmResult<()> {
+        self.pending_work.mark(PendingWork::SystemManagement);
         <system_management::SystemManagement as handlers::sm::SystemManagementReq<
             al::ApplicationLayer<ALS>,
         >>::sm_get_device_com_req(&mut self.system_management, &self.application_layer)?;
@@ -539,6 +1036,7 @@ impl<
     ///
     /// - IO-Link Specification, Table 91 – SM_SetDeviceIdent
     pub fn sm_set_device_ident_req(&mut self, device_ident: &page1::DeviceIdent) -> SmResult<()> {
+        self.pending_work.mark(PendingWork::SystemManagement);
         <system_management::SystemManagement as handlers::sm::SystemManagementReq<
             al::ApplicationLayer<ALS>,
         >>::sm_set_device_ident_req(&mut self.system_management, device_ident)?;
@@ -570,6 +1068,7 @@ impl<
     ///
     /// - IO-Link Specification, Table 92 – SM_GetDeviceIdent
     pub fn sm_get_device_ident_req(&mut self) -> SmResult<()> {
+        self.pending_work.mark(PendingWork::SystemManagement);
         <system_management::SystemManagement as handlers::sm::SystemManagementReq<
             al::ApplicationLayer<ALS>,
         >>::sm_get_device_ident_req(&mut self.system_management, &self.application_layer)?;
@@ -600,6 +1099,7 @@ impl<
     ///
     /// - IO-Link Specification, Table 93 – SM_SetDeviceMode
     pub fn sm_set_device_mode_req(&mut self, mode: DeviceMode) -> SmResult<()> {
+        self.pending_work.mark(PendingWork::SystemManagement);
         <system_management::SystemManagement as handlers::sm::SystemManagementReq<
             al::ApplicationLayer<ALS>,
         >>::sm_set_device_mode_req(&mut self.system_management, mode)?;
@@ -612,12 +1112,57 @@ impl<
     ALS: services::ApplicationLayerServicesInd
         + handlers::sm::SystemManagementCnf
         + services::AlEventCnf,
-> services::AlControlReq for IoLinkDevice<PHY, ALS>
+    NVM: storage::nvm::NvmBackend,
+> services::AlReadRsp for IoLinkDevice<PHY, ALS, NVM>
+{
+    /// Completes an AL_Read indicated through `ApplicationLayerServicesInd::al_read_ind`.
+    ///
+    /// The response may be given any number of polls after the indication, until then
+    /// the ISDU is answered "busy" and Process Data keeps being exchanged.
+    ///
+    /// # Returns
+    ///
+    /// - `Ok(())` if the response was accepted
+    /// - `Err(IoLinkError::InvalidEvent)` if no AL_Read is pending, e.g. it was aborted
+    fn al_read_rsp(&mut self, result: AlResult<(u8, &[u8])>) -> IoLinkResult<()> {
+        self.pending_work.mark(PendingWork::ApplicationLayer);
+        self.application_layer.al_read_rsp(result)
+    }
+}
+
+impl<
+    PHY: pl::physical_layer::PhysicalLayerReq,
+    ALS: services::ApplicationLayerServicesInd
+        + handlers::sm::SystemManagementCnf
+        + services::AlEventCnf,
+    NVM: storage::nvm::NvmBackend,
+> services::AlWriteRsp for IoLinkDevice<PHY, ALS, NVM>
+{
+    /// Completes an AL_Write indicated through `ApplicationLayerServicesInd::al_write_ind`.
+    ///
+    /// # Returns
+    ///
+    /// - `Ok(())` if the response was accepted
+    /// - `Err(IoLinkError::InvalidEvent)` if no AL_Write is pending, e.g. it was aborted
+    fn al_write_rsp(&mut self, result: AlResult<()>) -> IoLinkResult<()> {
+        self.pending_work.mark(PendingWork::ApplicationLayer);
+        self.application_layer.al_write_rsp(result)
+    }
+}
+
+impl<
+    PHY: pl::physical_layer::PhysicalLayerReq,
+    ALS: services::ApplicationLayerServicesInd
+        + handlers::sm::SystemManagementCnf
+        + services::AlEventCnf,
+    NVM: storage::nvm::NvmBackend,
+> services::AlControlReq for IoLinkDevice<PHY, ALS, NVM>
 {
     fn al_control_req(
         &mut self,
         control_code: handlers::command::DlControlCode,
     ) -> IoLinkResult<()> {
+        self.pending_work.mark(PendingWork::DataLinkLayer);
         let _ = self.data_link_layer.dl_control_req(control_code);
 
         Ok(())
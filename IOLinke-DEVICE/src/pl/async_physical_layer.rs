@@ -0,0 +1,90 @@
+//! Asynchronous Physical Layer interface for async executors (e.g. embassy, RTIC).
+//!
+//! With the synchronous [`PhysicalLayerReq`] the firmware forwards the indications of
+//! the hardware (received bytes, timer expiry, wake-up) from its interrupt handlers to
+//! the device and spins [`crate::IoLinkDevice::poll`] in a loop. With the `async`
+//! feature the physical layer implements [`AsyncPhysicalLayer`] instead, and
+//! [`crate::IoLinkDevice::run`] awaits the next indication whenever no state machine
+//! has work pending:
+//!
+//! - The executor can put the CPU to sleep between M-sequences.
+//! - Application tasks share the core cooperatively, `run` yields after every poll
+//!   which left work pending.
+//!
+//! The requests of the stack (`pl_transfer_req`, the timer requests) stay the
+//! synchronous ones of [`PhysicalLayerReq`]: they only hand the work to the hardware
+//! (start the TX DMA, arm a timer) and return, the completion comes back through
+//! [`AsyncPhysicalLayer::wait_ind`].
+
+use iolinke_types::handlers;
+
+use core::future::Future;
+use core::pin::Pin;
+use core::task::{Context, Poll};
+
+use crate::pl::physical_layer::PhysicalLayerReq;
+
+/// Indication of the physical layer, see [`AsyncPhysicalLayer::wait_ind`]
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub enum PlInd {
+    /// PL_Transfer.ind, the given number of octets received from the Master were
+    /// written to the start of [`AsyncPhysicalLayer::rx_buffer`]
+    Transfer(usize),
+    /// A timer started through [`PhysicalLayerReq::pl_start_timer_req`] elapsed
+    TimerElapsed(handlers::pl::Timer),
+    /// PL_WakeUp.ind, a wake-up request of the Master was detected
+    WakeUp,
+    /// The octets handed to [`PhysicalLayerReq::pl_transfer_req`] are sent
+    #[cfg(feature = "non_blocking_tx")]
+    TransferCnf,
+}
+
+/// Physical Layer which indicates the hardware events through a future.
+///
+/// # Specification Reference
+///
+/// - IO-Link v1.1.4 Section 5.2.2.2: PL_WakeUp
+/// - IO-Link v1.1.4 Section 5.2.2.3: PL_Transfer
+pub trait AsyncPhysicalLayer: PhysicalLayerReq {
+    /// Returns the receive buffer of the physical layer, e.g. the target of the UART
+    /// RX DMA. Holds the octets indicated by the last [`PlInd::Transfer`] until the
+    /// next call of [`Self::wait_ind`].
+    fn rx_buffer(&self) -> &[u8];
+
+    /// Waits for the next indication of the hardware.
+    ///
+    /// Received octets are written to [`Self::rx_buffer`] and indicated with
+    /// [`PlInd::Transfer`]. A Master message may be indicated in several parts.
+    ///
+    /// # Cancel safety
+    ///
+    /// The future may be dropped before it completes, e.g. by a `select` of the
+    /// application, and must be cancel safe: indications which arrived meanwhile are
+    /// kept for the next call. The receive buffer is owned by the physical layer, so a
+    /// DMA transfer still running when the future is dropped never writes to memory
+    /// which is gone.
+    fn wait_ind(&mut self) -> impl Future<Output = PlInd>;
+}
+
+/// Future of [`yield_now`]
+struct YieldNow {
+    yielded: bool,
+}
+
+impl Future for YieldNow {
+    type Output = ();
+
+    fn poll(mut self: Pin<&mut Self>, context: &mut Context<'_>) -> Poll<()> {
+        if self.yielded {
+            return Poll::Ready(());
+        }
+        self.yielded = true;
+        context.waker().wake_by_ref();
+        Poll::Pending
+    }
+}
+
+/// Returns to the executor once, so other tasks can run
+pub(crate) fn yield_now() -> impl Future<Output = ()> {
+    YieldNow { yielded: false }
+}
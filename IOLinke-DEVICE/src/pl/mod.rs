@@ -8,6 +8,8 @@
 //!
 //! - **Physical Layer**: Core physical layer operations and state management
 //! - **Hardware Abstraction Layer**: Platform-independent hardware interfaces
+//! - **Async Physical Layer**: Awaitable indications for async executors (`async` feature)
+//! - **Timer Service**: All timers of all ports on one hardware timer (`timer_service` feature)
 //!
 //! ## Specification Compliance
 //!
@@ -15,4 +17,8 @@
 //! - Section 5.3: C/Q Line Control and Timing
 //! - Annex A: Protocol Timing and Sequences
 
+#[cfg(feature = "async")]
+pub mod async_physical_layer;
 pub mod physical_layer;
+#[cfg(feature = "timer_service")]
+pub mod timer_service;
@@ -62,6 +62,27 @@ pub trait PhysicalLayerInd<PHY: PhysicalLayerReq> {
         Err(IoLinkError::NoImplFound)
     }
 
+    /// Handles a span of bytes received by the physical layer, e.g. a whole or a
+    /// partial Master message from a DMA UART reception.
+    ///
+    /// Must behave like calling [`PhysicalLayerInd::pl_transfer_ind`] for every byte
+    /// of the span. The default implementation does exactly that.
+    ///
+    /// # Parameters
+    ///
+    /// * `rx_bytes` - The received bytes in reception order
+    ///
+    /// # Returns
+    ///
+    /// - `Ok(())` if all bytes were processed successfully
+    /// - `Err(IoLinkError)` the error of the first byte which failed
+    fn pl_transfer_ind_burst(&mut self, physical_layer: &PHY, rx_bytes: &[u8]) -> IoLinkResult<()> {
+        for &rx_byte in rx_bytes {
+            self.pl_transfer_ind(physical_layer, rx_byte)?;
+        }
+        Ok(())
+    }
+
     /// Handles wake-up requests from the data link layer.
     ///
     /// This method is called when the data link layer needs to
@@ -329,6 +350,15 @@ pub trait PhysicalLayerReq {
     ///
     /// - IO-Link v1.1.4 Section 5.2.2.2: Data Transfer
     ///
+    /// # Non-blocking transfer
+    ///
+    /// With the `non_blocking_tx` feature the implementation may return as soon as the
+    /// transfer is started, e.g. by pointing the UART TX DMA at `tx_data`. The octets
+    /// stay valid and unchanged until the completion is indicated with
+    /// `IoLinkDevice::pl_transfer_cnf`, the device must not be moved meanwhile. Every
+    /// started transfer has to be confirmed, also an aborted one, the next response is
+    /// held back until then.
+    ///
     /// # Note
     ///
     /// This is a placeholder implementation that should be replaced
@@ -0,0 +1,178 @@
+//! Software timers of several device instances on one hardware timer.
+//!
+//! The stack requests its timers ([`Timer`]) through `pl_start_timer_req`,
+//! `pl_restart_timer_req` and `pl_stop_timer_req`. Instead of a hardware timer per
+//! timer and port, a physical layer can forward the requests to a [`TimerService`],
+//! which runs the timers of up to `PORTS` device instances off one free-running
+//! counter and one compare channel ([`TimerHardware`]):
+//!
+//! - A request stores the deadline of the timer, O(1). The compare channel is only
+//!   reprogrammed if the new deadline is earlier than the programmed one, so the
+//!   restart of `MaxUARTframeTime` on every received octet does not touch the hardware.
+//! - The compare interrupt calls [`TimerService::on_compare`], which indicates the
+//!   elapsed timers of all ports and programs the earliest remaining deadline. A
+//!   deadline moved to the future by a restart makes the compare fire early once.
+//!
+//! The counter runs in microseconds and wraps around, a timer may run for up to
+//! `i32::MAX` microseconds. The state is kept in atomics, which are loaded and stored
+//! only, so it works on ARMv6-M (Cortex-M0+) too. The requests and `on_compare` must not
+//! preempt each other, e.g. the UART and the compare interrupt have the same priority.
+
+use iolinke_types::handlers::pl::Timer;
+
+use core::iter::Iterator;
+use core::ops::FnMut;
+use core::option::{
+    Option,
+    Option::{None, Some},
+};
+use core::sync::atomic::{AtomicBool, AtomicU32, Ordering};
+
+/// Number of timers per port, see [`Timer`]
+pub const TIMER_COUNT: usize = 4;
+
+/// Timers in the order of their slots
+const TIMERS: [Timer; TIMER_COUNT] = [
+    Timer::Tdsio,
+    Timer::MaxCycleTime,
+    Timer::MaxUARTFrameTime,
+    Timer::MaxUARTframeTime,
+];
+
+/// Free-running counter with one compare channel
+pub trait TimerHardware {
+    /// Returns the counter value in microseconds, wraps around
+    fn now_us(&self) -> u32;
+
+    /// Raises the compare interrupt when the counter reaches `deadline_us`, as soon as
+    /// possible if it passed already
+    fn set_compare(&self, deadline_us: u32);
+
+    /// Disables the compare interrupt
+    fn disable_compare(&self);
+}
+
+/// Deadline of one timer
+struct TimerSlot {
+    /// `true` while the timer runs
+    armed: AtomicBool,
+    /// Counter value at which the timer elapses
+    deadline_us: AtomicU32,
+}
+
+impl TimerSlot {
+    const fn new() -> Self {
+        Self {
+            armed: AtomicBool::new(false),
+            deadline_us: AtomicU32::new(0),
+        }
+    }
+}
+
+/// Timers of `PORTS` device instances on one [`TimerHardware`]
+pub struct TimerService<HW: TimerHardware, const PORTS: usize> {
+    hardware: HW,
+    slots: [[TimerSlot; TIMER_COUNT]; PORTS],
+    /// `true` while the compare channel is programmed
+    compare_armed: AtomicBool,
+    /// Deadline programmed into the compare channel
+    compare_us: AtomicU32,
+}
+
+impl<HW: TimerHardware, const PORTS: usize> TimerService<HW, PORTS> {
+    /// Creates a service with all timers stopped
+    pub const fn new(hardware: HW) -> Self {
+        Self {
+            hardware,
+            slots: [const { [const { TimerSlot::new() }; TIMER_COUNT] }; PORTS],
+            compare_armed: AtomicBool::new(false),
+            compare_us: AtomicU32::new(0),
+        }
+    }
+
+    /// Returns `true` if `deadline_us` is reached at counter value `now_us`
+    const fn is_reached(deadline_us: u32, now_us: u32) -> bool {
+        now_us.wrapping_sub(deadline_us) as i32 >= 0
+    }
+
+    fn slot(&self, port: usize, timer: Timer) -> Option<&TimerSlot> {
+        let index = TIMERS.iter().position(|slot_timer| *slot_timer == timer)?;
+        Some(&self.slots.get(port)?[index])
+    }
+
+    /// Starts or restarts `timer` of `port`, it elapses after `duration_us`.
+    ///
+    /// # Returns
+    /// - `true` if the timer was started.
+    /// - `false` if `port` is out of range.
+    pub fn start(&self, port: usize, timer: Timer, duration_us: u32) -> bool {
+        let Some(slot) = self.slot(port, timer) else {
+            return false;
+        };
+        let deadline_us = self.hardware.now_us().wrapping_add(duration_us);
+        slot.deadline_us.store(deadline_us, Ordering::Relaxed);
+        slot.armed.store(true, Ordering::Release);
+        // A later deadline is picked up when the programmed compare fires
+        if !self.compare_armed.load(Ordering::Acquire)
+            || Self::is_reached(deadline_us, self.compare_us.load(Ordering::Relaxed))
+        {
+            self.program_compare(deadline_us);
+        }
+        true
+    }
+
+    /// Stops `timer` of `port`, the compare channel is left as it is
+    pub fn stop(&self, port: usize, timer: Timer) {
+        if let Some(slot) = self.slot(port, timer) {
+            slot.armed.store(false, Ordering::Release);
+        }
+    }
+
+    /// Returns `true` if `timer` of `port` runs
+    pub fn is_running(&self, port: usize, timer: Timer) -> bool {
+        self.slot(port, timer)
+            .is_some_and(|slot| slot.armed.load(Ordering::Acquire))
+    }
+
+    /// Handles the compare interrupt, calls `elapsed` with the port and timer of every
+    /// elapsed timer.
+    pub fn on_compare(&self, mut elapsed: impl FnMut(usize, Timer)) {
+        // The programmed deadline is reached, timers started by `elapsed` program a new one
+        self.compare_armed.store(false, Ordering::Release);
+        let now_us = self.hardware.now_us();
+        let mut next_deadline_us: Option<u32> = None;
+        for (port, slots) in self.slots.iter().enumerate() {
+            for (slot, timer) in slots.iter().zip(TIMERS) {
+                if !slot.armed.load(Ordering::Acquire) {
+                    continue;
+                }
+                let deadline_us = slot.deadline_us.load(Ordering::Relaxed);
+                if Self::is_reached(deadline_us, now_us) {
+                    slot.armed.store(false, Ordering::Release);
+                    elapsed(port, timer);
+                } else if next_deadline_us
+                    .is_none_or(|next_deadline_us| Self::is_reached(deadline_us, next_deadline_us))
+                {
+                    next_deadline_us = Some(deadline_us);
+                }
+            }
+        }
+        let compare_armed = self.compare_armed.load(Ordering::Acquire);
+        match next_deadline_us {
+            Some(deadline_us)
+                if !compare_armed
+                    || Self::is_reached(deadline_us, self.compare_us.load(Ordering::Relaxed)) =>
+            {
+                self.program_compare(deadline_us)
+            }
+            None if !compare_armed => self.hardware.disable_compare(),
+            _ => {}
+        }
+    }
+
+    fn program_compare(&self, deadline_us: u32) {
+        self.compare_us.store(deadline_us, Ordering::Relaxed);
+        self.compare_armed.store(true, Ordering::Release);
+        self.hardware.set_compare(deadline_us);
+    }
+}
@@ -0,0 +1,288 @@
+//! Cycle count instrumentation of the IO-Link Device Stack state machines.
+//!
+//! With the `profiling` feature enabled, the poll of every state machine (which runs
+//! its pending `execute_tN` transition), the poll of System Management and the
+//! byte reception path `pl_transfer_ind` are timed through a cycle counter hook.
+//! For every [`ProfileId`] the number of calls, the min/max/avg cycles and a histogram
+//! of the cycles in power of two buckets are kept.
+//!
+//! A state machine poll runs at most one `execute_tN` transition, so every sample of
+//! a handler is one transition or an idle poll. The samples are not told apart by
+//! transition, a slow transition shows up as a separate peak of the histogram. With
+//! the `trace` feature the trace ring records which transitions ran.
+//!
+//! Without the `profiling` feature the instrumentation compiles to nothing.
+//!
+//! ## Cycle counter
+//!
+//! The hook is registered with [`set_cycle_counter`] and must return a free running,
+//! wrapping 32 bit counter, e.g. the DWT `CYCCNT` register on Cortex-M.
+//! With the `std` feature and no hook registered, the nanoseconds of a monotonic
+//! `std::time::Instant` are used. Without either, all samples are 0.
+//!
+//! ## Concurrency
+//!
+//! Each [`ProfileId`] is only recorded from one context (`pl_transfer_ind` from the
+//! UART interrupt, all others from the poll loop), so the statistics only use atomic
+//! loads and stores. A reader may see a sample which is partially recorded.
+//! The statistics are shared by all devices of the firmware.
+
+/// Times `$body` and records it under `$id` when the `profiling` feature is enabled
+macro_rules! profile_scope {
+    ($id:expr, $body:expr) => {{
+        #[cfg(feature = "profiling")]
+        let profile_start = $crate::profiling::cycles();
+        let result = $body;
+        #[cfg(feature = "profiling")]
+        $crate::profiling::record($id, profile_start);
+        result
+    }};
+}
+pub(crate) use profile_scope;
+
+#[cfg(feature = "profiling")]
+pub use enabled::*;
+
+#[cfg(feature = "profiling")]
+mod enabled {
+    use core::option::{
+        Option,
+        Option::{None, Some},
+    };
+    use core::sync::atomic::{AtomicPtr, AtomicU32, Ordering};
+
+    /// Cycle counter hook, returns a free running wrapping 32 bit counter
+    pub type CycleCounter = extern "C" fn() -> u32;
+
+    /// Instrumented state machines and services
+    #[repr(C)]
+    #[derive(Debug, Clone, Copy, PartialEq, Eq)]
+    pub enum ProfileId {
+        /// `IoLinkDevice::poll`, all pending layers
+        DevicePoll = 0,
+        /// Byte reception, `pl_transfer_ind` / `pl_transfer_ind_burst`
+        PlTransferInd = 1,
+        /// DL Command handler poll
+        DlCommandHandler = 2,
+        /// DL-Mode handler poll
+        DlModeHandler = 3,
+        /// DL Event handler poll
+        DlEventHandler = 4,
+        /// DL Process Data handler poll
+        DlPdHandler = 5,
+        /// DL ISDU handler poll
+        DlIsduHandler = 6,
+        /// DL Message handler poll
+        DlMessageHandler = 7,
+        /// DL On-request Data handler poll
+        DlOdHandler = 8,
+        /// AL Event handler poll
+        AlEventHandler = 9,
+        /// AL On-request Data handler poll
+        AlOdHandler = 10,
+        /// Parameter Manager poll
+        AlParameterManager = 11,
+        /// Data Storage poll
+        AlDataStorage = 12,
+        /// System Management poll
+        SystemManagement = 13,
+    }
+
+    /// Number of [`ProfileId`] entries
+    pub const PROFILE_ID_COUNT: usize = 14;
+
+    /// Number of buckets of a [`ProfileHistogram`]
+    pub const PROFILE_HISTOGRAM_BUCKETS: usize = 16;
+
+    impl ProfileId {
+        /// Converts a raw index into a [`ProfileId`]
+        pub const fn from_index(index: u8) -> Option<Self> {
+            Some(match index {
+                0 => Self::DevicePoll,
+                1 => Self::PlTransferInd,
+                2 => Self::DlCommandHandler,
+                3 => Self::DlModeHandler,
+                4 => Self::DlEventHandler,
+                5 => Self::DlPdHandler,
+                6 => Self::DlIsduHandler,
+                7 => Self::DlMessageHandler,
+                8 => Self::DlOdHandler,
+                9 => Self::AlEventHandler,
+                10 => Self::AlOdHandler,
+                11 => Self::AlParameterManager,
+                12 => Self::AlDataStorage,
+                13 => Self::SystemManagement,
+                _ => return None,
+            })
+        }
+    }
+
+    /// Statistics of one [`ProfileId`], all values in cycle counter ticks
+    #[repr(C)]
+    #[derive(Debug, Clone, Copy, PartialEq, Eq, Default)]
+    pub struct ProfileStats {
+        /// Number of recorded samples
+        pub count: u32,
+        /// Shortest sample, 0 if no sample is recorded
+        pub min: u32,
+        /// Longest sample
+        pub max: u32,
+        /// Average of all samples
+        pub avg: u32,
+    }
+
+    /// Histogram of the samples of one [`ProfileId`]
+    ///
+    /// Bucket 0 counts the samples of 0 ticks, bucket n the samples of 2^(n-1) to
+    /// 2^n - 1 ticks. The last bucket also counts all longer samples.
+    #[repr(C)]
+    #[derive(Debug, Clone, Copy, PartialEq, Eq, Default)]
+    pub struct ProfileHistogram {
+        /// Number of samples per bucket
+        pub buckets: [u32; PROFILE_HISTOGRAM_BUCKETS],
+    }
+
+    /// Running statistics of one [`ProfileId`]
+    struct ProfileSlot {
+        count: AtomicU32,
+        min: AtomicU32,
+        max: AtomicU32,
+        /// Sum of all samples, low and high word
+        total_low: AtomicU32,
+        total_high: AtomicU32,
+        histogram: [AtomicU32; PROFILE_HISTOGRAM_BUCKETS],
+    }
+
+    impl ProfileSlot {
+        const fn new() -> Self {
+            Self {
+                count: AtomicU32::new(0),
+                min: AtomicU32::new(u32::MAX),
+                max: AtomicU32::new(0),
+                total_low: AtomicU32::new(0),
+                total_high: AtomicU32::new(0),
+                histogram: [const { AtomicU32::new(0) }; PROFILE_HISTOGRAM_BUCKETS],
+            }
+        }
+
+        fn record(&self, sample: u32) {
+            let count = self.count.load(Ordering::Relaxed);
+            if count == u32::MAX {
+                return;
+            }
+            if sample < self.min.load(Ordering::Relaxed) {
+                self.min.store(sample, Ordering::Relaxed);
+            }
+            if sample > self.max.load(Ordering::Relaxed) {
+                self.max.store(sample, Ordering::Relaxed);
+            }
+            let total = self.total() + sample as u64;
+            self.total_low.store(total as u32, Ordering::Relaxed);
+            self.total_high.store((total >> 32) as u32, Ordering::Relaxed);
+            let bucket = &self.histogram[Self::bucket(sample)];
+            bucket.store(bucket.load(Ordering::Relaxed) + 1, Ordering::Relaxed);
+            self.count.store(count + 1, Ordering::Release);
+        }
+
+        /// Returns the histogram bucket of `sample`, the number of its significant bits
+        fn bucket(sample: u32) -> usize {
+            ((u32::BITS - sample.leading_zeros()) as usize).min(PROFILE_HISTOGRAM_BUCKETS - 1)
+        }
+
+        fn total(&self) -> u64 {
+            (self.total_high.load(Ordering::Relaxed) as u64) << 32
+                | self.total_low.load(Ordering::Relaxed) as u64
+        }
+
+        fn stats(&self) -> ProfileStats {
+            let count = self.count.load(Ordering::Acquire);
+            if count == 0 {
+                return ProfileStats::default();
+            }
+            ProfileStats {
+                count,
+                min: self.min.load(Ordering::Relaxed),
+                max: self.max.load(Ordering::Relaxed),
+                avg: (self.total() / count as u64) as u32,
+            }
+        }
+
+        fn histogram(&self) -> ProfileHistogram {
+            ProfileHistogram {
+                buckets: core::array::from_fn(|i| self.histogram[i].load(Ordering::Relaxed)),
+            }
+        }
+
+        fn reset(&self) {
+            self.count.store(0, Ordering::Release);
+            self.min.store(u32::MAX, Ordering::Relaxed);
+            self.max.store(0, Ordering::Relaxed);
+            self.total_low.store(0, Ordering::Relaxed);
+            self.total_high.store(0, Ordering::Relaxed);
+            for bucket in &self.histogram {
+                bucket.store(0, Ordering::Relaxed);
+            }
+        }
+    }
+
+    static CYCLE_COUNTER: AtomicPtr<()> = AtomicPtr::new(core::ptr::null_mut());
+
+    static PROFILE: [ProfileSlot; PROFILE_ID_COUNT] =
+        [const { ProfileSlot::new() }; PROFILE_ID_COUNT];
+
+    /// Registers the cycle counter hook used to time the state machines
+    ///
+    /// # Example
+    ///
+    /// ```ignore
+    /// extern "C" fn read_cyccnt() -> u32 {
+    ///     cortex_m::peripheral::DWT::cycle_count()
+    /// }
+    /// iolinke_device::profiling::set_cycle_counter(read_cyccnt);
+    /// ```
+    pub fn set_cycle_counter(counter: CycleCounter) {
+        CYCLE_COUNTER.store(counter as *mut (), Ordering::Release);
+    }
+
+    /// Returns the current value of the cycle counter
+    pub fn cycles() -> u32 {
+        let counter = CYCLE_COUNTER.load(Ordering::Acquire);
+        if !counter.is_null() {
+            // SAFETY: Only `CycleCounter` function pointers are stored in `CYCLE_COUNTER`
+            let counter = unsafe { core::mem::transmute::<*mut (), CycleCounter>(counter) };
+            return counter();
+        }
+        default_cycles()
+    }
+
+    #[cfg(feature = "std")]
+    fn default_cycles() -> u32 {
+        static START: std::sync::OnceLock<std::time::Instant> = std::sync::OnceLock::new();
+        START.get_or_init(std::time::Instant::now).elapsed().as_nanos() as u32
+    }
+
+    #[cfg(not(feature = "std"))]
+    fn default_cycles() -> u32 {
+        0
+    }
+
+    /// Records the cycles elapsed since `start` under `id`
+    pub fn record(id: ProfileId, start: u32) {
+        PROFILE[id as usize].record(cycles().wrapping_sub(start));
+    }
+
+    /// Returns the statistics recorded for `id`
+    pub fn stats(id: ProfileId) -> ProfileStats {
+        PROFILE[id as usize].stats()
+    }
+
+    /// Returns the histogram recorded for `id`
+    pub fn histogram(id: ProfileId) -> ProfileHistogram {
+        PROFILE[id as usize].histogram()
+    }
+
+    /// Clears the statistics of all [`ProfileId`] entries
+    pub fn reset() {
+        PROFILE.iter().for_each(ProfileSlot::reset);
+    }
+}
@@ -0,0 +1,107 @@
+//! Pending work scheduler for the IO-Link Device Stack.
+//!
+//! Instead of polling every state machine on every call, each service entry point
+//! (`pl_transfer_ind`, `timer_elapsed`, `al_set_input_req`, ...) marks the layer it
+//! affects as pending. [`crate::IoLinkDevice::poll`] then only polls the marked layers
+//! and re-marks the layers which still have a transition pending afterwards.
+//!
+//! The mask can be marked from an interrupt and queried from the main loop on every
+//! target. Targets without read-modify-write atomics, e.g. ARMv6-M (Cortex-M0+), take
+//! a flag with a load and a store, see [`PendingWorkMask::take`].
+//! Firmware can check [`PendingWorkMask::has_pending_work`] and sleep (e.g. `WFI`)
+//! until the next interrupt when nothing is pending.
+
+#[cfg(not(target_has_atomic = "8"))]
+use core::sync::atomic::compiler_fence;
+use core::sync::atomic::{AtomicBool, Ordering};
+
+/// Layers of the device stack which can be scheduled independently
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub enum PendingWork {
+    /// Application Layer state machines
+    ApplicationLayer = 0,
+    /// Data Link Layer state machines
+    DataLinkLayer = 1,
+    /// System Management state machine
+    SystemManagement = 2,
+    /// Non-volatile parameter journal
+    ParameterStorage = 3,
+}
+
+/// Number of independently scheduled layers
+const PENDING_WORK_COUNT: usize = 4;
+
+/// Per-device pending work mask
+///
+/// One flag per [`PendingWork`] layer. The flags are separate atomic booleans instead
+/// of a single atomic bitmask, so a layer is taken with one swap where read-modify-write
+/// atomics are available and with a load and a store where they are not.
+pub struct PendingWorkMask {
+    pending: [AtomicBool; PENDING_WORK_COUNT],
+}
+
+impl PendingWorkMask {
+    /// Creates a new mask with all layers pending, so the first poll runs the whole stack
+    pub const fn new() -> Self {
+        Self {
+            pending: [
+                AtomicBool::new(true),
+                AtomicBool::new(true),
+                AtomicBool::new(true),
+                AtomicBool::new(true),
+            ],
+        }
+    }
+
+    /// Marks `work` as pending for the next poll
+    pub fn mark(&self, work: PendingWork) {
+        self.pending[work as usize].store(true, Ordering::Release);
+    }
+
+    /// Clears and returns the pending flag of `work`.
+    ///
+    /// The flag is cleared before the work is done, so a mark arriving while the
+    /// layer is polled is kept for the next poll.
+    ///
+    /// Without read-modify-write atomics the flag is cleared by a store after the load.
+    /// A mark from an interrupt between the two is merged into this take: it precedes
+    /// the poll of the layer, which runs on the same core and sees the work marked.
+    /// Marking from another core is only supported with read-modify-write atomics.
+    pub fn take(&self, work: PendingWork) -> bool {
+        let flag = &self.pending[work as usize];
+        #[cfg(target_has_atomic = "8")]
+        return flag.swap(false, Ordering::AcqRel);
+        #[cfg(not(target_has_atomic = "8"))]
+        if flag.load(Ordering::Acquire) {
+            flag.store(false, Ordering::Release);
+            // Keep the poll of the layer after the store
+            compiler_fence(Ordering::SeqCst);
+            true
+        } else {
+            false
+        }
+    }
+
+    /// Returns `true` if any layer is pending
+    pub fn has_pending_work(&self) -> bool {
+        self.pending
+            .iter()
+            .any(|flag| flag.load(Ordering::Acquire))
+    }
+
+    /// Returns the pending layers as a bitmask, bit n set for `PendingWork` n
+    pub fn bits(&self) -> u8 {
+        self.pending
+            .iter()
+            .enumerate()
+            .fold(0, |bits, (i, flag)| {
+                bits | ((flag.load(Ordering::Acquire) as u8) << i)
+            })
+    }
+}
+
+impl core::default::Default for PendingWorkMask {
+    fn default() -> Self {
+        Self::new()
+    }
+}
@@ -0,0 +1,601 @@
+//! Lock-free mailbox between the Data Link Layer and the Application Layer.
+//!
+//! Every service one layer calls on the other is queued as a message in a
+//! [`SpscRing`], the other side delivers it with its next poll. Each ring has exactly one
+//! producer and one consumer, so neither side disables interrupts or takes a lock:
+//!
+//! | Direction | Services | Queue |
+//! |-----------|----------|-------|
+//! | DL → AL | DL_Control, DL_ReadParam, DL_WriteParam, DL_ISDUAbort, DL_EventTrigger confirmation, SM_DeviceMode, SM confirmations | [`AL_MESSAGE_COUNT`] messages |
+//! | DL → AL | DL_ISDUTransport | [`ISDU_REQUEST_COUNT`] ISDUs |
+//! | DL → AL | DL_PDOutputTransport | latest output Process Data |
+//! | AL → DL | DL_ReadParam, DL_WriteParam, DL_ISDUTransport error responses, DL_Event, DL_EventTrigger, DL_Control | [`DL_MESSAGE_COUNT`] messages |
+//! | AL → DL | DL_ISDUTransport read response | one ISDU |
+//! | AL → DL | DL_PDInputUpdate | latest input Process Data |
+//!
+//! Process Data is not queued, a [`DoubleBuffer`] holds the latest value and a counter
+//! tells the consumer that a new value was written. A side which falls behind skips the
+//! stale Process Data instead of overflowing the mailbox.
+//!
+//! A service whose queue is full fails with `IoLinkError::BufferOverflow`, the message is
+//! dropped and counted in the overflow counter of the ring.
+
+use heapless::Vec;
+use iolinke_types::{
+    custom::{IoLinkError, IoLinkResult},
+    frame::msequence::RwDirection,
+    handlers::{
+        self,
+        command::DlControlCode,
+        isdu::MAX_ISDU_LENGTH,
+        sm::{DeviceCom, DeviceMode, SmResult},
+    },
+    page::page1::DeviceIdent,
+};
+use iolinke_util::{double_buffer::DoubleBuffer, spsc_ring::SpscRing};
+
+use core::clone::Clone;
+use core::default::Default;
+use core::marker::Copy;
+use core::option::{
+    Option,
+    Option::{None, Some},
+};
+use core::result::Result::{Err, Ok};
+use core::sync::atomic::{AtomicU32, Ordering};
+
+use crate::dl::{self, PD_INPUT_LENGTH, PD_OUTPUT_LENGTH};
+use crate::storage::event_memory::EVENT_ENTRY_SIZE;
+
+/// Number of queued indications of the Data Link Layer and System Management
+pub const AL_MESSAGE_COUNT: usize = 8;
+
+/// Number of queued requests of the Application Layer
+pub const DL_MESSAGE_COUNT: usize = 8;
+
+/// Number of queued DL_ISDUTransport indications, the ISDU in transfer and the next one
+/// after a DL_ISDUAbort
+pub const ISDU_REQUEST_COUNT: usize = 2;
+
+/// Indication of the Data Link Layer or System Management to the Application Layer
+#[derive(Debug, Clone, Copy)]
+enum AlMessage {
+    ControlInd(DlControlCode),
+    ReadParamInd(u8),
+    WriteParamInd(u8, u8),
+    IsduAbort,
+    EventTriggerCnf,
+    /// The ISDU is the next one of `isdu_requests`
+    IsduTransportInd,
+    PdCycleInd,
+    DeviceModeInd(DeviceMode),
+    SetDeviceComCnf(SmResult<()>),
+    GetDeviceComCnf(SmResult<DeviceCom>),
+    SetDeviceIdentCnf(SmResult<()>),
+    GetDeviceIdentCnf(SmResult<DeviceIdent>),
+    SetDeviceModeCnf(SmResult<()>),
+}
+
+/// Request of the Application Layer to the Data Link Layer
+#[derive(Debug, Clone, Copy)]
+enum DlMessage {
+    ReadParamRsp(u8, u8),
+    WriteParamRsp,
+    /// The data is the next one of `isdu_responses`
+    IsduReadRsp,
+    IsduWriteRsp,
+    IsduReadErrorRsp(u8, u8),
+    IsduWriteErrorRsp(u8, u8),
+    EventEntryReq([u8; EVENT_ENTRY_SIZE]),
+    EventTriggerReq,
+    ControlReq(DlControlCode),
+}
+
+/// ISDU with its data in a fixed size buffer, so it can be queued
+#[derive(Debug, Clone, Copy)]
+struct IsduBuffer {
+    index: u16,
+    sub_index: u8,
+    direction: RwDirection,
+    length: u8,
+    data: [u8; MAX_ISDU_LENGTH],
+}
+
+impl IsduBuffer {
+    fn new(index: u16, sub_index: u8, direction: RwDirection, data: &[u8]) -> Self {
+        let length = data.len().min(MAX_ISDU_LENGTH);
+        let mut buffer = Self {
+            index,
+            sub_index,
+            direction,
+            length: length as u8,
+            data: [0; MAX_ISDU_LENGTH],
+        };
+        buffer.data[..length].copy_from_slice(&data[..length]);
+        buffer
+    }
+
+    fn data(&self) -> &[u8] {
+        &self.data[..self.length as usize]
+    }
+}
+
+/// Latest value of one direction of the Process Data
+struct ProcessDataMailbox<const N: usize> {
+    buffer: DoubleBuffer<N>,
+    /// Number of values written, written only by the producer
+    written: AtomicU32,
+    /// Value of `written` at the last delivery, written only by the consumer
+    delivered: AtomicU32,
+}
+
+impl<const N: usize> ProcessDataMailbox<N> {
+    const fn new() -> Self {
+        Self {
+            buffer: DoubleBuffer::new(),
+            written: AtomicU32::new(0),
+            delivered: AtomicU32::new(0),
+        }
+    }
+
+    /// Publishes `data`, producer side
+    fn write(&self, data: &[u8]) -> IoLinkResult<()> {
+        if !self.buffer.write(data) {
+            return Err(IoLinkError::DeviceNotReady);
+        }
+        let written = self.written.load(Ordering::Relaxed);
+        self.written
+            .store(written.wrapping_add(1), Ordering::Release);
+        Ok(())
+    }
+
+    fn has_new_value(&self) -> bool {
+        self.written.load(Ordering::Acquire) != self.delivered.load(Ordering::Relaxed)
+    }
+
+    /// Returns a copy of the latest value if it was not delivered yet, consumer side.
+    ///
+    /// The value is copied out before it is handed to the other layer, so the producer
+    /// can publish the next value while the consumer still processes this one.
+    fn take(&self) -> Option<[u8; N]> {
+        let written = self.written.load(Ordering::Acquire);
+        if written == self.delivered.load(Ordering::Relaxed) {
+            return None;
+        }
+        self.delivered.store(written, Ordering::Relaxed);
+        Some(self.buffer.read(|data| *data))
+    }
+}
+
+/// Mailbox shared by a [`DataLinkSide`] and an [`ApplicationSide`].
+///
+/// Lives as long as both sides, usually in a `static`:
+///
+/// ```ignore
+/// static MAILBOX: LayerMailbox = LayerMailbox::new();
+/// ```
+///
+/// [`DataLinkSide`]: crate::split::DataLinkSide
+/// [`ApplicationSide`]: crate::split::ApplicationSide
+pub struct LayerMailbox {
+    al_messages: SpscRing<AlMessage, AL_MESSAGE_COUNT>,
+    isdu_requests: SpscRing<IsduBuffer, ISDU_REQUEST_COUNT>,
+    pd_out: ProcessDataMailbox<PD_OUTPUT_LENGTH>,
+    dl_messages: SpscRing<DlMessage, DL_MESSAGE_COUNT>,
+    isdu_responses: SpscRing<IsduBuffer, 1>,
+    pd_in: ProcessDataMailbox<PD_INPUT_LENGTH>,
+    /// Last `master_cycle_count` of the Data Link Layer
+    master_cycle_count: AtomicU32,
+}
+
+impl LayerMailbox {
+    /// Creates a new, empty mailbox
+    pub const fn new() -> Self {
+        Self {
+            al_messages: SpscRing::new(),
+            isdu_requests: SpscRing::new(),
+            pd_out: ProcessDataMailbox::new(),
+            dl_messages: SpscRing::new(),
+            isdu_responses: SpscRing::new(),
+            pd_in: ProcessDataMailbox::new(),
+            master_cycle_count: AtomicU32::new(0),
+        }
+    }
+
+    /// Returns `true` if the Application Layer has messages to deliver, e.g. to wake up
+    /// the task of the [`ApplicationSide`] after a poll of the [`DataLinkSide`]
+    ///
+    /// [`DataLinkSide`]: crate::split::DataLinkSide
+    /// [`ApplicationSide`]: crate::split::ApplicationSide
+    pub fn has_application_layer_messages(&self) -> bool {
+        !self.al_messages.is_empty() || self.pd_out.has_new_value()
+    }
+
+    /// Returns `true` if the Data Link Layer has messages to deliver
+    pub fn has_data_link_layer_messages(&self) -> bool {
+        !self.dl_messages.is_empty() || self.pd_in.has_new_value()
+    }
+
+    /// Returns the number of messages dropped because a queue was full, wraps around
+    pub fn overflow_count(&self) -> u32 {
+        self.al_messages
+            .overflow_count()
+            .wrapping_add(self.isdu_requests.overflow_count())
+            .wrapping_add(self.dl_messages.overflow_count())
+            .wrapping_add(self.isdu_responses.overflow_count())
+    }
+
+    fn push_al(&self, message: AlMessage) -> IoLinkResult<()> {
+        if self.al_messages.push(message) {
+            Ok(())
+        } else {
+            Err(IoLinkError::BufferOverflow)
+        }
+    }
+
+    fn push_dl(&self, message: DlMessage) -> IoLinkResult<()> {
+        if self.dl_messages.push(message) {
+            Ok(())
+        } else {
+            Err(IoLinkError::BufferOverflow)
+        }
+    }
+
+    /// Queues `isdu` into `isdus` and the `message` which refers to it into `messages`.
+    ///
+    /// The ISDU is only queued if the message has room as well, so a full message queue
+    /// never leaves an ISDU behind that a later message would pick up. The room seen by
+    /// the producer can only grow until it pushes, the consumer never takes it away.
+    fn push_with_isdu<M: Copy, const M_N: usize, const I_N: usize>(
+        messages: &SpscRing<M, M_N>,
+        message: M,
+        isdus: &SpscRing<IsduBuffer, I_N>,
+        isdu: IsduBuffer,
+    ) -> IoLinkResult<()> {
+        if messages.len() == messages.capacity() {
+            // Dropped and counted by the message queue
+            let _ = messages.push(message);
+            return Err(IoLinkError::BufferOverflow);
+        }
+        if !isdus.push(isdu) || !messages.push(message) {
+            return Err(IoLinkError::BufferOverflow);
+        }
+        Ok(())
+    }
+
+    /// Delivers the queued indications to `application_layer`, Application Layer side.
+    ///
+    /// # Returns
+    /// `true` if anything was delivered
+    pub(crate) fn deliver_to_application_layer<AL: dl::ApplicationLayerInd>(
+        &self,
+        application_layer: &mut AL,
+    ) -> bool {
+        let mut delivered = false;
+        while let Some(message) = self.al_messages.pop() {
+            delivered = true;
+            let _ = match message {
+                AlMessage::ControlInd(control_code) => {
+                    application_layer.dl_control_ind(control_code)
+                }
+                AlMessage::ReadParamInd(address) => application_layer.dl_read_param_ind(address),
+                AlMessage::WriteParamInd(address, data) => {
+                    application_layer.dl_write_param_ind(address, data)
+                }
+                AlMessage::IsduAbort => application_layer.dl_isdu_abort(),
+                AlMessage::EventTriggerCnf => application_layer.event_trigger_conf(),
+                AlMessage::IsduTransportInd => match self.isdu_requests.pop() {
+                    Some(isdu) => {
+                        let mut data = Vec::new();
+                        let _ = data.extend_from_slice(isdu.data());
+                        application_layer.dl_isdu_transport_ind(dl::IsduMessage {
+                            index: isdu.index,
+                            sub_index: isdu.sub_index,
+                            data,
+                            direction: isdu.direction,
+                        })
+                    }
+                    None => Err(IoLinkError::InvalidData),
+                },
+                AlMessage::PdCycleInd => application_layer.dl_pd_cycle_ind(),
+                AlMessage::DeviceModeInd(mode) => {
+                    let _ = application_layer.sm_device_mode_ind(mode);
+                    Ok(())
+                }
+                AlMessage::SetDeviceComCnf(result) => {
+                    let _ = application_layer.sm_set_device_com_cnf(result);
+                    Ok(())
+                }
+                AlMessage::GetDeviceComCnf(result) => {
+                    let _ =
+                        application_layer.sm_get_device_com_cnf(result.as_ref().map_err(|e| *e));
+                    Ok(())
+                }
+                AlMessage::SetDeviceIdentCnf(result) => {
+                    let _ = application_layer.sm_set_device_ident_cnf(result);
+                    Ok(())
+                }
+                AlMessage::GetDeviceIdentCnf(result) => {
+                    let _ =
+                        application_layer.sm_get_device_ident_cnf(result.as_ref().map_err(|e| *e));
+                    Ok(())
+                }
+                AlMessage::SetDeviceModeCnf(result) => {
+                    let _ = application_layer.sm_set_device_mode_cnf(result);
+                    Ok(())
+                }
+            };
+        }
+        if let Some(pd_out) = self.pd_out.take() {
+            delivered = true;
+            let mut data = Vec::new();
+            let _ = data.extend_from_slice(&pd_out);
+            let _ = application_layer.dl_pd_output_transport_ind(&data);
+        }
+        delivered
+    }
+
+    /// Delivers the queued requests to `data_link_layer`, Data Link Layer side.
+    ///
+    /// # Returns
+    /// `true` if anything was delivered
+    pub(crate) fn deliver_to_data_link_layer(
+        &self,
+        data_link_layer: &mut dl::DataLinkLayer,
+    ) -> bool {
+        use handlers::command::DlControlReq;
+        use handlers::event::DlEventReq;
+        use handlers::isdu::DlIsduTransportRsp;
+        use handlers::od::DlParamRsp;
+        use handlers::pd::DlPDInputUpdate;
+
+        let mut delivered = false;
+        while let Some(message) = self.dl_messages.pop() {
+            delivered = true;
+            let _ = match message {
+                DlMessage::ReadParamRsp(length, data) => {
+                    data_link_layer.dl_read_param_rsp(length, data)
+                }
+                DlMessage::WriteParamRsp => data_link_layer.dl_write_param_rsp(),
+                DlMessage::IsduReadRsp => match self.isdu_responses.pop() {
+                    Some(isdu) => {
+                        data_link_layer.dl_isdu_transport_read_rsp(isdu.length, isdu.data())
+                    }
+                    None => Err(IoLinkError::InvalidData),
+                },
+                DlMessage::IsduWriteRsp => data_link_layer.dl_isdu_transport_write_rsp(),
+                DlMessage::IsduReadErrorRsp(error, additional_error) => {
+                    data_link_layer.dl_isdu_transport_read_error_rsp(error, additional_error)
+                }
+                DlMessage::IsduWriteErrorRsp(error, additional_error) => {
+                    data_link_layer.dl_isdu_transport_write_error_rsp(error, additional_error)
+                }
+                DlMessage::EventEntryReq(entry) => data_link_layer.dl_event_entry_req(&entry),
+                DlMessage::EventTriggerReq => data_link_layer.dl_event_trigger_req(),
+                DlMessage::ControlReq(control_code) => data_link_layer.dl_control_req(control_code),
+            };
+        }
+        if let Some(pd_in) = self.pd_in.take() {
+            delivered = true;
+            let _ = data_link_layer.dl_pd_input_update_req(PD_INPUT_LENGTH as u8, &pd_in);
+        }
+        self.master_cycle_count
+            .store(data_link_layer.master_cycle_count(), Ordering::Relaxed);
+        delivered
+    }
+}
+
+impl Default for LayerMailbox {
+    fn default() -> Self {
+        Self::new()
+    }
+}
+
+/// The Application Layer as seen by the Data Link Layer, queues the indications
+pub(crate) struct AlEndpoint<'a> {
+    mailbox: &'a LayerMailbox,
+}
+
+impl<'a> AlEndpoint<'a> {
+    pub(crate) const fn new(mailbox: &'a LayerMailbox) -> Self {
+        Self { mailbox }
+    }
+
+    pub(crate) fn mailbox(&self) -> &'a LayerMailbox {
+        self.mailbox
+    }
+}
+
+impl dl::DlControlInd for AlEndpoint<'_> {
+    fn dl_control_ind(&mut self, control_code: DlControlCode) -> IoLinkResult<()> {
+        self.mailbox.push_al(AlMessage::ControlInd(control_code))
+    }
+}
+
+impl dl::DlReadParamInd for AlEndpoint<'_> {
+    fn dl_read_param_ind(&mut self, address: u8) -> IoLinkResult<()> {
+        self.mailbox.push_al(AlMessage::ReadParamInd(address))
+    }
+}
+
+impl dl::DlWriteParamInd for AlEndpoint<'_> {
+    fn dl_write_param_ind(&mut self, index: u8, data: u8) -> IoLinkResult<()> {
+        self.mailbox.push_al(AlMessage::WriteParamInd(index, data))
+    }
+}
+
+impl dl::DlIsduAbort for AlEndpoint<'_> {
+    fn dl_isdu_abort(&mut self) -> IoLinkResult<()> {
+        self.mailbox.push_al(AlMessage::IsduAbort)
+    }
+}
+
+impl dl::DlEventTriggerConf for AlEndpoint<'_> {
+    fn event_trigger_conf(&mut self) -> IoLinkResult<()> {
+        self.mailbox.push_al(AlMessage::EventTriggerCnf)
+    }
+}
+
+impl dl::DlIsduTransportInd for AlEndpoint<'_> {
+    fn dl_isdu_transport_ind(&mut self, isdu: dl::IsduMessage) -> IoLinkResult<()> {
+        let buffer = IsduBuffer::new(isdu.index, isdu.sub_index, isdu.direction, &isdu.data);
+        LayerMailbox::push_with_isdu(
+            &self.mailbox.al_messages,
+            AlMessage::IsduTransportInd,
+            &self.mailbox.isdu_requests,
+            buffer,
+        )
+    }
+}
+
+impl dl::DlPDOutputTransportInd for AlEndpoint<'_> {
+    fn dl_pd_output_transport_ind(
+        &mut self,
+        pd_out: &Vec<u8, PD_OUTPUT_LENGTH>,
+    ) -> IoLinkResult<()> {
+        self.mailbox.pd_out.write(pd_out)
+    }
+
+    fn dl_pd_cycle_ind(&mut self) -> IoLinkResult<()> {
+        self.mailbox.push_al(AlMessage::PdCycleInd)
+    }
+}
+
+impl handlers::sm::SystemManagementInd for AlEndpoint<'_> {
+    fn sm_device_mode_ind(&mut self, mode: DeviceMode) -> SmResult<()> {
+        let _ = self.mailbox.push_al(AlMessage::DeviceModeInd(mode));
+        Ok(())
+    }
+}
+
+impl handlers::sm::SystemManagementCnf for AlEndpoint<'_> {
+    fn sm_set_device_com_cnf(&self, result: SmResult<()>) -> SmResult<()> {
+        let _ = self.mailbox.push_al(AlMessage::SetDeviceComCnf(result));
+        Ok(())
+    }
+
+    fn sm_get_device_com_cnf(&self, result: SmResult<&DeviceCom>) -> SmResult<()> {
+        let result = result.map(|device_com| *device_com);
+        let _ = self.mailbox.push_al(AlMessage::GetDeviceComCnf(result));
+        Ok(())
+    }
+
+    fn sm_set_device_ident_cnf(&self, result: SmResult<()>) -> SmResult<()> {
+        let _ = self.mailbox.push_al(AlMessage::SetDeviceIdentCnf(result));
+        Ok(())
+    }
+
+    fn sm_get_device_ident_cnf(&self, result: SmResult<&DeviceIdent>) -> SmResult<()> {
+        let result = result.map(|device_ident| *device_ident);
+        let _ = self.mailbox.push_al(AlMessage::GetDeviceIdentCnf(result));
+        Ok(())
+    }
+
+    fn sm_set_device_mode_cnf(&self, result: SmResult<()>) -> SmResult<()> {
+        let _ = self.mailbox.push_al(AlMessage::SetDeviceModeCnf(result));
+        Ok(())
+    }
+}
+
+/// The Data Link Layer as seen by the Application Layer, queues the requests
+pub(crate) struct DlEndpoint<'a> {
+    mailbox: &'a LayerMailbox,
+}
+
+impl<'a> DlEndpoint<'a> {
+    pub(crate) const fn new(mailbox: &'a LayerMailbox) -> Self {
+        Self { mailbox }
+    }
+
+    pub(crate) fn mailbox(&self) -> &'a LayerMailbox {
+        self.mailbox
+    }
+
+    /// DL_Control requested by the device application
+    pub(crate) fn dl_control_req(&self, control_code: DlControlCode) -> IoLinkResult<()> {
+        self.mailbox.push_dl(DlMessage::ControlReq(control_code))
+    }
+}
+
+impl dl::DlParamRsp for DlEndpoint<'_> {
+    fn dl_read_param_rsp(&mut self, length: u8, data: u8) -> IoLinkResult<()> {
+        self.mailbox.push_dl(DlMessage::ReadParamRsp(length, data))
+    }
+
+    fn dl_write_param_rsp(&mut self) -> IoLinkResult<()> {
+        self.mailbox.push_dl(DlMessage::WriteParamRsp)
+    }
+}
+
+impl dl::DlIsduTransportRsp for DlEndpoint<'_> {
+    fn dl_isdu_transport_read_rsp(&mut self, length: u8, data: &[u8]) -> IoLinkResult<()> {
+        let length = (length as usize).min(data.len());
+        let buffer = IsduBuffer::new(0, 0, RwDirection::Read, &data[..length]);
+        LayerMailbox::push_with_isdu(
+            &self.mailbox.dl_messages,
+            DlMessage::IsduReadRsp,
+            &self.mailbox.isdu_responses,
+            buffer,
+        )
+    }
+
+    fn dl_isdu_transport_write_rsp(&mut self) -> IoLinkResult<()> {
+        self.mailbox.push_dl(DlMessage::IsduWriteRsp)
+    }
+
+    fn dl_isdu_transport_read_error_rsp(
+        &mut self,
+        error: u8,
+        additional_error: u8,
+    ) -> IoLinkResult<()> {
+        self.mailbox
+            .push_dl(DlMessage::IsduReadErrorRsp(error, additional_error))
+    }
+
+    fn dl_isdu_transport_write_error_rsp(
+        &mut self,
+        error: u8,
+        additional_error: u8,
+    ) -> IoLinkResult<()> {
+        self.mailbox
+            .push_dl(DlMessage::IsduWriteErrorRsp(error, additional_error))
+    }
+}
+
+impl dl::DlEventReq for DlEndpoint<'_> {
+    /// Queues every entry as a DL_Event with one entry, see
+    /// [`dl::DataLinkLayerReq::dl_event_entry_req`]
+    fn dl_event_req(
+        &mut self,
+        _event_count: u8,
+        event_entries: &[handlers::event::EventEntry],
+    ) -> IoLinkResult<()> {
+        for event_entry in event_entries {
+            self.mailbox
+                .push_dl(DlMessage::EventEntryReq(event_entry.to_bytes()))?;
+        }
+        Ok(())
+    }
+
+    fn dl_event_trigger_req(&mut self) -> IoLinkResult<()> {
+        self.mailbox.push_dl(DlMessage::EventTriggerReq)
+    }
+}
+
+impl dl::DlPDInputUpdate for DlEndpoint<'_> {
+    fn dl_pd_input_update_req(&mut self, length: u8, input_data: &[u8]) -> IoLinkResult<()> {
+        let length = (length as usize).min(input_data.len());
+        self.mailbox.pd_in.write(&input_data[..length])
+    }
+}
+
+impl dl::DataLinkLayerReq for DlEndpoint<'_> {
+    /// Returns the count of the Data Link Layer at its last poll
+    fn master_cycle_count(&self) -> u32 {
+        self.mailbox.master_cycle_count.load(Ordering::Relaxed)
+    }
+
+    fn dl_event_entry_req(&mut self, entry: &[u8; EVENT_ENTRY_SIZE]) -> IoLinkResult<()> {
+        self.mailbox.push_dl(DlMessage::EventEntryReq(*entry))
+    }
+}
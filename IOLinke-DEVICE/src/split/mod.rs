@@ -0,0 +1,443 @@
+//! IO-Link device split into a Data Link Layer side and an Application Layer side.
+//!
+//! [`crate::IoLinkDevice::poll`] runs the Application Layer, the Data Link Layer and
+//! System Management one after another, so a slow ISDU parameter access, Data Storage or
+//! Event processing delays the next M-sequence response. With the `split_layers` feature
+//! the device can run as two halves instead, which only share a [`LayerMailbox`]:
+//!
+//! - [`DataLinkSide`]: Data Link Layer (message, Process Data, On-request Data, ISDU
+//!   and Event handlers), System Management and the Physical Layer. Polled from the UART
+//!   interrupt or a high priority task, its response time does not depend on the load of
+//!   the Application Layer.
+//! - [`ApplicationSide`]: Application Layer, Parameter Manager, Data Storage, the Event
+//!   queue and the parameter journal. Polled from a low priority RTOS task or from the
+//!   second core, e.g. of an RP2040 or STM32H7.
+//!
+//! The services between the layers become messages of the mailbox, see
+//! [`mailbox`]. The Master sees no difference: ISDUs are answered "busy" until the
+//! response of the Application Layer arrived, exactly as for a slow device application.
+//! Each side must be polled from one context at a time, the two sides may run in
+//! parallel.
+//!
+//! ## Usage
+//!
+//! ```ignore
+//! static MAILBOX: LayerMailbox = LayerMailbox::new();
+//!
+//! // UART interrupt / high priority task
+//! let mut dl_side = DataLinkSide::new(physical_layer, &MAILBOX);
+//! dl_side.pl_transfer_ind(rx_byte)?;
+//! dl_side.poll()?;
+//! if MAILBOX.has_application_layer_messages() {
+//!     app_task_notify();
+//! }
+//!
+//! // Low priority task / second core
+//! let mut al_side = ApplicationSide::new(al_services, &MAILBOX);
+//! loop {
+//!     app_task_wait();
+//!     al_side.poll()?;
+//! }
+//! ```
+
+pub mod mailbox;
+
+pub use mailbox::LayerMailbox;
+
+use iolinke_types::{
+    custom::IoLinkResult,
+    frame::msequence::TransmissionRate,
+    handlers::{
+        self,
+        command::DlControlCode,
+        pl::Timer,
+        sm::{DeviceCom, DeviceMode, SmResult, SystemManagementReq},
+    },
+    page::page1::DeviceIdent,
+};
+
+use core::option::Option;
+use core::result::Result::Ok;
+
+use crate::al::services::{self, AlReadRsp, AlSetInputReq, AlWriteRsp};
+use crate::pl::physical_layer::{PhysicalLayerInd, PhysicalLayerReq};
+use crate::scheduler::{PendingWork, PendingWorkMask};
+use crate::storage::nvm::{NoNvm, NvmBackend, ParameterJournal};
+use crate::{al, dl, system_management};
+
+/// Data Link Layer, System Management and Physical Layer of a split device
+pub struct DataLinkSide<'a, PHY: PhysicalLayerReq> {
+    /// Data link layer managing protocol state machines and message handling
+    data_link_layer: dl::DataLinkLayer,
+    /// System management handling device identification and communication setup
+    system_management: system_management::SystemManagement,
+    /// Physical layer managing communication, timing, and mode switching
+    physical_layer: PHY,
+    /// Queues the indications to the Application Layer
+    application_layer: mailbox::AlEndpoint<'a>,
+    /// Layers with work pending for the next poll
+    pending_work: PendingWorkMask,
+}
+
+impl<'a, PHY: PhysicalLayerReq> DataLinkSide<'a, PHY> {
+    /// Creates the Data Link Layer side of a device whose Application Layer side uses
+    /// the same `mailbox`
+    pub fn new(physical_layer: PHY, mailbox: &'a LayerMailbox) -> Self {
+        Self {
+            data_link_layer: dl::DataLinkLayer::default(),
+            system_management: system_management::SystemManagement::default(),
+            physical_layer,
+            application_layer: mailbox::AlEndpoint::new(mailbox),
+            pending_work: PendingWorkMask::new(),
+        }
+    }
+
+    /// Delivers the requests of the Application Layer and polls the pending state
+    /// machines, see [`crate::IoLinkDevice::poll`]
+    pub fn poll(&mut self) -> IoLinkResult<()> {
+        let result = self.poll_pending();
+        if self.data_link_layer.has_pending_work() {
+            self.pending_work.mark(PendingWork::DataLinkLayer);
+        }
+        if self.system_management.has_pending_transition() {
+            self.pending_work.mark(PendingWork::SystemManagement);
+        }
+        result
+    }
+
+    fn poll_pending(&mut self) -> IoLinkResult<()> {
+        let mailbox = self.application_layer.mailbox();
+        if mailbox.deliver_to_data_link_layer(&mut self.data_link_layer) {
+            self.pending_work.mark(PendingWork::DataLinkLayer);
+        }
+        if self.pending_work.take(PendingWork::DataLinkLayer)
+            || self.data_link_layer.has_pending_work()
+        {
+            self.data_link_layer.poll(
+                &mut self.system_management,
+                &mut self.physical_layer,
+                &mut self.application_layer,
+            )?;
+        }
+        if self.pending_work.take(PendingWork::SystemManagement)
+            || self.system_management.has_pending_transition()
+        {
+            self.system_management
+                .poll(&mut self.application_layer, &mut self.physical_layer)?;
+        }
+        Ok(())
+    }
+
+    /// Returns `true` if a state machine has work pending or the Application Layer sent
+    /// a request, see [`crate::IoLinkDevice::has_pending_work`]
+    pub fn has_pending_work(&self) -> bool {
+        self.pending_work.has_pending_work()
+            || self
+                .application_layer
+                .mailbox()
+                .has_data_link_layer_messages()
+    }
+
+    /// See [`crate::IoLinkDevice::successful_com`]
+    pub fn successful_com(&mut self, transmission_rate: TransmissionRate) {
+        self.data_link_layer.successful_com(transmission_rate);
+        self.pending_work.mark(PendingWork::DataLinkLayer);
+    }
+
+    /// See [`crate::IoLinkDevice::timer_elapsed`]
+    pub fn timer_elapsed(&mut self, timer: Timer) -> IoLinkResult<()> {
+        self.pending_work.mark(PendingWork::DataLinkLayer);
+        self.data_link_layer.timer_elapsed(timer)
+    }
+
+    /// See [`crate::IoLinkDevice::pl_transfer_ind`]
+    pub fn pl_transfer_ind(&mut self, rx_byte: u8) -> IoLinkResult<()> {
+        self.pending_work.mark(PendingWork::DataLinkLayer);
+        self.data_link_layer
+            .pl_transfer_ind(&self.physical_layer, rx_byte)
+    }
+
+    /// See [`crate::IoLinkDevice::pl_transfer_ind_burst`]
+    pub fn pl_transfer_ind_burst(&mut self, rx_bytes: &[u8]) -> IoLinkResult<()> {
+        self.pending_work.mark(PendingWork::DataLinkLayer);
+        self.data_link_layer
+            .pl_transfer_ind_burst(&self.physical_layer, rx_bytes)
+    }
+
+    /// See [`crate::IoLinkDevice::pl_transfer_cnf`]
+    #[cfg(feature = "non_blocking_tx")]
+    pub fn pl_transfer_cnf(&mut self) -> IoLinkResult<()> {
+        self.pending_work.mark(PendingWork::DataLinkLayer);
+        self.data_link_layer.pl_transfer_cnf();
+        Ok(())
+    }
+
+    /// See [`crate::IoLinkDevice::pl_wake_up_ind`]
+    pub fn pl_wake_up_ind(&mut self) -> IoLinkResult<()> {
+        self.pending_work.mark(PendingWork::DataLinkLayer);
+        let _ = self.data_link_layer.pl_wake_up_ind(&self.physical_layer);
+        Ok(())
+    }
+
+    /// Returns the input Process Data slot for in place update, see
+    /// [`crate::IoLinkDevice::acquire_pd_in_buffer`]. For sensors sampled in the same
+    /// context as the Data Link Layer, bypasses the mailbox.
+    pub fn acquire_pd_in_buffer(&mut self) -> Option<&mut [u8; dl::PD_INPUT_LENGTH]> {
+        self.data_link_layer.acquire_pd_in_buffer()
+    }
+
+    /// Publishes the slot returned by [`DataLinkSide::acquire_pd_in_buffer`]
+    pub fn commit_pd_in_buffer(&mut self) -> IoLinkResult<()> {
+        self.pending_work.mark(PendingWork::DataLinkLayer);
+        self.data_link_layer.commit_pd_in_buffer()
+    }
+
+    /// SM_SetDeviceCom, see [`crate::IoLinkDevice::sm_set_device_com_req`]
+    pub fn sm_set_device_com_req(&mut self, device_com: &DeviceCom) -> SmResult<()> {
+        self.pending_work.mark(PendingWork::SystemManagement);
+        <system_management::SystemManagement as SystemManagementReq<
+            mailbox::AlEndpoint<'a>,
+        >>::sm_set_device_com_req(&mut self.system_management, device_com)
+    }
+
+    /// SM_GetDeviceCom, the confirmation is delivered by the next poll of the
+    /// [`ApplicationSide`]
+    pub fn sm_get_device_com_req(&mut self) -> SmResult<()> {
+        self.pending_work.mark(PendingWork::SystemManagement);
+        self.system_management
+            .sm_get_device_com_req(&self.application_layer)
+    }
+
+    /// SM_SetDeviceIdent, see [`crate::IoLinkDevice::sm_set_device_ident_req`]
+    pub fn sm_set_device_ident_req(&mut self, device_ident: &DeviceIdent) -> SmResult<()> {
+        self.pending_work.mark(PendingWork::SystemManagement);
+        <system_management::SystemManagement as SystemManagementReq<
+            mailbox::AlEndpoint<'a>,
+        >>::sm_set_device_ident_req(&mut self.system_management, device_ident)
+    }
+
+    /// SM_GetDeviceIdent, the confirmation is delivered by the next poll of the
+    /// [`ApplicationSide`]
+    pub fn sm_get_device_ident_req(&mut self) -> SmResult<()> {
+        self.pending_work.mark(PendingWork::SystemManagement);
+        self.system_management
+            .sm_get_device_ident_req(&self.application_layer)
+    }
+
+    /// SM_SetDeviceMode, see [`crate::IoLinkDevice::sm_set_device_mode_req`]
+    pub fn sm_set_device_mode_req(&mut self, mode: DeviceMode) -> SmResult<()> {
+        self.pending_work.mark(PendingWork::SystemManagement);
+        <system_management::SystemManagement as SystemManagementReq<
+            mailbox::AlEndpoint<'a>,
+        >>::sm_set_device_mode_req(&mut self.system_management, mode)
+    }
+}
+
+/// Application Layer and parameter journal of a split device
+pub struct ApplicationSide<
+    'a,
+    ALS: services::ApplicationLayerServicesInd
+        + handlers::sm::SystemManagementCnf
+        + services::AlEventCnf,
+    NVM: NvmBackend = NoNvm,
+> {
+    /// Application layer providing parameter access and event handling
+    application_layer: al::ApplicationLayer<ALS>,
+    /// Queues the requests to the Data Link Layer
+    data_link_layer: mailbox::DlEndpoint<'a>,
+    /// Layers with work pending for the next poll
+    pending_work: PendingWorkMask,
+    /// Journal of the persistent parameters in non-volatile memory
+    parameter_journal: ParameterJournal<NVM>,
+}
+
+impl<
+    'a,
+    ALS: services::ApplicationLayerServicesInd
+        + handlers::sm::SystemManagementCnf
+        + services::AlEventCnf,
+> ApplicationSide<'a, ALS>
+{
+    /// Creates the Application Layer side of a device whose Data Link Layer side uses
+    /// the same `mailbox`, parameters are kept in RAM only
+    pub fn new(al_services: ALS, mailbox: &'a LayerMailbox) -> Self {
+        Self::new_with_nvm(al_services, NoNvm, mailbox)
+    }
+}
+
+impl<
+    'a,
+    ALS: services::ApplicationLayerServicesInd
+        + handlers::sm::SystemManagementCnf
+        + services::AlEventCnf,
+    NVM: NvmBackend,
+> ApplicationSide<'a, ALS, NVM>
+{
+    /// Creates the Application Layer side whose persistent parameters are saved in
+    /// `nvm`, see [`crate::IoLinkDevice::new_with_nvm`]
+    pub fn new_with_nvm(al_services: ALS, nvm: NVM, mailbox: &'a LayerMailbox) -> Self {
+        Self {
+            application_layer: al::ApplicationLayer::new(al_services),
+            data_link_layer: mailbox::DlEndpoint::new(mailbox),
+            pending_work: PendingWorkMask::new(),
+            parameter_journal: ParameterJournal::new(nvm),
+        }
+    }
+
+    /// See [`crate::IoLinkDevice::restore_parameters`]
+    pub fn restore_parameters(&mut self) -> IoLinkResult<()> {
+        let result = self
+            .parameter_journal
+            .mount(self.application_layer.parameter_storage_mut());
+        self.pending_work.mark(PendingWork::ParameterStorage);
+        result
+    }
+
+    /// Delivers the indications of the Data Link Layer and polls the pending state
+    /// machines, see [`crate::IoLinkDevice::poll`]
+    pub fn poll(&mut self) -> IoLinkResult<()> {
+        let result = self.poll_pending();
+        if self
+            .application_layer
+            .has_pending_work(&self.data_link_layer)
+        {
+            self.pending_work.mark(PendingWork::ApplicationLayer);
+        }
+        if self
+            .parameter_journal
+            .has_pending_work(self.application_layer.parameter_storage_mut())
+        {
+            self.pending_work.mark(PendingWork::ParameterStorage);
+        }
+        result
+    }
+
+    fn poll_pending(&mut self) -> IoLinkResult<()> {
+        let mailbox = self.data_link_layer.mailbox();
+        if mailbox.deliver_to_application_layer(&mut self.application_layer) {
+            self.pending_work.mark(PendingWork::ApplicationLayer);
+        }
+        if self.pending_work.take(PendingWork::ApplicationLayer)
+            || self
+                .application_layer
+                .has_pending_work(&self.data_link_layer)
+        {
+            self.application_layer.poll(&mut self.data_link_layer)?;
+        }
+        let parameter_storage = self.application_layer.parameter_storage_mut();
+        if self.pending_work.take(PendingWork::ParameterStorage)
+            || self.parameter_journal.has_pending_work(parameter_storage)
+        {
+            self.parameter_journal.poll(parameter_storage)?;
+        }
+        Ok(())
+    }
+
+    /// Returns `true` if a state machine has work pending or the Data Link Layer sent an
+    /// indication, see [`crate::IoLinkDevice::has_pending_work`]
+    pub fn has_pending_work(&self) -> bool {
+        self.pending_work.has_pending_work()
+            || self
+                .data_link_layer
+                .mailbox()
+                .has_application_layer_messages()
+    }
+
+    /// AL_SetInput, the input Process Data is handed to the Data Link Layer by its next
+    /// poll, see [`crate::IoLinkDevice::al_set_input_req`]
+    ///
+    /// # Errors
+    ///
+    /// - `IoLinkError::DeviceNotReady` if the Data Link Layer is still reading the
+    ///   previous input Process Data, retry later
+    pub fn al_set_input_req(&mut self, _length: u8, input_data: &[u8]) -> IoLinkResult<()> {
+        self.application_layer
+            .al_set_input_req(input_data, &mut self.data_link_layer)
+    }
+
+    /// See [`crate::IoLinkDevice::al_prefetch_req`]
+    pub fn al_prefetch_req(&mut self, index: u16, sub_index: u8, data: &[u8]) -> IoLinkResult<()> {
+        self.application_layer
+            .al_prefetch_req(index, sub_index, data)
+    }
+
+    /// See [`crate::IoLinkDevice::al_invalidate_req`]
+    pub fn al_invalidate_req(&mut self, index: u16, sub_index: u8) {
+        self.application_layer.al_invalidate_req(index, sub_index);
+    }
+
+    /// See [`crate::IoLinkDevice::set_output_indication`]
+    pub fn set_output_indication(&mut self, output_indication: crate::OutputIndication) {
+        self.application_layer
+            .set_output_indication(output_indication);
+    }
+
+    /// See [`crate::IoLinkDevice::al_event_push_req`]
+    pub fn al_event_push_req(&mut self, event_entry: &handlers::event::EventEntry) -> bool {
+        let queued = self.application_layer.al_event_push_req(event_entry);
+        self.pending_work.mark(PendingWork::ApplicationLayer);
+        queued
+    }
+
+    /// See [`crate::IoLinkDevice::al_event_take_req`]
+    pub fn al_event_take_req(&mut self, queue: &crate::AlEventQueue) {
+        self.application_layer.al_event_take_req(queue);
+        self.pending_work.mark(PendingWork::ApplicationLayer);
+    }
+
+    /// See [`crate::IoLinkDevice::has_queued_events`]
+    pub fn has_queued_events(&self, queue: &crate::AlEventQueue) -> bool {
+        self.application_layer.has_queued_event(queue)
+    }
+
+    /// See [`crate::IoLinkDevice::al_event_overflow_count`]
+    pub fn al_event_overflow_count(&self) -> u32 {
+        self.application_layer.event_overflow_count()
+    }
+
+    /// See [`crate::IoLinkDevice::al_event_coalesced_count`]
+    pub fn al_event_coalesced_count(&self) -> u32 {
+        self.application_layer.event_coalesced_count()
+    }
+}
+
+impl<
+    ALS: services::ApplicationLayerServicesInd
+        + handlers::sm::SystemManagementCnf
+        + services::AlEventCnf,
+    NVM: NvmBackend,
+> AlReadRsp for ApplicationSide<'_, ALS, NVM>
+{
+    /// See [`crate::IoLinkDevice::al_read_rsp`]
+    fn al_read_rsp(&mut self, result: services::AlResult<(u8, &[u8])>) -> IoLinkResult<()> {
+        self.pending_work.mark(PendingWork::ApplicationLayer);
+        self.application_layer.al_read_rsp(result)
+    }
+}
+
+impl<
+    ALS: services::ApplicationLayerServicesInd
+        + handlers::sm::SystemManagementCnf
+        + services::AlEventCnf,
+    NVM: NvmBackend,
+> AlWriteRsp for ApplicationSide<'_, ALS, NVM>
+{
+    /// See [`crate::IoLinkDevice::al_write_rsp`]
+    fn al_write_rsp(&mut self, result: services::AlResult<()>) -> IoLinkResult<()> {
+        self.pending_work.mark(PendingWork::ApplicationLayer);
+        self.application_layer.al_write_rsp(result)
+    }
+}
+
+impl<
+    ALS: services::ApplicationLayerServicesInd
+        + handlers::sm::SystemManagementCnf
+        + services::AlEventCnf,
+    NVM: NvmBackend,
+> services::AlControlReq for ApplicationSide<'_, ALS, NVM>
+{
+    /// AL_Control, handed to the Data Link Layer by its next poll
+    fn al_control_req(&mut self, control_code: DlControlCode) -> IoLinkResult<()> {
+        self.data_link_layer.dl_control_req(control_code)
+    }
+}
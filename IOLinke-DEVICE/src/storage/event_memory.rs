@@ -1,21 +1,28 @@
 use iolinke_types::custom::{IoLinkError, IoLinkResult};
-use iolinke_types::handlers::event::{EventEntry, StatusCodeType1, StatusCodeType2};
+use iolinke_types::handlers::event::EventEntry;
 
 use core::result::Result::{Err, Ok};
 
-const MAX_EVENT_MEMORY_SIZE: usize = 19;
-
-#[derive(Debug, Clone, PartialEq, Eq)]
-enum EventCode {
-    StatusCodeType1(StatusCodeType1),
-    _StatusCodeType2(StatusCodeType2),
-}
+/// Addresses 0x00..=0x1F of the Diagnosis channel, see Table 58 – Event memory
+const MAX_EVENT_MEMORY_SIZE: usize = 32;
+/// Size of one event entry in the Event memory (EventQualifier, EventCode)
+pub const EVENT_ENTRY_SIZE: usize = 3;
+/// Maximum number of event entries reported with one DL_EventTrigger
+pub const MAX_EVENT_ENTRIES: usize = 6;
+/// Address of the StatusCode, the Event slots follow it
+const STATUS_CODE_ADDRESS: usize = 0;
+/// StatusCodeType2 with "Event Details" set, see A.6.3
+const STATUS_CODE_EVENT_DETAILS: u8 = 0x80;
 
 /// See 7.3.8.1 Events and Table 58 – Event memory
+///
+/// The memory is kept in its wire layout, address 0x00 holds the StatusCode and the
+/// addresses 0x01..=0x12 hold the 6 Event slots. The remaining addresses are reserved
+/// and read as zero.
 #[derive(Debug, Clone, PartialEq, Eq)]
 pub struct EventMemory {
-    event_code: EventCode,
-    events: heapless::Vec<u8, MAX_EVENT_MEMORY_SIZE>,
+    memory: [u8; MAX_EVENT_MEMORY_SIZE],
+    event_count: usize,
     read_only: bool,
 }
 
@@ -23,31 +30,35 @@ impl EventMemory {
     /// Create a new EventMemory instance
     pub fn new() -> Self {
         Self {
-            event_code: EventCode::StatusCodeType1(StatusCodeType1::new()),
-            events: heapless::Vec::new(),
+            memory: [0; MAX_EVENT_MEMORY_SIZE],
+            event_count: 0,
             read_only: false,
         }
     }
 
     /// Add an event entry to the memory
     pub fn add_event_details(&mut self, entries: &[EventEntry]) -> IoLinkResult<()> {
+        // Push all entries to the self.events as bytes
+        for entry in entries.iter() {
+            self.add_event_entry(&entry.to_bytes())?;
+        }
+        Ok(())
+    }
+
+    /// Add an event entry which is already in the wire format of [`EventEntry::to_bytes`]
+    pub fn add_event_entry(&mut self, entry: &[u8; EVENT_ENTRY_SIZE]) -> IoLinkResult<()> {
         if self.read_only {
             return Err(IoLinkError::ReadOnlyError);
         }
-
-        // Push all entries to the self.events as bytes
-        for entry in entries.iter() {
-            let bytes = entry.to_bytes();
-            // Only push if there is enough space left
-            if self.events.len() + bytes.len() > self.events.capacity() {
-                return Err(IoLinkError::EventMemoryFull);
-            }
-            for b in bytes.iter() {
-                self.events
-                    .push(*b)
-                    .map_err(|_| IoLinkError::EventMemoryFull)?;
-            }
+        // Only add if there is a free Event slot left
+        if self.event_count >= MAX_EVENT_ENTRIES {
+            return Err(IoLinkError::EventMemoryFull);
         }
+        let slot = STATUS_CODE_ADDRESS + 1 + self.event_count * EVENT_ENTRY_SIZE;
+        self.memory[slot..slot + EVENT_ENTRY_SIZE].copy_from_slice(entry);
+        // Mark the slot as activated in the StatusCodeType2
+        self.memory[STATUS_CODE_ADDRESS] |= STATUS_CODE_EVENT_DETAILS | (1 << self.event_count);
+        self.event_count += 1;
         Ok(())
     }
 
@@ -55,24 +66,17 @@ impl EventMemory {
         if self.read_only {
             return Err(IoLinkError::ReadOnlyError);
         }
-        // Clear all event entries
-        self.events.clear();
-        // Reset the event code to StatusCodeType1
-        self.event_code = EventCode::StatusCodeType1(StatusCodeType1::new());
+        // Clear all event entries, the StatusCode reads as StatusCodeType1 without Events
+        self.memory = [0; MAX_EVENT_MEMORY_SIZE];
+        self.event_count = 0;
         Ok(())
     }
 
+    /// Returns `length` octets of the Event memory starting at `address`
     pub fn get_event_detail(&self, address: usize, length: usize) -> IoLinkResult<&[u8]> {
-        if address + length > MAX_EVENT_MEMORY_SIZE {
-            return Err(IoLinkError::InvalidAddress);
-        }
-        if self.events.is_empty() {
-            return Err(IoLinkError::InvalidEvent);
-        }
-        // Extract the event entry from the events vector
-        self.events
+        self.memory
             .get(address..address + length)
-            .ok_or(IoLinkError::InvalidData)
+            .ok_or(IoLinkError::InvalidAddress)
     }
 
     pub fn set_read_only(&mut self, read_only: bool) {
@@ -9,6 +9,7 @@
 //! - **Direct Parameters**: Handles direct parameter page access
 //! - **ISDU Memory**: Manages Index-based Service Data Unit storage
 //! - **Parameters Memory**: Handles device parameter storage
+//! - **Non-volatile Memory**: Journals persistent parameters to flash
 //!
 //! ## Specification Compliance
 //!
@@ -18,3 +19,4 @@
 
 pub mod event_memory;
 pub mod isdu_memory;
+pub mod nvm;
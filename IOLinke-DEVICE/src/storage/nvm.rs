@@ -0,0 +1,617 @@
+//! Non-volatile parameter memory
+//!
+//! Parameter writes of the Master only change the parameter arena in RAM. The journal
+//! saves the persistent parameters to a non-volatile memory of the device (e.g. the
+//! internal flash) accessed through [`NvmBackend`]:
+//!
+//! - A changed parameter is appended as one small record (index, subindex, value), a
+//!   burst of ISDU writes costs one record per parameter instead of a sector erase.
+//! - The sectors are filled one after the other and reused round robin, so the erase
+//!   cycles are spread over all sectors (wear levelling).
+//! - While fewer than two sectors besides the head sector are free, the oldest sector
+//!   is reclaimed: the records in it which are still the latest ones of their
+//!   parameters are appended again, then the sector is erased. The second free sector
+//!   takes over when a power loss tears the head sector during a reclaim, so a
+//!   power-loss-safe journal needs at least three sectors.
+//! - Saving and reclaiming run in slices of one flash operation: a
+//!   [`ParameterJournal::poll`] starts a program or erase and the next polls check its
+//!   [`NvmBackend::status`], so the stack is never blocked for a sector erase and the
+//!   writes are not on the path of the ISDU response.
+//! - [`ParameterJournal::mount`] replays the records from the oldest to the newest into
+//!   the arena at boot, the last record of a parameter wins.
+//!
+//! ## Layout
+//!
+//! A used sector starts with a header of the magic `'I' 'J'`, the sequence number
+//! (u32, big endian) and a check octet of both. The records follow:
+//!
+//! | Octets | Content |
+//! |--------|---------|
+//! | 1      | Length `L` of the value, 0xFF marks the end of the records |
+//! | 2      | Index, big endian |
+//! | 1      | Subindex |
+//! | L      | Value |
+//! | 1      | Check octet of the octets before |
+//!
+//! Header and records are padded with 0xFF to a multiple of [`NvmBackend::WRITE_SIZE`].
+//! The check octet is the CRC-8 of the octets before it with bit 7 cleared. The octets
+//! are programmed in order, so a header or record torn by a power loss ends in erased
+//! octets and its check octet reads 0xFF, which no valid check octet does.
+//! A torn record fails its check, the rest of its sector is skipped and
+//! the next record goes to a new sector. A sector torn while it is erased is only ever
+//! the one being reclaimed, whose records were appended again before. Its header may
+//! read erased while records are left behind, so a sector is blank checked before it is
+//! taken into use and erased again if it is not blank.
+
+use iolinke_derived_config::device::vendor_specifics::storage_config::{
+    MAX_PARAMETER_LENGTH, PARAMETER_COUNT, ParameterStorage,
+};
+use iolinke_types::custom::{IoLinkError, IoLinkResult};
+
+use core::iter::Iterator;
+use core::option::{
+    Option,
+    Option::{None, Some},
+};
+use core::result::Result::{Err, Ok};
+
+/// Largest [`NvmBackend::WRITE_SIZE`] supported by the journal
+pub const MAX_WRITE_SIZE: usize = 16;
+
+/// Largest `data` of [`NvmBackend::start_program`]
+pub const MAX_PROGRAM_LENGTH: usize = RECORD_BUFFER_LENGTH;
+
+/// Value of an erased octet
+const ERASED: u8 = 0xFF;
+/// Magic at the start of a used sector
+const SECTOR_MAGIC: [u8; 2] = [0x49, 0x4A];
+/// Magic, sequence number and check octet
+const SECTOR_HEADER_SIZE: usize = 7;
+/// Length, index, subindex and check octet
+const RECORD_OVERHEAD: usize = 5;
+/// Largest padded record
+const RECORD_BUFFER_LENGTH: usize = RECORD_OVERHEAD + MAX_PARAMETER_LENGTH + MAX_WRITE_SIZE;
+/// Free sectors besides the head sector below which the oldest sector is reclaimed
+const MIN_FREE_SECTORS: usize = 2;
+
+/// State of the operation started last on an [`NvmBackend`]
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub enum NvmStatus {
+    /// The operation is still in progress
+    Busy,
+    /// The operation is complete
+    Done,
+}
+
+/// Non-volatile memory of the device, e.g. a few sectors of the internal flash.
+///
+/// The memory has flash semantics: an erased octet reads 0xFF and programming can only
+/// clear bits, an area is programmed at most once between two erases.
+/// Addresses are relative to the start of the first sector.
+///
+/// Programs and erases are started and run in the background, the journal polls
+/// [`NvmBackend::status`] until the operation is complete and starts at most one
+/// operation at a time. A backend whose operations block completes them before the
+/// start returns and always reports [`NvmStatus::Done`].
+pub trait NvmBackend {
+    /// Programming granularity in octets, a power of two up to [`MAX_WRITE_SIZE`].
+    /// Every [`NvmBackend::start_program`] starts at a multiple of it and has a multiple
+    /// of it as length.
+    const WRITE_SIZE: usize = 1;
+
+    /// Number of sectors of the journal, 0 disables the journal, otherwise at least 2.
+    fn sector_count(&self) -> usize;
+
+    /// Size of one sector in octets.
+    fn sector_size(&self) -> usize;
+
+    /// Reads `buffer.len()` octets starting at `address`, never called while an
+    /// operation is in progress.
+    fn read(&mut self, address: usize, buffer: &mut [u8]) -> IoLinkResult<()>;
+
+    /// Starts programming `data` at `address`. `data` is only borrowed for the call, a
+    /// backend programming in the background copies it, up to [`MAX_PROGRAM_LENGTH`]
+    /// octets.
+    fn start_program(&mut self, address: usize, data: &[u8]) -> IoLinkResult<()>;
+
+    /// Starts erasing `sector`, all its octets read 0xFF once it is done.
+    fn start_erase(&mut self, sector: usize) -> IoLinkResult<()>;
+
+    /// Returns the state of the operation started last.
+    ///
+    /// # Errors
+    /// - The error of a failed operation, the octets it programmed or erased may be torn.
+    fn status(&mut self) -> IoLinkResult<NvmStatus>;
+}
+
+/// No non-volatile memory, parameters are kept in RAM only
+#[derive(Debug, Clone, Copy, Default)]
+pub struct NoNvm;
+
+impl NvmBackend for NoNvm {
+    fn sector_count(&self) -> usize {
+        0
+    }
+
+    fn sector_size(&self) -> usize {
+        0
+    }
+
+    fn read(&mut self, _address: usize, _buffer: &mut [u8]) -> IoLinkResult<()> {
+        Err(IoLinkError::FuncNotAvailable)
+    }
+
+    fn start_program(&mut self, _address: usize, _data: &[u8]) -> IoLinkResult<()> {
+        Err(IoLinkError::FuncNotAvailable)
+    }
+
+    fn start_erase(&mut self, _sector: usize) -> IoLinkResult<()> {
+        Err(IoLinkError::FuncNotAvailable)
+    }
+
+    fn status(&mut self) -> IoLinkResult<NvmStatus> {
+        Ok(NvmStatus::Done)
+    }
+}
+
+/// State of a sector, read from its header
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+enum SectorState {
+    /// Erased, can be taken into use
+    Erased,
+    /// Holds records, with the sequence number of the sector
+    Used(u32),
+    /// Torn header, must be erased before it is taken into use
+    Invalid,
+}
+
+/// Flash operation of the journal in progress on the [`NvmBackend`]
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+enum Operation {
+    /// Erase of a sector which is not blank, before it becomes head sector `sequence`
+    EraseForOpen { sector: usize, sequence: u32 },
+    /// Erase of the sector being reclaimed
+    EraseReclaimed,
+    /// Program of the header of the head sector
+    Header,
+    /// Program of a record of `length` octets of the parameter at `position`
+    Record { position: usize, length: usize },
+}
+
+/// Journal of the persistent parameters in an [`NvmBackend`]
+pub struct ParameterJournal<NVM: NvmBackend> {
+    nvm: NVM,
+    /// `true` once mounted on a non-volatile memory
+    mounted: bool,
+    /// Sector the records are appended to and its sequence number
+    head: Option<(usize, u32)>,
+    /// Offset of the next record in the head sector
+    write_offset: usize,
+    /// Sector holding the latest record of each parameter, in the order of
+    /// [`ParameterStorage::get_all_parameters`]
+    latest: [Option<u8>; PARAMETER_COUNT],
+    /// Sector being reclaimed
+    reclaim: Option<usize>,
+    /// Operation started on the memory and not yet complete
+    operation: Option<Operation>,
+}
+
+impl<NVM: NvmBackend> ParameterJournal<NVM> {
+    /// Creates a journal on `nvm`, it is used once mounted
+    pub const fn new(nvm: NVM) -> Self {
+        Self {
+            nvm,
+            mounted: false,
+            head: None,
+            write_offset: 0,
+            latest: [None; PARAMETER_COUNT],
+            reclaim: None,
+            operation: None,
+        }
+    }
+
+    /// Restores the saved parameters into `storage`, called once at boot.
+    ///
+    /// Records of parameters which are unknown, not persistent or of another length
+    /// (e.g. after a firmware update) are skipped.
+    ///
+    /// # Errors
+    /// - `IoLinkError::InvalidParameter` if the geometry of the memory is not supported.
+    /// - `IoLinkError::NotEnoughMemory` if the persistent parameters do not fit in one
+    ///   sector.
+    /// - Any error of the [`NvmBackend`].
+    pub fn mount(&mut self, storage: &mut ParameterStorage) -> IoLinkResult<()> {
+        self.mounted = false;
+        self.head = None;
+        self.write_offset = 0;
+        self.latest = [None; PARAMETER_COUNT];
+        self.reclaim = None;
+        self.operation = None;
+        let sector_count = self.nvm.sector_count();
+        if sector_count == 0 {
+            // No non-volatile memory
+            return Ok(());
+        }
+        if !NVM::WRITE_SIZE.is_power_of_two()
+            || NVM::WRITE_SIZE > MAX_WRITE_SIZE
+            || sector_count < 2
+            || sector_count > u8::MAX as usize
+        {
+            return Err(IoLinkError::InvalidParameter);
+        }
+        // A reclaim appends at most every persistent parameter to a fresh sector
+        let mut required = Self::header_length();
+        for info in storage.get_all_parameters().iter() {
+            if info.persistent {
+                if info.length >= ERASED as usize {
+                    return Err(IoLinkError::InvalidParameter);
+                }
+                required += Self::record_length(info.length);
+            }
+        }
+        if required > self.nvm.sector_size() {
+            return Err(IoLinkError::NotEnoughMemory);
+        }
+
+        let mut previous = 0;
+        while let Some((sector, sequence)) = self.next_used_sector(previous)? {
+            self.write_offset = self.replay_sector(storage, sector)?;
+            self.head = Some((sector, sequence));
+            previous = sequence;
+        }
+        // Continue a reclaim interrupted by a power loss
+        self.update_reclaim()?;
+        self.mounted = true;
+        Ok(())
+    }
+
+    /// Returns `true` while a parameter is not yet saved, a sector is reclaimed or a
+    /// flash operation is in progress
+    pub fn has_pending_work(&self, storage: &ParameterStorage) -> bool {
+        self.mounted
+            && (self.operation.is_some() || self.reclaim.is_some() || storage.has_unsaved())
+    }
+
+    /// Runs one slice of the journal.
+    ///
+    /// While a flash operation is in progress, only its status is checked. Otherwise at
+    /// most one program or erase is started: a sector being reclaimed goes first, it has
+    /// to be erased before the head sector is full, then the next unsaved parameter is
+    /// appended.
+    ///
+    /// # Errors
+    /// - Any error of the [`NvmBackend`], the failed operation is retried by later polls.
+    pub fn poll(&mut self, storage: &mut ParameterStorage) -> IoLinkResult<()> {
+        if !self.mounted {
+            return Ok(());
+        }
+        if let Some(operation) = self.operation {
+            return match self.nvm.status() {
+                Ok(NvmStatus::Busy) => Ok(()),
+                Ok(NvmStatus::Done) => {
+                    self.operation = None;
+                    self.complete(storage, operation)
+                }
+                Err(error) => {
+                    self.operation = None;
+                    self.fail(storage, operation);
+                    Err(error)
+                }
+            };
+        }
+        if let Some(sector) = self.reclaim {
+            let still_latest = self
+                .latest
+                .iter()
+                .position(|latest| *latest == Some(sector as u8));
+            return match still_latest {
+                Some(position) => self.append(storage, position),
+                None => {
+                    let started = self.nvm.start_erase(sector);
+                    self.begin(storage, Operation::EraseReclaimed, started)
+                }
+            };
+        }
+        let Some((info, _)) = storage.next_unsaved() else {
+            return Ok(());
+        };
+        let position = storage
+            .position(info.index, info.subindex)
+            .map_err(|_| IoLinkError::InvalidParameter)?;
+        self.append(storage, position)
+    }
+
+    /// Starts appending the current value of the parameter at `position`, or opens the
+    /// next sector first if the head sector has no room for it
+    fn append(&mut self, storage: &mut ParameterStorage, position: usize) -> IoLinkResult<()> {
+        let info = &storage.get_all_parameters()[position];
+        let length = Self::record_length(info.length);
+        let Some((sector, _)) = self.head else {
+            return self.open_next_sector(storage);
+        };
+        if self.write_offset + length > self.nvm.sector_size() {
+            return self.open_next_sector(storage);
+        }
+
+        let mut record = [ERASED; RECORD_BUFFER_LENGTH];
+        let (_, value) = storage
+            .lookup(info.index, info.subindex)
+            .map_err(|_| IoLinkError::InvalidParameter)?;
+        record[0] = info.length as u8;
+        record[1..3].copy_from_slice(&info.index.to_be_bytes());
+        record[3] = info.subindex;
+        record[4..4 + info.length].copy_from_slice(value);
+        record[4 + info.length] = check_octet(&record[..4 + info.length]);
+
+        let address = self.address(sector, self.write_offset);
+        // A write of the parameter while the record is programmed marks it unsaved again
+        storage.mark_saved(info.index, info.subindex);
+        let started = self.nvm.start_program(address, &record[..length]);
+        self.begin(storage, Operation::Record { position, length }, started)
+    }
+
+    /// Starts taking the sector after the head sector into use, with an erase first if
+    /// it is not blank
+    fn open_next_sector(&mut self, storage: &mut ParameterStorage) -> IoLinkResult<()> {
+        let (sector, sequence) = match self.head {
+            Some((head, sequence)) => ((head + 1) % self.nvm.sector_count(), sequence + 1),
+            None => (0, 1),
+        };
+        match self.sector_state(sector)? {
+            SectorState::Erased if self.is_blank(sector)? => {
+                self.program_header(storage, sector, sequence)
+            }
+            // Only after the reclaim could not keep up
+            SectorState::Used(_) => Err(IoLinkError::NotEnoughMemory),
+            // A torn header, or records left behind by a torn erase
+            SectorState::Erased | SectorState::Invalid => {
+                let started = self.nvm.start_erase(sector);
+                self.begin(
+                    storage,
+                    Operation::EraseForOpen { sector, sequence },
+                    started,
+                )
+            }
+        }
+    }
+
+    /// Starts programming the header of the erased `sector`, which becomes the head sector
+    fn program_header(
+        &mut self,
+        storage: &mut ParameterStorage,
+        sector: usize,
+        sequence: u32,
+    ) -> IoLinkResult<()> {
+        let mut header = [ERASED; MAX_WRITE_SIZE];
+        header[..2].copy_from_slice(&SECTOR_MAGIC);
+        header[2..6].copy_from_slice(&sequence.to_be_bytes());
+        header[6] = check_octet(&header[..6]);
+        self.head = Some((sector, sequence));
+        // Until the header is programmed, the sector takes no record
+        self.write_offset = self.nvm.sector_size();
+        let address = self.address(sector, 0);
+        let started = self
+            .nvm
+            .start_program(address, &header[..Self::header_length()]);
+        self.begin(storage, Operation::Header, started)
+    }
+
+    /// Keeps `operation` in progress once `started`, or handles its failure
+    fn begin(
+        &mut self,
+        storage: &mut ParameterStorage,
+        operation: Operation,
+        started: IoLinkResult<()>,
+    ) -> IoLinkResult<()> {
+        match started {
+            Ok(()) => {
+                self.operation = Some(operation);
+                Ok(())
+            }
+            Err(error) => {
+                self.fail(storage, operation);
+                Err(error)
+            }
+        }
+    }
+
+    /// Continues after `operation` is complete
+    fn complete(
+        &mut self,
+        storage: &mut ParameterStorage,
+        operation: Operation,
+    ) -> IoLinkResult<()> {
+        match operation {
+            Operation::EraseForOpen { sector, sequence } => {
+                self.program_header(storage, sector, sequence)
+            }
+            Operation::EraseReclaimed => {
+                self.reclaim = None;
+                self.update_reclaim()
+            }
+            Operation::Header => {
+                self.write_offset = Self::header_length();
+                self.update_reclaim()
+            }
+            Operation::Record { position, length } => {
+                self.write_offset += length;
+                if let Some((sector, _)) = self.head {
+                    self.latest[position] = Some(sector as u8);
+                }
+                Ok(())
+            }
+        }
+    }
+
+    /// Recovers from a failed `operation`, the next polls start it again
+    fn fail(&mut self, storage: &mut ParameterStorage, operation: Operation) {
+        match operation {
+            // The sector is blank checked and erased again when it is opened next
+            Operation::EraseForOpen { .. } => {}
+            // Still the oldest sector, the reclaim erases it again
+            Operation::EraseReclaimed => {}
+            // The sector stays closed, the next record goes to a new sector
+            Operation::Header => {}
+            Operation::Record { position, .. } => {
+                // The record may be torn, the next one goes to a new sector
+                self.write_offset = self.nvm.sector_size();
+                let info = &storage.get_all_parameters()[position];
+                storage.mark_unsaved(info.index, info.subindex);
+            }
+        }
+    }
+
+    /// Starts reclaiming the oldest sector while fewer than [`MIN_FREE_SECTORS`] other
+    /// sectors are free
+    fn update_reclaim(&mut self) -> IoLinkResult<()> {
+        let Some((head, _)) = self.head else {
+            return Ok(());
+        };
+        let mut free = 0;
+        let mut oldest: Option<(usize, u32)> = None;
+        for sector in 0..self.nvm.sector_count() {
+            if sector == head {
+                continue;
+            }
+            match self.sector_state(sector)? {
+                SectorState::Used(sequence) => {
+                    if oldest.is_none_or(|(_, oldest_sequence)| sequence < oldest_sequence) {
+                        oldest = Some((sector, sequence));
+                    }
+                }
+                SectorState::Erased | SectorState::Invalid => free += 1,
+            }
+        }
+        self.reclaim = if free < MIN_FREE_SECTORS {
+            oldest.map(|(sector, _)| sector)
+        } else {
+            None
+        };
+        Ok(())
+    }
+
+    /// Returns the used sector with the lowest sequence number after `previous`
+    fn next_used_sector(&mut self, previous: u32) -> IoLinkResult<Option<(usize, u32)>> {
+        let mut next: Option<(usize, u32)> = None;
+        for sector in 0..self.nvm.sector_count() {
+            if let SectorState::Used(sequence) = self.sector_state(sector)?
+                && sequence > previous
+                && next.is_none_or(|(_, next_sequence)| sequence < next_sequence)
+            {
+                next = Some((sector, sequence));
+            }
+        }
+        Ok(next)
+    }
+
+    /// Restores the records of `sector`, returns the offset after the last valid record
+    fn replay_sector(
+        &mut self,
+        storage: &mut ParameterStorage,
+        sector: usize,
+    ) -> IoLinkResult<usize> {
+        let sector_size = self.nvm.sector_size();
+        let mut offset = Self::header_length();
+        let mut record = [ERASED; RECORD_BUFFER_LENGTH];
+        while offset < sector_size {
+            let address = self.address(sector, offset);
+            self.nvm.read(address, &mut record[..1])?;
+            if record[0] == ERASED {
+                return Ok(offset);
+            }
+            let value_length = record[0] as usize;
+            let length = Self::record_length(value_length);
+            if value_length > MAX_PARAMETER_LENGTH || offset + length > sector_size {
+                // Torn record, nothing after it can be trusted
+                return Ok(sector_size);
+            }
+            self.nvm
+                .read(address, &mut record[..RECORD_OVERHEAD + value_length])?;
+            if check_octet(&record[..4 + value_length]) != record[4 + value_length] {
+                return Ok(sector_size);
+            }
+            let index = u16::from_be_bytes([record[1], record[2]]);
+            let subindex = record[3];
+            if let Ok(position) = storage.position(index, subindex)
+                && storage.get_all_parameters()[position].persistent
+                && storage
+                    .restore_parameter(index, subindex, &record[4..4 + value_length])
+                    .is_ok()
+            {
+                self.latest[position] = Some(sector as u8);
+            }
+            offset += length;
+        }
+        Ok(sector_size)
+    }
+
+    /// Reads the header of `sector`
+    fn sector_state(&mut self, sector: usize) -> IoLinkResult<SectorState> {
+        let mut header = [ERASED; SECTOR_HEADER_SIZE];
+        let address = self.address(sector, 0);
+        self.nvm.read(address, &mut header)?;
+        if header.iter().all(|octet| *octet == ERASED) {
+            return Ok(SectorState::Erased);
+        }
+        if header[..2] != SECTOR_MAGIC || check_octet(&header[..6]) != header[6] {
+            return Ok(SectorState::Invalid);
+        }
+        Ok(SectorState::Used(u32::from_be_bytes([
+            header[2], header[3], header[4], header[5],
+        ])))
+    }
+
+    /// Returns `true` if every octet of `sector` reads erased
+    fn is_blank(&mut self, sector: usize) -> IoLinkResult<bool> {
+        let sector_size = self.nvm.sector_size();
+        let mut chunk = [ERASED; MAX_WRITE_SIZE];
+        let mut offset = 0;
+        while offset < sector_size {
+            let length = chunk.len().min(sector_size - offset);
+            let address = self.address(sector, offset);
+            self.nvm.read(address, &mut chunk[..length])?;
+            if chunk[..length].iter().any(|octet| *octet != ERASED) {
+                return Ok(false);
+            }
+            offset += length;
+        }
+        Ok(true)
+    }
+
+    fn address(&self, sector: usize, offset: usize) -> usize {
+        sector * self.nvm.sector_size() + offset
+    }
+
+    const fn header_length() -> usize {
+        SECTOR_HEADER_SIZE.next_multiple_of(NVM::WRITE_SIZE)
+    }
+
+    const fn record_length(value_length: usize) -> usize {
+        (RECORD_OVERHEAD + value_length).next_multiple_of(NVM::WRITE_SIZE)
+    }
+}
+
+/// Check octet of a header or record, never 0xFF like an erased octet
+const fn check_octet(data: &[u8]) -> u8 {
+    crc8(data) & 0x7F
+}
+
+/// CRC-8 with polynomial 0x07 and initial value 0xFF
+const fn crc8(data: &[u8]) -> u8 {
+    let mut crc = 0xFFu8;
+    let mut i = 0;
+    while i < data.len() {
+        crc ^= data[i];
+        let mut bit = 0;
+        while bit < 8 {
+            crc = if crc & 0x80 != 0 {
+                (crc << 1) ^ 0x07
+            } else {
+                crc << 1
+            };
+            bit += 1;
+        }
+        i += 1;
+    }
+    crc
+}
@@ -19,26 +19,30 @@
 //! - Section 10.7: System Commands and Control
 //! - Annex B: Parameter Definitions and Access
 
+use iolinke_derived_config::device::vendor_specifics;
 use iolinke_macros::{direct_parameter_address, master_command};
 use iolinke_types::custom::{IoLinkError, IoLinkResult};
 use iolinke_types::frame::msequence::TransmissionRate;
 use iolinke_types::handlers;
 use iolinke_types::handlers::mode::{DlModeInd, DlReadWriteInd};
-use iolinke_types::handlers::sm::SystemManagementCnf;
-use iolinke_types::handlers::sm::SystemManagementInd;
 use iolinke_types::handlers::sm::{
     DeviceCom, DeviceMode, IoLinkMode, SioMode, SmResult, SystemManagementReq,
 };
 use iolinke_types::page::page1::{DeviceIdent, RevisionId};
+#[cfg(feature = "trace")]
+use iolinke_util::trace::TraceModule;
 use iolinke_util::{log_state_transition, log_state_transition_error};
 
 use core::clone::Clone;
 use core::default::Default;
-use core::option::Option::Some;
+use core::ops::RangeInclusive;
+use core::option::{
+    Option,
+    Option::{None, Some},
+};
 use core::result::Result::{Err, Ok};
 
-use crate::services;
-use crate::{al, pl};
+use crate::{dl::ApplicationLayerInd, pl};
 
 /// System Management state transition types.
 ///
@@ -194,6 +198,7 @@ enum Transition {
 /// - IO-Link v1.1.4 Section 6.3: System Management State Machine
 /// - Table 94: SM_DeviceMode state definitions
 #[derive(Debug, Clone, Copy, PartialEq, Eq)]
+#[cfg_attr(feature = "trace", derive(iolinke_macros::TraceId))]
 pub enum SystemManagementState {
     /// SM_Idle_0: Waiting for configuration.
     ///
@@ -294,6 +299,7 @@ pub enum SystemManagementState {
 /// - IO-Link v1.1.4 Section 6.3: System Management State Machine
 /// - Table 95: State transition tables
 #[derive(Debug, Clone, Copy, PartialEq, Eq)]
+#[cfg_attr(feature = "trace", derive(iolinke_macros::TraceId))]
 enum SystemManagementEvent {
     /// Device mode changed to SIO
     SmDeviceModeSio,
@@ -319,6 +325,11 @@ enum SystemManagementEvent {
     TransmissionRateChanged,
 }
 
+/// Names of the states and events of the state machine, see [`crate::trace`]
+#[cfg(feature = "trace")]
+pub(crate) const TRACE_MODULE: TraceModule =
+    TraceModule::new::<SystemManagementState, SystemManagementEvent>(module_path!());
+
 /// Reconfiguration parameters for device compatibility.
 ///
 /// This struct holds the parameters that may need to be updated
@@ -383,6 +394,9 @@ pub struct SystemManagement {
     device_mode: DeviceMode,
     /// Reconfiguration parameters for compatibility
     reconfig: ReConfig,
+    /// Direct Parameter Page 1 image, built from the device configuration and updated by
+    /// SM_SetDeviceCom and SM_SetDeviceIdent
+    page1: [u8; 16],
 }
 
 impl SystemManagement {
@@ -408,6 +422,26 @@ impl SystemManagement {
             device_ident: DeviceIdent::default(),
             device_mode: DeviceMode::default(),
             reconfig: ReConfig::default(),
+            page1: vendor_specifics::storage_config::DIRECT_PARAMETER_PAGE_1,
+        }
+    }
+
+    /// Returns the value of a read-only Direct Parameter Page 1 parameter
+    /// (MinCycleTime to FunctionID2) from the page image.
+    ///
+    /// Page reads of these parameters are answered without the Application Layer.
+    ///
+    /// # Returns
+    ///
+    /// - `Some(value)` for the addresses 0x02 to 0x0D
+    /// - `None` for all other addresses, they are served by the Application Layer
+    pub fn direct_parameter(&self, address: u8) -> Option<u8> {
+        const READ_ONLY: RangeInclusive<u8> =
+            direct_parameter_address!(MinCycleTime)..=direct_parameter_address!(FunctionID2);
+        if READ_ONLY.contains(&address) {
+            Some(self.page1[address as usize])
+        } else {
+            None
         }
     }
 
@@ -450,11 +484,11 @@ impl SystemManagement {
             (State::ComStartup, Event::DlWriteMCmdMasterident(_addr, _value)) => {
                 (Transition::T5, State::IdentStartup)
             }
-            (State::ComStartup, Event::DlModeOperate) => (Transition::T11, State::Preoperate),
+            (State::ComStartup, Event::DlModeOperate) => (Transition::T11, State::Operate),
             (State::IdentStartup, Event::DlWriteMCmdDeviceident(_addr, _value)) => {
                 (Transition::T6, State::IdentCheck)
             }
-            (State::IdentStartup, Event::DlModeOperate) => (Transition::T10, State::Preoperate),
+            (State::IdentStartup, Event::DlModePreoperate) => (Transition::T10, State::Preoperate),
             (State::IdentCheck, Event::DlReadMincycletime) => (Transition::T7, State::CompStartup),
             (State::IdentCheck, Event::TransmissionRateChanged) => {
                 (Transition::T14, State::ComEstablish)
@@ -481,6 +515,20 @@ impl SystemManagement {
         Ok(())
     }
 
+    /// Returns `true` while a transition or a reconfiguration is pending for the next poll
+    pub fn has_pending_transition(&self) -> bool {
+        self.exec_transition != Transition::Tn
+            || (self.state == SystemManagementState::IdentCheck && self.is_reconfig_complete())
+    }
+
+    /// Returns `true` once all reconfiguration parameters are received
+    fn is_reconfig_complete(&self) -> bool {
+        self.reconfig.revision_id.is_some()
+            && self.reconfig.device_id1.is_some()
+            && self.reconfig.device_id2.is_some()
+            && self.reconfig.device_id3.is_some()
+    }
+
     /// Polls the System Management to advance its state and handle transitions.
     ///
     /// This method must be called regularly to:
@@ -516,21 +564,12 @@ impl SystemManagement {
     ///     }
     /// }
     /// ```
-    pub fn poll<
-        T: pl::physical_layer::PhysicalLayerReq,
-        ALS: services::ApplicationLayerServicesInd
-            + handlers::sm::SystemManagementCnf
-            + services::AlEventCnf,
-    >(
+    pub fn poll<T: pl::physical_layer::PhysicalLayerReq, AL: ApplicationLayerInd>(
         &mut self,
-        application_layer: &mut al::ApplicationLayer<ALS>,
+        application_layer: &mut AL,
         physical_layer: &mut T,
     ) -> IoLinkResult<()> {
-        if self.reconfig.revision_id.is_some()
-            && self.reconfig.device_id1.is_some()
-            && self.reconfig.device_id2.is_some()
-            && self.reconfig.device_id3.is_some()
-        {
+        if self.is_reconfig_complete() {
             let _ = self.poll_active_state(application_layer);
         }
         match self.exec_transition {
@@ -626,13 +665,9 @@ impl SystemManagement {
         Ok(())
     }
 
-    fn poll_active_state<
-        ALS: services::ApplicationLayerServicesInd
-            + handlers::sm::SystemManagementCnf
-            + services::AlEventCnf,
-    >(
+    fn poll_active_state<AL: ApplicationLayerInd>(
         &mut self,
-        application_layer: &mut al::ApplicationLayer<ALS>,
+        application_layer: &mut AL,
     ) -> IoLinkResult<()> {
         use SystemManagementState as State;
         match self.state {
@@ -659,14 +694,9 @@ impl SystemManagement {
     }
 
     /// Execute T1 transition: Switch to SIO mode
-    fn execute_t1<
-        T: pl::physical_layer::PhysicalLayerReq,
-        ALS: services::ApplicationLayerServicesInd
-            + handlers::sm::SystemManagementCnf
-            + services::AlEventCnf,
-    >(
+    fn execute_t1<T: pl::physical_layer::PhysicalLayerReq, AL: ApplicationLayerInd>(
         &mut self,
-        application_layer: &mut al::ApplicationLayer<ALS>,
+        application_layer: &mut AL,
         physical_layer: &mut T,
     ) -> IoLinkResult<()> {
         // Invoke PL_SetMode(DI|DO|INACTIVE)
@@ -682,14 +712,9 @@ impl SystemManagement {
     }
 
     /// Execute T2 transition: Switch to communication mode
-    fn execute_t2<
-        T: pl::physical_layer::PhysicalLayerReq,
-        ALS: services::ApplicationLayerServicesInd
-            + handlers::sm::SystemManagementCnf
-            + services::AlEventCnf,
-    >(
+    fn execute_t2<T: pl::physical_layer::PhysicalLayerReq, AL: ApplicationLayerInd>(
         &mut self,
-        application_layer: &mut al::ApplicationLayer<ALS>,
+        application_layer: &mut AL,
         physical_layer: &mut T,
     ) -> IoLinkResult<()> {
         let com_mode = match self.device_com.transmission_rate {
@@ -705,14 +730,9 @@ impl SystemManagement {
     }
 
     /// Execute T3 transition: Switch to SM_Idle mode
-    fn execute_t3<
-        T: pl::physical_layer::PhysicalLayerReq,
-        ALS: services::ApplicationLayerServicesInd
-            + handlers::sm::SystemManagementCnf
-            + services::AlEventCnf,
-    >(
+    fn execute_t3<T: pl::physical_layer::PhysicalLayerReq, AL: ApplicationLayerInd>(
         &mut self,
-        application_layer: &mut al::ApplicationLayer<ALS>,
+        application_layer: &mut AL,
         physical_layer: &mut T,
     ) -> IoLinkResult<()> {
         // TODO: Cleanup any active communication sessions and reset state
@@ -724,14 +744,10 @@ impl SystemManagement {
     }
 
     /// Execute T4 transition: Indicate baudrate establishment
-    fn execute_t4<
-        ALS: services::ApplicationLayerServicesInd
-            + handlers::sm::SystemManagementCnf
-            + services::AlEventCnf,
-    >(
+    fn execute_t4<AL: ApplicationLayerInd>(
         &mut self,
         mode: DeviceMode,
-        application_layer: &mut al::ApplicationLayer<ALS>,
+        application_layer: &mut AL,
     ) -> IoLinkResult<()> {
         // Invoke SM_DeviceMode(COMx)
         // TODO: Invoke SM_DeviceMode(COMx)
@@ -740,13 +756,9 @@ impl SystemManagement {
     }
 
     /// Execute T5 transition: Enter device identification phase
-    fn execute_t5<
-        ALS: services::ApplicationLayerServicesInd
-            + handlers::sm::SystemManagementCnf
-            + services::AlEventCnf,
-    >(
+    fn execute_t5<AL: ApplicationLayerInd>(
         &mut self,
-        application_layer: &mut al::ApplicationLayer<ALS>,
+        application_layer: &mut AL,
     ) -> IoLinkResult<()> {
         // TODO: Prepare device identification data for master verification
         // Invoke SM_DeviceMode(IDENTSTARTUP)
@@ -755,13 +767,9 @@ impl SystemManagement {
     }
 
     /// Execute T6 transition: Enter device identity check phase
-    fn execute_t6<
-        ALS: services::ApplicationLayerServicesInd
-            + handlers::sm::SystemManagementCnf
-            + services::AlEventCnf,
-    >(
+    fn execute_t6<AL: ApplicationLayerInd>(
         &mut self,
-        application_layer: &mut al::ApplicationLayer<ALS>,
+        application_layer: &mut AL,
     ) -> IoLinkResult<()> {
         // TODO: Handle master-provided RID and DID parameters for compatibility check
         // Invoke SM_DeviceMode(IDENTCHANGE)
@@ -778,13 +786,9 @@ impl SystemManagement {
     }
 
     /// Execute T8 transition: Enter device preoperate phase
-    fn execute_t8<
-        ALS: services::ApplicationLayerServicesInd
-            + handlers::sm::SystemManagementCnf
-            + services::AlEventCnf,
-    >(
+    fn execute_t8<AL: ApplicationLayerInd>(
         &mut self,
-        application_layer: &mut al::ApplicationLayer<ALS>,
+        application_layer: &mut AL,
     ) -> IoLinkResult<()> {
         // TODO: Prepare device for parameterization and data storage operations
         // Invoke SM_DeviceMode(PREOPERATE)
@@ -793,13 +797,9 @@ impl SystemManagement {
     }
 
     /// Execute T9 transition: Enter device operate phase
-    fn execute_t9<
-        ALS: services::ApplicationLayerServicesInd
-            + handlers::sm::SystemManagementCnf
-            + services::AlEventCnf,
-    >(
+    fn execute_t9<AL: ApplicationLayerInd>(
         &mut self,
-        application_layer: &mut al::ApplicationLayer<ALS>,
+        application_layer: &mut AL,
     ) -> IoLinkResult<()> {
         // TODO: Initialize cyclic process data exchange and acyclic data transfer
         // Invoke SM_DeviceMode(OPERATE)
@@ -808,13 +808,9 @@ impl SystemManagement {
     }
 
     /// Execute T10 transition: Enter device preoperate phase from IdentStartup
-    fn execute_t10<
-        ALS: services::ApplicationLayerServicesInd
-            + handlers::sm::SystemManagementCnf
-            + services::AlEventCnf,
-    >(
+    fn execute_t10<AL: ApplicationLayerInd>(
         &mut self,
-        application_layer: &mut al::ApplicationLayer<ALS>,
+        application_layer: &mut AL,
     ) -> IoLinkResult<()> {
         // TODO: Handle direct transition from identification to preoperate
         // Invoke SM_DeviceMode(PREOPERATE)
@@ -823,13 +819,9 @@ impl SystemManagement {
     }
 
     /// Execute T11 transition: Enter device operate phase from ComStartup
-    fn execute_t11<
-        ALS: services::ApplicationLayerServicesInd
-            + handlers::sm::SystemManagementCnf
-            + services::AlEventCnf,
-    >(
+    fn execute_t11<AL: ApplicationLayerInd>(
         &mut self,
-        application_layer: &mut al::ApplicationLayer<ALS>,
+        application_layer: &mut AL,
     ) -> IoLinkResult<()> {
         // TODO: Handle legacy master behavior (direct transition to operate)
         // Invoke SM_DeviceMode(OPERATE)
@@ -838,13 +830,9 @@ impl SystemManagement {
     }
 
     /// Execute T12 transition: Enter communication startup phase from Preoperate
-    fn execute_t12<
-        ALS: services::ApplicationLayerServicesInd
-            + handlers::sm::SystemManagementCnf
-            + services::AlEventCnf,
-    >(
+    fn execute_t12<AL: ApplicationLayerInd>(
         &mut self,
-        application_layer: &mut al::ApplicationLayer<ALS>,
+        application_layer: &mut AL,
     ) -> IoLinkResult<()> {
         // TODO: Reset communication parameters and restart identification process
         // Invoke SM_DeviceMode(STARTUP)
@@ -853,13 +841,9 @@ impl SystemManagement {
     }
 
     /// Execute T13 transition: Enter communication startup phase from Operate
-    fn execute_t13<
-        ALS: services::ApplicationLayerServicesInd
-            + handlers::sm::SystemManagementCnf
-            + services::AlEventCnf,
-    >(
+    fn execute_t13<AL: ApplicationLayerInd>(
         &mut self,
-        application_layer: &mut al::ApplicationLayer<ALS>,
+        application_layer: &mut AL,
     ) -> IoLinkResult<()> {
         // TODO: Handle communication restart from operate mode
         // Invoke SM_DeviceMode(STARTUP)
@@ -868,14 +852,9 @@ impl SystemManagement {
     }
 
     /// Execute T14 transition: Change transmission rate and establish communication
-    fn execute_t14<
-        T: pl::physical_layer::PhysicalLayerReq,
-        ALS: services::ApplicationLayerServicesInd
-            + handlers::sm::SystemManagementCnf
-            + services::AlEventCnf,
-    >(
+    fn execute_t14<T: pl::physical_layer::PhysicalLayerReq, AL: ApplicationLayerInd>(
         &mut self,
-        application_layer: &mut al::ApplicationLayer<ALS>,
+        application_layer: &mut AL,
         physical_layer: &mut T,
     ) -> IoLinkResult<()> {
         // TODO: Implement transmission rate change logic based on device identification requirements
@@ -937,17 +916,23 @@ impl DlReadWriteInd for SystemManagement {
                     address, value,
                 ))?;
             }
+            // The page image follows the written values, page reads answered from it
+            // report them until the application sets the identification again
             (direct_parameter_address!(RevisionID), value) => {
                 self.reconfig.revision_id = Some(RevisionId::from_bits(value));
+                self.page1[address as usize] = value;
             }
             (direct_parameter_address!(DeviceID1), value) => {
                 self.reconfig.device_id1 = Some(value);
+                self.page1[address as usize] = value;
             }
             (direct_parameter_address!(DeviceID2), value) => {
                 self.reconfig.device_id2 = Some(value);
+                self.page1[address as usize] = value;
             }
             (direct_parameter_address!(DeviceID3), value) => {
                 self.reconfig.device_id3 = Some(value);
+                self.page1[address as usize] = value;
             }
             _ => return Err(IoLinkError::InvalidEvent),
         }
@@ -963,22 +948,24 @@ impl DlReadWriteInd for SystemManagement {
     }
 }
 
-impl<
-    ALS: services::ApplicationLayerServicesInd
-        + handlers::sm::SystemManagementCnf
-        + services::AlEventCnf,
-> SystemManagementReq<al::ApplicationLayer<ALS>> for SystemManagement
-{
+impl<AL: ApplicationLayerInd> SystemManagementReq<AL> for SystemManagement {
     fn sm_set_device_com_req(&mut self, device_com: &DeviceCom) -> SmResult<()> {
         // Set the device communication parameters
         self.device_com = device_com.clone();
+        self.page1[direct_parameter_address!(MinCycleTime) as usize] =
+            device_com.min_cycle_time.into_bits();
+        self.page1[direct_parameter_address!(MSequenceCapability) as usize] =
+            device_com.msequence_capability.into_bits();
+        self.page1[direct_parameter_address!(RevisionID) as usize] =
+            device_com.revision_id.into_bits();
+        self.page1[direct_parameter_address!(ProcessDataIn) as usize] =
+            device_com.process_data_in.into_bits();
+        self.page1[direct_parameter_address!(ProcessDataOut) as usize] =
+            device_com.process_data_out.into_bits();
         Ok(())
     }
 
-    fn sm_get_device_com_req(
-        &mut self,
-        application_layer: &al::ApplicationLayer<ALS>,
-    ) -> SmResult<()> {
+    fn sm_get_device_com_req(&mut self, application_layer: &AL) -> SmResult<()> {
         // Return the current device communication parameters
         // Typically, this would trigger a confirmation callback
         // Here, we just return Ok(())
@@ -990,13 +977,16 @@ impl<
     fn sm_set_device_ident_req(&mut self, device_ident: &DeviceIdent) -> SmResult<()> {
         // Set the device identification parameters
         self.device_ident = device_ident.clone();
+        let vendor_id = direct_parameter_address!(VendorID1) as usize;
+        let device_id = direct_parameter_address!(DeviceID1) as usize;
+        let function_id = direct_parameter_address!(FunctionID1) as usize;
+        self.page1[vendor_id..vendor_id + 2].copy_from_slice(&device_ident.vendor_id);
+        self.page1[device_id..device_id + 3].copy_from_slice(&device_ident.device_id);
+        self.page1[function_id..function_id + 2].copy_from_slice(&device_ident.function_id);
         Ok(())
     }
 
-    fn sm_get_device_ident_req(
-        &mut self,
-        application_layer: &al::ApplicationLayer<ALS>,
-    ) -> SmResult<()> {
+    fn sm_get_device_ident_req(&mut self, application_layer: &AL) -> SmResult<()> {
         // Return the current device identification parameters
         let device_ident = Ok(&self.device_ident);
         application_layer.sm_get_device_ident_cnf(device_ident)?;
@@ -0,0 +1,76 @@
+//! Binary trace of the IO-Link Device Stack state machines.
+//!
+//! With the `trace` feature enabled, every event handled by a state machine of the
+//! stack writes a 12 octet [`TraceRecord`] into a static ring of
+//! `IODevice.Trace.RingLength` records (see `iolinke_util::trace`), the oldest records
+//! are overwritten. The ring takes `12 * RingLength` octets of RAM and is shared by all
+//! devices of the firmware.
+//!
+//! The records hold the hash of the module and the indices of the states and of the
+//! event. [`TRACE_MODULES`] is the symbol table of the state machines of this
+//! firmware, generated by `#[derive(TraceId)]` from the state and event enums. A host
+//! built with the same configuration and features decodes a dumped ring with [`decode`].
+//!
+//! ## Usage
+//!
+//! ```ignore
+//! let mut records = [TraceRecord::default(); 16];
+//! let count = iolinke_device::trace::dump(&mut records);
+//! for record in &records[..count] {
+//!     if let Some(entry) = iolinke_device::trace::decode(record) {
+//!         println!("{entry}");
+//!     }
+//! }
+//! ```
+
+pub use iolinke_util::trace::{
+    TRACE_REJECTED, TRACE_RING_LENGTH, TraceClock, TraceEntry, TraceModule, TraceRecord, dump,
+    reset, set_trace_clock,
+};
+
+use core::option::Option;
+
+use crate::{al, dl, system_management};
+
+/// Number of traced state machines
+const TRACE_MODULE_COUNT: usize = dl::TRACE_MODULES.len() + al::TRACE_MODULES.len() + 1;
+
+/// Symbol tables of all traced state machines
+pub const TRACE_MODULES: [TraceModule; TRACE_MODULE_COUNT] = {
+    let mut modules = [system_management::TRACE_MODULE; TRACE_MODULE_COUNT];
+    let mut i = 0;
+    while i < dl::TRACE_MODULES.len() {
+        modules[1 + i] = dl::TRACE_MODULES[i];
+        i += 1;
+    }
+    let mut j = 0;
+    while j < al::TRACE_MODULES.len() {
+        modules[1 + i + j] = al::TRACE_MODULES[j];
+        j += 1;
+    }
+    modules
+};
+
+const _: () = {
+    let mut i = 0;
+    while i < TRACE_MODULE_COUNT {
+        let mut j = i + 1;
+        while j < TRACE_MODULE_COUNT {
+            assert!(
+                TRACE_MODULES[i].id != TRACE_MODULES[j].id,
+                "Two traced modules have the same module id"
+            );
+            j += 1;
+        }
+        i += 1;
+    }
+};
+
+/// Looks up the names of `record` in [`TRACE_MODULES`].
+///
+/// # Returns
+/// - The decoded record.
+/// - `None` if the record is not from a state machine of this firmware.
+pub fn decode(record: &TraceRecord) -> Option<TraceEntry> {
+    TraceModule::decode(&TRACE_MODULES, record)
+}
@@ -0,0 +1,6 @@
+//! Re-exports the device memory budget configuration from the `iolinke_dev_config` crate.
+//!
+//! The RAM budget is checked at compile time by the bindings, the flash budget by
+//! `cargo configuration`.
+
+pub use iolinke_dev_config::device::budget::{flash_bytes, ram_bytes};
@@ -0,0 +1,8 @@
+//! Re-exports the Event reporting configuration from the `iolinke_dev_config` crate.
+//!
+//! The queue depth sizes the application Event queue and the aggregation table, the
+//! rate limit is applied per EventCode by the AL Event handler.
+
+pub use iolinke_dev_config::device::events::{
+    MAX_EVENT_QUEUE_DEPTH, queue_depth, rate_limit_cycles,
+};
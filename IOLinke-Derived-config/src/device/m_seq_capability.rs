@@ -282,8 +282,10 @@ pub mod operate_m_sequence {
 // values for ISDU are listed in Table B.4.
 /// - `0` = ISDU not supported
 /// - `1` = ISDU supported
+///
+/// Selected with `IODevice.Services.Isdu` in `device_config.toon`
 pub const fn isdu_supported() -> bool {
-    true // Accepted values true for ISDU support, false for no support
+    iolinke_dev_config::device::services::isdu()
 }
 
 /// ## M-sequenceCapability (B.1.4)
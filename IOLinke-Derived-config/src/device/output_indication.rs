@@ -0,0 +1,9 @@
+//! Re-exports the output Process Data indication configuration from the
+//! `iolinke_dev_config` crate.
+//!
+//! Selects the filtering of AL_NewOutput and AL_PDCycle in the Process Data Handler of the
+//! Application Layer.
+
+pub use iolinke_dev_config::device::output_indication::{
+    coalesce_pd_cycle, min_interval_cycles, on_change,
+};
@@ -0,0 +1,5 @@
+//! Re-exports the device port count configuration from the `iolinke_dev_config` crate.
+//!
+//! The port count sizes the device instance table of the bindings.
+
+pub use iolinke_dev_config::device::ports::{MAX_PORT_COUNT, port_count};
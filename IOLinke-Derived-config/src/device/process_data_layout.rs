@@ -0,0 +1,55 @@
+//! Typed layout of the Process Data, generated from `IODevice.Operate.PdIn` and
+//! `IODevice.Operate.PdOut` of `device_config.toon`.
+//!
+//! `#[process_data_layout]` turns the bit offsets of the fields into the straight-line
+//! [`PdIn::pack`] and [`PdOut::unpack`], which work on the zero-copy Process Data slots
+//! of the device (`acquire_pd_in_buffer` / `acquire_pd_out_buffer`). The structs are
+//! `#[repr(C)]` and exported to C by the bindings.
+
+use crate::device::process_data::{pd_in, pd_out};
+use iolinke_macros::process_data_layout;
+
+/// Input Process Data (Device to Master)
+#[process_data_layout(length = /*CONFIG:PD_IN_LAYOUT_LENGTH*/ 3 /*ENDCONFIG*/)]
+#[repr(C)]
+#[derive(Debug, Clone, Copy, Default, PartialEq)]
+pub struct PdIn {
+    /*CONFIG:PD_IN_LAYOUT*/
+    /// Bit 0
+    #[pd_field(bit_offset = 0, bit_length = 1)]
+    pub alarm: bool,
+    /// Bits 4-7
+    #[pd_field(bit_offset = 4, bit_length = 4)]
+    pub level: u8,
+    /// Bits 8-23
+    #[pd_field(bit_offset = 8, bit_length = 16)]
+    pub temperature: i16,
+    /*ENDCONFIG*/
+}
+
+/// Output Process Data (Master to Device)
+#[process_data_layout(length = /*CONFIG:PD_OUT_LAYOUT_LENGTH*/ 4 /*ENDCONFIG*/)]
+#[repr(C)]
+#[derive(Debug, Clone, Copy, Default, PartialEq)]
+pub struct PdOut {
+    /*CONFIG:PD_OUT_LAYOUT*/
+    /// Bit 0
+    #[pd_field(bit_offset = 0, bit_length = 1)]
+    pub enable: bool,
+    /// Bits 8-15
+    #[pd_field(bit_offset = 8, bit_length = 8)]
+    pub mode: u8,
+    /// Bits 16-31
+    #[pd_field(bit_offset = 16, bit_length = 16)]
+    pub setpoint: i16,
+    /*ENDCONFIG*/
+}
+
+const _: () = assert!(
+    PdIn::LENGTH == pd_in::config_length_in_bytes() as usize,
+    "PdIn layout does not match IODevice.Operate.PdInLength"
+);
+const _: () = assert!(
+    PdOut::LENGTH == pd_out::config_length_in_bytes() as usize,
+    "PdOut layout does not match IODevice.Operate.PdOutLength"
+);
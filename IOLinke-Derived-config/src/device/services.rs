@@ -0,0 +1,6 @@
+//! Re-exports the device service configuration from the `iolinke_dev_config` crate.
+//!
+//! The services select the ISDU, Event and Data Storage state machines of the device
+//! stack and the ISDU bit of the M-sequenceCapability.
+
+pub use iolinke_dev_config::device::services::{data_storage, events, isdu};
@@ -0,0 +1,5 @@
+//! Re-exports the state transition trace configuration from the `iolinke_dev_config` crate.
+//!
+//! The ring length sizes the static trace ring of the `trace` feature of `iolinke_util`.
+
+pub use iolinke_dev_config::device::trace::{MAX_TRACE_RING_LENGTH, ring_length};
@@ -158,6 +158,29 @@ pub mod storage_config {
     const FUNCTION_ID_1_CONFIG_VALUE: u8 = config_values::function_id_1();
     const FUNCTION_ID_2_CONFIG_VALUE: u8 = config_values::function_id_2();
 
+    /// Direct Parameter Page 1 (Annex B.1) with the configured values of the read-only
+    /// parameters, the same values as the storage rows of index 0x0000 below.
+    ///
+    /// System Management answers page reads from a copy of it during startup.
+    pub const DIRECT_PARAMETER_PAGE_1: [u8; 16] = [
+        0, // MasterCommand
+        0, // MasterCycleTime
+        MIN_CYCLE_TIME_CONFIG_VALUE,
+        M_SEQUENCE_CAPABILITY_CONFIG_VALUE,
+        REVISION_ID_CONFIG_VALUE,
+        PROCESS_DATA_IN_CONFIG_VALUE,
+        PROCESS_DATA_OUT_CONFIG_VALUE,
+        VENDOR_ID_1_CONFIG_VALUE,
+        VENDOR_ID_2_CONFIG_VALUE,
+        DEVICE_ID_1_CONFIG_VALUE,
+        DEVICE_ID_2_CONFIG_VALUE,
+        DEVICE_ID_3_CONFIG_VALUE,
+        FUNCTION_ID_1_CONFIG_VALUE,
+        FUNCTION_ID_2_CONFIG_VALUE,
+        0, // Reserved
+        0, // SystemCommand
+    ];
+
     // The following macro invocation declares the parameter storage layout for the device.
     // Each tuple specifies:
     //   (Index, Subindex, Length, IndexRange, Access, Type, DefaultValue)
@@ -188,13 +211,14 @@ pub mod storage_config {
         (    /* SYSTEM_COMMAND_INDEX */ 0x0002,        /* SYSTEM_COMMAND_SUBINDEX */ 0x00,             /* Default */  1,       0..0, WriteOnly,   u8, &[0]),
         (/* DATA_STORAGE_INDEX_INDEX */ 0x0003,            /* DS_COMMAND_SUBINDEX */ 0x01,             /* Default */  1,       0..0, ReadWrite,   u8, &[0]),
         (/* DATA_STORAGE_INDEX_INDEX */ 0x0003,        /* STATE_PROPERTY_SUBINDEX */ 0x02,             /* Default */  1,       0..0, ReadWrite,   u8, &[0]),
-        (/* DATA_STORAGE_INDEX_INDEX */ 0x0003,     /* DATA_STORAGE_SIZE_SUBINDEX */ 0x03,             /* Default */  1,       0..0, ReadWrite,   u8, &[0]),
-        (/* DATA_STORAGE_INDEX_INDEX */ 0x0003,    /* PARAMETER_CHECKSUM_SUBINDEX */ 0x04,             /* Default */  1,       0..0, ReadWrite,   u8, &[0]),
+        // Data_Storage_Size, Parameter_Checksum and Index_List are filled in by declare_parameter_storage!
+        (/* DATA_STORAGE_INDEX_INDEX */ 0x0003,     /* DATA_STORAGE_SIZE_SUBINDEX */ 0x03,             /* Default */  4,       0..3, ReadOnly,    u32, &[0; 4]),
+        (/* DATA_STORAGE_INDEX_INDEX */ 0x0003,    /* PARAMETER_CHECKSUM_SUBINDEX */ 0x04,             /* Default */  4,       0..3, ReadOnly,    u32, &[0; 4]),
         (/* DATA_STORAGE_INDEX_INDEX */ 0x0003,            /* INDEX_LIST_SUBINDEX */ 0x05,   /* INDEX_LIST_LENGTH */ 30,      0..29, ReadWrite,   u8, &[0; 30]),
 
         /*CONFIG:VENDOR_PARAMS*/
         (            /* Index */ 0x0010,         /* Subindex */ 0x00,               /* Length */ 7,        /* IndexRange */ 0..6,        /* Access */ ReadOnly,     /* Type */ StringT,  /* DefaultValue */ b"IOLinke"),
-        (            /* Index */ 0x0012,         /* Subindex */ 0x00,               /* Length */ 7,        /* IndexRange */ 0..6,        /* Access */ ReadOnly,     /* Type */ StringT,  /* DefaultValue */ b"IOLinke Stack"),
+        (            /* Index */ 0x0012,         /* Subindex */ 0x00,               /* Length */ 7,        /* IndexRange */ 0..6,        /* Access */ ReadOnly,     /* Type */ StringT,  /* DefaultValue */ b"IOLinke"),
         /*ENDCONFIG*/
     }
 }
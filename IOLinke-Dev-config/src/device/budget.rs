@@ -0,0 +1,24 @@
+//! Device Memory Budget Configuration
+//!
+//! This module provides the memory budget of the device stacks on the target MCU, so
+//! the OD lengths, Event queue depth and port count of a configuration can be traded
+//! against the RAM and flash of a hub SKU.
+//!
+//! - The RAM budget covers the static memory of all device ports. The bindings fail to
+//!   compile when the device instances exceed it.
+//! - The flash budget covers the firmware image. `cargo configuration --elf <firmware>`
+//!   checks the image against it.
+//!
+//! A budget of 0 is not checked.
+
+/// Returns the configured RAM budget of all device ports in octets
+pub const fn ram_bytes() -> usize {
+    const RAM_BUDGET_BYTES: usize = /*CONFIG:RAM_BUDGET_BYTES*/ 0 /*ENDCONFIG*/;
+    RAM_BUDGET_BYTES
+}
+
+/// Returns the configured flash budget of the firmware image in octets
+pub const fn flash_bytes() -> usize {
+    const FLASH_BUDGET_BYTES: usize = /*CONFIG:FLASH_BUDGET_BYTES*/ 0 /*ENDCONFIG*/;
+    FLASH_BUDGET_BYTES
+}
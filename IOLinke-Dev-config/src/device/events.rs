@@ -0,0 +1,35 @@
+//! Device Event Reporting Configuration
+//!
+//! This module provides the limits of the Event aggregation stage ahead of the AL Event
+//! handler. When a fault flaps, every occurrence would otherwise start its own Event
+//! signaling (Event flag, Master reads the Event memory, EventConf) and use up the
+//! on-request channel that ISDU traffic needs.
+//!
+//! - Occurrences of an Event which is still waiting to be reported are merged into it.
+//! - An EventCode is reported at most once per `rate_limit_cycles` Master cycles, later
+//!   occurrences are merged and reported when the interval expired.
+
+/// Maximum number of distinct Events held by the device stack
+pub const MAX_EVENT_QUEUE_DEPTH: usize = 64;
+
+/// Returns the configured number of distinct Events which can wait to be reported.
+///
+/// The lock-free queue of application Events and the aggregation table are both
+/// sized with this depth.
+///
+/// # Panics
+/// Panics if the configured value is 0 or greater than [`MAX_EVENT_QUEUE_DEPTH`].
+pub const fn queue_depth() -> usize {
+    const EVENT_QUEUE_DEPTH: usize = /*CONFIG:EVENT_QUEUE_DEPTH*/ 8 /*ENDCONFIG*/;
+    if EVENT_QUEUE_DEPTH == 0 || EVENT_QUEUE_DEPTH > MAX_EVENT_QUEUE_DEPTH {
+        core::panic!("Invalid event queue depth configuration. Valid range: 1–64 events");
+    }
+    EVENT_QUEUE_DEPTH
+}
+
+/// Returns the configured minimum number of Master cycles between two reports of the
+/// same EventCode, 0 disables the rate limit.
+pub const fn rate_limit_cycles() -> u32 {
+    const EVENT_RATE_LIMIT_CYCLES: u32 = /*CONFIG:EVENT_RATE_LIMIT_CYCLES*/ 100 /*ENDCONFIG*/;
+    EVENT_RATE_LIMIT_CYCLES
+}
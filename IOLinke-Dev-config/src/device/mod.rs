@@ -8,7 +8,13 @@
 //! - **M-Sequence Capability**: M-sequence type and timing configuration
 //! - **Vendor Specifics**: Vendor-specific configuration parameters
 //! - **Process Data**: Process data configuration and settings
+//! - **Output Indication**: Change detection and throttling of AL_NewOutput
 //! - **Timings**: Protocol timing and cycle time configuration
+//! - **Ports**: Number of device ports hosted by one MCU
+//! - **Events**: Event queue depth and rate limit of the Event reporting
+//! - **Services**: Optional ISDU, Event and Data Storage services
+//! - **Budget**: RAM and flash budget of the device stacks
+//! - **Trace**: Length of the binary state transition trace ring
 //!
 //! ## Specification Compliance
 //!
@@ -16,7 +22,13 @@
 //! - Annex B: Device Configuration Parameters
 //! - Section 8.2: Process Data Configuration
 
+pub mod budget;
+pub mod events;
 pub mod on_req_data;
+pub mod output_indication;
+pub mod ports;
 pub mod process_data;
+pub mod services;
 pub mod timings;
+pub mod trace;
 pub mod vendor_specifics;
@@ -0,0 +1,39 @@
+//! Output Process Data Indication Configuration
+//!
+//! By default every output Process Data received from the Master is indicated to the
+//! device application with AL_NewOutput, once per Master cycle. Actuators whose outputs
+//! rarely change can filter the indications in the Application Layer:
+//!
+//! - With `on_change`, AL_NewOutput is only indicated if the output Process Data differs
+//!   from the one of the last AL_NewOutput.
+//! - With `min_interval_cycles`, at most one AL_NewOutput is indicated per that many
+//!   received output Process Data. The latest value is indicated once the interval
+//!   expired, so no change is lost while the Master keeps sending.
+//! - With `coalesce_pd_cycle`, the DL_PDCycle indications received between two polls
+//!   of the Application Layer raise one AL_PDCycle. This only has an effect with the
+//!   `split_layers` feature of the device crate, without it the Application Layer is
+//!   polled right after every DL_PDCycle.
+//!
+//! The PDOUTVALID and PDOUTINVALID AL_Control indications are never filtered, and the
+//! first output Process Data after either is always indicated.
+
+/// Returns `true` if AL_NewOutput is only indicated for changed output Process Data
+pub const fn on_change() -> bool {
+    const PD_OUT_ON_CHANGE: bool = /*CONFIG:PD_OUT_ON_CHANGE*/ false /*ENDCONFIG*/;
+    PD_OUT_ON_CHANGE
+}
+
+/// Returns the configured minimum number of received output Process Data between two
+/// AL_NewOutput indications, 0 disables the throttling.
+pub const fn min_interval_cycles() -> u32 {
+    const PD_OUT_MIN_INTERVAL_CYCLES: u32 =
+        /*CONFIG:PD_OUT_MIN_INTERVAL_CYCLES*/ 0 /*ENDCONFIG*/;
+    PD_OUT_MIN_INTERVAL_CYCLES
+}
+
+/// Returns `true` if the DL_PDCycle indications between two Application Layer polls raise
+/// one AL_PDCycle
+pub const fn coalesce_pd_cycle() -> bool {
+    const PD_CYCLE_COALESCE: bool = /*CONFIG:PD_CYCLE_COALESCE*/ false /*ENDCONFIG*/;
+    PD_CYCLE_COALESCE
+}
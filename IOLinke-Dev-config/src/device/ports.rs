@@ -0,0 +1,22 @@
+//! Device Port Count Configuration
+//!
+//! This module provides the number of IO-Link device ports (device stack instances)
+//! hosted by a single MCU, e.g. a multi-channel IO-Link hub.
+//!
+//! Every port owns a complete, independent device stack. The bindings reserve the
+//! memory for all ports statically, so the count should match the hardware.
+
+/// Maximum number of device ports supported on a single MCU
+pub const MAX_PORT_COUNT: usize = 16;
+
+/// Returns the configured number of device ports.
+///
+/// # Panics
+/// Panics if the configured value is 0 or greater than [`MAX_PORT_COUNT`].
+pub const fn port_count() -> usize {
+    const PORT_COUNT: usize = /*CONFIG:PORT_COUNT*/ 1 /*ENDCONFIG*/;
+    if PORT_COUNT == 0 || PORT_COUNT > MAX_PORT_COUNT {
+        core::panic!("Invalid port count configuration. Valid range: 1–16 ports");
+    }
+    PORT_COUNT
+}
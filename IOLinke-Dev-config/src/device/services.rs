@@ -0,0 +1,35 @@
+//! Device Service Configuration
+//!
+//! This module selects the optional services of the device stack. A simple device, e.g.
+//! a binary switching sensor, may do without ISDU, Events and Data Storage. A disabled
+//! service is replaced by a zero-sized stub in `iolinke-device`, which answers the Master
+//! with the "no service" responses of the specification.
+//!
+//! - Data Storage is transferred through ISDU and requests its upload with an Event, so
+//!   it needs both of them.
+//! - The Cargo features `isdu`, `events` and `data_storage` of `iolinke-device` have to
+//!   match this configuration, a mismatch is reported at compile time.
+
+/// Returns `true` if the ISDU communication channel is supported
+pub const fn isdu() -> bool {
+    const SERVICE_ISDU: bool = /*CONFIG:SERVICE_ISDU*/ true /*ENDCONFIG*/;
+    SERVICE_ISDU
+}
+
+/// Returns `true` if the device reports Events
+pub const fn events() -> bool {
+    const SERVICE_EVENTS: bool = /*CONFIG:SERVICE_EVENTS*/ true /*ENDCONFIG*/;
+    SERVICE_EVENTS
+}
+
+/// Returns `true` if the device supports Data Storage
+///
+/// # Panics
+/// Panics if Data Storage is enabled without ISDU or Events.
+pub const fn data_storage() -> bool {
+    const SERVICE_DATA_STORAGE: bool = /*CONFIG:SERVICE_DATA_STORAGE*/ true /*ENDCONFIG*/;
+    if SERVICE_DATA_STORAGE && !(isdu() && events()) {
+        core::panic!("Invalid service configuration. Data Storage requires ISDU and Events");
+    }
+    SERVICE_DATA_STORAGE
+}
@@ -0,0 +1,24 @@
+//! Device State Transition Trace Configuration
+//!
+//! This module provides the length of the binary trace ring of the `trace` feature. Every
+//! state transition of the device stack writes one record into the ring, the oldest
+//! records are overwritten. The ring is a power of two long, so the write position is
+//! masked instead of divided.
+
+/// Maximum number of records in the trace ring
+pub const MAX_TRACE_RING_LENGTH: usize = 1024;
+
+/// Returns the configured number of records in the trace ring.
+///
+/// # Panics
+/// Panics if the configured value is not a power of two or greater than
+/// [`MAX_TRACE_RING_LENGTH`].
+pub const fn ring_length() -> usize {
+    const TRACE_RING_LENGTH: usize = /*CONFIG:TRACE_RING_LENGTH*/ 64 /*ENDCONFIG*/;
+    if !TRACE_RING_LENGTH.is_power_of_two() || TRACE_RING_LENGTH > MAX_TRACE_RING_LENGTH {
+        core::panic!(
+            "Invalid trace ring length configuration. Valid range: 1–1024 records, power of two"
+        );
+    }
+    TRACE_RING_LENGTH
+}
@@ -111,6 +111,15 @@ int main(void)
 
     /* USER CODE BEGIN 3 */
     iolinke_device_poll(iolinke_device);
+    /* WFI also wakes on an interrupt pending while masked, so work marked by an
+       interrupt after the check is not slept through */
+    __disable_irq();
+    if (!iolinke_device_has_pending_work(iolinke_device))
+    {
+      /* Nothing to do until the next UART or timer interrupt */
+      __WFI();
+    }
+    __enable_irq();
   }
   /* USER CODE END 3 */
 }
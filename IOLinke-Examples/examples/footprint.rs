@@ -0,0 +1,48 @@
+//! Static memory footprint of the configured device stack
+//!
+//! Prints the RAM of every component of one device port, of all ports and the stack
+//! estimate of the poll for the configuration in `device_config.toon`.
+//! `cargo configuration` runs this example after writing the configuration.
+//!
+//! The sizes are measured on the host. Targets with 32 bit pointers need a few octets
+//! less, and the bindings check the devices against the RAM budget when they are
+//! compiled for the target.
+//!
+//! ## Usage
+//!
+//! ```bash
+//! cargo run -p iolinke-examples --example footprint
+//! ```
+//!
+//! Exits with an error if the device ports exceed `IODevice.Budget.RamBytes`.
+
+use iolinke_derived_config::device::{budget, ports};
+use iolinke_device::footprint;
+
+/// Prints one line of the report
+fn print_size(name: &str, size: usize) {
+    println!("  {name:<32}{size:>8} octets");
+}
+
+fn main() {
+    println!("Device stack RAM footprint (host sizes)");
+    for component in footprint::components() {
+        print_size(component.name, component.size);
+    }
+    let port_count = ports::port_count();
+    let ram = footprint::port_ram() * port_count;
+    print_size("One device port", footprint::port_ram());
+    print_size(&format!("{port_count} device ports"), ram);
+    print_size("Poll stack estimate", footprint::stack_estimate());
+
+    let ram_budget = budget::ram_bytes();
+    if ram_budget == 0 {
+        return;
+    }
+    print_size("RAM budget", ram_budget);
+    if ram > ram_budget {
+        let excess = ram - ram_budget;
+        eprintln!("IODevice.Budget.RamBytes exceeded by {excess} octets");
+        std::process::exit(1);
+    }
+}
@@ -0,0 +1,59 @@
+//! Benchmarks of complete master/device cycles
+//!
+//! The device is driven by [`SyncTestDevice`] in the benchmark thread, so a sample is
+//! the time from the first byte of the master frame to the device response. The log
+//! output of the stack is switched off, as in the simulator.
+//!
+//! Run with `cargo bench -p iolinke-test-utils --bench cycle_benches`.
+use criterion::{Criterion, black_box, criterion_group, criterion_main};
+
+use iolinke_derived_config::device as derived_config;
+use iolinke_device::direct_parameter_address;
+use iolinke_test_utils::{SimulatedMaster, Simulator, SyncTestDevice, frame_utils};
+use iolinke_util::log_utils;
+
+const OP_OD_LENGTH: usize = derived_config::on_req_data::operate::od_length() as usize;
+
+/// One Operate mode cycle reading a Direct Parameter page 1 value
+fn bench_operate_read_cycle(c: &mut Criterion) {
+    let _log_suppression = log_utils::suppress_log();
+    let mut sync_device = SyncTestDevice::new();
+    assert!(sync_device.startup_to_operate(), "Device did not reach Operate mode");
+    let master_frame = frame_utils::create_op_read_request(direct_parameter_address!(MinCycleTime));
+    c.bench_function("operate_cycle_page_read", |b| {
+        b.iter(|| black_box(sync_device.transfer(black_box(&master_frame))))
+    });
+}
+
+/// One Operate mode cycle writing the MasterCycleTime with new PD out
+fn bench_operate_write_cycle(c: &mut Criterion) {
+    let _log_suppression = log_utils::suppress_log();
+    let mut sync_device = SyncTestDevice::new();
+    assert!(sync_device.startup_to_operate(), "Device did not reach Operate mode");
+    let master_frame = frame_utils::create_op_write_request(
+        direct_parameter_address!(MasterCycleTime),
+        &[0x42; OP_OD_LENGTH],
+    );
+    c.bench_function("operate_cycle_page_write", |b| {
+        b.iter(|| black_box(sync_device.transfer(black_box(&master_frame))))
+    });
+}
+
+/// Operate mode cycles on the virtual time simulator, including the UART timing
+fn bench_simulated_operate_cycles(c: &mut Criterion) {
+    let mut simulator = Simulator::new();
+    let master = SimulatedMaster::new(simulator.min_cycle_time());
+    assert!(master.startup_to_operate(&mut simulator), "Device did not reach Operate mode");
+    let master_frame = frame_utils::create_op_read_request(direct_parameter_address!(MinCycleTime));
+    c.bench_function("simulated_operate_cycle", |b| {
+        b.iter(|| black_box(master.cycle(&mut simulator, black_box(&master_frame))))
+    });
+}
+
+criterion_group!(
+    cycle_benches,
+    bench_operate_read_cycle,
+    bench_operate_write_cycle,
+    bench_simulated_operate_cycles
+);
+criterion_main!(cycle_benches);
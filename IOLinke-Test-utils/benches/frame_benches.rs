@@ -0,0 +1,94 @@
+//! Benchmarks of the frame encode/decode hot path
+//!
+//! Run with `cargo bench -p iolinke-test-utils --bench frame_benches`.
+use criterion::{Criterion, black_box, criterion_group, criterion_main};
+
+use iolinke_derived_config::device as derived_config;
+use iolinke_device::direct_parameter_address;
+use iolinke_test_utils::frame_utils;
+use iolinke_types::frame::msequence::{PdStatus, RwDirection};
+use iolinke_types::handlers::pm::{DeviceParametersIndex, SubIndex};
+use iolinke_util::frame_fromat::checksum::{calculate_isdu_checksum, calculate_m_sequence_checksum};
+use iolinke_util::frame_fromat::isdu::RxIsduMessageBuffer;
+use iolinke_util::frame_fromat::message::{
+    DeviceOperationMode, FrameCodec, MAX_RX_FRAME_SIZE, MAX_TX_FRAME_SIZE, RxMessageBuffer,
+    TxMessageBuffer,
+};
+
+const OP_OD_LENGTH: usize = derived_config::on_req_data::operate::od_length() as usize;
+const PD_IN_LENGTH: usize = derived_config::process_data::pd_in::config_length_in_bytes() as usize;
+
+/// Operate mode request and response through the codec selected once per mode
+fn bench_frame_codec(c: &mut Criterion) {
+    let codec =
+        FrameCodec::<MAX_RX_FRAME_SIZE, MAX_TX_FRAME_SIZE>::of(DeviceOperationMode::Operate);
+    let master_frame = frame_utils::create_op_write_request(
+        direct_parameter_address!(MasterCycleTime),
+        &[0x42; OP_OD_LENGTH],
+    );
+    let mut rx_buffer: RxMessageBuffer<MAX_RX_FRAME_SIZE> = RxMessageBuffer::new();
+    c.bench_function("frame_codec_valid_req_operate", |b| {
+        b.iter(|| {
+            rx_buffer.clear();
+            let _ = rx_buffer.push_slice(black_box(&master_frame));
+            black_box(codec.valid_req(&mut rx_buffer))
+        })
+    });
+
+    let od = [0x5A; OP_OD_LENGTH];
+    let pd_in = [0xA5; PD_IN_LENGTH];
+    let mut tx_buffer: TxMessageBuffer<MAX_TX_FRAME_SIZE> = TxMessageBuffer::new();
+    c.bench_function("frame_codec_compile_message_rsp_operate", |b| {
+        b.iter(|| {
+            let _ = codec.insert_od(&mut tx_buffer, OP_OD_LENGTH, black_box(&od));
+            let _ = codec.insert_pd(&mut tx_buffer, black_box(&pd_in));
+            black_box(codec.compile_message_rsp(
+                &mut tx_buffer,
+                RwDirection::Read,
+                false,
+                PdStatus::VALID,
+            ))
+        })
+    });
+}
+
+/// Parsing of reassembled ISDU read and write requests
+fn bench_isdu_extract(c: &mut Criterion) {
+    let index = DeviceParametersIndex::VendorName.index();
+    let sub_index = DeviceParametersIndex::VendorName.subindex(SubIndex::VendorName);
+    let read_request = frame_utils::isdu_frame::create_isdu_read_request(index, Some(sub_index));
+    let write_request =
+        frame_utils::isdu_frame::create_isdu_write_request(index, Some(sub_index), &[0x33; 32]);
+
+    let mut read_buffer = RxIsduMessageBuffer::new();
+    read_buffer.extend(&read_request);
+    c.bench_function("rx_isdu_extract_isdu_data_read", |b| {
+        b.iter(|| black_box(black_box(&read_buffer).extract_isdu_data().is_ok()))
+    });
+
+    let mut write_buffer = RxIsduMessageBuffer::new();
+    write_buffer.extend(&write_request);
+    c.bench_function("rx_isdu_extract_isdu_data_write_32", |b| {
+        b.iter(|| black_box(black_box(&write_buffer).extract_isdu_data().is_ok()))
+    });
+}
+
+/// M-sequence checksum of the largest frame and ISDU checksum of the largest ISDU
+fn bench_checksum(c: &mut Criterion) {
+    let frame: Vec<u8> = (0..MAX_RX_FRAME_SIZE as u8).collect();
+    c.bench_function("m_sequence_checksum_max_rx_frame", |b| {
+        b.iter(|| black_box(calculate_m_sequence_checksum(frame.len(), black_box(&frame))))
+    });
+    let isdu: Vec<u8> = (0..=237u8).collect();
+    c.bench_function("isdu_checksum_max_isdu", |b| {
+        b.iter(|| black_box(calculate_isdu_checksum(isdu.len(), black_box(&isdu))))
+    });
+}
+
+criterion_group!(
+    frame_benches,
+    bench_frame_codec,
+    bench_isdu_extract,
+    bench_checksum
+);
+criterion_main!(frame_benches);
@@ -0,0 +1,645 @@
+//! Multi-threaded runtime of many virtual devices against one simulated master
+//!
+//! The [`Fleet`] runs thousands of `IoLinkDevice` instances in one process, e.g. for
+//! load tests of a master or gateway without hardware:
+//!
+//! - The devices are grouped into chunks of [`FleetConfig::chunk_size`] devices. A pool
+//!   of [`FleetConfig::workers`] threads takes the chunks round-robin from an atomic
+//!   cursor and claims a chunk with a compare-and-swap. A worker never waits for
+//!   another: a chunk claimed by a slower worker is skipped and taken by the next idle
+//!   one. This balances the load like work stealing without per-worker deques.
+//! - Every device has a lock-free [`SpscRing`] inbox. The master thread is its only
+//!   producer, the worker holding the chunk its only consumer.
+//! - Frame delivery is batched per chunk: one claim delivers the queued master frame of
+//!   every device of the chunk, each frame with one `pl_transfer_ind_burst`. The master
+//!   sends the next frame to a device only after the device processed the previous
+//!   one, so an inbox holds at most one frame and a claim delivers one frame per device.
+//! - The response latency of every frame, from the push by the master to the
+//!   `pl_transfer_req` of the device, is recorded in a [`LatencyHistogram`] per device.
+//!
+//! The master sends the next frame to a device as soon as the device answered the
+//! previous one, so a run measures the throughput of the stack, not a cycle time.
+//! Timers are not indicated to the devices, the same as for `SyncTestDevice`.
+//!
+//! The log output of the stack is switched off while the fleet lives. With the `trace` feature all devices
+//! share one trace ring, see `iolinke_util::trace`.
+//!
+//! # Example
+//!
+//! ```ignore
+//! let mut fleet = Fleet::new(FleetConfig { devices: 10_000, ..FleetConfig::default() });
+//! assert!(fleet.startup_to_operate());
+//! let frame = frame_utils::create_op_read_request(0x02);
+//! let report = fleet.run_cycles(&frame, 1_000);
+//! println!("{:.0} cycles/s, p99 {:?}", report.cycles_per_second(), report.latency.p99);
+//! ```
+use core::cell::UnsafeCell;
+use core::sync::atomic::{AtomicBool, AtomicU32, AtomicUsize, Ordering};
+use std::sync::Arc;
+use std::thread::{self, JoinHandle};
+use std::time::{Duration, Instant};
+use std::vec::Vec;
+
+use core::default::Default;
+use core::iter::Iterator;
+use core::ops::{Deref, DerefMut, Drop};
+use core::option::{
+    Option,
+    Option::{None, Some},
+};
+use core::result::Result::Ok;
+
+use iolinke_device::{IoLinkDevice, PhysicalLayerReq, Timer};
+use iolinke_types::custom::IoLinkResult;
+use iolinke_types::handlers::sm::IoLinkMode;
+use iolinke_util::frame_fromat::message::MAX_RX_FRAME_SIZE;
+use iolinke_util::log_utils::{self, LogSuppression};
+use iolinke_util::spsc_ring::SpscRing;
+
+use crate::frame_utils;
+use crate::mock_app_layer::MockApplicationLayer;
+
+/// Capacity of the inbox of a device, `Fleet::run` keeps at most one frame in it
+const INBOX_LENGTH: usize = 4;
+/// Upper bound of polls for one master frame, protects against a state machine which
+/// never reports its work as done
+const MAX_POLLS_PER_FRAME: usize = 64;
+/// Sub-buckets of every power of two of the latency histogram, 8 bounds the error of a
+/// percentile to 12.5 %
+const SUB_BUCKET_BITS: u32 = 3;
+const SUB_BUCKETS: usize = 1 << SUB_BUCKET_BITS;
+/// Largest power of two of the latency histogram, 2^40 ns is about 18 minutes
+const MAX_EXPONENT: u32 = 40;
+const LATENCY_BUCKETS: usize = SUB_BUCKETS * (MAX_EXPONENT - SUB_BUCKET_BITS + 2) as usize;
+
+/// Size of the fleet
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub struct FleetConfig {
+    /// Number of virtual devices
+    pub devices: usize,
+    /// Number of worker threads
+    pub workers: usize,
+    /// Number of devices a worker processes per claim
+    pub chunk_size: usize,
+}
+
+impl Default for FleetConfig {
+    /// 1000 devices on one worker per CPU
+    fn default() -> Self {
+        Self {
+            devices: 1000,
+            workers: thread::available_parallelism().map_or(4, |workers| workers.get()),
+            chunk_size: 32,
+        }
+    }
+}
+
+/// Histogram of response latencies with logarithmic buckets
+#[derive(Debug, Clone, PartialEq, Eq)]
+pub struct LatencyHistogram {
+    counts: [u32; LATENCY_BUCKETS],
+    count: u64,
+    max: u64,
+}
+
+impl LatencyHistogram {
+    /// Creates an empty histogram
+    pub fn new() -> Self {
+        Self {
+            counts: [0; LATENCY_BUCKETS],
+            count: 0,
+            max: 0,
+        }
+    }
+
+    /// Records one latency
+    pub fn record(&mut self, latency: Duration) {
+        let nanos = latency.as_nanos().min(u64::MAX as u128) as u64;
+        let bucket = &mut self.counts[bucket_index(nanos)];
+        *bucket = bucket.saturating_add(1);
+        self.count += 1;
+        self.max = self.max.max(nanos);
+    }
+
+    /// Adds the latencies of `other`
+    pub fn merge(&mut self, other: &LatencyHistogram) {
+        for (count, other_count) in self.counts.iter_mut().zip(other.counts.iter()) {
+            *count = count.saturating_add(*other_count);
+        }
+        self.count += other.count;
+        self.max = self.max.max(other.max);
+    }
+
+    /// Returns the number of recorded latencies
+    pub fn count(&self) -> u64 {
+        self.count
+    }
+
+    /// Returns the latency `percentile` (0.0 to 100.0) of the recorded latencies
+    ///
+    /// # Returns
+    /// - The upper bound of the bucket of the percentile, at most the maximum latency.
+    /// - `Duration::ZERO` if nothing was recorded.
+    pub fn percentile(&self, percentile: f64) -> Duration {
+        if self.count == 0 {
+            return Duration::ZERO;
+        }
+        let rank = ((percentile.clamp(0.0, 100.0) / 100.0) * self.count as f64).ceil() as u64;
+        let rank = rank.max(1);
+        let mut seen = 0u64;
+        for (index, count) in self.counts.iter().enumerate() {
+            seen += *count as u64;
+            if seen >= rank {
+                return Duration::from_nanos(bucket_upper_bound(index).min(self.max));
+            }
+        }
+        Duration::from_nanos(self.max)
+    }
+
+    /// Returns the 50th, 90th and 99th percentile and the maximum
+    pub fn percentiles(&self) -> LatencyPercentiles {
+        LatencyPercentiles {
+            p50: self.percentile(50.0),
+            p90: self.percentile(90.0),
+            p99: self.percentile(99.0),
+            max: Duration::from_nanos(self.max),
+        }
+    }
+
+    /// Discards all recorded latencies
+    pub fn reset(&mut self) {
+        *self = Self::new();
+    }
+}
+
+impl Default for LatencyHistogram {
+    fn default() -> Self {
+        Self::new()
+    }
+}
+
+/// Returns the bucket of `nanos`, the values below `SUB_BUCKETS` have a bucket each
+fn bucket_index(nanos: u64) -> usize {
+    if nanos < SUB_BUCKETS as u64 {
+        return nanos as usize;
+    }
+    let exponent = 63 - nanos.leading_zeros();
+    if exponent > MAX_EXPONENT {
+        return LATENCY_BUCKETS - 1;
+    }
+    let shift = exponent - SUB_BUCKET_BITS;
+    let sub_bucket = (nanos >> shift) as usize & (SUB_BUCKETS - 1);
+    SUB_BUCKETS * (shift as usize + 1) + sub_bucket
+}
+
+/// Returns the largest value of the bucket `index`
+fn bucket_upper_bound(index: usize) -> u64 {
+    if index < SUB_BUCKETS {
+        return index as u64;
+    }
+    let shift = (index / SUB_BUCKETS - 1) as u32;
+    let lower = ((SUB_BUCKETS + index % SUB_BUCKETS) as u64) << shift;
+    lower + (1 << shift) - 1
+}
+
+/// Latency percentiles of one device or of the fleet
+#[derive(Debug, Clone, Copy, PartialEq, Eq, Default)]
+pub struct LatencyPercentiles {
+    /// Median
+    pub p50: Duration,
+    /// 90th percentile
+    pub p90: Duration,
+    /// 99th percentile
+    pub p99: Duration,
+    /// Largest latency
+    pub max: Duration,
+}
+
+/// Result of a run of [`Fleet::run_cycles`]
+#[derive(Debug, Clone, PartialEq)]
+pub struct FleetReport {
+    /// Number of master frames sent to all devices
+    pub cycles: u64,
+    /// Number of master frames the devices responded to
+    pub responses: u64,
+    /// Number of master frames without a device response
+    pub missed: u64,
+    /// Wall clock time of the run
+    pub elapsed: Duration,
+    /// Latencies of all devices
+    pub latency: LatencyPercentiles,
+    /// Latencies of every device, indexed like the devices
+    pub device_latency: Vec<LatencyPercentiles>,
+}
+
+impl FleetReport {
+    /// Returns the aggregate number of cycles per second of all devices
+    pub fn cycles_per_second(&self) -> f64 {
+        let seconds = self.elapsed.as_secs_f64();
+        if seconds == 0.0 {
+            return 0.0;
+        }
+        self.cycles as f64 / seconds
+    }
+}
+
+/// Physical layer of a fleet device, counts the responses handed to `pl_transfer_req`
+pub struct FleetPhysicalLayer {
+    tx_count: Arc<AtomicU32>,
+    mode: IoLinkMode,
+}
+
+impl FleetPhysicalLayer {
+    /// Returns the mode requested by the device
+    pub fn mode(&self) -> IoLinkMode {
+        self.mode
+    }
+}
+
+impl PhysicalLayerReq for FleetPhysicalLayer {
+    fn pl_set_mode_req(&mut self, mode: IoLinkMode) -> IoLinkResult<()> {
+        self.mode = mode;
+        Ok(())
+    }
+
+    fn pl_transfer_req(&mut self, _tx_data: &[u8]) -> IoLinkResult<()> {
+        self.tx_count.fetch_add(1, Ordering::Relaxed);
+        Ok(())
+    }
+
+    fn pl_stop_timer_req(&self, _timer: Timer) -> IoLinkResult<()> {
+        Ok(())
+    }
+
+    fn pl_start_timer_req(&self, _timer: Timer, _duration_us: u32) -> IoLinkResult<()> {
+        Ok(())
+    }
+
+    fn pl_restart_timer_req(&self, _timer: Timer, _duration_us: u32) -> IoLinkResult<()> {
+        Ok(())
+    }
+}
+
+/// Master frame queued in the inbox of a device
+#[derive(Clone, Copy)]
+struct MasterFrame {
+    length: u8,
+    data: [u8; MAX_RX_FRAME_SIZE],
+    sent_at: Instant,
+}
+
+impl MasterFrame {
+    fn data(&self) -> &[u8] {
+        &self.data[..self.length as usize]
+    }
+}
+
+/// Queues shared by the master and the worker of one device
+struct DeviceMailbox {
+    inbox: SpscRing<MasterFrame, INBOX_LENGTH>,
+    /// Number of master frames processed, written by the worker
+    processed: AtomicU32,
+}
+
+/// A virtual device with its statistics, only accessed while its chunk is claimed
+struct FleetDevice {
+    device: IoLinkDevice<FleetPhysicalLayer, MockApplicationLayer>,
+    tx_count: Arc<AtomicU32>,
+    latency: LatencyHistogram,
+    responses: u64,
+    missed: u64,
+}
+
+impl FleetDevice {
+    /// Creates a configured device which completed the wake-up and is in Startup mode
+    fn new() -> Self {
+        let tx_count = Arc::new(AtomicU32::new(0));
+        let physical_layer = FleetPhysicalLayer {
+            tx_count: Arc::clone(&tx_count),
+            mode: IoLinkMode::Inactive,
+        };
+        let mut fleet_device = Self {
+            device: IoLinkDevice::new(physical_layer, MockApplicationLayer::new_quiet()),
+            tx_count,
+            latency: LatencyHistogram::new(),
+            responses: 0,
+            missed: 0,
+        };
+        let _ = fleet_device.device.al_set_input_req(3, &[0x01, 0x02, 0x03]);
+        frame_utils::configure_and_wake_up(&mut fleet_device.device, poll_until_idle);
+        fleet_device
+    }
+
+    /// Delivers `frame` and polls the device until it responded or has no work pending
+    ///
+    /// A device which stops reporting pending work without responding counts as
+    /// missed, the same as firmware which sleeps until the next interrupt. Further polls
+    /// would hide such a stall of the scheduling.
+    fn transfer(&mut self, frame: &MasterFrame) {
+        let tx_count = self.tx_count.load(Ordering::Relaxed);
+        let _ = self.device.pl_transfer_ind_burst(frame.data());
+        for _ in 0..MAX_POLLS_PER_FRAME {
+            let _ = self.device.poll();
+            if self.tx_count.load(Ordering::Relaxed) != tx_count || !self.device.has_pending_work()
+            {
+                break;
+            }
+        }
+        if self.tx_count.load(Ordering::Relaxed) != tx_count {
+            self.responses += 1;
+            self.latency.record(frame.sent_at.elapsed());
+        } else {
+            self.missed += 1;
+        }
+    }
+
+    fn reset_statistics(&mut self) {
+        self.latency.reset();
+        self.responses = 0;
+        self.missed = 0;
+    }
+}
+
+/// Polls `device` until no state machine has work pending
+fn poll_until_idle(device: &mut IoLinkDevice<FleetPhysicalLayer, MockApplicationLayer>) {
+    for _ in 0..MAX_POLLS_PER_FRAME {
+        if !device.has_pending_work() {
+            break;
+        }
+        let _ = device.poll();
+    }
+}
+
+/// Devices processed by one claim of a worker
+struct Chunk {
+    claimed: AtomicBool,
+    devices: UnsafeCell<Vec<FleetDevice>>,
+}
+
+// SAFETY: `devices` is only accessed through a `ChunkGuard`, of which at most one
+// exists at a time, `claimed` orders the accesses of the threads
+unsafe impl Sync for Chunk {}
+
+impl Chunk {
+    /// Claims the chunk, `None` if another thread holds it
+    fn try_claim(&self) -> Option<ChunkGuard<'_>> {
+        self.claimed
+            .compare_exchange(false, true, Ordering::Acquire, Ordering::Relaxed)
+            .ok()
+            .map(|_| ChunkGuard { chunk: self })
+    }
+
+    /// Claims the chunk, waits until the worker holding it released it
+    fn claim(&self) -> ChunkGuard<'_> {
+        loop {
+            if let Some(guard) = self.try_claim() {
+                return guard;
+            }
+            thread::yield_now();
+        }
+    }
+}
+
+/// Exclusive access to the devices of a claimed chunk
+struct ChunkGuard<'a> {
+    chunk: &'a Chunk,
+}
+
+impl Deref for ChunkGuard<'_> {
+    type Target = Vec<FleetDevice>;
+
+    fn deref(&self) -> &Self::Target {
+        // SAFETY: The chunk is claimed by this guard
+        unsafe { &*self.chunk.devices.get() }
+    }
+}
+
+impl DerefMut for ChunkGuard<'_> {
+    fn deref_mut(&mut self) -> &mut Self::Target {
+        // SAFETY: The chunk is claimed by this guard
+        unsafe { &mut *self.chunk.devices.get() }
+    }
+}
+
+impl Drop for ChunkGuard<'_> {
+    fn drop(&mut self) {
+        self.chunk.claimed.store(false, Ordering::Release);
+    }
+}
+
+/// State shared by the master and the workers
+struct FleetShared {
+    chunks: Vec<Chunk>,
+    mailboxes: Vec<DeviceMailbox>,
+    chunk_size: usize,
+    /// Next chunk to be taken by a worker
+    cursor: AtomicUsize,
+    stop: AtomicBool,
+}
+
+impl FleetShared {
+    /// Processes the queued frames of the next unclaimed chunks
+    ///
+    /// # Returns
+    /// - `true` if a frame was processed.
+    fn work(&self) -> bool {
+        let mut worked = false;
+        for _ in 0..self.chunks.len() {
+            let index = self.cursor.fetch_add(1, Ordering::Relaxed) % self.chunks.len();
+            let Some(mut devices) = self.chunks[index].try_claim() else {
+                continue;
+            };
+            let first = index * self.chunk_size;
+            for (device, mailbox) in devices.iter_mut().zip(&self.mailboxes[first..]) {
+                while let Some(frame) = mailbox.inbox.pop() {
+                    device.transfer(&frame);
+                    mailbox.processed.fetch_add(1, Ordering::Release);
+                    worked = true;
+                }
+            }
+        }
+        worked
+    }
+}
+
+/// Virtual devices on a pool of worker threads, driven by a master in the calling thread
+pub struct Fleet {
+    shared: Arc<FleetShared>,
+    workers: Vec<JoinHandle<()>>,
+    /// Number of master frames sent to every device
+    sent: Vec<u32>,
+    _log_suppression: LogSuppression,
+}
+
+impl Fleet {
+    /// Creates `config.devices` configured devices in Startup mode and starts the workers
+    pub fn new(config: FleetConfig) -> Self {
+        let log_suppression = log_utils::suppress_log();
+        let chunk_size = config.chunk_size.max(1);
+        let chunks = (0..config.devices)
+            .step_by(chunk_size)
+            .map(|first| Chunk {
+                claimed: AtomicBool::new(false),
+                devices: UnsafeCell::new(
+                    (first..config.devices.min(first + chunk_size))
+                        .map(|_| FleetDevice::new())
+                        .collect(),
+                ),
+            })
+            .collect();
+        let mailboxes = (0..config.devices)
+            .map(|_| DeviceMailbox {
+                inbox: SpscRing::new(),
+                processed: AtomicU32::new(0),
+            })
+            .collect();
+        let shared = Arc::new(FleetShared {
+            chunks,
+            mailboxes,
+            chunk_size,
+            cursor: AtomicUsize::new(0),
+            stop: AtomicBool::new(false),
+        });
+        let workers = (0..config.workers.max(1))
+            .map(|worker| {
+                let shared = Arc::clone(&shared);
+                thread::Builder::new()
+                    .name(std::format!("fleet-worker-{worker}"))
+                    .spawn(move || {
+                        while !shared.stop.load(Ordering::Relaxed) {
+                            if !shared.work() {
+                                thread::yield_now();
+                            }
+                        }
+                    })
+                    .expect("Failed to spawn a fleet worker")
+            })
+            .collect();
+        Self {
+            shared,
+            workers,
+            sent: std::vec![0; config.devices],
+            _log_suppression: log_suppression,
+        }
+    }
+
+    /// Returns the number of devices
+    pub fn device_count(&self) -> usize {
+        self.sent.len()
+    }
+
+    /// Queues `master_frame` to `device`
+    ///
+    /// # Returns
+    /// - `false` if the inbox of the device is full.
+    fn send(&mut self, device: usize, master_frame: &[u8]) -> bool {
+        assert!(
+            master_frame.len() <= MAX_RX_FRAME_SIZE,
+            "Master frame longer than MAX_RX_FRAME_SIZE"
+        );
+        let mut frame = MasterFrame {
+            length: master_frame.len() as u8,
+            data: [0; MAX_RX_FRAME_SIZE],
+            sent_at: Instant::now(),
+        };
+        frame.data[..master_frame.len()].copy_from_slice(master_frame);
+        let queued = self.shared.mailboxes[device].inbox.push(frame);
+        if queued {
+            self.sent[device] = self.sent[device].wrapping_add(1);
+        }
+        queued
+    }
+
+    /// Returns `true` if `device` processed every frame sent to it
+    fn is_idle(&self, device: usize) -> bool {
+        self.shared.mailboxes[device]
+            .processed
+            .load(Ordering::Acquire)
+            == self.sent[device]
+    }
+
+    /// Sends `master_frame` `cycles` times to every device, the next frame as soon as the
+    /// device processed the previous one, and waits for all devices
+    fn run(&mut self, master_frame: &[u8], cycles: u64) {
+        let mut remaining = std::vec![cycles; self.device_count()];
+        let mut pending = self.device_count();
+        while pending > 0 {
+            pending = 0;
+            for device in 0..self.device_count() {
+                if !self.is_idle(device) {
+                    pending += 1;
+                } else if remaining[device] > 0 && self.send(device, master_frame) {
+                    remaining[device] -= 1;
+                    pending += 1;
+                }
+            }
+            if pending > 0 {
+                thread::yield_now();
+            }
+        }
+    }
+
+    /// Sums the statistics of all devices since the last reset
+    fn statistics(&self) -> (u64, u64, LatencyHistogram, Vec<LatencyPercentiles>) {
+        let mut responses = 0;
+        let mut missed = 0;
+        let mut latency = LatencyHistogram::new();
+        let mut device_latency = Vec::with_capacity(self.device_count());
+        for chunk in &self.shared.chunks {
+            for device in chunk.claim().iter() {
+                responses += device.responses;
+                missed += device.missed;
+                latency.merge(&device.latency);
+                device_latency.push(device.latency.percentiles());
+            }
+        }
+        (responses, missed, latency, device_latency)
+    }
+
+    fn reset_statistics(&self) {
+        for chunk in &self.shared.chunks {
+            for device in chunk.claim().iter_mut() {
+                device.reset_statistics();
+            }
+        }
+    }
+
+    /// Takes every device from Startup through PreOperate into Operate mode
+    ///
+    /// # Returns
+    /// - `true` if every device responded to every master command.
+    pub fn startup_to_operate(&mut self) -> bool {
+        self.reset_statistics();
+        for master_frame in frame_utils::startup_to_operate_requests() {
+            self.run(&master_frame, 1);
+        }
+        let (_, missed, _, _) = self.statistics();
+        missed == 0
+    }
+
+    /// Runs `cycles` M-sequence cycles with `master_frame` on every device
+    pub fn run_cycles(&mut self, master_frame: &[u8], cycles: u64) -> FleetReport {
+        self.reset_statistics();
+        let start = Instant::now();
+        self.run(master_frame, cycles);
+        let elapsed = start.elapsed();
+        let (responses, missed, latency, device_latency) = self.statistics();
+        FleetReport {
+            cycles: cycles * self.device_count() as u64,
+            responses,
+            missed,
+            elapsed,
+            latency: latency.percentiles(),
+            device_latency,
+        }
+    }
+}
+
+impl Drop for Fleet {
+    fn drop(&mut self) {
+        self.shared.stop.store(true, Ordering::Relaxed);
+        for worker in self.workers.drain(..) {
+            let _ = worker.join();
+        }
+    }
+}
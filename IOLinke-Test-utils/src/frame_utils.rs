@@ -3,14 +3,15 @@
 use iolinke_derived_config::device as derived_config;
 use iolinke_device::IoLinkDevice;
 use iolinke_device::{
-    CycleTime, DeviceCom, DeviceIdent, DeviceMode, MsequenceCapability, ProcessDataIn,
-    ProcessDataOut, RevisionId, SioMode, TransmissionRate,
+    DeviceCom, DeviceIdent, DeviceMode, PhysicalLayerReq, SioMode, TransmissionRate,
+    direct_parameter_address,
 };
 use iolinke_types::frame::isdu::IsduFlowCtrl;
 use iolinke_types::frame::msequence::{
     ChecksumMsequenceType, ChecksumMsequenceTypeBuilder, ChecksumStatus, ComChannel,
     MsequenceBaseType, MsequenceControl, MsequenceControlBuilder, RwDirection,
 };
+use iolinke_types::page::page1::MasterCommand;
 use iolinke_util::frame_fromat::message::calculate_checksum_for_testing;
 use std::sync::{Arc, Mutex};
 use std::vec::Vec;
@@ -52,25 +53,34 @@ pub fn validate_device_frame_checksum(data: &mut Vec<u8>) -> bool {
     cks_calculated_checksum == rec_cks
 }
 
+/// Device communication parameters used by the test device configuration, the
+/// configured ones of `device_config.toon`
+pub fn test_device_com() -> DeviceCom {
+    DeviceCom {
+        suppported_sio_mode: SioMode::default(),
+        transmission_rate: TransmissionRate::Com3,
+        min_cycle_time: derived_config::timings::min_cycle_time::min_cycle_time_parameter(),
+        msequence_capability: derived_config::m_seq_capability::m_sequence_capability_parameter(),
+        revision_id: derived_config::vendor_specifics::revision_id_parameter(),
+        process_data_in: derived_config::process_data::pd_in::pd_in_parameter(),
+        process_data_out: derived_config::process_data::pd_out::pd_out_parameter(),
+    }
+}
+
+/// Device identification used by the test device configuration, the configured one
+/// of `device_config.toon`
+pub fn test_device_ident() -> DeviceIdent {
+    DeviceIdent {
+        vendor_id: derived_config::vendor_specifics::VENDOR_ID,
+        device_id: derived_config::vendor_specifics::DEVICE_ID,
+        function_id: derived_config::vendor_specifics::FUNCTION_ID,
+    }
+}
+
 /// Sets up the device with basic configuration for testing
 pub fn setup_device_configuration(
     io_link_device: &Arc<Mutex<IoLinkDevice<MockPhysicalLayer, MockApplicationLayer>>>,
 ) {
-    let mseq_cap = derived_config::m_seq_capability::m_sequence_capability_parameter();
-    let mut min_cycle_time = CycleTime::new();
-    min_cycle_time.set_time_base(0b10);
-    min_cycle_time.set_multiplier(0b000001);
-    let mut revision_id = RevisionId::new();
-    revision_id.set_major_rev(1);
-    revision_id.set_minor_rev(1);
-    let mut process_data_in = ProcessDataIn::new();
-    process_data_in.set_length(9);
-    process_data_in.set_sio(true);
-    process_data_in.set_byte(true);
-    let mut process_data_out = ProcessDataOut::new();
-    process_data_out.set_length(9);
-    process_data_out.set_byte(true);
-
     let _ = io_link_device
         .lock()
         .unwrap()
@@ -79,24 +89,12 @@ pub fn setup_device_configuration(
     let _ = io_link_device
         .lock()
         .unwrap()
-        .sm_set_device_com_req(&DeviceCom {
-            suppported_sio_mode: SioMode::default(),
-            transmission_rate: TransmissionRate::Com3,
-            min_cycle_time: min_cycle_time,
-            msequence_capability: MsequenceCapability::from(mseq_cap),
-            revision_id: revision_id,
-            process_data_in: process_data_in,
-            process_data_out: process_data_out,
-        });
+        .sm_set_device_com_req(&test_device_com());
 
     let _ = io_link_device
         .lock()
         .unwrap()
-        .sm_set_device_ident_req(&DeviceIdent {
-            vendor_id: [0x12, 0x34],
-            device_id: [0x56, 0x78, 0x9A],
-            function_id: [0xBC, 0xDE],
-        });
+        .sm_set_device_ident_req(&test_device_ident());
 
     let _ = io_link_device
         .lock()
@@ -104,6 +102,49 @@ pub fn setup_device_configuration(
         .sm_set_device_mode_req(DeviceMode::Sio);
 }
 
+/// Applies the test device configuration and the wake-up sequence to a device
+/// which is polled by the caller, `poll` is called after every step.
+///
+/// Same sequence as `setup_device_configuration` followed by `perform_startup_sequence`.
+pub fn configure_and_wake_up<PHY: PhysicalLayerReq>(
+    io_link_device: &mut IoLinkDevice<PHY, MockApplicationLayer>,
+    mut poll: impl FnMut(&mut IoLinkDevice<PHY, MockApplicationLayer>),
+) {
+    let _ = io_link_device.sm_set_device_mode_req(DeviceMode::Idle);
+    poll(io_link_device);
+    let _ = io_link_device.sm_set_device_com_req(&test_device_com());
+    poll(io_link_device);
+    let _ = io_link_device.sm_set_device_ident_req(&test_device_ident());
+    poll(io_link_device);
+    let _ = io_link_device.sm_set_device_mode_req(DeviceMode::Sio);
+    poll(io_link_device);
+    let _ = io_link_device.pl_wake_up_ind();
+    poll(io_link_device);
+    io_link_device.successful_com(TransmissionRate::Com3);
+    poll(io_link_device);
+}
+
+/// Master commands which take a device from Startup through PreOperate into Operate
+/// mode, in the order of the threaded test sequences.
+pub fn startup_to_operate_requests() -> [Vec<u8>; 4] {
+    let master_command_address = direct_parameter_address!(MasterCommand);
+    [
+        create_startup_write_request(master_command_address, MasterCommand::MasterIdent.into()),
+        create_startup_write_request(
+            master_command_address,
+            MasterCommand::DevicePreOperate.into(),
+        ),
+        create_preop_write_request(
+            master_command_address,
+            &[MasterCommand::DeviceOperate.into()],
+        ),
+        create_op_write_request(
+            master_command_address,
+            &[MasterCommand::ProcessDataOutputOperate.into()],
+        ),
+    ]
+}
+
 /// Performs the startup sequence for the device
 pub fn perform_startup_sequence(
     io_link_device: &Arc<Mutex<IoLinkDevice<MockPhysicalLayer, MockApplicationLayer>>>,
@@ -467,6 +508,12 @@ pub fn create_preop_write_isdu_complete_request() -> Vec<u8> {
 
 /// Creates a read request message for testing
 pub fn create_op_read_request(address: u8) -> Vec<u8> {
+    create_op_pd_out_read_request(address, &[])
+}
+
+/// Creates a read request message carrying the output Process Data `pd_out` for
+/// testing, missing octets of `pd_out` are sent as zero
+pub fn create_op_pd_out_read_request(address: u8, pd_out: &[u8]) -> Vec<u8> {
     const BASE_TYPE: MsequenceBaseType =
         derived_config::m_seq_capability::operate_m_sequence::m_sequence_base_type();
     const PD_OUT_LENGTH: u8 = derived_config::process_data::pd_out::config_length_in_bytes();
@@ -487,8 +534,8 @@ pub fn create_op_read_request(address: u8) -> Vec<u8> {
     let mut rx_buffer = Vec::new();
     rx_buffer.push(mc_bits);
     rx_buffer.push(ckt_bits);
-    for _ in 0..PD_OUT_LENGTH as usize {
-        rx_buffer.push(0);
+    for index in 0..PD_OUT_LENGTH as usize {
+        rx_buffer.push(pd_out.get(index).copied().unwrap_or(0));
     }
     let checksum = calculate_checksum_for_testing(rx_buffer.len(), &rx_buffer);
     ckt.set_checksum(checksum);
@@ -568,6 +615,63 @@ pub fn create_preop_write_request(address: u8, data: &[u8]) -> Vec<u8> {
     rx_buffer
 }
 
+/// Creates a read request of the Event memory on the Diagnosis channel for testing
+pub fn create_preop_diagnosis_read_request(address: u8) -> Vec<u8> {
+    let mc = MsequenceControlBuilder::new()
+        .with_read_write(RwDirection::Read)
+        .with_comm_channel(ComChannel::Diagnosis)
+        .with_address_fctrl(address)
+        .build();
+
+    let mut ckt = ChecksumMsequenceTypeBuilder::new()
+        .with_m_seq_type(
+            derived_config::m_seq_capability::pre_operate_m_sequence::m_sequence_base_type(),
+        )
+        .with_checksum(0)
+        .build();
+
+    let mut rx_buffer = Vec::new();
+    rx_buffer.push(mc.into_bits());
+    rx_buffer.push(ckt.into_bits());
+
+    let checksum = calculate_checksum_for_testing(rx_buffer.len(), &rx_buffer);
+    ckt.set_checksum(checksum);
+    rx_buffer[1] = ckt.into_bits();
+
+    rx_buffer
+}
+
+/// Creates a write request of the Event memory on the Diagnosis channel for testing,
+/// a write of the StatusCode (address 0) confirms the Events
+pub fn create_preop_diagnosis_write_request(address: u8, data: &[u8]) -> Vec<u8> {
+    const OD_LENGTH_BYTES: u8 = derived_config::on_req_data::pre_operate::od_length();
+    let mc = MsequenceControlBuilder::new()
+        .with_read_write(RwDirection::Write)
+        .with_comm_channel(ComChannel::Diagnosis)
+        .with_address_fctrl(address)
+        .build();
+
+    let mut ckt = ChecksumMsequenceTypeBuilder::new()
+        .with_m_seq_type(
+            derived_config::m_seq_capability::pre_operate_m_sequence::m_sequence_base_type(),
+        )
+        .with_checksum(0)
+        .build();
+
+    let mut rx_buffer = Vec::new();
+    rx_buffer.push(mc.into_bits());
+    rx_buffer.push(ckt.into_bits());
+    for index in 0..OD_LENGTH_BYTES as usize {
+        rx_buffer.push(data.get(index).copied().unwrap_or(0));
+    }
+
+    let checksum = calculate_checksum_for_testing(rx_buffer.len(), &rx_buffer);
+    ckt.set_checksum(checksum);
+    rx_buffer[1] = ckt.into_bits();
+
+    rx_buffer
+}
+
 pub fn create_op_write_request(address: u8, data: &[u8]) -> Vec<u8> {
     const OD_LENGTH_BYTES: u8 = derived_config::on_req_data::operate::od_length();
     const PD_LENGTH_BYTES: u8 = derived_config::process_data::pd_out::config_length_in_bytes();
@@ -734,4 +838,59 @@ pub mod isdu_frame {
 
         isdu_request_buffer
     }
+
+    /// Transfers `isdu_request` in PreOperate through `transfer` and reads the ISDU
+    /// response, the read is started again while the device answers busy.
+    ///
+    /// `transfer` sends one master frame and returns the device response, e.g.
+    /// [`crate::SyncTestDevice::transfer`].
+    ///
+    /// # Returns
+    /// - `Some(response)` the ISDU response from the I-Service octet to the CHKPDU.
+    /// - `None` if a frame was not answered or the device aborted the ISDU.
+    pub fn transfer_preop_isdu(
+        mut transfer: impl FnMut(&[u8]) -> Option<Vec<u8>>,
+        isdu_request: &[u8],
+    ) -> Option<Vec<u8>> {
+        use iolinke_types::frame::isdu::IsduFlowCtrl;
+        const OD_LENGTH: usize =
+            super::derived_config::on_req_data::pre_operate::od_length() as usize;
+        /// Start requests answered busy before the ISDU is given up
+        const MAX_BUSY_RESPONSES: usize = 32;
+
+        // Same flow control sequence as `util_pre_op_test_isdu_sequence_read`
+        let mut flow_control = IsduFlowCtrl::Start.into_bits();
+        for chunk in isdu_request.chunks(OD_LENGTH) {
+            let mut od = [0u8; OD_LENGTH];
+            od[..chunk.len()].copy_from_slice(chunk);
+            transfer(&super::create_preop_write_isdu_request(flow_control, &od))?;
+            flow_control = match flow_control {
+                0x00..=0x0E => flow_control + 1,
+                _ => 0,
+            };
+        }
+
+        let start_request = super::create_preop_read_start_isdu_request();
+        let mut response = (0..MAX_BUSY_RESPONSES)
+            .map_while(|_| transfer(&start_request))
+            .find(|response| response[0] != 0x01)?;
+        if response[0] == 0x00 {
+            return None;
+        }
+        response.truncate(OD_LENGTH);
+        let isdu_service = IsduService::from_bits(response[0]);
+        let length = match isdu_service.length() {
+            1 => response[1] as usize,
+            length => length as usize,
+        };
+        let mut segment = 1u8;
+        while response.len() < length {
+            let segment_response = transfer(&super::create_preop_read_isdu_segment(segment))?;
+            response.extend_from_slice(&segment_response[..OD_LENGTH]);
+            segment = (segment + 1) % 16;
+        }
+        transfer(&super::create_preop_isdu_idle_request())?;
+        response.truncate(length);
+        Some(response)
+    }
 }
@@ -5,15 +5,23 @@
 //! the IO-Link device stack components.
 
 // Re-export all submodules
+#[cfg(feature = "std")]
+pub mod fleet;
 pub mod frame_utils;
 pub mod mock_app_layer;
 pub mod mock_physical_layer;
 pub mod page_params;
+pub mod simulator;
+#[cfg(feature = "split_layers")]
+pub mod split_device;
+pub mod sync_device;
 pub mod test_environment;
 pub mod test_sequences;
 pub mod types;
 
 // Re-export commonly used types and functions to maintain backward compatibility
+#[cfg(feature = "std")]
+pub use fleet::{Fleet, FleetConfig, FleetReport, LatencyHistogram, LatencyPercentiles};
 pub use frame_utils::{
     create_op_read_request, create_op_write_request, create_preop_isdu_idle_request,
     create_preop_read_isdu_segment, create_preop_read_request,
@@ -27,6 +35,10 @@ pub use page_params::{
     read_m_sequence_capability, read_min_cycle_time, read_process_data_in, read_process_data_out,
     read_revision_id, read_vendor_id_1, read_vendor_id_2, write_master_command,
 };
+pub use simulator::{SimEvent, SimPhysicalLayer, SimulatedMaster, SimulationStats, Simulator};
+#[cfg(feature = "split_layers")]
+pub use split_device::SplitTestDevice;
+pub use sync_device::SyncTestDevice;
 pub use test_environment::{
     create_test_device, send_test_message_and_wait, setup_test_environment, startup_routine,
     take_care_of_poll,
@@ -1,6 +1,11 @@
 use heapless::Vec;
 use iolinke_device::{AlEventCnf, ApplicationLayerServicesInd, DlControlCode, DlControlInd};
-use iolinke_types::{custom::IoLinkResult, handlers};
+use iolinke_types::{
+    custom::{IoLinkError, IoLinkResult},
+    handlers,
+};
+
+use std::sync::{Arc, Mutex};
 
 use core::default::Default;
 use core::result::Result::{Err, Ok};
@@ -8,11 +13,64 @@ use core::result::Result::{Err, Ok};
 const PD_OUTPUT_LENGTH: usize =
     iolinke_dev_config::device::process_data::config_pd_out_length_in_bytes() as usize;
 
-pub struct MockApplicationLayer {}
+/// Indications received by a [`MockApplicationLayer`], shared with the test
+#[derive(Debug, Default)]
+pub struct MockIndications {
+    /// Output Process Data of every AL_NewOutput, oldest first
+    pub new_outputs: std::vec::Vec<std::vec::Vec<u8>>,
+    /// Number of AL_PDCycle indications
+    pub pd_cycles: u32,
+    /// Number of AL_Event confirmations
+    pub event_cnfs: u32,
+    /// Index and subindex of every AL_Read, oldest first
+    pub read_inds: std::vec::Vec<(u16, u8)>,
+    /// Index, subindex and data of every AL_Write, oldest first
+    pub write_inds: std::vec::Vec<(u16, u8, std::vec::Vec<u8>)>,
+    /// Number of AL_Abort indications
+    pub abort_inds: u32,
+}
+
+pub struct MockApplicationLayer {
+    /// Print the received indications
+    verbose: bool,
+    /// Start every AL_Read and AL_Write, the test answers them through the device
+    backend: bool,
+    indications: Arc<Mutex<MockIndications>>,
+}
 
 impl MockApplicationLayer {
     pub fn new() -> Self {
-        Self {}
+        Self {
+            verbose: true,
+            backend: false,
+            indications: Arc::default(),
+        }
+    }
+
+    /// Creates a mock which does not print the received indications
+    pub fn new_quiet() -> Self {
+        Self {
+            verbose: false,
+            backend: false,
+            indications: Arc::default(),
+        }
+    }
+
+    /// Creates a quiet mock which starts every AL_Read and AL_Write of a parameter
+    /// outside the parameter storage, the test completes them with `al_read_rsp` and
+    /// `al_write_rsp` of the device
+    pub fn new_backend() -> Self {
+        Self {
+            verbose: false,
+            backend: true,
+            indications: Arc::default(),
+        }
+    }
+
+    /// Returns the indications received by the mock, stays valid after the mock moved
+    /// into the device
+    pub fn indications(&self) -> Arc<Mutex<MockIndications>> {
+        Arc::clone(&self.indications)
     }
 }
 
@@ -29,36 +87,71 @@ impl DlControlInd for MockApplicationLayer {
 }
 
 impl ApplicationLayerServicesInd for MockApplicationLayer {
-    fn al_read_ind(&mut self, _index: u16, _sub_index: u8) -> IoLinkResult<()> {
-        todo!()
+    fn al_read_ind(&mut self, index: u16, sub_index: u8) -> IoLinkResult<()> {
+        self.indications
+            .lock()
+            .unwrap()
+            .read_inds
+            .push((index, sub_index));
+        match self.backend {
+            true => Ok(()),
+            // No application parameters, the device answers "index not available"
+            false => Err(IoLinkError::NoImplFound),
+        }
     }
 
-    fn al_write_ind(&mut self, _index: u16, _sub_index: u8, _data: &[u8]) -> IoLinkResult<()> {
-        todo!()
+    fn al_write_ind(&mut self, index: u16, sub_index: u8, data: &[u8]) -> IoLinkResult<()> {
+        self.indications
+            .lock()
+            .unwrap()
+            .write_inds
+            .push((index, sub_index, data.to_vec()));
+        match self.backend {
+            true => Ok(()),
+            // No application parameters, the device answers "index not available"
+            false => Err(IoLinkError::NoImplFound),
+        }
     }
 
     fn al_abort_ind(&mut self) -> IoLinkResult<()> {
-        todo!()
+        self.indications.lock().unwrap().abort_inds += 1;
+        Ok(())
     }
 
     fn al_pd_cycle_ind(&mut self) {
-        println!("AL PD Cycle Ind");
+        if self.verbose {
+            println!("AL PD Cycle Ind");
+        }
+        self.indications.lock().unwrap().pd_cycles += 1;
     }
 
-    fn al_new_output_ind(&mut self, _pd_out: &Vec<u8, { PD_OUTPUT_LENGTH }>) -> IoLinkResult<()> {
-        println!("AL New Output Ind");
-        Err(iolinke_types::custom::IoLinkError::NoImplFound)
+    fn al_new_output_ind(&mut self, pd_out: &Vec<u8, { PD_OUTPUT_LENGTH }>) -> IoLinkResult<()> {
+        if self.verbose {
+            println!("AL New Output Ind");
+        }
+        self.indications
+            .lock()
+            .unwrap()
+            .new_outputs
+            .push(pd_out.to_vec());
+        Ok(())
     }
 
     fn al_control_ind(&mut self, _control_code: DlControlCode) -> IoLinkResult<()> {
-        println!("AL Control Ind");
+        if self.verbose {
+            println!("AL Control Ind");
+        }
         Err(iolinke_types::custom::IoLinkError::NoImplFound)
     }
 }
 
 impl AlEventCnf for MockApplicationLayer {
     fn al_event_cnf(&mut self) -> IoLinkResult<()> {
-        todo!()
+        if self.verbose {
+            println!("AL Event Cnf");
+        }
+        self.indications.lock().unwrap().event_cnfs += 1;
+        Ok(())
     }
 }
 
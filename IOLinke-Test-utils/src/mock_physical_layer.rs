@@ -3,14 +3,24 @@
 use crate::mock_app_layer::MockApplicationLayer;
 
 use super::types::ThreadMessage;
+#[cfg(feature = "async")]
+use iolinke_device::{AsyncPhysicalLayer, PlInd};
 use iolinke_device::{IoLinkDevice, PhysicalLayerReq, Timer};
 use iolinke_types::custom::IoLinkResult;
 use iolinke_types::handlers::sm::IoLinkMode;
+use std::collections::VecDeque;
 use std::sync::mpsc::Sender;
+#[cfg(feature = "non_blocking_tx")]
+use std::sync::atomic::{AtomicBool, Ordering};
 use std::sync::{Arc, Mutex};
 use std::time::Instant;
 
+#[cfg(feature = "async")]
+use core::future::{self, Future};
+use core::option::Option::{None, Some};
 use core::result::Result::Ok;
+#[cfg(feature = "async")]
+use core::task::Poll;
 use std::vec::Vec;
 
 /// Mock timer state for tracking timer expiration
@@ -58,6 +68,14 @@ pub struct MockPhysicalLayer {
     rx_data: Vec<u8>,
     timers: Arc<Mutex<Vec<MockTimerState>>>,
     mock_to_usr_tx: Sender<ThreadMessage>,
+    /// Master frames indicated by [`AsyncPhysicalLayer::wait_ind`]
+    rx_frames: Arc<Mutex<VecDeque<Vec<u8>>>>,
+    /// Address of every buffer handed to `pl_transfer_req`
+    tx_addresses: Arc<Mutex<Vec<usize>>>,
+    /// Set when a response handed to `pl_transfer_req` is sent, like the TX DMA
+    /// complete interrupt, until its PL_Transfer.cnf is indicated
+    #[cfg(feature = "non_blocking_tx")]
+    transfer_sent: Arc<AtomicBool>,
 }
 
 impl MockPhysicalLayer {
@@ -78,9 +96,32 @@ impl MockPhysicalLayer {
             rx_data: Vec::new(),
             timers: Arc::new(Mutex::new(Vec::new())),
             mock_to_usr_tx,
+            rx_frames: Arc::new(Mutex::new(VecDeque::new())),
+            tx_addresses: Arc::new(Mutex::new(Vec::new())),
+            #[cfg(feature = "non_blocking_tx")]
+            transfer_sent: Arc::new(AtomicBool::new(false)),
         }
     }
 
+    /// Returns the flag set when a response is sent and its PL_Transfer.cnf is not yet
+    /// indicated, shared with the test
+    #[cfg(feature = "non_blocking_tx")]
+    pub fn transfer_sent(&self) -> Arc<AtomicBool> {
+        self.transfer_sent.clone()
+    }
+
+    /// Returns the addresses of the buffers handed to `pl_transfer_req`, in the order
+    /// of the transfers, shared with the test
+    pub fn tx_addresses(&self) -> Arc<Mutex<Vec<usize>>> {
+        self.tx_addresses.clone()
+    }
+
+    /// Returns the queue of Master frames indicated by [`AsyncPhysicalLayer::wait_ind`],
+    /// shared with the test
+    pub fn rx_frames(&self) -> Arc<Mutex<VecDeque<Vec<u8>>>> {
+        self.rx_frames.clone()
+    }
+
     pub fn set_rx_data_from_slice(&mut self, data: &[u8]) {
         self.rx_data.clear();
         self.rx_data.extend_from_slice(data);
@@ -118,6 +159,29 @@ impl MockPhysicalLayer {
     }
 }
 
+/// Indicates the PL_Transfer.cnf of a sent response and the queued Master frames one at
+/// a time, [`AsyncPhysicalLayer::wait_ind`] stays pending while there is neither
+#[cfg(feature = "async")]
+impl AsyncPhysicalLayer for MockPhysicalLayer {
+    fn rx_buffer(&self) -> &[u8] {
+        &self.rx_data
+    }
+
+    fn wait_ind(&mut self) -> impl Future<Output = PlInd> {
+        future::poll_fn(|_context| {
+            #[cfg(feature = "non_blocking_tx")]
+            if self.transfer_sent.swap(false, Ordering::AcqRel) {
+                return Poll::Ready(PlInd::TransferCnf);
+            }
+            let Some(rx_frame) = self.rx_frames.lock().unwrap().pop_front() else {
+                return Poll::Pending;
+            };
+            self.set_rx_data_from_slice(&rx_frame);
+            Poll::Ready(PlInd::Transfer(rx_frame.len()))
+        })
+    }
+}
+
 /// Transfer the received data to the IO-Link device
 pub fn transfer_ind(
     rx_buffer: &[u8],
@@ -136,11 +200,17 @@ impl PhysicalLayerReq for MockPhysicalLayer {
     }
 
     fn pl_transfer_req(&mut self, tx_data: &[u8]) -> IoLinkResult<()> {
+        self.tx_addresses
+            .lock()
+            .unwrap()
+            .push(tx_data.as_ptr() as usize);
         self.tx_data.clear();
         self.tx_data.extend_from_slice(tx_data);
         self.mock_to_usr_tx
             .send(ThreadMessage::TxData(self.tx_data.clone()))
             .unwrap();
+        #[cfg(feature = "non_blocking_tx")]
+        self.transfer_sent.store(true, Ordering::Release);
         let _tx_data_len = tx_data.len();
         Ok(())
     }
@@ -0,0 +1,446 @@
+//! Deterministic virtual time simulation of a master and the device
+//!
+//! The [`Simulator`] runs the device in the calling thread against a virtual clock:
+//!
+//! - [`SimPhysicalLayer`] keeps the timers requested by the device as deadlines on the
+//!   virtual clock, an elapsed timer is indicated through `IoLinkDevice::timer_elapsed`.
+//! - Master frames are scheduled byte by byte on an event queue, every byte is received
+//!   one UART frame time (11 TBIT) after the previous one, so `MaxUARTframeTime` and
+//!   `MaxCycleTime` behave as on the wire.
+//! - The device is polled after every event until it has no pending work, device
+//!   processing takes no virtual time.
+//! - [`SimulatedMaster`] runs M-sequence cycles against the simulator.
+//!
+//! Nothing is shared between threads, the event queue and the timers are plain
+//! single threaded data structures without locks, and no wall clock time is involved.
+//! The same inputs always produce the same cycle by cycle behaviour.
+//!
+//! The event queue is a binary heap ordered by virtual time, not a concurrent queue:
+//! only the thread owning the [`Simulator`] schedules events, the simulator is not
+//! `Send` as the device shares its bus through an `Rc`. Events produced in another
+//! thread have to be handed over first, e.g. through an
+//! `iolinke_util::spsc_ring::SpscRing` drained into [`Simulator::schedule`].
+//!
+//! Time is counted in the unit of the `PhysicalLayerReq` timer durations (µs).
+//!
+//! # Example
+//!
+//! ```ignore
+//! let mut simulator = Simulator::new();
+//! let master = SimulatedMaster::new(simulator.min_cycle_time());
+//! assert!(master.startup_to_operate(&mut simulator));
+//! let frame = frame_utils::create_op_read_request(0x02);
+//! let stats = master.run_cycles(&mut simulator, &frame, 1_000_000);
+//! assert_eq!(stats.missed, 0);
+//! ```
+use core::cell::{Cell, RefCell};
+use core::cmp::{Ordering, Reverse};
+use std::collections::{BinaryHeap, VecDeque};
+use std::rc::Rc;
+use std::vec::Vec;
+
+use core::option::{
+    Option,
+    Option::{None, Some},
+};
+use core::result::Result::Ok;
+
+use iolinke_device::{IoLinkDevice, PhysicalLayerReq, Timer, TransmissionRate};
+use iolinke_types::custom::IoLinkResult;
+use iolinke_types::handlers::sm::IoLinkMode;
+use iolinke_util::log_utils::{self, LogSuppression};
+
+use crate::frame_utils;
+use crate::mock_app_layer::MockApplicationLayer;
+
+/// Number of timers of the physical layer
+const TIMER_COUNT: usize = 4;
+/// Number of bits of one UART frame (start, 8 data, parity, stop)
+const UART_FRAME_BITS: u64 = 11;
+/// Upper bound of polls after one event, protects against a state machine which
+/// never reports its work as done
+const MAX_POLLS_PER_EVENT: usize = 32;
+/// Longest delay of the device response after the last octet of the master frame,
+/// see A.3.4 t_A of 1 to 10 TBIT
+const MAX_RESPONSE_DELAY_BITS: u64 = 10;
+
+/// Timer of each slot of `SimBus::timer_deadlines`
+const TIMERS: [Timer; TIMER_COUNT] = [
+    Timer::Tdsio,
+    Timer::MaxCycleTime,
+    Timer::MaxUARTFrameTime,
+    Timer::MaxUARTframeTime,
+];
+
+/// Returns the slot of `timer` in `SimBus::timer_deadlines`
+const fn timer_slot(timer: Timer) -> usize {
+    match timer {
+        Timer::Tdsio => 0,
+        Timer::MaxCycleTime => 1,
+        Timer::MaxUARTFrameTime => 2,
+        Timer::MaxUARTframeTime => 3,
+    }
+}
+
+/// State shared between the simulator and the simulated physical layer
+struct SimBus {
+    /// Current virtual time
+    now: Cell<u64>,
+    /// Deadline of every running timer
+    timer_deadlines: [Cell<Option<u64>>; TIMER_COUNT],
+    /// Responses handed to `pl_transfer_req`, with their virtual time
+    tx_frames: RefCell<VecDeque<(u64, Vec<u8>)>>,
+}
+
+impl SimBus {
+    fn new() -> Self {
+        Self {
+            now: Cell::new(0),
+            timer_deadlines: [const { Cell::new(None) }; TIMER_COUNT],
+            tx_frames: RefCell::new(VecDeque::new()),
+        }
+    }
+
+    /// Returns the timer which elapses next, earliest deadline first
+    fn next_timer(&self) -> Option<(u64, Timer)> {
+        self.timer_deadlines
+            .iter()
+            .zip(TIMERS)
+            .filter_map(|(deadline, timer)| deadline.get().map(|deadline| (deadline, timer)))
+            .min_by_key(|(deadline, _)| *deadline)
+    }
+}
+
+/// Physical layer of the simulated device
+pub struct SimPhysicalLayer {
+    bus: Rc<SimBus>,
+    mode: IoLinkMode,
+}
+
+impl SimPhysicalLayer {
+    /// Returns the mode requested by the device
+    pub fn mode(&self) -> IoLinkMode {
+        self.mode
+    }
+}
+
+impl PhysicalLayerReq for SimPhysicalLayer {
+    fn pl_set_mode_req(&mut self, mode: IoLinkMode) -> IoLinkResult<()> {
+        self.mode = mode;
+        Ok(())
+    }
+
+    fn pl_transfer_req(&mut self, tx_data: &[u8]) -> IoLinkResult<()> {
+        let now = self.bus.now.get();
+        self.bus
+            .tx_frames
+            .borrow_mut()
+            .push_back((now, tx_data.to_vec()));
+        Ok(())
+    }
+
+    fn pl_stop_timer_req(&self, timer: Timer) -> IoLinkResult<()> {
+        self.bus.timer_deadlines[timer_slot(timer)].set(None);
+        Ok(())
+    }
+
+    fn pl_start_timer_req(&self, timer: Timer, duration_us: u32) -> IoLinkResult<()> {
+        let deadline = self.bus.now.get() + duration_us as u64;
+        self.bus.timer_deadlines[timer_slot(timer)].set(Some(deadline));
+        Ok(())
+    }
+
+    fn pl_restart_timer_req(&self, timer: Timer, duration_us: u32) -> IoLinkResult<()> {
+        self.pl_start_timer_req(timer, duration_us)
+    }
+}
+
+/// Inputs of the device scheduled on the event queue
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub enum SimEvent {
+    /// A byte of a master frame is received
+    RxByte(u8),
+    /// The master sent a wake-up request
+    WakeUp,
+    /// The communication was established at the given transmission rate
+    SuccessfulCom(TransmissionRate),
+}
+
+/// Event with the virtual time it is due at
+#[derive(Debug, Clone, Copy)]
+struct ScheduledEvent {
+    at: u64,
+    /// Scheduling order, keeps events due at the same time in FIFO order
+    sequence: u64,
+    event: SimEvent,
+}
+
+impl PartialEq for ScheduledEvent {
+    fn eq(&self, other: &Self) -> bool {
+        self.cmp(other) == Ordering::Equal
+    }
+}
+
+impl Eq for ScheduledEvent {}
+
+impl PartialOrd for ScheduledEvent {
+    fn partial_cmp(&self, other: &Self) -> Option<Ordering> {
+        Some(self.cmp(other))
+    }
+}
+
+impl Ord for ScheduledEvent {
+    fn cmp(&self, other: &Self) -> Ordering {
+        (self.at, self.sequence).cmp(&(other.at, other.sequence))
+    }
+}
+
+/// Virtual time simulation of the device
+pub struct Simulator {
+    device: IoLinkDevice<SimPhysicalLayer, MockApplicationLayer>,
+    bus: Rc<SimBus>,
+    events: BinaryHeap<Reverse<ScheduledEvent>>,
+    next_sequence: u64,
+    transmission_rate: TransmissionRate,
+    _log_suppression: LogSuppression,
+}
+
+impl Simulator {
+    /// Creates a configured device which completed the wake-up and is in Startup mode.
+    ///
+    /// The log output of the stack is switched off while the simulator lives, a
+    /// simulation runs far too many state transitions to print them.
+    pub fn new() -> Self {
+        let log_suppression = log_utils::suppress_log();
+        let bus = Rc::new(SimBus::new());
+        let physical_layer = SimPhysicalLayer {
+            bus: Rc::clone(&bus),
+            mode: IoLinkMode::Inactive,
+        };
+        let mut simulator = Self {
+            device: IoLinkDevice::new(physical_layer, MockApplicationLayer::new_quiet()),
+            bus,
+            events: BinaryHeap::new(),
+            next_sequence: 0,
+            transmission_rate: TransmissionRate::Com3,
+            _log_suppression: log_suppression,
+        };
+        let _ = simulator.device.al_set_input_req(3, &[0x01, 0x02, 0x03]);
+        frame_utils::configure_and_wake_up(&mut simulator.device, poll_until_idle);
+        // The configuration may have started timers, let them elapse before the first cycle
+        simulator.run_until_quiet();
+        simulator
+    }
+
+    /// Returns the current virtual time
+    pub fn now(&self) -> u64 {
+        self.bus.now.get()
+    }
+
+    /// Time to receive one UART frame at the current transmission rate
+    pub fn byte_time(&self) -> u64 {
+        UART_FRAME_BITS * TransmissionRate::get_t_bit_in_us(self.transmission_rate) as u64
+    }
+
+    /// Longest delay of the device response after the last octet of the master frame
+    pub fn max_response_delay(&self) -> u64 {
+        MAX_RESPONSE_DELAY_BITS * TransmissionRate::get_t_bit_in_us(self.transmission_rate) as u64
+    }
+
+    /// Cycle time which fits the longest master frame and the longest device response
+    pub fn min_cycle_time(&self) -> u64 {
+        const MAX_FRAME_BYTES: u64 = (iolinke_util::frame_fromat::message::MAX_RX_FRAME_SIZE
+            + iolinke_util::frame_fromat::message::MAX_TX_FRAME_SIZE)
+            as u64;
+        // One extra UART frame time for the response delay of the device
+        (MAX_FRAME_BYTES + 1) * self.byte_time()
+    }
+
+    /// Schedules `event` at virtual time `at`
+    pub fn schedule(&mut self, at: u64, event: SimEvent) {
+        let sequence = self.next_sequence;
+        self.next_sequence += 1;
+        self.events.push(Reverse(ScheduledEvent {
+            at,
+            sequence,
+            event,
+        }));
+    }
+
+    /// Schedules the bytes of a master frame starting at `start`, one byte per UART frame
+    ///
+    /// # Returns
+    /// - The virtual time the last byte is received.
+    pub fn schedule_master_frame(&mut self, start: u64, master_frame: &[u8]) -> u64 {
+        let byte_time = self.byte_time();
+        let mut at = start;
+        for rx_byte in master_frame {
+            at += byte_time;
+            self.schedule(at, SimEvent::RxByte(*rx_byte));
+        }
+        at
+    }
+
+    /// Runs all events and timers due until virtual time `until`, then sets the clock to `until`.
+    ///
+    /// Events and timers are processed in time order. An event due at the same time as a
+    /// timer deadline is processed first, as a received byte restarts "MaxUARTframeTime".
+    pub fn run_until(&mut self, until: u64) {
+        loop {
+            let next_event = self.events.peek().map(|Reverse(event)| event.at);
+            let next_timer = self.bus.next_timer();
+            match (next_event, next_timer) {
+                (Some(event_at), timer) if event_at <= until
+                    && timer.is_none_or(|(deadline, _)| event_at <= deadline) =>
+                {
+                    let Some(Reverse(scheduled)) = self.events.pop() else {
+                        break;
+                    };
+                    self.bus.now.set(scheduled.at);
+                    self.dispatch(scheduled.event);
+                }
+                (_, Some((deadline, timer))) if deadline <= until => {
+                    self.bus.now.set(deadline);
+                    self.bus.timer_deadlines[timer_slot(timer)].set(None);
+                    let _ = self.device.timer_elapsed(timer);
+                }
+                _ => break,
+            }
+            poll_until_idle(&mut self.device);
+        }
+        self.bus.now.set(until.max(self.now()));
+    }
+
+    /// Runs until no event is scheduled and no timer is running
+    pub fn run_until_quiet(&mut self) {
+        loop {
+            let next_event = self.events.peek().map(|Reverse(event)| event.at);
+            let next_timer = self.bus.next_timer().map(|(deadline, _)| deadline);
+            match next_event.into_iter().chain(next_timer).max() {
+                Some(until) => self.run_until(until),
+                None => break,
+            }
+        }
+    }
+
+    /// Takes the oldest response of the device with the virtual time it was sent
+    pub fn take_device_response(&mut self) -> Option<(u64, Vec<u8>)> {
+        self.bus.tx_frames.borrow_mut().pop_front()
+    }
+
+    /// Returns the device under test
+    pub fn device_mut(&mut self) -> &mut IoLinkDevice<SimPhysicalLayer, MockApplicationLayer> {
+        &mut self.device
+    }
+
+    fn dispatch(&mut self, event: SimEvent) {
+        match event {
+            SimEvent::RxByte(rx_byte) => {
+                let _ = self.device.pl_transfer_ind(rx_byte);
+            }
+            SimEvent::WakeUp => {
+                let _ = self.device.pl_wake_up_ind();
+            }
+            SimEvent::SuccessfulCom(transmission_rate) => {
+                self.transmission_rate = transmission_rate;
+                self.device.successful_com(transmission_rate);
+            }
+        }
+    }
+}
+
+impl Default for Simulator {
+    fn default() -> Self {
+        Self::new()
+    }
+}
+
+/// Polls `device` until no state machine has work pending
+fn poll_until_idle(device: &mut IoLinkDevice<SimPhysicalLayer, MockApplicationLayer>) {
+    for _ in 0..MAX_POLLS_PER_EVENT {
+        if !device.has_pending_work() {
+            break;
+        }
+        let _ = device.poll();
+    }
+}
+
+/// Result of a run of M-sequence cycles
+#[derive(Debug, Clone, Copy, PartialEq, Eq, Default)]
+pub struct SimulationStats {
+    /// Number of master frames sent
+    pub cycles: u64,
+    /// Number of cycles the device responded to within the cycle
+    pub responses: u64,
+    /// Number of cycles without a device response
+    pub missed: u64,
+}
+
+/// Master sending one frame per cycle
+pub struct SimulatedMaster {
+    cycle_time: u64,
+}
+
+impl SimulatedMaster {
+    /// Creates a master running M-sequence cycles of `cycle_time`
+    pub fn new(cycle_time: u64) -> Self {
+        Self { cycle_time }
+    }
+
+    /// Runs one M-sequence cycle with `master_frame`
+    ///
+    /// The frame is sent at the start of the cycle, the cycle ends `cycle_time` later
+    /// or when the frame is completely sent, whichever is later.
+    ///
+    /// # Panics
+    /// If the device response does not start within [`Simulator::max_response_delay`]
+    /// after the last octet of the master frame.
+    ///
+    /// # Returns
+    /// - `Some(response)` if the device responded within the cycle.
+    /// - `None` if the device did not respond.
+    pub fn cycle(&self, simulator: &mut Simulator, master_frame: &[u8]) -> Option<Vec<u8>> {
+        let start = simulator.now();
+        let frame_end = simulator.schedule_master_frame(start, master_frame);
+        let cycle_end = frame_end.max(start + self.cycle_time);
+        simulator.run_until(cycle_end);
+        let response_window = frame_end..=frame_end + simulator.max_response_delay();
+        let mut response = None;
+        while let Some((sent_at, tx_frame)) = simulator.take_device_response() {
+            assert!(
+                response_window.contains(&sent_at),
+                "Device response at {sent_at} µs outside of the response window {response_window:?}"
+            );
+            response = Some(tx_frame);
+        }
+        response
+    }
+
+    /// Takes the device from Startup through PreOperate into Operate mode
+    ///
+    /// # Returns
+    /// - `true` if the device responded to every master command.
+    pub fn startup_to_operate(&self, simulator: &mut Simulator) -> bool {
+        frame_utils::startup_to_operate_requests()
+            .iter()
+            .all(|master_frame| self.cycle(simulator, master_frame).is_some())
+    }
+
+    /// Runs `cycles` M-sequence cycles, each sending `master_frame`
+    pub fn run_cycles(
+        &self,
+        simulator: &mut Simulator,
+        master_frame: &[u8],
+        cycles: u64,
+    ) -> SimulationStats {
+        let mut stats = SimulationStats::default();
+        for _ in 0..cycles {
+            stats.cycles += 1;
+            match self.cycle(simulator, master_frame) {
+                Some(_) => stats.responses += 1,
+                None => stats.missed += 1,
+            }
+        }
+        stats
+    }
+}
@@ -0,0 +1,157 @@
+//! Synchronous test device split into a Data Link Layer and an Application Layer side
+//!
+//! Drives a [`DataLinkSide`] and an [`ApplicationSide`] of the `split_layers` feature
+//! from the calling thread, the same as [`crate::SyncTestDevice`] for an `IoLinkDevice`.
+//! Every poll runs the Data Link Layer side first and the Application Layer side after
+//! it, the same as a UART interrupt preempting a low priority application task.
+use iolinke_device::split::{ApplicationSide, DataLinkSide, LayerMailbox};
+use iolinke_device::{DeviceMode, TransmissionRate};
+use std::boxed::Box;
+use std::sync::mpsc::{self, Receiver};
+use std::sync::{Arc, Mutex, MutexGuard};
+use std::vec::Vec;
+
+use core::option::{
+    Option,
+    Option::{None, Some},
+};
+use core::result::Result::Ok;
+
+use crate::mock_app_layer::{MockApplicationLayer, MockIndications};
+use crate::mock_physical_layer::MockPhysicalLayer;
+use crate::{ThreadMessage, frame_utils};
+
+/// Polls of both sides to wait for a device response
+const MAX_RESPONSE_POLLS: usize = 256;
+
+/// IO-Link device with split layers driven synchronously from the calling thread
+pub struct SplitTestDevice {
+    dl_side: DataLinkSide<'static, MockPhysicalLayer>,
+    al_side: ApplicationSide<'static, MockApplicationLayer>,
+    mailbox: &'static LayerMailbox,
+    mock_to_usr_rx: Receiver<ThreadMessage>,
+    indications: Arc<Mutex<MockIndications>>,
+}
+
+impl SplitTestDevice {
+    /// Creates a configured device which completed the wake-up and is in Startup mode
+    pub fn new() -> Self {
+        let mailbox: &'static LayerMailbox = Box::leak(Box::new(LayerMailbox::new()));
+        let (mock_to_usr_tx, mock_to_usr_rx) = mpsc::channel();
+        let application = MockApplicationLayer::new_quiet();
+        let indications = application.indications();
+        let mut split_device = Self {
+            dl_side: DataLinkSide::new(MockPhysicalLayer::new(mock_to_usr_tx), mailbox),
+            al_side: ApplicationSide::new(application, mailbox),
+            mailbox,
+            mock_to_usr_rx,
+            indications,
+        };
+        let _ = split_device
+            .al_side
+            .al_set_input_req(3, &[0x01, 0x02, 0x03]);
+        let _ = split_device
+            .dl_side
+            .sm_set_device_mode_req(DeviceMode::Idle);
+        split_device.poll();
+        let _ = split_device
+            .dl_side
+            .sm_set_device_com_req(&frame_utils::test_device_com());
+        split_device.poll();
+        let _ = split_device
+            .dl_side
+            .sm_set_device_ident_req(&frame_utils::test_device_ident());
+        split_device.poll();
+        let _ = split_device.dl_side.sm_set_device_mode_req(DeviceMode::Sio);
+        split_device.poll();
+        let _ = split_device.dl_side.pl_wake_up_ind();
+        split_device.poll();
+        split_device.dl_side.successful_com(TransmissionRate::Com3);
+        split_device.poll();
+        split_device
+    }
+
+    /// Polls the Data Link Layer side and then the Application Layer side while
+    /// either has work pending
+    pub fn poll(&mut self) {
+        for _ in 0..MAX_RESPONSE_POLLS {
+            if !self.dl_side.has_pending_work() && !self.al_side.has_pending_work() {
+                break;
+            }
+            let _ = self.dl_side.poll();
+            let _ = self.al_side.poll();
+        }
+    }
+
+    /// Sends a master frame and polls both sides until the device responds
+    ///
+    /// # Returns
+    /// - `Some(response)` the device response handed to `pl_transfer_req`.
+    /// - `None` if the device did not respond.
+    pub fn transfer(&mut self, master_frame: &[u8]) -> Option<Vec<u8>> {
+        self.transfer_ind(master_frame);
+        for _ in 0..MAX_RESPONSE_POLLS {
+            let _ = self.dl_side.poll();
+            if let Some(response) = self.take_response() {
+                return Some(response);
+            }
+            let _ = self.al_side.poll();
+        }
+        None
+    }
+
+    /// Feeds a master frame octet by octet into the Data Link Layer side, without polling
+    pub fn transfer_ind(&mut self, master_frame: &[u8]) {
+        for &rx_byte in master_frame {
+            let _ = self.dl_side.pl_transfer_ind(rx_byte);
+        }
+    }
+
+    /// Takes the last response handed to `pl_transfer_req`
+    fn take_response(&mut self) -> Option<Vec<u8>> {
+        let mut response = None;
+        while let Ok(message) = self.mock_to_usr_rx.try_recv() {
+            if let ThreadMessage::TxData(tx_data) = message {
+                response = Some(tx_data);
+            }
+        }
+        response
+    }
+
+    /// Takes the device from Startup through PreOperate into Operate mode
+    ///
+    /// # Returns
+    /// - `true` if the device responded to every master command.
+    pub fn startup_to_operate(&mut self) -> bool {
+        let frames = frame_utils::startup_to_operate_requests();
+        frames
+            .iter()
+            .all(|master_frame| self.transfer(master_frame).is_some())
+    }
+
+    /// Returns the indications the device application received so far
+    pub fn indications(&self) -> MutexGuard<'_, MockIndications> {
+        self.indications.lock().unwrap()
+    }
+
+    /// Returns the mailbox shared by both sides
+    pub fn mailbox(&self) -> &'static LayerMailbox {
+        self.mailbox
+    }
+
+    /// Returns the Data Link Layer side of the device under test
+    pub fn dl_side_mut(&mut self) -> &mut DataLinkSide<'static, MockPhysicalLayer> {
+        &mut self.dl_side
+    }
+
+    /// Returns the Application Layer side of the device under test
+    pub fn al_side_mut(&mut self) -> &mut ApplicationSide<'static, MockApplicationLayer> {
+        &mut self.al_side
+    }
+}
+
+impl Default for SplitTestDevice {
+    fn default() -> Self {
+        Self::new()
+    }
+}
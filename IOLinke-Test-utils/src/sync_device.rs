@@ -0,0 +1,198 @@
+//! Synchronous test device for benchmarks and single threaded tests
+//!
+//! Drives the same `IoLinkDevice<MockPhysicalLayer, MockApplicationLayer>` as the
+//! threaded test environment, but without the polling thread and the `recv_timeout`
+//! waits. A master frame is fed into the device, the device is polled in the calling
+//! thread until the response is handed to `pl_transfer_req`.
+use iolinke_device::IoLinkDevice;
+use std::collections::VecDeque;
+use std::sync::mpsc::{self, Receiver};
+#[cfg(feature = "non_blocking_tx")]
+use std::sync::atomic::{AtomicBool, Ordering};
+use std::sync::{Arc, Mutex, MutexGuard};
+use std::vec::Vec;
+
+use core::option::{
+    Option,
+    Option::{None, Some},
+};
+use core::result::Result::Ok;
+
+use crate::mock_app_layer::{MockApplicationLayer, MockIndications};
+use crate::mock_physical_layer::{self, MockPhysicalLayer};
+use crate::{ThreadMessage, frame_utils};
+
+/// Polls per step
+const POLLS_PER_STEP: usize = 9;
+/// Rounds of `POLLS_PER_STEP` polls to wait for a device response
+const MAX_RESPONSE_ROUNDS: usize = 64;
+/// Upper bound of polls of one poll burst, protects against a state machine which
+/// never reports its work as done
+const MAX_POLLS_PER_BURST: usize = 64;
+
+/// IO-Link device driven synchronously from the calling thread
+pub struct SyncTestDevice {
+    device: IoLinkDevice<MockPhysicalLayer, MockApplicationLayer>,
+    mock_to_usr_rx: Receiver<ThreadMessage>,
+    indications: Arc<Mutex<MockIndications>>,
+    rx_frames: Arc<Mutex<VecDeque<Vec<u8>>>>,
+    tx_addresses: Arc<Mutex<Vec<usize>>>,
+    #[cfg(feature = "non_blocking_tx")]
+    transfer_sent: Arc<AtomicBool>,
+}
+
+impl SyncTestDevice {
+    /// Creates a configured device which completed the wake-up and is in Startup mode
+    pub fn new() -> Self {
+        Self::with_application(MockApplicationLayer::new_quiet())
+    }
+
+    /// Same as [`Self::new`] with the given device application, e.g.
+    /// [`MockApplicationLayer::new_backend`]
+    pub fn with_application(application: MockApplicationLayer) -> Self {
+        let (mock_to_usr_tx, mock_to_usr_rx) = mpsc::channel();
+        let indications = application.indications();
+        let physical_layer = MockPhysicalLayer::new(mock_to_usr_tx);
+        let rx_frames = physical_layer.rx_frames();
+        let tx_addresses = physical_layer.tx_addresses();
+        #[cfg(feature = "non_blocking_tx")]
+        let transfer_sent = physical_layer.transfer_sent();
+        let device = IoLinkDevice::new(physical_layer, application);
+        let mut sync_device = Self {
+            device,
+            mock_to_usr_rx,
+            indications,
+            rx_frames,
+            tx_addresses,
+            #[cfg(feature = "non_blocking_tx")]
+            transfer_sent,
+        };
+        let _ = sync_device.device.al_set_input_req(3, &[0x01, 0x02, 0x03]);
+        frame_utils::configure_and_wake_up(&mut sync_device.device, poll_step);
+        sync_device
+    }
+
+    /// Polls the device for one step
+    pub fn poll(&mut self) {
+        poll_step(&mut self.device);
+    }
+
+    /// Sends a master frame and polls the device until it responds
+    ///
+    /// # Returns
+    /// - `Some(response)` the device response handed to `pl_transfer_req`.
+    /// - `None` if the device did not respond.
+    pub fn transfer(&mut self, master_frame: &[u8]) -> Option<Vec<u8>> {
+        let _ = mock_physical_layer::transfer_ind(master_frame, &mut self.device);
+        self.wait_response()
+    }
+
+    /// Same as [`Self::transfer`], the frame is received in spans of `span` octets with
+    /// `pl_transfer_ind_burst`, as from a DMA UART reception
+    pub fn transfer_burst(&mut self, master_frame: &[u8], span: usize) -> Option<Vec<u8>> {
+        for rx_bytes in master_frame.chunks(span) {
+            let _ = self.device.pl_transfer_ind_burst(rx_bytes);
+        }
+        self.wait_response()
+    }
+
+    /// Polls the device until it responds
+    fn wait_response(&mut self) -> Option<Vec<u8>> {
+        for _ in 0..MAX_RESPONSE_ROUNDS {
+            self.poll();
+            if let Some(response) = self.take_response() {
+                self.confirm_transfer();
+                return Some(response);
+            }
+        }
+        None
+    }
+
+    /// Sends a master frame and polls the device only while it has work pending, the
+    /// same as firmware which sleeps as soon as `has_pending_work` returns `false`
+    ///
+    /// # Returns
+    /// - `Some(response)` the device response handed to `pl_transfer_req` within the
+    ///   poll burst following the last byte of the frame.
+    /// - `None` if the device stopped reporting pending work without responding.
+    pub fn transfer_in_poll_burst(&mut self, master_frame: &[u8]) -> Option<Vec<u8>> {
+        let _ = mock_physical_layer::transfer_ind(master_frame, &mut self.device);
+        for _ in 0..MAX_POLLS_PER_BURST {
+            if !self.device.has_pending_work() {
+                break;
+            }
+            let _ = self.device.poll();
+        }
+        let response = self.take_response();
+        if response.is_some() {
+            self.confirm_transfer();
+        }
+        response
+    }
+
+    /// With `non_blocking_tx`, confirms the response handed to `pl_transfer_req` was
+    /// sent, the same as the TX DMA complete interrupt
+    fn confirm_transfer(&mut self) {
+        #[cfg(feature = "non_blocking_tx")]
+        if self.transfer_sent.swap(false, Ordering::AcqRel) {
+            let _ = self.device.pl_transfer_cnf();
+        }
+    }
+
+    /// Takes the last response handed to `pl_transfer_req`
+    pub fn take_response(&mut self) -> Option<Vec<u8>> {
+        let mut response = None;
+        while let Ok(message) = self.mock_to_usr_rx.try_recv() {
+            if let ThreadMessage::TxData(tx_data) = message {
+                response = Some(tx_data);
+            }
+        }
+        response
+    }
+
+    /// Takes the device from Startup through PreOperate into Operate mode
+    /// with the same master commands as the threaded test sequences.
+    ///
+    /// # Returns
+    /// - `true` if the device responded to every master command.
+    pub fn startup_to_operate(&mut self) -> bool {
+        let frames = frame_utils::startup_to_operate_requests();
+        frames
+            .iter()
+            .all(|master_frame| self.transfer(master_frame).is_some())
+    }
+
+    /// Returns the indications the device application received so far
+    pub fn indications(&self) -> MutexGuard<'_, MockIndications> {
+        self.indications.lock().unwrap()
+    }
+
+    /// Returns the queue of Master frames the async physical layer indicates to
+    /// `IoLinkDevice::run_once`
+    pub fn rx_frames(&self) -> Arc<Mutex<VecDeque<Vec<u8>>>> {
+        self.rx_frames.clone()
+    }
+
+    /// Returns the addresses of the buffers the device handed to `pl_transfer_req`
+    pub fn tx_addresses(&self) -> Vec<usize> {
+        self.tx_addresses.lock().unwrap().clone()
+    }
+
+    /// Returns the device under test
+    pub fn device_mut(&mut self) -> &mut IoLinkDevice<MockPhysicalLayer, MockApplicationLayer> {
+        &mut self.device
+    }
+}
+
+/// Polls `device` for one step, same as one round of the threaded poll loop
+fn poll_step(device: &mut IoLinkDevice<MockPhysicalLayer, MockApplicationLayer>) {
+    for _ in 0..POLLS_PER_STEP {
+        let _ = device.poll();
+    }
+}
+
+impl Default for SyncTestDevice {
+    fn default() -> Self {
+        Self::new()
+    }
+}
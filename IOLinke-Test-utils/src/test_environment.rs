@@ -1,7 +1,7 @@
 //! Test environment setup and device management utilities
 use iolinke_device::IoLinkDevice;
 use iolinke_types::custom::IoLinkError;
-use std::sync::mpsc::{self, Receiver, Sender};
+use std::sync::mpsc::{self, Receiver, RecvTimeoutError, Sender};
 use std::sync::{Arc, Mutex};
 use std::time::Duration;
 
@@ -61,8 +61,11 @@ pub fn take_care_of_poll(
                         }
                     }
                 }
-                Err(_e) => {
-                    // eprintln!("Error receiving message: {:?}", e);
+                Err(RecvTimeoutError::Disconnected) => {
+                    // The test is done, stop polling so the next tests get the CPU
+                    break;
+                }
+                Err(RecvTimeoutError::Timeout) => {
                     // No message received, continue polling
                 }
             }
@@ -0,0 +1,298 @@
+use iolinke_bindings::c::backend::{AlResponse, AlResponseMailbox};
+use iolinke_bindings::c::types::DeviceActionState;
+use iolinke_device::{AlReadRsp, AlResult, AlRspError, AlWriteRsp};
+use iolinke_test_utils::SyncTestDevice;
+use iolinke_test_utils::frame_utils::{self, isdu_frame};
+use iolinke_test_utils::mock_app_layer::MockApplicationLayer;
+use iolinke_types::custom::IoLinkResult;
+use iolinke_types::frame::isdu::{IsduIServiceCode, IsduService};
+use iolinke_util::frame_fromat::isdu::calculate_checksum_for_testing;
+
+/// Vendor specific index outside of the parameter storage, served by the application
+const BACKEND_INDEX: u16 = 0x0050;
+
+/// Device side of the mailbox, records the delivered responses
+#[derive(Default)]
+struct ResponseRecorder {
+    reads: Vec<AlResult<Vec<u8>>>,
+    writes: Vec<AlResult<()>>,
+}
+
+impl AlReadRsp for ResponseRecorder {
+    fn al_read_rsp(&mut self, result: AlResult<(u8, &[u8])>) -> IoLinkResult<()> {
+        self.reads.push(result.map(|(_, data)| data.to_vec()));
+        Ok(())
+    }
+}
+
+impl AlWriteRsp for ResponseRecorder {
+    fn al_write_rsp(&mut self, result: AlResult<()>) -> IoLinkResult<()> {
+        self.writes.push(result);
+        Ok(())
+    }
+}
+
+/// Returns `true` if `state` is `Done`
+fn is_done(state: DeviceActionState) -> bool {
+    matches!(state, DeviceActionState::Done)
+}
+
+/// Returns a device in PreOperate mode
+fn preoperate_device(application: MockApplicationLayer) -> SyncTestDevice {
+    let mut device = SyncTestDevice::with_application(application);
+    let [master_ident, device_pre_operate, ..] = frame_utils::startup_to_operate_requests();
+    assert!(device.transfer(&master_ident).is_some());
+    assert!(device.transfer(&device_pre_operate).is_some());
+    device
+}
+
+/// ISDU Write Request (Index) of `data` to an index up to 0xFF
+fn isdu_write_index_request(index: u16, data: &[u8]) -> Vec<u8> {
+    let mut isdu_service = IsduService::new();
+    isdu_service.set_i_service(IsduIServiceCode::WriteRequestIndex);
+    // I-Service, Index, data and CHKPDU
+    isdu_service.set_length(3 + data.len() as u8);
+    let mut request = vec![isdu_service.into_bits(), index as u8];
+    request.extend_from_slice(data);
+    request.push(0);
+    let checkpdu = calculate_checksum_for_testing(request.len(), &request);
+    *request.last_mut().unwrap() = checkpdu;
+    request
+}
+
+/// Returns the I-Service code and the data of an ISDU response of up to 15 octets
+fn isdu_response(response: &[u8]) -> (u8, &[u8]) {
+    (response[0] >> 4, &response[1..response.len() - 1])
+}
+
+/// Test a positive AL_Read response is delivered with the value borrowed from the
+/// application
+#[test]
+fn test_al_response_mailbox_read() {
+    let mailbox = AlResponseMailbox::new();
+    let mut device = ResponseRecorder::default();
+    let value = [0x01, 0x02, 0x03];
+
+    let request_id = mailbox.begin_request();
+    assert!(is_done(mailbox.post(
+        request_id,
+        AlResponse::Read(value.as_ptr(), value.len() as u8)
+    )));
+    assert!(mailbox.has_response());
+    mailbox.deliver(&mut device);
+    assert!(!mailbox.has_response());
+    assert_eq!(device.reads, [Ok(value.to_vec())]);
+    assert!(device.writes.is_empty());
+
+    let request_id = mailbox.begin_request();
+    assert!(is_done(
+        mailbox.post(request_id, AlResponse::ReadError(0x80, 0x11))
+    ));
+    mailbox.deliver(&mut device);
+    assert_eq!(device.reads[1], Err(AlRspError::Error(0x80, 0x11)));
+}
+
+/// Test positive and negative AL_Write responses are delivered
+#[test]
+fn test_al_response_mailbox_write() {
+    let mailbox = AlResponseMailbox::new();
+    let mut device = ResponseRecorder::default();
+
+    let request_id = mailbox.begin_request();
+    assert!(is_done(mailbox.post(request_id, AlResponse::Write)));
+    mailbox.deliver(&mut device);
+    let request_id = mailbox.begin_request();
+    assert!(is_done(
+        mailbox.post(request_id, AlResponse::WriteError(0x80, 0x23))
+    ));
+    mailbox.deliver(&mut device);
+
+    assert_eq!(device.writes, [Ok(()), Err(AlRspError::Error(0x80, 0x23))]);
+    assert!(device.reads.is_empty());
+}
+
+/// Test a response to an aborted request is dropped, before and after it was posted
+#[test]
+fn test_al_response_mailbox_abort() {
+    let mailbox = AlResponseMailbox::new();
+    let mut device = ResponseRecorder::default();
+    let value = [0xAA];
+
+    let request_id = mailbox.begin_request();
+    assert_eq!(mailbox.end_request(), request_id);
+    assert!(is_done(
+        mailbox.post(request_id, AlResponse::Read(value.as_ptr(), 1))
+    ));
+    assert!(!mailbox.has_response());
+
+    let request_id = mailbox.begin_request();
+    assert!(is_done(mailbox.post(request_id, AlResponse::Write)));
+    mailbox.end_request();
+    assert!(!mailbox.has_response());
+    mailbox.deliver(&mut device);
+
+    assert!(device.reads.is_empty());
+    assert!(device.writes.is_empty());
+    // Nothing is outstanding after the abort
+    assert_eq!(mailbox.end_request(), 0);
+}
+
+/// Test a late response to an earlier request never completes the next one
+#[test]
+fn test_al_response_mailbox_late_response_dropped() {
+    let mailbox = AlResponseMailbox::new();
+    let mut device = ResponseRecorder::default();
+    let late_value = [0xDE, 0xAD];
+    let value = [0x12, 0x34];
+
+    // Posted after the next request started
+    let first_id = mailbox.begin_request();
+    let second_id = mailbox.begin_request();
+    assert_ne!(first_id, second_id);
+    assert!(is_done(
+        mailbox.post(first_id, AlResponse::Read(late_value.as_ptr(), 2))
+    ));
+    assert!(!mailbox.has_response());
+
+    // Posted before the next request started, but not yet delivered
+    assert!(is_done(
+        mailbox.post(second_id, AlResponse::Read(late_value.as_ptr(), 2))
+    ));
+    let third_id = mailbox.begin_request();
+    mailbox.deliver(&mut device);
+    assert!(device.reads.is_empty());
+
+    assert!(is_done(
+        mailbox.post(third_id, AlResponse::Read(value.as_ptr(), 2))
+    ));
+    mailbox.deliver(&mut device);
+    assert_eq!(device.reads, [Ok(value.to_vec())]);
+}
+
+/// Test a request is answered once, a second response is refused until the first is
+/// delivered and dropped afterwards
+#[test]
+fn test_al_response_mailbox_single_response() {
+    let mailbox = AlResponseMailbox::new();
+    let mut device = ResponseRecorder::default();
+
+    let request_id = mailbox.begin_request();
+    assert!(is_done(mailbox.post(request_id, AlResponse::Write)));
+    assert!(matches!(
+        mailbox.post(request_id, AlResponse::WriteError(0x80, 0x00)),
+        DeviceActionState::Busy
+    ));
+    mailbox.deliver(&mut device);
+    assert!(is_done(
+        mailbox.post(request_id, AlResponse::WriteError(0x80, 0x00))
+    ));
+    mailbox.deliver(&mut device);
+    assert_eq!(device.writes, [Ok(())]);
+}
+
+/// Test the request id skips 0, which never refers to a request, when it wraps around
+#[test]
+fn test_al_response_mailbox_request_id_wraps() {
+    let mailbox = AlResponseMailbox::new();
+    assert!((0..=u16::MAX as u32).all(|_| mailbox.begin_request() != 0));
+    // A response claiming to answer no request is dropped
+    assert!(is_done(mailbox.post(0, AlResponse::Write)));
+    assert!(!mailbox.has_response());
+}
+
+/// Test an ISDU read of an application parameter is answered busy until the
+/// application completes it with AL_Read response
+#[test]
+fn test_backend_read_completed_later() {
+    let mut device = preoperate_device(MockApplicationLayer::new_backend());
+    let value = [0x0A, 0x0B, 0x0C];
+    let mut busy_responses = 0;
+
+    let isdu_request = isdu_frame::create_isdu_read_request(BACKEND_INDEX, None);
+    let response = isdu_frame::transfer_preop_isdu(
+        |frame| {
+            let response = device.transfer(frame)?;
+            if response[0] == 0x01 {
+                busy_responses += 1;
+                // The application completes the read from its backend
+                assert_eq!(device.indications().read_inds, [(BACKEND_INDEX, 0)]);
+                device
+                    .device_mut()
+                    .al_read_rsp(Ok((value.len() as u8, &value)))
+                    .expect("AL_Read response rejected");
+            }
+            Some(response)
+        },
+        &isdu_request,
+    )
+    .expect("ISDU read not answered");
+
+    assert_eq!(busy_responses, 1);
+    assert_eq!(
+        isdu_response(&response),
+        (IsduIServiceCode::ReadSuccess as u8, &value[..])
+    );
+}
+
+/// Test an ISDU write of an application parameter is answered busy until the
+/// application completes it with AL_Write response
+#[test]
+fn test_backend_write_completed_later() {
+    let mut device = preoperate_device(MockApplicationLayer::new_backend());
+    let value = [0x5A, 0xA5];
+    let mut busy_responses = 0;
+
+    let isdu_request = isdu_write_index_request(BACKEND_INDEX, &value);
+    let response = isdu_frame::transfer_preop_isdu(
+        |frame| {
+            let response = device.transfer(frame)?;
+            if response[0] == 0x01 {
+                busy_responses += 1;
+                device
+                    .device_mut()
+                    .al_write_rsp(Ok(()))
+                    .expect("AL_Write response rejected");
+            }
+            Some(response)
+        },
+        &isdu_request,
+    )
+    .expect("ISDU write not answered");
+
+    assert_eq!(busy_responses, 1);
+    assert_eq!(
+        device.indications().write_inds,
+        [(BACKEND_INDEX, 0, value.to_vec())]
+    );
+    assert_eq!(
+        isdu_response(&response),
+        (IsduIServiceCode::WriteSuccess as u8, &[][..])
+    );
+}
+
+/// Test a prefetched parameter is read without AL_Read, until it is invalidated
+#[test]
+fn test_backend_prefetched_read() {
+    let mut device = preoperate_device(MockApplicationLayer::new_quiet());
+    let value = [0x11, 0x22, 0x33, 0x44];
+    device
+        .device_mut()
+        .al_prefetch_req(BACKEND_INDEX, 0, &value)
+        .expect("Prefetch rejected");
+
+    let isdu_request = isdu_frame::create_isdu_read_request(BACKEND_INDEX, None);
+    let response = isdu_frame::transfer_preop_isdu(|frame| device.transfer(frame), &isdu_request)
+        .expect("ISDU read not answered");
+    assert_eq!(
+        isdu_response(&response),
+        (IsduIServiceCode::ReadSuccess as u8, &value[..])
+    );
+    assert!(device.indications().read_inds.is_empty());
+
+    // Without the prefetched value the read reaches the application, which has none
+    device.device_mut().al_invalidate_req(BACKEND_INDEX, 0);
+    let response = isdu_frame::transfer_preop_isdu(|frame| device.transfer(frame), &isdu_request)
+        .expect("ISDU read not answered");
+    assert_eq!(response[0] >> 4, IsduIServiceCode::ReadFailure as u8);
+    assert_eq!(device.indications().read_inds, [(BACKEND_INDEX, 0)]);
+}
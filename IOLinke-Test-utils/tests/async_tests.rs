@@ -0,0 +1,111 @@
+#![cfg(feature = "async")]
+
+use core::pin::pin;
+use core::task::{Context, Poll, Waker};
+
+use iolinke_device::direct_parameter_address;
+use iolinke_test_utils::SyncTestDevice;
+use iolinke_test_utils::frame_utils;
+
+/// Runs of `run_once` to wait for a device response
+const MAX_RUNS: usize = 16;
+
+/// Polls `future` to completion without an executor. The mock physical layer never
+/// wakes a waiting task, so a future still pending after the first poll waits for an
+/// indication the test did not queue.
+///
+/// # Returns
+/// - `Some(output)` if the future completed.
+/// - `None` if it is waiting for the next indication.
+fn block_on<F: Future>(future: F) -> Option<F::Output> {
+    let mut future = pin!(future);
+    let mut context = Context::from_waker(Waker::noop());
+    match future.as_mut().poll(&mut context) {
+        Poll::Ready(output) => Some(output),
+        Poll::Pending => None,
+    }
+}
+
+/// Test `run_once` awaits a Master frame from the physical layer and answers it
+/// without awaiting another indication while the response is not sent
+#[test]
+fn test_run_once_answers_master_frame() {
+    let mut device = SyncTestDevice::new();
+    let rx_frames = device.rx_frames();
+    let _ = device.take_response();
+
+    // Nothing received, the device waits for the physical layer
+    assert!(block_on(device.device_mut().run_once()).is_none());
+
+    let [master_ident, ..] = frame_utils::startup_to_operate_requests();
+    rx_frames.lock().unwrap().push_back(master_ident);
+    let mut runs = 0;
+    let response = loop {
+        assert!(runs < MAX_RUNS, "Device did not respond");
+        let result = block_on(device.device_mut().run_once())
+            .expect("run_once awaited an indication with a response unsent");
+        assert!(result.is_ok());
+        runs += 1;
+        if let Some(response) = device.take_response() {
+            break response;
+        }
+    };
+    assert!(rx_frames.lock().unwrap().is_empty());
+    assert!(!response.is_empty());
+
+    // The response is sent, the device waits for the next frame again
+    assert!(
+        (0..MAX_RUNS).any(|_| block_on(device.device_mut().run_once()).is_none()),
+        "Device kept work pending"
+    );
+
+    // A read of a page parameter is answered from the queued frame as well
+    rx_frames
+        .lock()
+        .unwrap()
+        .push_back(frame_utils::create_startup_read_request(
+            direct_parameter_address!(MinCycleTime),
+        ));
+    assert!(
+        (0..MAX_RUNS).any(|_| {
+            block_on(device.device_mut().run_once()).is_some() && device.take_response().is_some()
+        }),
+        "Device did not respond"
+    );
+}
+
+/// Test `run_once` awaits PL_Transfer.cnf while a response is in flight instead of
+/// polling the device, and answers the next Master frame after it
+#[cfg(feature = "non_blocking_tx")]
+#[test]
+fn test_run_once_awaits_transfer_cnf() {
+    let mut device = SyncTestDevice::new();
+    let rx_frames = device.rx_frames();
+    let [master_ident, ..] = frame_utils::startup_to_operate_requests();
+    assert!(device.transfer(&master_ident).is_some());
+    let page_read =
+        frame_utils::create_startup_read_request(direct_parameter_address!(MinCycleTime));
+
+    rx_frames.lock().unwrap().push_back(page_read.clone());
+    let first = (0..MAX_RUNS)
+        .find_map(|_| {
+            let _ = block_on(device.device_mut().run_once())?;
+            device.take_response()
+        })
+        .expect("Device did not respond");
+
+    // Only the PL_Transfer.cnf of the response is left, it is awaited
+    assert!(
+        !device.device_mut().has_pending_work(),
+        "A response in flight keeps the device busy"
+    );
+    assert!(block_on(device.device_mut().run_once()).is_some());
+    assert!(block_on(device.device_mut().run_once()).is_none());
+
+    rx_frames.lock().unwrap().push_back(page_read);
+    let second = (0..MAX_RUNS).find_map(|_| {
+        let _ = block_on(device.device_mut().run_once())?;
+        device.take_response()
+    });
+    assert_eq!(second, Some(first));
+}
@@ -0,0 +1,53 @@
+use iolinke_derived_config::device as derived_config;
+use iolinke_device::direct_parameter_address;
+use iolinke_test_utils::SyncTestDevice;
+use iolinke_test_utils::frame_utils;
+
+const OP_OD_LENGTH: usize = derived_config::on_req_data::operate::od_length() as usize;
+
+/// Master frames from Startup through Operate, with page reads and writes in every mode
+fn master_frames() -> Vec<Vec<u8>> {
+    let mut frames = vec![
+        frame_utils::create_startup_read_request(direct_parameter_address!(MinCycleTime)),
+        frame_utils::create_startup_write_request(direct_parameter_address!(RevisionID), 0x11),
+        frame_utils::create_startup_read_request(direct_parameter_address!(RevisionID)),
+    ];
+    frames.extend(frame_utils::startup_to_operate_requests());
+    frames.push(frame_utils::create_op_read_request(direct_parameter_address!(VendorID1)));
+    frames.push(frame_utils::create_op_write_request(
+        direct_parameter_address!(MasterCycleTime),
+        &[0x42; OP_OD_LENGTH],
+    ));
+    frames
+}
+
+/// Test a frame received with `pl_transfer_ind_burst`, whole or in spans as from an
+/// idle-line interrupt, leaves the device in the same state with the same response as
+/// the byte by byte `pl_transfer_ind`
+#[test]
+fn test_burst_matches_byte_by_byte() {
+    let mut by_byte = SyncTestDevice::new();
+    let mut whole = SyncTestDevice::new();
+    let mut in_spans = SyncTestDevice::new();
+    for master_frame in master_frames() {
+        let expected = by_byte.transfer(&master_frame);
+        assert!(expected.is_some(), "No response to {:02X?}", master_frame);
+        for (device, span) in [(&mut whole, master_frame.len()), (&mut in_spans, 2)] {
+            assert_eq!(
+                device.transfer_burst(&master_frame, span),
+                expected,
+                "Response to {:02X?} in spans of {}",
+                master_frame,
+                span
+            );
+            assert_eq!(
+                device.device_mut().has_pending_work(),
+                by_byte.device_mut().has_pending_work()
+            );
+            assert_eq!(
+                format!("{:?}", *device.indications()),
+                format!("{:?}", *by_byte.indications())
+            );
+        }
+    }
+}
@@ -0,0 +1,86 @@
+use iolinke_util::frame_fromat::checksum::{
+    MsequenceChecksum, calculate_isdu_checksum, calculate_m_sequence_checksum, xor_fold,
+};
+use iolinke_util::frame_fromat::message::RxMessageBuffer;
+
+/// Bit by bit reference of A.1.6, used to cross check the table driven engine
+fn reference_m_sequence_checksum(data: &[u8]) -> u8 {
+    let d = data.iter().fold(0x52u8, |acc, byte| acc ^ byte);
+    let bit = |n: u8| (d >> n) & 0x01;
+    (bit(1) ^ bit(0))
+        | (bit(3) ^ bit(2)) << 1
+        | (bit(5) ^ bit(4)) << 2
+        | (bit(7) ^ bit(6)) << 3
+        | (bit(6) ^ bit(4) ^ bit(2) ^ bit(0)) << 4
+        | (bit(7) ^ bit(5) ^ bit(3) ^ bit(1)) << 5
+}
+
+/// Test the table driven checksum against the bitwise reference for every frame length
+#[test]
+fn test_m_sequence_checksum_matches_reference() {
+    let frame: Vec<u8> = (0..=70u8).map(|i| i.wrapping_mul(37) ^ 0xA5).collect();
+    for length in 0..=frame.len() {
+        assert_eq!(
+            calculate_m_sequence_checksum(length, &frame),
+            reference_m_sequence_checksum(&frame[..length]),
+            "M-sequence checksum mismatch for length {}",
+            length
+        );
+    }
+    // Length longer than the data must not read out of bounds
+    assert_eq!(
+        calculate_m_sequence_checksum(frame.len() + 4, &frame),
+        reference_m_sequence_checksum(&frame)
+    );
+}
+
+/// Test the incremental checksum gives the same result as the one shot calculation
+#[test]
+fn test_m_sequence_checksum_incremental() {
+    let frame: [u8; 11] = [0xA0, 0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88, 0x99];
+    for split in 0..=frame.len() {
+        let mut checksum = MsequenceChecksum::new();
+        for byte in &frame[..split] {
+            checksum.update(*byte);
+        }
+        checksum.update_slice(&frame[split..]);
+        assert_eq!(
+            checksum.finish(),
+            calculate_m_sequence_checksum(frame.len(), &frame)
+        );
+    }
+}
+
+/// Test the word-at-a-time XOR fold used by the ISDU checksum
+#[test]
+fn test_isdu_checksum_xor_fold() {
+    let data: Vec<u8> = (0..=240u8).collect();
+    for length in 0..=data.len() {
+        let expected = data[..length].iter().fold(0u8, |acc, byte| acc ^ byte);
+        assert_eq!(xor_fold(&data[..length]), expected);
+        assert_eq!(calculate_isdu_checksum(length, &data), expected);
+    }
+}
+
+/// Test a span pushed into the rx buffer gives the same frame and checksum as single bytes
+#[test]
+fn test_rx_buffer_push_slice_matches_push() {
+    let mut frame: [u8; 6] = [0xB0, 0x40, 0x12, 0x34, 0x56, 0x78];
+    frame[1] |= calculate_m_sequence_checksum(frame.len(), &frame);
+    for split in 0..=frame.len() {
+        let mut by_byte: RxMessageBuffer<8> = RxMessageBuffer::new();
+        for byte in &frame {
+            let _ = by_byte.push(*byte);
+        }
+        let mut by_span: RxMessageBuffer<8> = RxMessageBuffer::new();
+        let _ = by_span.push_slice(&frame[..split]);
+        let _ = by_span.push_slice(&frame[split..]);
+        assert_eq!(by_span.get_as_slice(), by_byte.get_as_slice());
+        assert!(by_byte.is_checksum_valid());
+        assert!(by_span.is_checksum_valid(), "Checksum invalid for split {}", split);
+    }
+    // Bytes beyond the buffer size are dropped
+    let mut rx_buffer: RxMessageBuffer<4> = RxMessageBuffer::new();
+    assert!(rx_buffer.push_slice(&frame).is_err());
+    assert_eq!(rx_buffer.get_as_slice(), &frame[..4]);
+}
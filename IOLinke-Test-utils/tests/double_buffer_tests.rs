@@ -0,0 +1,89 @@
+use iolinke_util::double_buffer::DoubleBuffer;
+
+/// Test the reader only sees committed snapshots
+#[test]
+fn test_double_buffer_commit_publishes_snapshot() {
+    let buffer: DoubleBuffer<4> = DoubleBuffer::new();
+    buffer.read(|pd| assert_eq!(pd, &[0, 0, 0, 0]));
+
+    let slot = buffer.acquire().expect("Back slot must be free");
+    unsafe { *slot = [0x11, 0x22, 0x33, 0x44] };
+    // Not committed yet, reader still sees the old snapshot
+    buffer.read(|pd| assert_eq!(pd, &[0, 0, 0, 0]));
+    buffer.commit();
+    buffer.read(|pd| assert_eq!(pd, &[0x11, 0x22, 0x33, 0x44]));
+
+    assert!(buffer.write(&[0xAA, 0xBB]));
+    buffer.read(|pd| assert_eq!(pd, &[0xAA, 0xBB, 0x00, 0x00]));
+}
+
+/// Test the writer never gets the slot held by the reader
+#[test]
+fn test_double_buffer_reader_slot_is_protected() {
+    let buffer: DoubleBuffer<2> = DoubleBuffer::new();
+    assert!(buffer.write(&[0x01, 0x01]));
+
+    let held = buffer.read_begin();
+    // The first write goes to the free slot
+    assert!(buffer.write(&[0x02, 0x02]));
+    // The next write would overwrite the slot held by the reader
+    assert!(!buffer.write(&[0x03, 0x03]));
+    assert_eq!(unsafe { &*held }, &[0x01, 0x01]);
+    buffer.read_end();
+
+    assert!(buffer.write(&[0x03, 0x03]));
+    buffer.read(|pd| assert_eq!(pd, &[0x03, 0x03]));
+}
+
+/// Test snapshots stay consistent with a concurrent writer
+#[test]
+fn test_double_buffer_concurrent_snapshots() {
+    let buffer: &'static DoubleBuffer<8> = Box::leak(Box::new(DoubleBuffer::new()));
+    let writer = std::thread::spawn(move || {
+        for value in 0..=10_000u32 {
+            let byte = value as u8;
+            while !buffer.write(&[byte; 8]) {}
+        }
+    });
+    while !writer.is_finished() {
+        buffer.read(|pd| assert!(pd.iter().all(|byte| *byte == pd[0]), "Torn snapshot"));
+    }
+    writer.join().unwrap();
+}
+
+/// Test the writer reading its last commit keeps the slot held by the reader protected
+#[test]
+fn test_double_buffer_read_committed_keeps_reader_slot() {
+    let buffer: DoubleBuffer<2> = DoubleBuffer::new();
+    assert!(buffer.write(&[0x01, 0x01]));
+    let held = buffer.read_begin();
+    assert!(buffer.write(&[0x02, 0x02]));
+    buffer.read_committed(|pd| assert_eq!(pd, &[0x02, 0x02]));
+    // The reader still holds its slot, the next write must not get it
+    assert!(!buffer.write(&[0x03, 0x03]));
+    assert_eq!(unsafe { &*held }, &[0x01, 0x01]);
+    buffer.read_end();
+}
+
+/// Test the device keeps responding in Operate while the application holds the
+/// output Process Data
+#[test]
+fn test_operate_responds_while_pd_out_is_held() {
+    let mut device = iolinke_test_utils::SyncTestDevice::new();
+    assert!(
+        device.startup_to_operate(),
+        "Device did not reach Operate mode"
+    );
+    let master_frame = iolinke_test_utils::create_op_read_request(
+        iolinke_device::direct_parameter_address!(MinCycleTime),
+    );
+    let _held = device.device_mut().acquire_pd_out_buffer();
+    for cycle in 0..4 {
+        assert!(
+            device.transfer_in_poll_burst(&master_frame).is_some(),
+            "No response in cycle {cycle} while the output Process Data is held"
+        );
+    }
+    device.device_mut().release_pd_out_buffer();
+    assert!(device.transfer_in_poll_burst(&master_frame).is_some());
+}
@@ -0,0 +1,110 @@
+use iolinke_device::{EventAggregator, EventEntryBytes};
+
+/// EventQualifier of an appearing and of a disappearing Event
+const APPEARS: u8 = 0xE4;
+const DISAPPEARS: u8 = 0xD4;
+
+/// Event entry of `qualifier` and the EventCode `code`
+const fn entry(qualifier: u8, code: u16) -> EventEntryBytes {
+    let [code_high, code_low] = code.to_be_bytes();
+    [qualifier, code_low, code_high]
+}
+
+const TEMPERATURE: EventEntryBytes = entry(APPEARS, 0x4000);
+const SHORT_CIRCUIT: EventEntryBytes = entry(APPEARS, 0x7710);
+const SUPPLY: EventEntryBytes = entry(APPEARS, 0x5100);
+
+/// Takes every Event reportable in Master cycle `cycle`
+fn take_all<const N: usize>(
+    aggregator: &mut EventAggregator<N>,
+    cycle: u32,
+) -> Vec<EventEntryBytes> {
+    core::iter::from_fn(|| aggregator.take_reportable(cycle)).collect()
+}
+
+/// Test an occurrence of a waiting Event is merged into it and counted, an Event
+/// reported before is added again
+#[test]
+fn test_event_aggregator_merges_waiting_event() {
+    let mut aggregator = EventAggregator::<4>::new(0);
+    assert!(aggregator.add(&TEMPERATURE));
+    assert!(aggregator.add(&TEMPERATURE));
+    assert!(aggregator.add(&SHORT_CIRCUIT));
+    assert!(aggregator.add(&TEMPERATURE));
+    assert_eq!(aggregator.coalesced_count(), 2);
+
+    assert_eq!(take_all(&mut aggregator, 0), [SHORT_CIRCUIT, TEMPERATURE]);
+    assert!(!aggregator.has_reportable(0));
+
+    // Nothing waits anymore, a new occurrence is not merged
+    assert!(aggregator.add(&TEMPERATURE));
+    assert_eq!(aggregator.coalesced_count(), 2);
+    assert_eq!(take_all(&mut aggregator, 1), [TEMPERATURE]);
+}
+
+/// Test an EventCode is reported at most once per rate limit interval, occurrences
+/// within the interval are delayed and not dropped
+#[test]
+fn test_event_aggregator_rate_limits_event_code() {
+    let mut aggregator = EventAggregator::<4>::new(10);
+    assert!(aggregator.add(&TEMPERATURE));
+    assert_eq!(take_all(&mut aggregator, 100), [TEMPERATURE]);
+
+    assert!(aggregator.add(&TEMPERATURE));
+    // Another EventQualifier of the same EventCode is rate limited as well
+    assert!(aggregator.add(&entry(DISAPPEARS, 0x4000)));
+    // Other EventCodes are not
+    assert!(aggregator.add(&SHORT_CIRCUIT));
+    assert_eq!(take_all(&mut aggregator, 109), [SHORT_CIRCUIT]);
+    assert!(!aggregator.has_reportable(109));
+
+    assert!(aggregator.has_reportable(110));
+    assert_eq!(aggregator.take_reportable(110), Some(TEMPERATURE));
+    // The report restarted the interval of the EventCode
+    assert!(!aggregator.has_reportable(110));
+    assert_eq!(take_all(&mut aggregator, 120), [entry(DISAPPEARS, 0x4000)]);
+}
+
+/// Test a rate limit of 0 reports every EventCode right away
+#[test]
+fn test_event_aggregator_without_rate_limit() {
+    let mut aggregator = EventAggregator::<4>::new(0);
+    for _ in 0..3 {
+        assert!(aggregator.add(&TEMPERATURE));
+        assert_eq!(take_all(&mut aggregator, 7), [TEMPERATURE]);
+    }
+}
+
+/// Test waiting Events are reported in the order of their last occurrence, the last
+/// state of a flapping fault is reported last
+#[test]
+fn test_event_aggregator_reports_in_order_of_last_occurrence() {
+    let mut aggregator = EventAggregator::<4>::new(0);
+    let disappears = entry(DISAPPEARS, 0x4000);
+    for event in [TEMPERATURE, disappears, SHORT_CIRCUIT, TEMPERATURE, SUPPLY] {
+        assert!(aggregator.add(&event));
+    }
+    assert_eq!(
+        take_all(&mut aggregator, 0),
+        [disappears, SHORT_CIRCUIT, TEMPERATURE, SUPPLY]
+    );
+}
+
+/// Test a full table refuses a new Event while all of its Events wait, and replaces a
+/// reported one otherwise
+#[test]
+fn test_event_aggregator_full_table() {
+    let mut aggregator = EventAggregator::<2>::new(0);
+    assert!(aggregator.add(&TEMPERATURE));
+    assert!(aggregator.add(&SHORT_CIRCUIT));
+    assert!(!aggregator.can_add(&SUPPLY));
+    assert!(!aggregator.add(&SUPPLY));
+    // A waiting Event is still merged
+    assert!(aggregator.can_add(&TEMPERATURE));
+    assert!(aggregator.add(&TEMPERATURE));
+
+    assert_eq!(aggregator.take_reportable(0), Some(SHORT_CIRCUIT));
+    assert!(aggregator.can_add(&SUPPLY));
+    assert!(aggregator.add(&SUPPLY));
+    assert_eq!(take_all(&mut aggregator, 0), [TEMPERATURE, SUPPLY]);
+}
@@ -0,0 +1,110 @@
+use iolinke_derived_config::device as derived_config;
+use iolinke_device::{AlEventQueue, direct_parameter_address};
+use iolinke_test_utils::frame_utils;
+use iolinke_test_utils::sync_device::SyncTestDevice;
+use iolinke_types::frame::msequence::ChecksumStatus;
+use iolinke_types::handlers::event::{EventEntry, EventQualifier};
+
+const OD_LENGTH: usize = derived_config::on_req_data::pre_operate::od_length() as usize;
+
+/// Returns the Event flag of the CKS octet of a device response
+fn event_flag(response: &[u8]) -> bool {
+    ChecksumStatus::from(*response.last().unwrap()).event_flag()
+}
+
+/// Takes a device from Startup into PreOperate mode
+fn preoperate_device() -> SyncTestDevice {
+    let mut device = SyncTestDevice::new();
+    let [master_ident, device_pre_operate, ..] = frame_utils::startup_to_operate_requests();
+    assert!(device.transfer(&master_ident).is_some());
+    assert!(device.transfer(&device_pre_operate).is_some());
+    device
+}
+
+/// Test an Event of the device application is signaled with the Event flag, read by the
+/// Master on the Diagnosis channel and cleared by the write of the StatusCode
+#[test]
+fn test_event_read_on_diagnosis_channel() {
+    let mut device = preoperate_device();
+    let min_cycle_time_read =
+        frame_utils::create_preop_read_request(direct_parameter_address!(MinCycleTime));
+    let response = device.transfer(&min_cycle_time_read).unwrap();
+    assert!(!event_flag(&response), "Event flag set without an Event");
+
+    let event_entry = EventEntry::new(EventQualifier::from_bits(0xF4), 0x5110);
+    assert!(device.device_mut().al_event_push_req(&event_entry));
+    device.poll();
+    let response = device.transfer(&min_cycle_time_read).unwrap();
+    assert!(event_flag(&response), "Event flag not set");
+
+    // StatusCode followed by the first Event slot
+    let mut event_memory = Vec::new();
+    for address in (0..4).step_by(OD_LENGTH) {
+        let event_read = frame_utils::create_preop_diagnosis_read_request(address as u8);
+        let response = device
+            .transfer(&event_read)
+            .expect("Event memory read not answered");
+        event_memory.extend_from_slice(&response[..OD_LENGTH]);
+    }
+    assert_eq!(
+        event_memory[0], 0x81,
+        "StatusCode without Event details and slot 1"
+    );
+    assert_eq!(&event_memory[1..4], &event_entry.to_bytes());
+
+    let event_conf = frame_utils::create_preop_diagnosis_write_request(0, &[0x00]);
+    assert!(
+        device.transfer(&event_conf).is_some(),
+        "Event confirmation not answered"
+    );
+    let response = device.transfer(&min_cycle_time_read).unwrap();
+    assert!(!event_flag(&response), "Event flag not cleared");
+
+    // The next Event is reported once the previous one is confirmed
+    let event_entry = EventEntry::new(EventQualifier::from_bits(0xF4), 0x4000);
+    assert!(device.device_mut().al_event_push_req(&event_entry));
+    device.poll();
+    let response = device.transfer(&min_cycle_time_read).unwrap();
+    assert!(event_flag(&response), "Second Event not signaled");
+}
+
+/// Test Events pushed before PreOperate are reported once the Event channel is open
+#[test]
+fn test_event_pushed_in_startup_is_reported_in_preoperate() {
+    let mut device = SyncTestDevice::new();
+    let event_entry = EventEntry::new(EventQualifier::from_bits(0xF4), 0x5110);
+    assert!(device.device_mut().al_event_push_req(&event_entry));
+    device.poll();
+
+    let [master_ident, device_pre_operate, ..] = frame_utils::startup_to_operate_requests();
+    assert!(device.transfer(&master_ident).is_some());
+    assert!(device.transfer(&device_pre_operate).is_some());
+    device.poll();
+
+    let min_cycle_time_read =
+        frame_utils::create_preop_read_request(direct_parameter_address!(MinCycleTime));
+    let response = device.transfer(&min_cycle_time_read).unwrap();
+    assert!(event_flag(&response), "Event of Startup not signaled");
+}
+
+/// Test Events of another context are pushed into a queue outside of the device and
+/// reported after the poll context took them
+#[test]
+fn test_event_taken_from_interrupt_queue() {
+    static QUEUE: AlEventQueue = AlEventQueue::new();
+
+    let mut device = preoperate_device();
+    let event_entry = EventEntry::new(EventQualifier::from_bits(0xF4), 0x5110);
+    std::thread::spawn(move || assert!(QUEUE.push(&event_entry)))
+        .join()
+        .unwrap();
+    assert!(device.device_mut().has_queued_events(&QUEUE));
+
+    device.device_mut().al_event_take_req(&QUEUE);
+    assert!(!device.device_mut().has_queued_events(&QUEUE));
+    device.poll();
+    let min_cycle_time_read =
+        frame_utils::create_preop_read_request(direct_parameter_address!(MinCycleTime));
+    let response = device.transfer(&min_cycle_time_read).unwrap();
+    assert!(event_flag(&response), "Event of the queue not signaled");
+}
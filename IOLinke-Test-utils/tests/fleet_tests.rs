@@ -0,0 +1,50 @@
+use std::time::Duration;
+
+use iolinke_device::direct_parameter_address;
+use iolinke_test_utils::{Fleet, FleetConfig, LatencyHistogram, frame_utils};
+
+/// Test every device of a fleet reaches Operate mode and responds to every cycle
+#[test]
+fn test_fleet_operate_cycles() {
+    let mut fleet = Fleet::new(FleetConfig {
+        devices: 100,
+        workers: 4,
+        chunk_size: 8,
+    });
+    assert!(
+        fleet.startup_to_operate(),
+        "A device did not reach Operate mode"
+    );
+    let master_frame = frame_utils::create_op_read_request(direct_parameter_address!(MinCycleTime));
+    let report = fleet.run_cycles(&master_frame, 200);
+    assert_eq!(report.cycles, 100 * 200);
+    assert_eq!(report.responses, report.cycles);
+    assert_eq!(report.missed, 0, "Devices missed cycles: {}", report.missed);
+    assert_eq!(report.device_latency.len(), 100);
+    for latency in &report.device_latency {
+        assert!(latency.p50 <= latency.p99 && latency.p99 <= latency.max);
+    }
+    assert!(report.cycles_per_second() > 0.0);
+}
+
+/// Test the percentiles of the histogram are within the bucket error of 12.5 %
+#[test]
+fn test_latency_histogram_percentiles() {
+    let mut histogram = LatencyHistogram::new();
+    assert_eq!(histogram.percentile(50.0), Duration::ZERO);
+    for micros in 1..=1000 {
+        histogram.record(Duration::from_micros(micros));
+    }
+    assert_eq!(histogram.count(), 1000);
+    let p50 = histogram.percentile(50.0).as_nanos() as f64;
+    assert!((500_000.0..=562_500.0).contains(&p50), "p50 {p50}");
+    let p99 = histogram.percentile(99.0).as_nanos() as f64;
+    assert!((990_000.0..=1_113_750.0).contains(&p99), "p99 {p99}");
+    assert_eq!(histogram.percentiles().max, Duration::from_micros(1000));
+
+    let mut merged = LatencyHistogram::new();
+    merged.merge(&histogram);
+    merged.merge(&histogram);
+    assert_eq!(merged.count(), 2000);
+    assert_eq!(merged.percentile(50.0), histogram.percentile(50.0));
+}
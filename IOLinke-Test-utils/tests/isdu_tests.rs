@@ -4,6 +4,7 @@ use iolinke_types::{
     handlers::pm::{DataStorageIndexSubIndex, DeviceParametersIndex, SubIndex},
     page::page1::MasterCommand,
 };
+use iolinke_util::frame_fromat::isdu::{IsduSegmentEncoder, TxIsduMessageBuffer};
 
 /// Test ISDU read operations for vendor name
 #[test]
@@ -263,3 +264,41 @@ fn test_isdu_write_and_read_data_storage_index_operate_mode() {
         );
     }
 }
+
+/// Test the ISDU segment encoder produces the same response as the buffered one
+#[test]
+fn test_isdu_segment_encoder_matches_buffered_response() {
+    let data: std::vec::Vec<u8> = (0..64u8).collect();
+    // Short and extended length responses, segmented with the OD sizes of the M-sequences
+    for length in [0u8, 1, 13, 14, 64] {
+        let payload = &data[..length as usize];
+        let mut buffered = TxIsduMessageBuffer::new();
+        assert!(
+            buffered
+                .compile_isdu_read_success_response(length, payload)
+                .is_ok()
+        );
+        let expected = buffered.get_as_slice();
+
+        for segment_size in [1usize, 2, 8, 32] {
+            let mut encoder = IsduSegmentEncoder::new();
+            assert!(encoder.start_read_success_response(length).is_ok());
+            assert_eq!(encoder.len(), expected.len());
+
+            let mut response = std::vec::Vec::new();
+            let mut segment = std::vec![0u8; segment_size];
+            for offset in (0..encoder.len()).step_by(segment_size) {
+                assert!(encoder.encode_segment(payload, offset, &mut segment).is_ok());
+                response.extend_from_slice(&segment);
+            }
+            assert_eq!(&response[..expected.len()], expected, "length {length}");
+            assert!(response[expected.len()..].iter().all(|&octet| octet == 0));
+
+            // A repeated segment is produced again
+            let offset = (encoder.len() - 1) / segment_size * segment_size;
+            assert!(encoder.encode_segment(payload, 0, &mut segment).is_ok());
+            assert!(encoder.encode_segment(payload, offset, &mut segment).is_ok());
+            assert_eq!(&segment[..], &response[offset..offset + segment_size]);
+        }
+    }
+}
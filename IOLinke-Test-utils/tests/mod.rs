@@ -4,9 +4,34 @@
 use iolinke_test_utils::{self, TestDeviceMode};
 use iolinke_types::page::page1::MasterCommand;
 
+pub mod al_backend_tests;
+#[cfg(feature = "async")]
+pub mod async_tests;
+pub mod burst_ingestion_tests;
+pub mod checksum_tests;
+pub mod double_buffer_tests;
+pub mod event_aggregator_tests;
+pub mod event_tests;
+pub mod fleet_tests;
 pub mod isdu_tests;
+#[cfg(feature = "non_blocking_tx")]
+pub mod non_blocking_tx_tests;
+pub mod nvm_tests;
+pub mod output_indication_tests;
+pub mod parameter_storage_tests;
 pub mod preop_tests;
+pub mod process_data_layout_tests;
+#[cfg(feature = "profiling")]
+pub mod profiling_tests;
+pub mod simulator_tests;
+#[cfg(feature = "split_layers")]
+pub mod split_layers_tests;
+pub mod spsc_ring_tests;
 pub mod startup_tests;
+#[cfg(feature = "timer_service")]
+pub mod timer_service_tests;
+// trace_tests runs in its own test binary only, the trace ring is shared by every
+// device of the process
 
 #[test]
 fn mock_test_device_operations() {
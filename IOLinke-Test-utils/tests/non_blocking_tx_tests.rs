@@ -0,0 +1,67 @@
+#![cfg(feature = "non_blocking_tx")]
+
+use iolinke_device::direct_parameter_address;
+use iolinke_test_utils::SyncTestDevice;
+use iolinke_test_utils::frame_utils;
+use iolinke_test_utils::mock_physical_layer;
+
+/// Polls of the device waiting for a response
+const MAX_POLLS: usize = 64;
+
+/// Feeds `master_frame` into the device and polls it until a response is handed to
+/// `pl_transfer_req`, without confirming the transfer
+fn send_frame(device: &mut SyncTestDevice, master_frame: &[u8]) -> Option<Vec<u8>> {
+    let _ = mock_physical_layer::transfer_ind(master_frame, device.device_mut());
+    for _ in 0..MAX_POLLS {
+        let _ = device.device_mut().poll();
+        if let Some(response) = device.take_response() {
+            return Some(response);
+        }
+    }
+    None
+}
+
+/// Test the next response is compiled in the other TX buffer while the previous one is
+/// in flight, and handed to the Physical Layer only after PL_Transfer.cnf
+#[test]
+fn test_response_held_back_until_transfer_cnf() {
+    let mut device = SyncTestDevice::new();
+    let [master_ident, ..] = frame_utils::startup_to_operate_requests();
+    assert!(device.transfer(&master_ident).is_some());
+    let page_read =
+        frame_utils::create_startup_read_request(direct_parameter_address!(MinCycleTime));
+
+    let first = send_frame(&mut device, &page_read).expect("Device did not respond");
+    let first_buffer = *device.tx_addresses().last().unwrap();
+
+    // The cnf is held back, the next response waits in the other buffer
+    let transfers = device.tx_addresses().len();
+    assert!(send_frame(&mut device, &page_read).is_none());
+    assert_eq!(device.tx_addresses().len(), transfers);
+    assert!(
+        !device.device_mut().has_pending_work(),
+        "A response held back for PL_Transfer.cnf keeps the device busy"
+    );
+
+    device.device_mut().pl_transfer_cnf().unwrap();
+    let mut second = None;
+    for _ in 0..MAX_POLLS {
+        let _ = device.device_mut().poll();
+        second = device.take_response();
+        if second.is_some() {
+            break;
+        }
+    }
+    assert_eq!(second.as_ref(), Some(&first));
+    let second_buffer = *device.tx_addresses().last().unwrap();
+    assert_ne!(
+        second_buffer, first_buffer,
+        "Response not staged in the other buffer"
+    );
+
+    // Confirmed, the next response is sent from the first buffer again
+    device.device_mut().pl_transfer_cnf().unwrap();
+    assert_eq!(send_frame(&mut device, &page_read), Some(first));
+    assert_eq!(*device.tx_addresses().last().unwrap(), first_buffer);
+    device.device_mut().pl_transfer_cnf().unwrap();
+}
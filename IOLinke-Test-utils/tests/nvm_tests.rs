@@ -0,0 +1,449 @@
+use iolinke_derived_config::device::vendor_specifics::storage_config::ParameterStorage;
+use iolinke_device::{NvmBackend, NvmStatus, ParameterJournal};
+use iolinke_types::custom::{IoLinkError, IoLinkResult};
+use iolinke_types::handlers::pm::{DataStorageIndexSubIndex, DeviceParametersIndex, SubIndex};
+use std::cell::RefCell;
+use std::rc::Rc;
+
+const DATA_STORAGE_INDEX: u16 = DeviceParametersIndex::DataStorageIndex.index();
+/// Persistent parameter of 30 octets
+const INDEX_LIST_SUBINDEX: u8 = DeviceParametersIndex::DataStorageIndex.subindex(
+    SubIndex::DataStorageIndex(DataStorageIndexSubIndex::IndexList),
+);
+/// Persistent parameter of 1 octet
+const STATE_PROPERTY_SUBINDEX: u8 = DeviceParametersIndex::DataStorageIndex.subindex(
+    SubIndex::DataStorageIndex(DataStorageIndexSubIndex::StateProperty),
+);
+const INDEX_LIST_LENGTH: usize = 30;
+const SECTOR_COUNT: usize = 3;
+/// Holds the header and three Index_List records
+const SECTOR_SIZE: usize = 128;
+/// Polls to save all unsaved parameters
+const MAX_JOURNAL_POLLS: usize = 256;
+/// Status polls an operation reports busy
+const BUSY_POLLS: usize = 1;
+
+struct FlashMemory {
+    memory: Vec<u8>,
+    erase_counts: [u32; SECTOR_COUNT],
+    /// Operations until the power is cut, `None` while the power is on
+    operations_until_cut: Option<usize>,
+    /// Cut the power at the next erase operation
+    cut_at_next_erase: bool,
+    /// Program and erase operations so far
+    operations: usize,
+    /// Status polls until the operation in progress is complete
+    busy_polls: usize,
+    /// Result of the operation started last
+    result: IoLinkResult<()>,
+}
+
+/// Flash of [`SECTOR_COUNT`] sectors shared between the journal and the test
+///
+/// Every operation reports busy for [`BUSY_POLLS`] status polls. A power cut tears the
+/// operation it hits: a program only programs the first half of its octets, an erase
+/// only erases the first half of the sector. After the cut every operation fails until
+/// [`MockFlash::power_on`].
+#[derive(Clone)]
+struct MockFlash<const WRITE_SIZE: usize = 1>(Rc<RefCell<FlashMemory>>);
+
+impl<const WRITE_SIZE: usize> MockFlash<WRITE_SIZE> {
+    fn new() -> Self {
+        Self(Rc::new(RefCell::new(FlashMemory {
+            memory: vec![0xFF; SECTOR_COUNT * SECTOR_SIZE],
+            erase_counts: [0; SECTOR_COUNT],
+            operations_until_cut: None,
+            cut_at_next_erase: false,
+            operations: 0,
+            busy_polls: 0,
+            result: Ok(()),
+        })))
+    }
+
+    /// Cuts the power at the program or erase operation `operations` from now
+    fn cut_power_after(&self, operations: usize) {
+        self.0.borrow_mut().operations_until_cut = Some(operations);
+    }
+
+    /// Cuts the power at the next erase operation
+    fn cut_power_at_next_erase(&self) {
+        self.0.borrow_mut().cut_at_next_erase = true;
+    }
+
+    fn power_on(&self) {
+        let mut flash = self.0.borrow_mut();
+        flash.operations_until_cut = None;
+        flash.cut_at_next_erase = false;
+        flash.busy_polls = 0;
+        flash.result = Ok(());
+    }
+
+    fn erase_counts(&self) -> [u32; SECTOR_COUNT] {
+        self.0.borrow().erase_counts
+    }
+
+    fn operations(&self) -> usize {
+        self.0.borrow().operations
+    }
+
+    /// Starts an operation, returns `false` if the power is cut at it
+    fn operate(flash: &mut FlashMemory) -> bool {
+        assert_eq!(flash.busy_polls, 0, "Operation started while busy");
+        flash.operations += 1;
+        flash.busy_polls = BUSY_POLLS;
+        let powered = match flash.operations_until_cut {
+            Some(0) => false,
+            Some(operations) => {
+                flash.operations_until_cut = Some(operations - 1);
+                true
+            }
+            None => true,
+        };
+        flash.result = if powered {
+            Ok(())
+        } else {
+            Err(IoLinkError::HardwareError)
+        };
+        powered
+    }
+}
+
+impl<const WRITE_SIZE: usize> NvmBackend for MockFlash<WRITE_SIZE> {
+    const WRITE_SIZE: usize = WRITE_SIZE;
+
+    fn sector_count(&self) -> usize {
+        SECTOR_COUNT
+    }
+
+    fn sector_size(&self) -> usize {
+        SECTOR_SIZE
+    }
+
+    fn read(&mut self, address: usize, buffer: &mut [u8]) -> IoLinkResult<()> {
+        let flash = self.0.borrow();
+        assert_eq!(flash.busy_polls, 0, "Read while an operation is in progress");
+        buffer.copy_from_slice(&flash.memory[address..address + buffer.len()]);
+        Ok(())
+    }
+
+    fn start_program(&mut self, address: usize, data: &[u8]) -> IoLinkResult<()> {
+        assert_eq!(address % WRITE_SIZE, 0, "Unaligned program address");
+        assert_eq!(data.len() % WRITE_SIZE, 0, "Unaligned program length");
+        let mut flash = self.0.borrow_mut();
+        let powered = Self::operate(&mut flash);
+        let length = if powered { data.len() } else { data.len() / 2 };
+        for (octet, value) in flash.memory[address..address + length].iter_mut().zip(data) {
+            // Programming can only clear bits
+            *octet &= *value;
+        }
+        Ok(())
+    }
+
+    fn start_erase(&mut self, sector: usize) -> IoLinkResult<()> {
+        let mut flash = self.0.borrow_mut();
+        if flash.cut_at_next_erase {
+            flash.cut_at_next_erase = false;
+            flash.operations_until_cut = Some(0);
+        }
+        let start = sector * SECTOR_SIZE;
+        if Self::operate(&mut flash) {
+            flash.memory[start..start + SECTOR_SIZE].fill(0xFF);
+            flash.erase_counts[sector] += 1;
+        } else {
+            flash.memory[start..start + SECTOR_SIZE / 2].fill(0xFF);
+        }
+        Ok(())
+    }
+
+    fn status(&mut self) -> IoLinkResult<NvmStatus> {
+        let mut flash = self.0.borrow_mut();
+        if flash.busy_polls > 0 {
+            flash.busy_polls -= 1;
+            return Ok(NvmStatus::Busy);
+        }
+        flash.result.map(|()| NvmStatus::Done)
+    }
+}
+
+/// Mounts a journal on `flash` and restores its parameters into a new storage
+fn mount<const WRITE_SIZE: usize>(
+    flash: &MockFlash<WRITE_SIZE>,
+) -> (ParameterJournal<MockFlash<WRITE_SIZE>>, ParameterStorage) {
+    let mut journal = ParameterJournal::new(flash.clone());
+    let mut storage = ParameterStorage::new();
+    journal.mount(&mut storage).expect("Mount failed");
+    (journal, storage)
+}
+
+/// Polls the journal until all parameters are saved
+fn save<const WRITE_SIZE: usize>(
+    journal: &mut ParameterJournal<MockFlash<WRITE_SIZE>>,
+    storage: &mut ParameterStorage,
+) -> IoLinkResult<()> {
+    for _ in 0..MAX_JOURNAL_POLLS {
+        if !journal.has_pending_work(storage) {
+            return Ok(());
+        }
+        journal.poll(storage)?;
+    }
+    panic!("Journal did not save all parameters");
+}
+
+fn index_list(storage: &ParameterStorage) -> Vec<u8> {
+    let (_, value) = storage
+        .get_parameter(DATA_STORAGE_INDEX, INDEX_LIST_SUBINDEX)
+        .unwrap();
+    value.to_vec()
+}
+
+fn state_property(storage: &ParameterStorage) -> u8 {
+    let (_, value) = storage
+        .get_parameter(DATA_STORAGE_INDEX, STATE_PROPERTY_SUBINDEX)
+        .unwrap();
+    value[0]
+}
+
+fn set_index_list(storage: &mut ParameterStorage, value: u8) {
+    storage
+        .set_parameter(
+            DATA_STORAGE_INDEX,
+            INDEX_LIST_SUBINDEX,
+            &[value; INDEX_LIST_LENGTH],
+        )
+        .unwrap();
+}
+
+fn set_state_property(storage: &mut ParameterStorage, value: u8) {
+    storage
+        .set_parameter(DATA_STORAGE_INDEX, STATE_PROPERTY_SUBINDEX, &[value])
+        .unwrap();
+}
+
+/// Test an empty memory mounts with the default values and nothing to save
+#[test]
+fn test_journal_mount_empty() {
+    let flash = MockFlash::<1>::new();
+    let (journal, storage) = mount(&flash);
+    assert_eq!(index_list(&storage), index_list(&ParameterStorage::new()));
+    assert!(!journal.has_pending_work(&storage));
+    assert_eq!(flash.operations(), 0);
+}
+
+/// Test the saved parameters are replayed at the next mount, the last record of a
+/// parameter wins
+#[test]
+fn test_journal_replay() {
+    let flash = MockFlash::<1>::new();
+    let (mut journal, mut storage) = mount(&flash);
+    set_index_list(&mut storage, 0x11);
+    set_state_property(&mut storage, 0x02);
+    save(&mut journal, &mut storage).unwrap();
+    set_index_list(&mut storage, 0x22);
+    save(&mut journal, &mut storage).unwrap();
+    assert!(!storage.has_unsaved());
+
+    let (journal, storage) = mount(&flash);
+    assert_eq!(index_list(&storage), [0x22; INDEX_LIST_LENGTH]);
+    assert_eq!(state_property(&storage), 0x02);
+    assert!(!journal.has_pending_work(&storage));
+}
+
+/// Test the journal with a programming granularity larger than one octet
+#[test]
+fn test_journal_replay_aligned_writes() {
+    let flash = MockFlash::<8>::new();
+    let (mut journal, mut storage) = mount(&flash);
+    for value in 1..=10 {
+        set_index_list(&mut storage, value);
+        set_state_property(&mut storage, value);
+        save(&mut journal, &mut storage).unwrap();
+    }
+    let (_, storage) = mount(&flash);
+    assert_eq!(index_list(&storage), [10; INDEX_LIST_LENGTH]);
+    assert_eq!(state_property(&storage), 10);
+}
+
+/// Test a reset to defaults is journaled, the saved values do not come back
+#[test]
+fn test_journal_reset_to_defaults() {
+    let flash = MockFlash::<1>::new();
+    let (mut journal, mut storage) = mount(&flash);
+    set_index_list(&mut storage, 0x33);
+    set_state_property(&mut storage, 0x04);
+    save(&mut journal, &mut storage).unwrap();
+
+    storage.clear();
+    assert!(journal.has_pending_work(&storage));
+    save(&mut journal, &mut storage).unwrap();
+
+    let (_, storage) = mount(&flash);
+    let defaults = ParameterStorage::new();
+    assert_eq!(index_list(&storage), index_list(&defaults));
+    assert_eq!(state_property(&storage), state_property(&defaults));
+}
+
+/// Test a record torn by a power cut is skipped, the value saved before it is
+/// replayed and the journal continues in the next sector
+#[test]
+fn test_journal_torn_record() {
+    let flash = MockFlash::<1>::new();
+    let (mut journal, mut storage) = mount(&flash);
+    set_index_list(&mut storage, 0x44);
+    save(&mut journal, &mut storage).unwrap();
+
+    set_index_list(&mut storage, 0x55);
+    flash.cut_power_after(0);
+    assert!(save(&mut journal, &mut storage).is_err());
+    flash.power_on();
+
+    let (mut journal, mut storage) = mount(&flash);
+    assert_eq!(index_list(&storage), [0x44; INDEX_LIST_LENGTH]);
+    set_index_list(&mut storage, 0x66);
+    save(&mut journal, &mut storage).unwrap();
+
+    let (_, storage) = mount(&flash);
+    assert_eq!(index_list(&storage), [0x66; INDEX_LIST_LENGTH]);
+}
+
+/// Test the records still in use are moved out of the oldest sector before it is
+/// erased, a parameter written once survives many writes of another one
+#[test]
+fn test_journal_reclaim_keeps_latest_records() {
+    let flash = MockFlash::<1>::new();
+    let (mut journal, mut storage) = mount(&flash);
+    set_state_property(&mut storage, 0x06);
+    save(&mut journal, &mut storage).unwrap();
+    for value in 1..=30 {
+        set_index_list(&mut storage, value);
+        save(&mut journal, &mut storage).unwrap();
+    }
+    assert!(
+        flash.erase_counts().iter().sum::<u32>() > 0,
+        "No sector was reclaimed"
+    );
+
+    let (_, storage) = mount(&flash);
+    assert_eq!(index_list(&storage), [30; INDEX_LIST_LENGTH]);
+    assert_eq!(state_property(&storage), 0x06);
+}
+
+/// Test a sector whose erase was torn by a power cut is erased again before it is
+/// reused, its header reads erased but records are left in its second half
+#[test]
+fn test_journal_torn_erase() {
+    let flash = MockFlash::<1>::new();
+    let (mut journal, mut storage) = mount(&flash);
+    set_state_property(&mut storage, 0x08);
+    save(&mut journal, &mut storage).unwrap();
+    flash.cut_power_at_next_erase();
+    let mut value = 0;
+    loop {
+        value += 1;
+        set_index_list(&mut storage, value);
+        if save(&mut journal, &mut storage).is_err() {
+            break;
+        }
+    }
+    flash.power_on();
+
+    let (mut journal, mut storage) = mount(&flash);
+    let replayed = index_list(&storage);
+    assert!(
+        replayed == [value; INDEX_LIST_LENGTH] || replayed == [value - 1; INDEX_LIST_LENGTH],
+        "Torn erase replayed {:?}",
+        replayed
+    );
+    assert_eq!(state_property(&storage), 0x08);
+
+    // Every record written while the torn sector is reused is replayed
+    for value in 0x80..0x80 + 3 * SECTOR_COUNT as u8 {
+        set_index_list(&mut storage, value);
+        save(&mut journal, &mut storage).unwrap();
+        let (_, replayed) = mount(&flash);
+        assert_eq!(index_list(&replayed), [value; INDEX_LIST_LENGTH]);
+        assert_eq!(state_property(&replayed), 0x08);
+    }
+}
+
+/// Test the sectors are reused round robin, the erase cycles are spread over all
+#[test]
+fn test_journal_wear_rotation() {
+    let flash = MockFlash::<1>::new();
+    let (mut journal, mut storage) = mount(&flash);
+    for value in 0..=240u8 {
+        set_index_list(&mut storage, value);
+        save(&mut journal, &mut storage).unwrap();
+    }
+    let erase_counts = flash.erase_counts();
+    let max = *erase_counts.iter().max().unwrap();
+    let min = *erase_counts.iter().min().unwrap();
+    assert!(min > 0, "Sector never reused: {:?}", erase_counts);
+    assert!(max - min <= 1, "Uneven wear: {:?}", erase_counts);
+}
+
+/// Test a power cut at any flash operation of a sequence of writes, including the
+/// reclaims, loses at most the write in progress
+#[test]
+fn test_journal_power_cut_at_every_operation() {
+    const WRITES: u8 = 12;
+    let total_operations = {
+        let flash = MockFlash::<1>::new();
+        let (mut journal, mut storage) = mount(&flash);
+        set_state_property(&mut storage, 0x07);
+        save(&mut journal, &mut storage).unwrap();
+        for value in 1..=WRITES {
+            set_index_list(&mut storage, value);
+            save(&mut journal, &mut storage).unwrap();
+        }
+        flash.operations()
+    };
+
+    for cut in 0..total_operations {
+        let flash = MockFlash::<1>::new();
+        let (mut journal, mut storage) = mount(&flash);
+        set_state_property(&mut storage, 0x07);
+        save(&mut journal, &mut storage).unwrap();
+        let initial_operations = flash.operations();
+        if cut < initial_operations {
+            continue;
+        }
+        flash.cut_power_after(cut - initial_operations);
+        let mut saved = None;
+        let mut in_progress = None;
+        for value in 1..=WRITES {
+            set_index_list(&mut storage, value);
+            in_progress = Some(value);
+            if save(&mut journal, &mut storage).is_err() {
+                break;
+            }
+            saved = Some(value);
+        }
+        flash.power_on();
+
+        let (mut journal, mut storage) = mount(&flash);
+        let replayed = index_list(&storage);
+        let expected = [saved, in_progress].map(|value| {
+            value.map_or(index_list(&ParameterStorage::new()), |value| {
+                vec![value; INDEX_LIST_LENGTH]
+            })
+        });
+        assert!(
+            expected.contains(&replayed),
+            "Power cut at operation {} replayed {:?}",
+            cut,
+            replayed
+        );
+        assert_eq!(
+            state_property(&storage),
+            0x07,
+            "Power cut at operation {} lost a reclaimed record",
+            cut
+        );
+
+        // The journal keeps working after the power cut
+        set_index_list(&mut storage, 0xA5);
+        save(&mut journal, &mut storage).unwrap();
+        let (_, storage) = mount(&flash);
+        assert_eq!(index_list(&storage), [0xA5; INDEX_LIST_LENGTH]);
+    }
+}
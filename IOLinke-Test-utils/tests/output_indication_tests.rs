@@ -0,0 +1,187 @@
+use iolinke_derived_config::device as derived_config;
+use iolinke_device::{OutputIndication, direct_parameter_address};
+use iolinke_test_utils::frame_utils;
+use iolinke_test_utils::SyncTestDevice;
+#[cfg(feature = "split_layers")]
+use iolinke_test_utils::SplitTestDevice;
+use iolinke_types::page::page1::MasterCommand;
+
+const PD_OUT_LENGTH: usize =
+    derived_config::process_data::pd_out::config_length_in_bytes() as usize;
+
+/// Output Process Data of `create_op_write_request`
+const WRITE_REQUEST_PD_OUT: u8 = 99;
+
+/// Every AL_NewOutput is indicated and nothing is coalesced
+const UNFILTERED: OutputIndication = OutputIndication {
+    on_change: false,
+    min_interval_cycles: 0,
+    coalesce_pd_cycle: false,
+};
+
+/// Returns a device in Operate mode with the output indication `output_indication`
+fn operate_device(output_indication: OutputIndication) -> SyncTestDevice {
+    let mut device = SyncTestDevice::new();
+    assert!(
+        device.startup_to_operate(),
+        "Device did not reach Operate mode"
+    );
+    device.device_mut().set_output_indication(output_indication);
+    device
+}
+
+/// Output Process Data with every octet set to `value`
+fn pd_out(value: u8) -> Vec<u8> {
+    vec![value; PD_OUT_LENGTH]
+}
+
+/// Sends a read request carrying the output Process Data `pd_out`
+fn send_pd_out(device: &mut SyncTestDevice, pd_out: &[u8]) {
+    let address = direct_parameter_address!(MinCycleTime);
+    assert!(
+        device
+            .transfer(&frame_utils::create_op_pd_out_read_request(address, pd_out))
+            .is_some(),
+        "Device did not respond"
+    );
+}
+
+/// Returns the number of AL_NewOutput indicated so far
+fn new_outputs(device: &SyncTestDevice) -> usize {
+    device.indications().new_outputs.len()
+}
+
+/// Test the configured output indication is unfiltered, every frame raises exactly one
+/// AL_NewOutput with its output Process Data
+#[test]
+fn test_one_new_output_per_frame() {
+    assert_eq!(OutputIndication::configured(), UNFILTERED);
+    let mut device = operate_device(OutputIndication::configured());
+    let indicated = new_outputs(&device);
+
+    let frames: Vec<Vec<u8>> = (1..=4).map(pd_out).chain([pd_out(4)]).collect();
+    for frame in &frames {
+        send_pd_out(&mut device, frame);
+    }
+    let indications = device.indications();
+    assert_eq!(indications.new_outputs[indicated..], frames[..]);
+}
+
+/// Test OnChange indicates only output Process Data which differs from the last
+/// indicated one
+#[test]
+fn test_on_change_filters_unchanged_output() {
+    let mut device = operate_device(OutputIndication {
+        on_change: true,
+        ..UNFILTERED
+    });
+    let indicated = new_outputs(&device);
+
+    for value in [1, 1, 2, 2, 2, 1] {
+        send_pd_out(&mut device, &pd_out(value));
+    }
+    let indications = device.indications();
+    assert_eq!(
+        indications.new_outputs[indicated..],
+        [pd_out(1), pd_out(2), pd_out(1)]
+    );
+}
+
+/// Test MinIntervalCycles skips the output Process Data received within the interval
+#[test]
+fn test_min_interval_cycles_throttles_output() {
+    let mut device = operate_device(OutputIndication {
+        min_interval_cycles: 3,
+        ..UNFILTERED
+    });
+    let indicated = new_outputs(&device);
+
+    for value in 1..=7 {
+        send_pd_out(&mut device, &pd_out(value));
+    }
+    let indications = device.indications();
+    assert_eq!(
+        indications.new_outputs[indicated..],
+        [pd_out(1), pd_out(4), pd_out(7)]
+    );
+}
+
+/// Test PDOUTVALID and PDOUTINVALID reach the filter, the next output Process Data is
+/// indicated even if unchanged
+#[test]
+fn test_pd_out_valid_indicates_unchanged_output() {
+    let mut device = operate_device(OutputIndication {
+        on_change: true,
+        ..UNFILTERED
+    });
+    let master_command_address = direct_parameter_address!(MasterCommand);
+    let unchanged = pd_out(WRITE_REQUEST_PD_OUT);
+    send_pd_out(&mut device, &unchanged);
+    send_pd_out(&mut device, &unchanged);
+    let indicated = new_outputs(&device);
+    send_pd_out(&mut device, &unchanged);
+    assert_eq!(new_outputs(&device), indicated);
+
+    for master_command in [
+        MasterCommand::ProcessDataOutputOperate,
+        MasterCommand::DeviceOperate,
+    ] {
+        let indicated = new_outputs(&device);
+        // A write request carries the same output Process Data
+        assert!(
+            device
+                .transfer(&frame_utils::create_op_write_request(
+                    master_command_address,
+                    &[master_command.into()],
+                ))
+                .is_some(),
+            "Device did not respond"
+        );
+        send_pd_out(&mut device, &unchanged);
+        assert_eq!(
+            new_outputs(&device),
+            indicated + 1,
+            "{master_command:?} did not re-arm the output indication"
+        );
+        assert_eq!(device.indications().new_outputs.last(), Some(&unchanged));
+    }
+}
+
+/// Test CoalescePdCycle raises one AL_PDCycle for the DL_PDCycle indications between
+/// two polls of the Application Layer side
+#[cfg(feature = "split_layers")]
+#[test]
+fn test_coalesce_pd_cycle_between_polls() {
+    for (coalesce_pd_cycle, expected_pd_cycles) in [(true, 1), (false, 2)] {
+        let mut device = SplitTestDevice::new();
+        assert!(
+            device.startup_to_operate(),
+            "Device did not reach Operate mode"
+        );
+        device.poll();
+        device
+            .al_side_mut()
+            .set_output_indication(OutputIndication {
+                coalesce_pd_cycle,
+                ..UNFILTERED
+            });
+        let address = direct_parameter_address!(MinCycleTime);
+        let pd_cycles = device.indications().pd_cycles;
+
+        for value in [1, 2] {
+            device.transfer_ind(&frame_utils::create_op_pd_out_read_request(
+                address,
+                &pd_out(value),
+            ));
+            for _ in 0..8 {
+                let _ = device.dl_side_mut().poll();
+            }
+        }
+        device.poll();
+        assert_eq!(
+            device.indications().pd_cycles,
+            pd_cycles + expected_pd_cycles,
+            "CoalescePdCycle {coalesce_pd_cycle}"
+        );
+    }
+}
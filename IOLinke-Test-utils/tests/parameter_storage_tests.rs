@@ -0,0 +1,313 @@
+/// Parameter storage with a Data Storage parameter set, declared out of order
+mod test_storage {
+    use iolinke_macros::declare_parameter_storage;
+
+    declare_parameter_storage! {
+        (0x0041, 0x00, 4, 0..3, ReadWrite, u32, &[0x01, 0x02, 0x03, 0x04]),
+        (0x0003, 0x01, 1, 0..0, ReadWrite, u8, &[0]),
+        (0x0003, 0x02, 1, 0..0, ReadWrite, u8, &[0]),
+        (0x0003, 0x03, 4, 0..3, ReadOnly, u32, &[0; 4]),
+        (0x0003, 0x04, 4, 0..3, ReadOnly, u32, &[0; 4]),
+        (0x0003, 0x05, 12, 0..11, ReadWrite, u8, &[0; 12]),
+        (0x0010, 0x00, 7, 0..6, ReadOnly, StringT, b"IOLinke"),
+        (0x0040, 0x02, 2, 0..1, ReadWrite, u16, &[0x56, 0x78]),
+        (0x0040, 0x01, 2, 0..1, ReadWrite, u16, &[0x12, 0x34]),
+    }
+}
+
+use test_storage::{
+    MAX_INDEX_LENGTH, MAX_PARAMETER_LENGTH, PARAMETER_ARENA_SIZE, PARAMETER_COUNT, ParameterError,
+    ParameterStorage,
+};
+
+const PARAMETER_CHECKSUM: (u16, u8) = (0x0003, 0x04);
+
+/// Index and subindex of the dirty parameters of `storage`
+fn dirty_parameters(storage: &ParameterStorage) -> Vec<(u16, u8)> {
+    storage
+        .dirty_parameters()
+        .map(|info| (info.index, info.subindex))
+        .collect()
+}
+
+/// Parameter_Checksum of the Data Storage parameter set computed over the whole arena,
+/// used to cross check the incrementally updated one
+fn reference_parameter_checksum(storage: &ParameterStorage) -> u32 {
+    let arena = storage.arena();
+    let (mut sum, mut weighted_sum) = (0u16, 0u16);
+    for info in storage
+        .get_all_parameters()
+        .iter()
+        .filter(|info| info.data_storage)
+    {
+        for offset in info.offset..info.offset + info.length {
+            let weight = (offset as u16).wrapping_add(1);
+            sum = sum.wrapping_add(arena[offset] as u16);
+            weighted_sum = weighted_sum.wrapping_add((arena[offset] as u16).wrapping_mul(weight));
+        }
+    }
+    ((weighted_sum as u32) << 16) | sum as u32
+}
+
+/// Checks the cached Parameter_Checksum against a recomputation and against the value
+/// readable at index 0x0003 subindex 0x04
+fn assert_checksum_consistent(storage: &ParameterStorage) {
+    assert_eq!(
+        storage.parameter_checksum(),
+        reference_parameter_checksum(storage),
+        "Incremental Parameter_Checksum differs from the recomputed one"
+    );
+    let (_, checksum) = storage
+        .get_parameter(PARAMETER_CHECKSUM.0, PARAMETER_CHECKSUM.1)
+        .unwrap();
+    assert_eq!(checksum, storage.parameter_checksum().to_be_bytes());
+}
+
+/// Test the Data Storage parameter set starts dirty, it was not yet exchanged with
+/// the Master
+#[test]
+fn test_parameter_storage_starts_dirty() {
+    let storage = ParameterStorage::new();
+    assert!(storage.is_data_storage_dirty());
+    assert_eq!(
+        dirty_parameters(&storage),
+        [(0x0040, 0x01), (0x0040, 0x02), (0x0041, 0x00)]
+    );
+}
+
+/// Test only a write which changes a value sets the dirty bit of the parameter
+#[test]
+fn test_parameter_storage_dirty_on_change() {
+    let mut storage = ParameterStorage::new();
+    storage.clear_dirty();
+    assert!(!storage.is_data_storage_dirty());
+    assert!(dirty_parameters(&storage).is_empty());
+
+    // Writing the value a parameter already has is a no-op
+    storage.set_parameter(0x0040, 0x02, &[0x56, 0x78]).unwrap();
+    assert!(!storage.is_data_storage_dirty());
+    assert!(dirty_parameters(&storage).is_empty());
+
+    storage.set_parameter(0x0040, 0x02, &[0x9A, 0xBC]).unwrap();
+    assert!(storage.is_data_storage_dirty());
+    assert_eq!(dirty_parameters(&storage), [(0x0040, 0x02)]);
+
+    storage.clear_dirty();
+    assert!(!storage.is_data_storage_dirty());
+}
+
+/// Test a changed parameter outside of the Data Storage parameter set is dirty but
+/// does not make the set dirty
+#[test]
+fn test_parameter_storage_dirty_outside_data_storage() {
+    let mut storage = ParameterStorage::new();
+    storage.clear_dirty();
+    storage.set_parameter(0x0003, 0x02, &[0x80]).unwrap();
+    assert_eq!(dirty_parameters(&storage), [(0x0003, 0x02)]);
+    assert!(!storage.is_data_storage_dirty());
+}
+
+/// Test a rejected write leaves the value and the dirty bits untouched
+#[test]
+fn test_parameter_storage_rejected_write_not_dirty() {
+    let mut storage = ParameterStorage::new();
+    storage.clear_dirty();
+    let checksum = storage.parameter_checksum();
+    assert!(storage.set_parameter(0x0040, 0x01, &[0xFF]).is_err());
+    assert!(storage.set_parameter(0x0010, 0x00, b"Changed").is_err());
+    assert!(dirty_parameters(&storage).is_empty());
+    assert_eq!(storage.parameter_checksum(), checksum);
+    assert_eq!(
+        storage.get_parameter(0x0040, 0x01).unwrap(),
+        (2, &[0x12, 0x34][..])
+    );
+}
+
+/// Test the Parameter_Checksum of the default values matches a recomputation
+#[test]
+fn test_parameter_checksum_of_defaults() {
+    let storage = ParameterStorage::new();
+    assert_ne!(storage.parameter_checksum(), 0);
+    assert_checksum_consistent(&storage);
+}
+
+/// Test the incremental Parameter_Checksum follows single and whole index writes
+#[test]
+fn test_parameter_checksum_incremental() {
+    let mut storage = ParameterStorage::new();
+    let default_checksum = storage.parameter_checksum();
+
+    storage
+        .set_parameter(0x0041, 0x00, &[0xDE, 0xAD, 0xBE, 0xEF])
+        .unwrap();
+    assert_ne!(storage.parameter_checksum(), default_checksum);
+    assert_checksum_consistent(&storage);
+
+    storage
+        .write_index_memory(0x0040, &[0x00, 0x11, 0x22, 0x33])
+        .unwrap();
+    assert_checksum_consistent(&storage);
+
+    // A parameter outside of the Data Storage parameter set does not change it
+    let checksum = storage.parameter_checksum();
+    storage.set_parameter(0x0003, 0x02, &[0x80]).unwrap();
+    assert_eq!(storage.parameter_checksum(), checksum);
+
+    // Writing back the defaults gives the default checksum again
+    storage
+        .set_parameter(0x0041, 0x00, &[0x01, 0x02, 0x03, 0x04])
+        .unwrap();
+    storage
+        .write_index_memory(0x0040, &[0x12, 0x34, 0x56, 0x78])
+        .unwrap();
+    assert_eq!(storage.parameter_checksum(), default_checksum);
+    assert_checksum_consistent(&storage);
+}
+
+/// Test swapped values of two parameters change the Parameter_Checksum
+#[test]
+fn test_parameter_checksum_detects_swapped_values() {
+    let mut storage = ParameterStorage::new();
+    let default_checksum = storage.parameter_checksum();
+    storage.set_parameter(0x0040, 0x01, &[0x56, 0x78]).unwrap();
+    storage.set_parameter(0x0040, 0x02, &[0x12, 0x34]).unwrap();
+    assert_ne!(storage.parameter_checksum(), default_checksum);
+    assert_checksum_consistent(&storage);
+}
+
+/// Test loading an arena recomputes the Parameter_Checksum and keeps the dirty bits
+#[test]
+fn test_parameter_checksum_after_load_arena() {
+    let mut source = ParameterStorage::new();
+    source
+        .set_parameter(0x0041, 0x00, &[0x0A, 0x0B, 0x0C, 0x0D])
+        .unwrap();
+    let image: [u8; PARAMETER_ARENA_SIZE] = *source.arena();
+
+    let mut storage = ParameterStorage::new();
+    storage.clear_dirty();
+    storage.load_arena(&image);
+    assert_eq!(storage.parameter_checksum(), source.parameter_checksum());
+    assert_checksum_consistent(&storage);
+    assert!(!storage.is_data_storage_dirty());
+}
+
+/// Test a reset to defaults restores every value, marks the set dirty and the
+/// persistent parameters unsaved
+#[test]
+fn test_parameter_storage_clear_resets_to_defaults() {
+    let mut storage = ParameterStorage::new();
+    let default_checksum = storage.parameter_checksum();
+    storage.set_parameter(0x0040, 0x01, &[0xAA, 0xBB]).unwrap();
+    storage.clear_dirty();
+
+    storage.clear();
+    assert_eq!(
+        storage.get_parameter(0x0040, 0x01).unwrap(),
+        (2, &[0x12, 0x34][..])
+    );
+    assert_eq!(storage.parameter_checksum(), default_checksum);
+    assert!(storage.is_data_storage_dirty());
+    // The defaults replace the saved values in non-volatile memory as well
+    assert!(storage.has_unsaved());
+}
+
+/// Test the parameter table is sorted by index and subindex, every parameter is found
+/// at its position by the binary search
+#[test]
+fn test_parameter_table_sorted_and_found() {
+    let storage = ParameterStorage::new();
+    let table = storage.get_all_parameters();
+    assert_eq!(table.len(), PARAMETER_COUNT);
+    assert!(
+        table
+            .windows(2)
+            .all(|pair| (pair[0].index, pair[0].subindex) < (pair[1].index, pair[1].subindex))
+    );
+    for (position, info) in table.iter().enumerate() {
+        assert_eq!(storage.position(info.index, info.subindex), Ok(position));
+        let found = storage
+            .get_parameter_info(info.index, info.subindex)
+            .unwrap();
+        assert_eq!((found.offset, found.length), (info.offset, info.length));
+    }
+}
+
+/// Test the arena packs the parameters in the order of the table without gaps, and
+/// lookup returns the value at the offset of the parameter
+#[test]
+fn test_parameter_arena_layout() {
+    let storage = ParameterStorage::new();
+    let table = storage.get_all_parameters();
+    let mut offset = 0;
+    for info in table {
+        assert_eq!(
+            info.offset, offset,
+            "Gap before 0x{:04X}/{}",
+            info.index, info.subindex
+        );
+        offset += info.length;
+    }
+    assert_eq!(offset, PARAMETER_ARENA_SIZE);
+
+    let (info, value) = storage.lookup(0x0041, 0x00).unwrap();
+    assert_eq!((info.index, info.subindex, info.length), (0x0041, 0x00, 4));
+    assert_eq!(value, [0x01, 0x02, 0x03, 0x04]);
+    assert_eq!(
+        value,
+        &storage.arena()[info.offset..info.offset + info.length]
+    );
+}
+
+/// Test a missing index or subindex is reported as not available
+#[test]
+fn test_parameter_storage_missing_index() {
+    let mut storage = ParameterStorage::new();
+    // Before the first, between two and after the last index
+    for index in [0x0001, 0x0004, 0x0042] {
+        assert!(!storage.contains_index(index));
+        assert_eq!(
+            storage.get_parameter(index, 0x00),
+            Err(ParameterError::IndexNotAvailable)
+        );
+        assert!(matches!(
+            storage.read_index_slice(index),
+            Err(ParameterError::IndexNotAvailable)
+        ));
+        assert_eq!(
+            storage.write_index_memory(index, &[0x00]),
+            Err(ParameterError::IndexNotAvailable)
+        );
+    }
+    // A subindex of a declared index
+    assert!(storage.contains_index(0x0040));
+    assert!(storage.lookup(0x0040, 0x03).is_err());
+    assert!(matches!(
+        storage.get_parameter_info(0x0040, 0x00),
+        Err(ParameterError::IndexNotAvailable)
+    ));
+}
+
+/// Test a whole index read returns the subindexes in subindex order, also for an
+/// index longer than its longest parameter
+#[test]
+fn test_parameter_storage_whole_index_read() {
+    let storage = ParameterStorage::new();
+    // Declared subindex 0x02 first
+    assert_eq!(
+        storage.read_index_memory(0x0040).unwrap()[..],
+        [0x12, 0x34, 0x56, 0x78]
+    );
+
+    // Index 0x0003 holds 22 octets, more than the longest parameter
+    assert_eq!(MAX_PARAMETER_LENGTH, 12);
+    assert_eq!(MAX_INDEX_LENGTH, 22);
+    let data_storage_index = storage.read_index_memory(0x0003).unwrap();
+    assert_eq!(data_storage_index.len(), MAX_INDEX_LENGTH);
+    assert_eq!(
+        data_storage_index[..],
+        *storage.read_index_slice(0x0003).unwrap()
+    );
+    let (_, index_list) = storage.get_parameter(0x0003, 0x05).unwrap();
+    assert_eq!(data_storage_index[10..], *index_list);
+}
@@ -67,7 +67,7 @@ fn test_read_isdu_read_vendor_name() {
         // Vendor Name index 0x10, subindex 0x00
         const VENDOR_NAME: &'static str = derived_config::vendor_specifics::VENDOR_NAME;
         const VENDOR_NAME_LENGTH: u8 = VENDOR_NAME.len() as u8;
-        let vendor_name = read_vendor_name(&poll_tx, &poll_response_rx);
+        let vendor_name = read_vendor_name(&poll_tx, &poll_response_rx, TestDeviceMode::Preoperate);
         assert!(vendor_name.as_ref().is_ok(), "Test isdu sequence failed");
         assert!(
             VENDOR_NAME_LENGTH == vendor_name.as_ref().unwrap().len() as u8,
@@ -80,19 +80,71 @@ fn test_read_isdu_read_vendor_name() {
     }
 }
 
+/// Reads an index with the ISDU frames of `mode`, Preoperate or Operate
+fn isdu_read(
+    poll_tx: &std::sync::mpsc::Sender<iolinke_test_utils::ThreadMessage>,
+    poll_response_rx: &std::sync::mpsc::Receiver<iolinke_test_utils::ThreadMessage>,
+    mode: TestDeviceMode,
+    index: u16,
+    subindex: Option<u8>,
+) -> Result<Vec<u8>, Box<dyn std::error::Error>> {
+    match mode {
+        TestDeviceMode::Operate => iolinke_test_utils::util_op_test_isdu_sequence_read(
+            poll_tx,
+            poll_response_rx,
+            index,
+            subindex,
+        ),
+        _ => iolinke_test_utils::util_pre_op_test_isdu_sequence_read(
+            poll_tx,
+            poll_response_rx,
+            index,
+            subindex,
+        ),
+    }
+}
+
+/// Writes an index with the ISDU frames of `mode`, Preoperate or Operate
+fn isdu_write(
+    poll_tx: &std::sync::mpsc::Sender<iolinke_test_utils::ThreadMessage>,
+    poll_response_rx: &std::sync::mpsc::Receiver<iolinke_test_utils::ThreadMessage>,
+    mode: TestDeviceMode,
+    index: u16,
+    subindex: Option<u8>,
+    data: &[u8],
+) -> Result<(), Box<dyn std::error::Error>> {
+    match mode {
+        TestDeviceMode::Operate => iolinke_test_utils::util_op_test_isdu_sequence_write(
+            poll_tx,
+            poll_response_rx,
+            index,
+            subindex,
+            data,
+        ),
+        _ => iolinke_test_utils::util_pre_op_test_isdu_sequence_write(
+            poll_tx,
+            poll_response_rx,
+            index,
+            subindex,
+            data,
+        ),
+    }
+}
+
 fn read_vendor_name(
     poll_tx: &std::sync::mpsc::Sender<iolinke_test_utils::ThreadMessage>,
     poll_response_rx: &std::sync::mpsc::Receiver<iolinke_test_utils::ThreadMessage>,
+    mode: TestDeviceMode,
 ) -> Result<Vec<u8>, Box<dyn std::error::Error>> {
     let vendor_name_index = DeviceParametersIndex::VendorName.index();
     let vendor_name_subindex = DeviceParametersIndex::VendorName.subindex(SubIndex::VendorName);
-    let vendor_name = iolinke_test_utils::util_pre_op_test_isdu_sequence_read(
+    isdu_read(
         poll_tx,
         poll_response_rx,
+        mode,
         vendor_name_index,
         Some(vendor_name_subindex),
-    );
-    vendor_name
+    )
 }
 
 #[test]
@@ -120,7 +172,7 @@ fn test_write_data_storage_index_and_read_back() {
         // Vendor Name index 0x10, subindex 0x00
         const VENDOR_NAME: &'static str = derived_config::vendor_specifics::VENDOR_NAME;
         const VENDOR_NAME_LENGTH: u8 = VENDOR_NAME.len() as u8;
-        let vendor_name = read_vendor_name(&poll_tx, &poll_response_rx);
+        let vendor_name = read_vendor_name(&poll_tx, &poll_response_rx, TestDeviceMode::Preoperate);
         assert!(vendor_name.as_ref().is_ok(), "Test isdu sequence failed");
         assert!(
             VENDOR_NAME_LENGTH == vendor_name.as_ref().unwrap().len() as u8,
@@ -131,7 +183,7 @@ fn test_write_data_storage_index_and_read_back() {
             "ISDU data not matching"
         );
 
-        loop_test(&poll_tx, &poll_response_rx);
+        loop_test(&poll_tx, &poll_response_rx, TestDeviceMode::Preoperate);
     } else {
         println!("⚠️ Device does not configured to support ISDU in PreOperate mode ⚠️");
     }
@@ -148,7 +200,7 @@ fn test_write_data_storage_index_and_read_back() {
         // Vendor Name index 0x10, subindex 0x00
         const VENDOR_NAME: &'static str = derived_config::vendor_specifics::VENDOR_NAME;
         const VENDOR_NAME_LENGTH: u8 = VENDOR_NAME.len() as u8;
-        let vendor_name = read_vendor_name(&poll_tx, &poll_response_rx);
+        let vendor_name = read_vendor_name(&poll_tx, &poll_response_rx, TestDeviceMode::Operate);
         assert!(vendor_name.as_ref().is_ok(), "Test isdu sequence failed");
         assert!(
             VENDOR_NAME_LENGTH == vendor_name.as_ref().unwrap().len() as u8,
@@ -159,7 +211,7 @@ fn test_write_data_storage_index_and_read_back() {
             "ISDU data not matching"
         );
 
-        loop_test(&poll_tx, &poll_response_rx);
+        loop_test(&poll_tx, &poll_response_rx, TestDeviceMode::Operate);
     } else {
         println!("⚠️ Device does not configured to support ISDU in PreOperate mode ⚠️");
     }
@@ -168,6 +220,7 @@ fn test_write_data_storage_index_and_read_back() {
 fn loop_test(
     poll_tx: &std::sync::mpsc::Sender<iolinke_test_utils::ThreadMessage>,
     poll_response_rx: &std::sync::mpsc::Receiver<iolinke_test_utils::ThreadMessage>,
+    mode: TestDeviceMode,
 ) {
     // Write DATA_STORAGE_INDEX_INDEX , INDEX_LIST_SUBINDEX, 0x0003, 0x05
     let data_storage_index_index = DeviceParametersIndex::DataStorageIndex.index();
@@ -178,18 +231,20 @@ fn loop_test(
         0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E,
         0x0F, 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x1A, 0x1B, 0x1C, 0x1D,
     ];
-    let result = iolinke_test_utils::util_pre_op_test_isdu_sequence_write(
+    let result = isdu_write(
         &poll_tx,
         &poll_response_rx,
+        mode.clone(),
         data_storage_index_index,
         Some(index_list_subindex),
         &index_list_data,
     );
     assert!(result.is_ok(), "Test isdu sequence failed");
 
-    let result = iolinke_test_utils::util_pre_op_test_isdu_sequence_read(
+    let result = isdu_read(
         &poll_tx,
         &poll_response_rx,
+        mode,
         data_storage_index_index,
         Some(index_list_subindex),
     );
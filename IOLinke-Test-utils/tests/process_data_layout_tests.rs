@@ -0,0 +1,50 @@
+use iolinke_device::process_data_layout;
+
+/// Layout at the limits: fields across octet borders, narrow signed and float fields
+#[process_data_layout(length = 6)]
+#[repr(C)]
+#[derive(Debug, Clone, Copy, Default, PartialEq)]
+struct TestPd {
+    #[pd_field(bit_offset = 0)]
+    flag: bool,
+    #[pd_field(bit_offset = 3, bit_length = 5)]
+    small: i8,
+    #[pd_field(bit_offset = 8)]
+    value: f32,
+    #[pd_field(bit_offset = 44, bit_length = 4)]
+    nibble: u8,
+}
+
+/// Test the bit offsets start at the least significant bit of the last octet and
+/// unpack restores the packed fields
+#[test]
+fn test_process_data_layout_round_trip() {
+    let pd_value = TestPd {
+        flag: true,
+        small: -7,
+        value: 1.5,
+        nibble: 0xA,
+    };
+    let mut pd = [0u8; TestPd::LENGTH];
+    pd_value.pack(&mut pd);
+
+    let value_bytes = 1.5f32.to_bits().to_be_bytes();
+    assert_eq!(pd[0], 0xA0);
+    assert_eq!(pd[1..5], value_bytes);
+    assert_eq!(pd[5], ((-7i8 as u8 & 0x1F) << 3) | 0x01);
+    assert_eq!(TestPd::unpack(&pd), pd_value);
+    assert_eq!(TestPd::NIBBLE_BIT_OFFSET, 44);
+    assert_eq!(TestPd::SMALL_BIT_LENGTH, 5);
+}
+
+/// Test pack truncates values to the bit length of the field
+#[test]
+fn test_process_data_layout_truncates() {
+    let mut pd = [0xFFu8; TestPd::LENGTH];
+    TestPd {
+        nibble: 0x1F,
+        ..TestPd::default()
+    }
+    .pack(&mut pd);
+    assert_eq!(pd, [0xF0, 0, 0, 0, 0, 0]);
+}
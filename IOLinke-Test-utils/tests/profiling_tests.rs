@@ -0,0 +1,95 @@
+#![cfg(feature = "profiling")]
+
+use iolinke_bindings::c::profiling::{
+    ProfileHistogram, ProfileId, ProfileStats, iolinke_profile_histogram, iolinke_profile_stats,
+};
+use iolinke_device::profiling::{PROFILE_HISTOGRAM_BUCKETS, PROFILE_ID_COUNT};
+use iolinke_test_utils::SyncTestDevice;
+use iolinke_test_utils::frame_utils;
+
+/// Statistics marking a `ProfileStats` the binding did not fill
+const UNTOUCHED: ProfileStats = ProfileStats {
+    count: u32::MAX,
+    min: u32::MAX,
+    max: u32::MAX,
+    avg: u32::MAX,
+};
+
+/// Histogram marking a `ProfileHistogram` the binding did not fill
+const UNTOUCHED_HISTOGRAM: ProfileHistogram = ProfileHistogram {
+    buckets: [u32::MAX; PROFILE_HISTOGRAM_BUCKETS],
+};
+
+/// Test every profile_id_t value converts to its ProfileId and back
+#[test]
+fn test_profile_id_from_index() {
+    for index in 0..PROFILE_ID_COUNT as u8 {
+        assert_eq!(ProfileId::from_index(index).map(|id| id as u8), Some(index));
+    }
+    assert_eq!(ProfileId::from_index(PROFILE_ID_COUNT as u8), None);
+}
+
+/// Test an id which is no profile_id_t and a null pointer are rejected
+#[test]
+fn test_profile_stats_rejects_invalid_arguments() {
+    for id in [PROFILE_ID_COUNT as u8, 0x80, u8::MAX] {
+        let mut stats = UNTOUCHED;
+        assert!(!iolinke_profile_stats(id, &mut stats));
+        assert_eq!(stats, UNTOUCHED);
+    }
+    assert!(!iolinke_profile_stats(
+        ProfileId::DevicePoll as u8,
+        core::ptr::null_mut()
+    ));
+}
+
+/// Test the statistics of a device poll grow with the polls of a device. The
+/// statistics are process-global and other tests poll their devices concurrently, so
+/// only the growth is checked.
+#[test]
+fn test_profile_stats_record_device_poll() {
+    let mut device = SyncTestDevice::new();
+    let [master_ident, ..] = frame_utils::startup_to_operate_requests();
+    assert!(device.transfer(&master_ident).is_some());
+
+    for id in [ProfileId::DevicePoll, ProfileId::DlMessageHandler] {
+        let mut stats = UNTOUCHED;
+        assert!(iolinke_profile_stats(id as u8, &mut stats));
+        assert_ne!(stats, UNTOUCHED);
+        assert!(stats.count > 0, "{id:?} recorded no sample");
+    }
+}
+
+/// Test an id which is no profile_id_t and a null pointer are rejected by the histogram
+#[test]
+fn test_profile_histogram_rejects_invalid_arguments() {
+    for id in [PROFILE_ID_COUNT as u8, 0x80, u8::MAX] {
+        let mut histogram = UNTOUCHED_HISTOGRAM;
+        assert!(!iolinke_profile_histogram(id, &mut histogram));
+        assert_eq!(histogram, UNTOUCHED_HISTOGRAM);
+    }
+    assert!(!iolinke_profile_histogram(
+        ProfileId::DevicePoll as u8,
+        core::ptr::null_mut()
+    ));
+}
+
+/// Test the histogram of the message handler holds the samples of a device. Other
+/// tests poll their devices concurrently, so only the growth is checked.
+#[test]
+fn test_profile_histogram_records_samples() {
+    let id = ProfileId::DlMessageHandler as u8;
+    let mut before = UNTOUCHED_HISTOGRAM;
+    assert!(iolinke_profile_histogram(id, &mut before));
+
+    let mut device = SyncTestDevice::new();
+    let [master_ident, ..] = frame_utils::startup_to_operate_requests();
+    assert!(device.transfer(&master_ident).is_some());
+
+    let mut after = UNTOUCHED_HISTOGRAM;
+    assert!(iolinke_profile_histogram(id, &mut after));
+    let samples = |histogram: &ProfileHistogram| -> u64 {
+        histogram.buckets.iter().map(|&count| u64::from(count)).sum()
+    };
+    assert!(samples(&after) > samples(&before), "no sample recorded");
+}
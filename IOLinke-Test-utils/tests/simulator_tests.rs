@@ -0,0 +1,27 @@
+use iolinke_device::direct_parameter_address;
+use iolinke_test_utils::{SimulatedMaster, Simulator, frame_utils};
+
+/// Soak test of the startup, each run starts from a freshly woken up device
+#[test]
+fn test_simulated_startup_to_operate_soak() {
+    for run in 0..100 {
+        let mut simulator = Simulator::new();
+        let master = SimulatedMaster::new(simulator.min_cycle_time());
+        assert!(
+            master.startup_to_operate(&mut simulator),
+            "Device did not reach Operate mode in run {run}"
+        );
+    }
+}
+
+/// Test the device responds to every cycle in Operate mode
+#[test]
+fn test_simulated_operate_cycles() {
+    let mut simulator = Simulator::new();
+    let master = SimulatedMaster::new(simulator.min_cycle_time());
+    assert!(master.startup_to_operate(&mut simulator), "Device did not reach Operate mode");
+    let master_frame = frame_utils::create_op_read_request(direct_parameter_address!(MinCycleTime));
+    let stats = master.run_cycles(&mut simulator, &master_frame, 10_000);
+    assert_eq!(stats.cycles, 10_000);
+    assert_eq!(stats.missed, 0, "Device missed cycles: {stats:?}");
+}
@@ -0,0 +1,94 @@
+#![cfg(feature = "split_layers")]
+
+use iolinke_derived_config::device as derived_config;
+use iolinke_device::direct_parameter_address;
+use iolinke_device::split::LayerMailbox;
+use iolinke_test_utils::SplitTestDevice;
+use iolinke_test_utils::frame_utils::{self, isdu_frame};
+use iolinke_types::handlers::pm::{DeviceParametersIndex, SubIndex};
+
+const PD_OUT_LENGTH: usize =
+    derived_config::process_data::pd_out::config_length_in_bytes() as usize;
+
+/// Test a new mailbox has nothing to deliver and nothing dropped
+#[test]
+fn test_layer_mailbox_starts_empty() {
+    let mailbox = LayerMailbox::new();
+    assert!(!mailbox.has_application_layer_messages());
+    assert!(!mailbox.has_data_link_layer_messages());
+    assert_eq!(mailbox.overflow_count(), 0);
+}
+
+/// Test the mailbox is drained by the polls of both sides during the startup
+#[test]
+fn test_layer_mailbox_drained_by_both_sides() {
+    let mut device = SplitTestDevice::new();
+    assert!(
+        device.startup_to_operate(),
+        "Device did not reach Operate mode"
+    );
+    device.poll();
+    let mailbox = device.mailbox();
+    assert!(!mailbox.has_application_layer_messages());
+    assert!(!mailbox.has_data_link_layer_messages());
+    assert_eq!(mailbox.overflow_count(), 0, "Mailbox dropped messages");
+}
+
+/// Test an ISDU read is answered through the mailbox, the Application Layer side
+/// delivers the response to the Data Link Layer side
+#[test]
+fn test_split_isdu_read_vendor_name() {
+    let mut device = SplitTestDevice::new();
+    let [master_ident, device_pre_operate, ..] = frame_utils::startup_to_operate_requests();
+    assert!(device.transfer(&master_ident).is_some());
+    assert!(device.transfer(&device_pre_operate).is_some());
+
+    let vendor_name = derived_config::vendor_specifics::VENDOR_NAME.as_bytes();
+    let isdu_request = isdu_frame::create_isdu_read_request(
+        DeviceParametersIndex::VendorName.index(),
+        Some(DeviceParametersIndex::VendorName.subindex(SubIndex::VendorName)),
+    );
+    let response = isdu_frame::transfer_preop_isdu(|frame| device.transfer(frame), &isdu_request)
+        .expect("ISDU read not answered");
+    // I-Service with an extended length for more than 15 octets, data and CHKPDU
+    let header_length = if response[0] & 0x0F == 1 { 2 } else { 1 };
+    assert_eq!(&response[header_length..response.len() - 1], vendor_name);
+    assert_eq!(device.mailbox().overflow_count(), 0);
+}
+
+/// Test the output Process Data reaches the Application Layer side, a value written
+/// while the previous one was not delivered yet replaces it
+#[test]
+fn test_split_pd_out_delivered_to_application() {
+    let mut device = SplitTestDevice::new();
+    assert!(
+        device.startup_to_operate(),
+        "Device did not reach Operate mode"
+    );
+    device.poll();
+    let address = direct_parameter_address!(MinCycleTime);
+
+    let first: Vec<u8> = (1..=PD_OUT_LENGTH as u8).collect();
+    assert!(
+        device
+            .transfer(&frame_utils::create_op_pd_out_read_request(address, &first))
+            .is_some()
+    );
+    device.poll();
+    assert_eq!(device.indications().new_outputs.last(), Some(&first));
+
+    // Two cycles before the Application Layer side runs, only the latest is delivered
+    let stale: Vec<u8> = (0x10..0x10 + PD_OUT_LENGTH as u8).collect();
+    let latest: Vec<u8> = (0x20..0x20 + PD_OUT_LENGTH as u8).collect();
+    let indicated = device.indications().new_outputs.len();
+    for pd_out in [&stale, &latest] {
+        device.transfer_ind(&frame_utils::create_op_pd_out_read_request(address, pd_out));
+        for _ in 0..8 {
+            let _ = device.dl_side_mut().poll();
+        }
+    }
+    device.poll();
+    let indications = device.indications();
+    assert_eq!(indications.new_outputs.len(), indicated + 1);
+    assert_eq!(indications.new_outputs.last(), Some(&latest));
+}
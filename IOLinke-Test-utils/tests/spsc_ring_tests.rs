@@ -0,0 +1,64 @@
+use iolinke_util::spsc_ring::SpscRing;
+
+/// Test elements are popped in push order and a full ring counts the dropped pushes
+#[test]
+fn test_spsc_ring_order_and_overflow() {
+    let ring: SpscRing<[u8; 3], 3> = SpscRing::new();
+    assert!(ring.is_empty());
+    assert_eq!(ring.pop(), None);
+
+    // Run over the wrap around of the positions a few times
+    for round in 0..5u8 {
+        assert!(ring.push([round, 0x01, 0x00]));
+        assert!(ring.push([round, 0x02, 0x00]));
+        assert!(ring.push([round, 0x03, 0x00]));
+        assert!(!ring.push([round, 0x04, 0x00]));
+        assert_eq!(ring.len(), 3);
+        assert_eq!(ring.pop(), Some([round, 0x01, 0x00]));
+        assert_eq!(ring.pop(), Some([round, 0x02, 0x00]));
+        assert_eq!(ring.pop(), Some([round, 0x03, 0x00]));
+        assert_eq!(ring.pop(), None);
+    }
+    assert_eq!(ring.overflow_count(), 5);
+
+    assert!(ring.push([0xFF, 0xFF, 0xFF]));
+    ring.clear();
+    assert!(ring.is_empty());
+}
+
+/// Test no element is lost or reordered with a concurrent producer
+#[test]
+fn test_spsc_ring_concurrent_producer() {
+    let ring: &'static SpscRing<u32, 4> = Box::leak(Box::new(SpscRing::new()));
+    let producer = std::thread::spawn(move || {
+        for value in 0..10_000u32 {
+            while !ring.push(value) {}
+        }
+    });
+    let mut expected = 0u32;
+    while expected < 10_000 {
+        if let Some(value) = ring.pop() {
+            assert_eq!(value, expected, "Element lost or reordered");
+            expected += 1;
+        }
+    }
+    producer.join().unwrap();
+    assert!(ring.is_empty());
+}
+
+/// Test Events pushed into a device are queued up to the queue depth and counted after
+#[test]
+fn test_device_event_queue_overflow() {
+    use iolinke_test_utils::sync_device::SyncTestDevice;
+    use iolinke_types::handlers::event::{EventEntry, EventQualifier};
+
+    let mut sync_device = SyncTestDevice::new();
+    let device = sync_device.device_mut();
+    let event_entry = EventEntry::new(EventQualifier::from_bits(0xF4), 0x5110);
+    // The Event handler is not activated in Startup, so nothing is drained
+    for _ in 0..8 {
+        assert!(device.al_event_push_req(&event_entry));
+    }
+    assert!(!device.al_event_push_req(&event_entry));
+    assert_eq!(device.al_event_overflow_count(), 1);
+}
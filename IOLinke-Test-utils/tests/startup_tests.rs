@@ -146,3 +146,46 @@ fn test_vendor_id_2() {
     const CONFIG_VENDOR_ID_2: u8 = derived_config::vendor_specifics::VENDOR_ID[1];
     assert_eq!(CONFIG_VENDOR_ID_2, vendor_id_2, "VendorID2 is not matching");
 }
+
+/// Test page reads are answered within the poll burst following the last received
+/// byte, in Startup and PreOperate no Process Data keeps the Data Link Layer scheduled
+#[test]
+fn test_page_read_answered_in_poll_burst() {
+    let mut device = iolinke_test_utils::SyncTestDevice::new();
+    let min_cycle_time_address = direct_parameter_address!(MinCycleTime);
+    let startup_read = iolinke_test_utils::create_startup_read_request(min_cycle_time_address);
+    assert!(
+        device.transfer_in_poll_burst(&startup_read).is_some(),
+        "Startup page read not answered in the poll burst"
+    );
+
+    let [master_ident, device_pre_operate, ..] =
+        iolinke_test_utils::frame_utils::startup_to_operate_requests();
+    assert!(device.transfer(&master_ident).is_some());
+    assert!(device.transfer(&device_pre_operate).is_some());
+    let preop_read = iolinke_test_utils::create_preop_read_request(min_cycle_time_address);
+    assert!(
+        device.transfer_in_poll_burst(&preop_read).is_some(),
+        "PreOperate page read not answered in the poll burst"
+    );
+}
+
+/// Test page reads of RevisionID and DeviceID1 to DeviceID3 report the values the
+/// master wrote, the page image answering them follows the writes
+#[test]
+fn test_page_read_after_write() {
+    let mut device = iolinke_test_utils::SyncTestDevice::new();
+    let written = [
+        (direct_parameter_address!(RevisionID), 0x10),
+        (direct_parameter_address!(DeviceID1), 0xA1),
+        (direct_parameter_address!(DeviceID2), 0xA2),
+        (direct_parameter_address!(DeviceID3), 0xA3),
+    ];
+    for (address, value) in written {
+        let write = iolinke_test_utils::frame_utils::create_startup_write_request(address, value);
+        assert!(device.transfer(&write).is_some(), "Write of 0x{address:02X} not answered");
+        let read = iolinke_test_utils::create_startup_read_request(address);
+        let response = device.transfer(&read).expect("Page read not answered");
+        assert_eq!(response[0], value, "Page read of 0x{address:02X} is stale");
+    }
+}
@@ -0,0 +1,89 @@
+#![cfg(feature = "timer_service")]
+
+use iolinke_device::{Timer, TimerHardware, TimerService};
+
+use std::cell::Cell;
+
+/// Counter and compare channel driven by the test
+#[derive(Default)]
+struct TestTimer {
+    now_us: Cell<u32>,
+    compare_us: Cell<Option<u32>>,
+    compare_writes: Cell<u32>,
+}
+
+impl TimerHardware for &TestTimer {
+    fn now_us(&self) -> u32 {
+        self.now_us.get()
+    }
+
+    fn set_compare(&self, deadline_us: u32) {
+        self.compare_us.set(Some(deadline_us));
+        self.compare_writes.set(self.compare_writes.get() + 1);
+    }
+
+    fn disable_compare(&self) {
+        self.compare_us.set(None);
+    }
+}
+
+/// Test the timers of two ports elapse in order on one compare channel, over the
+/// wrap around of the counter
+#[test]
+fn test_timer_service_multiplexes_ports() {
+    let hardware = TestTimer::default();
+    hardware.now_us.set(u32::MAX - 50);
+    let timer_service: TimerService<&TestTimer, 2> = TimerService::new(&hardware);
+
+    assert!(timer_service.start(0, Timer::MaxCycleTime, 100));
+    assert!(timer_service.start(1, Timer::MaxUARTframeTime, 20));
+    assert!(
+        !timer_service.start(2, Timer::Tdsio, 20),
+        "Port out of range"
+    );
+    assert_eq!(hardware.compare_us.get(), Some(u32::MAX - 30));
+
+    // Restarting with a later deadline does not reprogram the compare channel
+    let compare_writes = hardware.compare_writes.get();
+    hardware.now_us.set(u32::MAX - 40);
+    for _ in 0..10 {
+        timer_service.start(1, Timer::MaxUARTframeTime, 20);
+    }
+    assert_eq!(hardware.compare_writes.get(), compare_writes);
+
+    // The compare fires at the old deadline, nothing elapsed yet
+    let mut elapsed = Vec::new();
+    hardware.now_us.set(u32::MAX - 30);
+    timer_service.on_compare(|port, timer| elapsed.push((port, timer)));
+    assert!(elapsed.is_empty());
+    assert_eq!(hardware.compare_us.get(), Some(u32::MAX - 20));
+
+    hardware.now_us.set(u32::MAX - 20);
+    timer_service.on_compare(|port, timer| elapsed.push((port, timer)));
+    assert_eq!(elapsed, [(1, Timer::MaxUARTframeTime)]);
+    assert_eq!(hardware.compare_us.get(), Some(49));
+
+    hardware.now_us.set(49);
+    timer_service.on_compare(|port, timer| elapsed.push((port, timer)));
+    assert_eq!(
+        elapsed,
+        [(1, Timer::MaxUARTframeTime), (0, Timer::MaxCycleTime)]
+    );
+    assert_eq!(hardware.compare_us.get(), None);
+}
+
+/// Test a stopped timer does not elapse
+#[test]
+fn test_timer_service_stop() {
+    let hardware = TestTimer::default();
+    let timer_service: TimerService<&TestTimer, 1> = TimerService::new(&hardware);
+
+    timer_service.start(0, Timer::Tdsio, 10);
+    assert!(timer_service.is_running(0, Timer::Tdsio));
+    timer_service.stop(0, Timer::Tdsio);
+    assert!(!timer_service.is_running(0, Timer::Tdsio));
+
+    hardware.now_us.set(10);
+    timer_service.on_compare(|_, _| panic!("Stopped timer elapsed"));
+    assert_eq!(hardware.compare_us.get(), None);
+}
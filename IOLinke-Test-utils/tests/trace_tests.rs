@@ -0,0 +1,69 @@
+#![cfg(feature = "trace")]
+
+use iolinke_device::trace::{self, TRACE_REJECTED, TRACE_RING_LENGTH, TraceRecord};
+use iolinke_test_utils;
+
+/// Test a record decodes with the symbol table of its state machine
+#[test]
+fn test_trace_decode() {
+    let module = trace::TRACE_MODULES
+        .iter()
+        .find(|module| module.path.ends_with("::system_management"))
+        .expect("System Management is traced");
+    let state = |name| {
+        module
+            .states
+            .iter()
+            .position(|state| *state == name)
+            .unwrap() as u8
+    };
+    let record = TraceRecord {
+        timestamp: 42,
+        module: module.id,
+        event: module.events.len() as u8 - 1,
+        source_state: state("Idle"),
+        target_state: state("ComStartup"),
+    };
+    let entry = trace::decode(&record).expect("Record of this firmware");
+    assert_eq!(entry.source_state, "Idle");
+    assert_eq!(entry.target_state, Some("ComStartup"));
+    assert_eq!(
+        entry.to_string(),
+        format!(
+            "[42] [{}] [Idle] [ComStartup] [{}]",
+            module.path, entry.event
+        )
+    );
+
+    let rejected = TraceRecord {
+        target_state: TRACE_REJECTED,
+        ..record
+    };
+    assert_eq!(trace::decode(&rejected).unwrap().target_state, None);
+    let unknown = TraceRecord {
+        event: u8::MAX,
+        ..record
+    };
+    assert_eq!(trace::decode(&unknown), None);
+}
+
+/// Test the transitions of a startup are recorded and decode
+#[test]
+fn test_trace_records_startup() {
+    let (poll_tx, poll_response_rx) = iolinke_test_utils::setup_test_environment();
+    let result = iolinke_test_utils::util_test_startup_sequence(&poll_tx, &poll_response_rx);
+    assert!(result.is_ok(), "Test startup sequence failed");
+
+    // Only this test runs a device in this test binary, no other device writes to the
+    // shared ring
+    let mut records = [TraceRecord::default(); TRACE_RING_LENGTH];
+    let count = trace::dump(&mut records);
+    assert!(count > 0, "No transition recorded");
+    assert!(
+        records[..count]
+            .iter()
+            .filter_map(trace::decode)
+            .any(|entry| entry.target_state.is_some()),
+        "No record in the symbol table"
+    );
+}
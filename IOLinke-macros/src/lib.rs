@@ -1421,6 +1421,16 @@ fn extract_u8_value(expr: &syn::Expr) -> Result<u8> {
 /// Macro for declaring parameter storage with validation and access control
 ///
 /// Creates memory space and helper functions for parameter access with:
+/// - A static parameter table sorted by index and subindex, a lookup is one binary search
+/// - All values packed into one contiguous `[u8; PARAMETER_ARENA_SIZE]` arena, laid out
+///   in table order, reads are borrowed slices of the arena
+/// - The Data Storage parameter set (all `ReadWrite` parameters of Direct Parameter
+///   Page 2 and of index 0x0010 and above) with its Index_List and Data_Storage_Size
+///   precomputed at expansion time
+/// - A dirty bit per parameter and a Parameter_Checksum of the Data Storage parameter
+///   set, both updated by every write which changes a value
+/// - An unsaved bit per persistent parameter (all `ReadWrite` parameters except Direct
+///   Parameter Page 1 and DS_Command) for a non-volatile memory journal
 /// - Index range: 0-65535
 /// - Subindex range: 0-255
 /// - Configurable value length, range, access rights and type
@@ -1428,11 +1438,15 @@ fn extract_u8_value(expr: &syn::Expr) -> Result<u8> {
 ///
 /// Panics if:
 /// - Default value is not a slice
-/// - Default value is not the same length as the length
+/// - Default value is longer than the length
 /// - Default value is not the same type as the data type
 /// - Default value is not the same range as the range
 /// - Default value is not the same access as the access
 /// - Default value is not the same type as the data type
+/// - The same index and subindex is declared more than once
+/// - The Index_List (index 0x0003, subindex 0x05) is too short for the Data Storage
+///   parameter set, or Data_Storage_Size / Parameter_Checksum (subindexes 0x03 / 0x04)
+///   are not 4 octets long
 ///
 /// # Example
 /// ```
@@ -1462,12 +1476,25 @@ fn extract_u8_value(expr: &syn::Expr) -> Result<u8> {
 /// // Get parameter info
 /// let info = storage.get_parameter_info(0x0001, 0x00);
 ///
+/// // Get parameter info and value together
+/// let (info, value) = storage.lookup(0x0001, 0x00)?;
+///
 /// // Read all parameters for an index
 /// let all = storage.read_index_memory(0x0001);
 ///
+/// // Borrow all parameters for an index from the arena
+/// let all = storage.read_index_slice(0x0001);
+///
+/// // The whole arena, e.g. for Data Storage upload or flash persistence
+/// let image: &[u8; PARAMETER_ARENA_SIZE] = storage.arena();
+///
 /// // Write all parameters for an index
 /// let write_result = storage.write_index_memory(0x0001, &[1]);
 ///
+/// // Data Storage parameters changed since the last Data Storage upload or download
+/// let changed = storage.is_data_storage_dirty();
+/// let checksum = storage.parameter_checksum();
+///
 /// // Validate constraints
 /// let valid = storage.validate_constraints();
 /// ```
@@ -1484,11 +1511,7 @@ pub fn declare_parameter_storage(input: TokenStream) -> TokenStream {
     //     );
     // }
 
-    let mut storage_fields = Vec::new();
-    let mut new_fields = Vec::new();
-    let mut parameter_map = Vec::new();
-    let mut get_match_arms = Vec::new();
-    let mut set_match_arms = Vec::new();
+    let mut declarations = Vec::new();
 
     let max_parameter_length = params
         .iter()
@@ -1615,26 +1638,7 @@ pub fn declare_parameter_storage(input: TokenStream) -> TokenStream {
         // Note: Length can be larger than minimum required bytes for storage purposes
         // We only validate that it's not too small
 
-        // Generate field identifier
-        let field_ident = syn::Ident::new(
-            &format!("index_{:04X}_sub_{:02x}", index_val, subindex_val),
-            proc_macro2::Span::call_site(),
-        );
-
-        // eprintln!("Generated field: {}", field_ident);
-
-        // Generate storage field
-        storage_fields.push(quote! {
-            #[doc = "Parameter storage field"]
-            pub #field_ident: heapless::Vec<u8, { #length_val as usize }>,
-        });
-
-        // Generate default value for new()
-        new_fields.push(quote! {
-            #field_ident: heapless::Vec::<u8, { #length_val as usize }>::from_slice(#default_value).unwrap(),
-        });
-
-        // Generate parameter map entry
+        // Generate parameter table entry
         let access_right = match access.to_string().as_str() {
             "ReadOnly" => quote! { AccessRight::ReadOnly },
             "WriteOnly" => quote! { AccessRight::WriteOnly },
@@ -1642,32 +1646,183 @@ pub fn declare_parameter_storage(input: TokenStream) -> TokenStream {
             _ => panic!("Invalid access right: {}", access),
         };
 
+        // Writable parameters of Direct Parameter Page 2 and of the indices from 0x0010 on
+        // form the Data Storage parameter set, see IO-Link v1.1.4 Section 10.4.2
+        let data_storage = access == "ReadWrite" && (index_val == 0x0001 || index_val >= 0x0010);
+        // Writable parameters survive a power cycle, except the runtime values of Direct
+        // Parameter Page 1 and the DS_Command
+        let persistent = access == "ReadWrite"
+            && index_val != 0x0000
+            && (index_val, subindex_val) != (0x0003, 0x01);
+
+        declarations.push((
+            (index_val, subindex_val),
+            length_val,
+            range.clone(),
+            access_right,
+            data_type.clone(),
+            default_value.clone(),
+            data_storage,
+            persistent,
+        ));
+    }
+
+    // The parameter table is sorted by (index, subindex), so a lookup is a binary search.
+    // The values are packed into the arena in the same order, so all subindexes of an
+    // index are one contiguous range of the arena.
+    declarations.sort_by_key(|(key, ..)| *key);
+    if let Some(pair) = declarations.windows(2).find(|pair| pair[0].0 == pair[1].0) {
+        let (index_val, subindex_val) = pair[0].0;
+        let error_msg = format!(
+            "Parameter index 0x{:04X} subindex 0x{:02X} is declared more than once",
+            index_val, subindex_val
+        );
+        return quote! {
+            compile_error!(#error_msg);
+        }
+        .into();
+    }
+    let parameter_count = declarations.len();
+
+    let mut parameter_map = Vec::new();
+    let mut default_values = Vec::new();
+    let mut offset = 0usize;
+    // Data Storage parameter set: table positions, Index_List entries and size
+    let mut data_storage_positions = Vec::new();
+    let mut index_list = Vec::new();
+    let mut data_storage_size = 0usize;
+    // Arena offset and length of the Data Storage index subindexes filled at expansion time
+    let mut index_list_slot = None;
+    let mut data_storage_size_slot = None;
+    let mut checksum_slot = None;
+    // Total length of all subindexes of the current and of the longest index, the
+    // declarations are sorted so the subindexes of an index are adjacent
+    let mut index_length = (None, 0usize);
+    let mut max_index_length = 0usize;
+
+    for (
+        position,
+        (
+            (index_val, subindex_val),
+            length_val,
+            range,
+            access_right,
+            data_type,
+            default_value,
+            data_storage,
+            persistent,
+        ),
+    ) in declarations.into_iter().enumerate()
+    {
         parameter_map.push(quote! {
             ParameterInfo {
                 index: #index_val,
                 subindex: #subindex_val,
+                offset: #offset,
                 length: #length_val as usize,
                 range: Some(#range),
                 access: #access_right,
                 data_type: stringify!(#data_type),
+                data_storage: #data_storage,
+                persistent: #persistent,
             }
         });
 
-        // Generate get match arm
-        get_match_arms.push(quote! {
-            (#index, #subindex) => {
-                (self.#field_ident.len() as u8, self.#field_ident.as_slice())
-            },
+        if data_storage {
+            data_storage_positions.push(position);
+            index_list.extend_from_slice(&index_val.to_be_bytes());
+            index_list.push(subindex_val);
+            data_storage_size += length_val as usize;
+        }
+        match (index_val, subindex_val) {
+            (0x0003, 0x03) => data_storage_size_slot = Some((offset, length_val as usize)),
+            (0x0003, 0x04) => checksum_slot = Some((offset, length_val as usize)),
+            (0x0003, 0x05) => index_list_slot = Some((offset, length_val as usize)),
+            _ => {}
+        }
+
+        // Copy the default value into the arena image, checked at compile time
+        let error_msg = format!(
+            "Default value of index 0x{:04X} subindex 0x{:02X} is longer than its length {}",
+            index_val, subindex_val, length_val
+        );
+        default_values.push(quote! {
+            let default_value: &[u8] = #default_value;
+            assert!(default_value.len() <= #length_val as usize, #error_msg);
+            let mut i = 0;
+            while i < default_value.len() {
+                arena[#offset + i] = default_value[i];
+                i += 1;
+            }
         });
 
-        // Generate set match arm
-        set_match_arms.push(quote! {
-            (#index, #subindex) => {
-                self.#field_ident.copy_from_slice(data);
-                Ok(())
-            },
+        if index_length.0 != Some(index_val) {
+            index_length = (Some(index_val), 0);
+        }
+        index_length.1 += length_val as usize;
+        max_index_length = max_index_length.max(index_length.1);
+
+        offset += length_val as usize;
+    }
+    let arena_size = offset;
+
+    // The Index_List ends with the termination entry index 0x0000, see IO-Link v1.1.4 Table B.11
+    index_list.extend_from_slice(&[0x00, 0x00, 0x00]);
+    let index_list_length = index_list.len();
+    let data_storage_count = data_storage_positions.len();
+    let dirty_words = parameter_count.div_ceil(32);
+
+    let mut data_storage_defaults = Vec::new();
+    if let Some((slot_offset, slot_length)) = index_list_slot {
+        if index_list_length > slot_length {
+            let error_msg = format!(
+                "Index_List of {} octets for {} Data Storage parameters does not fit into the {} octets of index 0x0003 subindex 0x05",
+                index_list_length, data_storage_count, slot_length
+            );
+            return quote! {
+                compile_error!(#error_msg);
+            }
+            .into();
+        }
+        data_storage_defaults.push(quote! {
+            let mut i = 0;
+            while i < DATA_STORAGE_INDEX_LIST.len() {
+                arena[#slot_offset + i] = DATA_STORAGE_INDEX_LIST[i];
+                i += 1;
+            }
         });
     }
+    for (slot, name) in [
+        (data_storage_size_slot, "Data_Storage_Size"),
+        (checksum_slot, "Parameter_Checksum"),
+    ] {
+        if let Some((_, slot_length)) = slot
+            && slot_length != 4
+        {
+            let error_msg = format!(
+                "{} (index 0x0003) must be 4 octets long, got {}",
+                name, slot_length
+            );
+            return quote! {
+                compile_error!(#error_msg);
+            }
+            .into();
+        }
+    }
+    if let Some((slot_offset, _)) = data_storage_size_slot {
+        data_storage_defaults.push(quote! {
+            let size = (DATA_STORAGE_SIZE as u32).to_be_bytes();
+            let mut i = 0;
+            while i < size.len() {
+                arena[#slot_offset + i] = size[i];
+                i += 1;
+            }
+        });
+    }
+    let checksum_offset = match checksum_slot {
+        Some((slot_offset, _)) => quote! { Some(#slot_offset) },
+        None => quote! { None },
+    };
 
     // eprintln!(
     //     "Generated {} storage fields, {} parameter map entries",
@@ -1738,16 +1893,21 @@ pub fn declare_parameter_storage(input: TokenStream) -> TokenStream {
         ///
         /// This structure provides information about a parameter, including:
         /// - `index` and `subindex`: The parameter's address.
+        /// - `offset`: The position of the parameter value in the storage arena.
         /// - `length`: The length in bytes of the parameter value.
         /// - `range`: An optional valid value range for the parameter.
         /// - `access`: The access rights for the parameter.
         /// - `data_type`: The name of the parameter's data type.
+        /// - `data_storage`: Whether the parameter is part of the Data Storage parameter set.
+        /// - `persistent`: Whether the parameter is kept in non-volatile memory.
         #[derive(Debug, Clone)]
         pub struct ParameterInfo {
             /// The parameter's index address.
             pub index: u16,
             /// The parameter's subindex address.
             pub subindex: u8,
+            /// The position of the parameter value in the storage arena.
+            pub offset: usize,
             /// The length in bytes of the parameter value.
             pub length: usize,
             /// An optional valid value range for the parameter.
@@ -1756,45 +1916,191 @@ pub fn declare_parameter_storage(input: TokenStream) -> TokenStream {
             pub access: AccessRight,
             /// The name of the parameter's data type.
             pub data_type: &'static str,
+            /// Whether the parameter is part of the Data Storage parameter set.
+            pub data_storage: bool,
+            /// Whether the parameter is kept in non-volatile memory.
+            pub persistent: bool,
         }
 
+        /// Size in bytes of the parameter storage arena, the sum of all parameter lengths.
+        pub const PARAMETER_ARENA_SIZE: usize = #arena_size;
+
+        /// Number of parameters in the parameter table.
+        pub const PARAMETER_COUNT: usize = #parameter_count;
+
+        /// Length in bytes of the longest parameter.
+        pub const MAX_PARAMETER_LENGTH: usize = #max_parameter_length;
+
+        /// Length in bytes of the longest index, the sum of the lengths of its subindexes.
+        pub const MAX_INDEX_LENGTH: usize = #max_index_length;
+
+        /// Size in bytes of the Data Storage parameter set (Data_Storage_Size).
+        pub const DATA_STORAGE_SIZE: usize = #data_storage_size;
+
+        /// Index_List of the Data Storage parameter set, an index (big endian) and a
+        /// subindex per parameter followed by the termination entry index 0x0000.
+        ///
+        /// The Index_List parameter (index 0x0003, subindex 0x05) defaults to this list.
+        pub const DATA_STORAGE_INDEX_LIST: [u8; #index_list_length] = [#(#index_list),*];
+
+        /// Metadata of all parameters, sorted by index and subindex.
+        static PARAMETER_TABLE: [ParameterInfo; PARAMETER_COUNT] = [
+            #(#parameter_map),*
+        ];
+
+        /// Positions in `PARAMETER_TABLE` of the Data Storage parameter set.
+        static DATA_STORAGE_POSITIONS: [usize; #data_storage_count] = [#(#data_storage_positions),*];
+
+        /// Number of words of the dirty bitmap, one bit per parameter.
+        const DIRTY_WORDS: usize = #dirty_words;
+
+        /// Arena offset of the Parameter_Checksum (index 0x0003, subindex 0x04), if declared.
+        const PARAMETER_CHECKSUM_OFFSET: Option<usize> = #checksum_offset;
+
+        /// Arena image with the default value of every parameter.
+        ///
+        /// A default value shorter than its parameter is padded with zeros. The Data
+        /// Storage index holds the precomputed Index_List, Data_Storage_Size and the
+        /// Parameter_Checksum of the default values.
+        const PARAMETER_DEFAULTS: [u8; PARAMETER_ARENA_SIZE] = {
+            let mut arena = [0u8; PARAMETER_ARENA_SIZE];
+            #({ #default_values })*
+            #({ #data_storage_defaults })*
+            if let Some(checksum_offset) = PARAMETER_CHECKSUM_OFFSET {
+                let checksum = parameter_checksum_of(&arena).to_be_bytes();
+                let mut i = 0;
+                while i < checksum.len() {
+                    arena[checksum_offset + i] = checksum[i];
+                    i += 1;
+                }
+            }
+            arena
+        };
+
+        /// Parameter_Checksum of the default values.
+        const PARAMETER_DEFAULTS_CHECKSUM: u32 = parameter_checksum_of(&PARAMETER_DEFAULTS);
+
+        /// Updates the Parameter_Checksum for the octet at arena `offset` changing from
+        /// `old` to `new`.
+        ///
+        /// The checksum is a Fletcher-32 style pair of a sum of the octets (low word) and
+        /// a sum of the octets weighted with their arena offset (high word), so it detects
+        /// changed as well as swapped values and is updated per written octet.
+        const fn update_parameter_checksum(checksum: u32, offset: usize, old: u8, new: u8) -> u32 {
+            let weight = (offset as u16).wrapping_add(1);
+            let sum = (checksum as u16).wrapping_sub(old as u16).wrapping_add(new as u16);
+            let weighted_sum = ((checksum >> 16) as u16)
+                .wrapping_sub((old as u16).wrapping_mul(weight))
+                .wrapping_add((new as u16).wrapping_mul(weight));
+            ((weighted_sum as u32) << 16) | sum as u32
+        }
+
+        /// Computes the Parameter_Checksum of the Data Storage parameter set of `arena`.
+        const fn parameter_checksum_of(arena: &[u8; PARAMETER_ARENA_SIZE]) -> u32 {
+            let mut checksum = 0;
+            let mut i = 0;
+            while i < DATA_STORAGE_POSITIONS.len() {
+                let info = &PARAMETER_TABLE[DATA_STORAGE_POSITIONS[i]];
+                let mut offset = info.offset;
+                while offset < info.offset + info.length {
+                    checksum = update_parameter_checksum(checksum, offset, 0, arena[offset]);
+                    offset += 1;
+                }
+                i += 1;
+            }
+            checksum
+        }
+
+        /// Dirty bitmap with the bits of the Data Storage parameter set set.
+        const DATA_STORAGE_DIRTY_MASK: [u32; DIRTY_WORDS] = {
+            let mut mask = [0u32; DIRTY_WORDS];
+            let mut i = 0;
+            while i < DATA_STORAGE_POSITIONS.len() {
+                let position = DATA_STORAGE_POSITIONS[i];
+                mask[position / 32] |= 1 << (position % 32);
+                i += 1;
+            }
+            mask
+        };
+
+        /// Unsaved bitmap with the bits of the persistent parameters set.
+        const PERSISTENT_MASK: [u32; DIRTY_WORDS] = {
+            let mut mask = [0u32; DIRTY_WORDS];
+            let mut position = 0;
+            while position < PARAMETER_COUNT {
+                if PARAMETER_TABLE[position].persistent {
+                    mask[position / 32] |= 1 << (position % 32);
+                }
+                position += 1;
+            }
+            mask
+        };
+
         /// Storage structure for all parameters.
         ///
-        /// This struct contains a field for each parameter, as generated by the macro.
-        /// Each field holds the value of a parameter, typically as a fixed-size buffer.
-        #[allow(missing_docs)]
+        /// All parameter values are packed into one contiguous arena in the order of
+        /// `PARAMETER_TABLE`, every value lives at `ParameterInfo::offset`. The subindexes
+        /// of an index are adjacent, so an index is one slice of the arena.
+        /// The arena is also the unit to upload to Data Storage or persist in flash.
+        ///
+        /// Every write which changes a value sets the dirty bit of the parameter and, for
+        /// the Data Storage parameter set, updates the Parameter_Checksum octet by octet,
+        /// so neither has to be recomputed over the whole set.
         pub struct ParameterStorage {
-            #(#storage_fields)*
+            arena: [u8; PARAMETER_ARENA_SIZE],
+            /// One bit per parameter, in the order of `PARAMETER_TABLE`
+            dirty: [u32; DIRTY_WORDS],
+            /// Parameter_Checksum of the Data Storage parameter set
+            checksum: u32,
+            /// One bit per parameter, set while a persistent value is not yet saved
+            unsaved: [u32; DIRTY_WORDS],
         }
 
         impl ParameterStorage {
             /// Creates a new parameter storage instance with all parameters set to their default values.
+            ///
+            /// The Data Storage parameter set starts dirty, it was not yet exchanged with
+            /// the Master.
             pub fn new() -> Self {
                 Self {
-                    #(#new_fields)*
+                    arena: PARAMETER_DEFAULTS,
+                    dirty: DATA_STORAGE_DIRTY_MASK,
+                    checksum: PARAMETER_DEFAULTS_CHECKSUM,
+                    unsaved: [0; DIRTY_WORDS],
                 }
             }
 
-            /// Resets all parameters to their default values.
+            /// Resets all parameters to their default values, e.g. for a
+            /// RestoreFactorySettings.
+            ///
+            /// The Data Storage parameter set is dirty again afterwards and every persistent
+            /// parameter is unsaved, so the defaults replace the saved values as well.
             pub fn clear(&mut self) {
                 *self = Self::new();
+                self.unsaved = PERSISTENT_MASK;
             }
 
             /// Retrieves the metadata information for a parameter by index and subindex.
             ///
             /// Returns `Ok(ParameterInfo)` if the parameter exists, or an appropriate `ParameterError`.
             pub fn get_parameter_info(&self, index: u16, subindex: u8) -> Result<ParameterInfo, ParameterError> {
-                let param_infos = [
-                    #(#parameter_map),*
-                ];
+                Self::find(index, subindex)
+                    .map(|position| &PARAMETER_TABLE[position])
+                    .cloned()
+            }
 
-                for info in &param_infos {
-                    if info.index == index && info.subindex == subindex {
-                        return Ok(info.clone());
-                    }
-                }
+            /// Checks whether `index` has at least one subindex in the parameter storage.
+            pub fn contains_index(&self, index: u16) -> bool {
+                Self::index_positions(index).is_ok()
+            }
 
-                Err(ParameterError::IndexNotAvailable)
+            /// Looks up a parameter by index and subindex.
+            ///
+            /// Returns the metadata and the current value of the parameter together,
+            /// with one binary search of the static parameter table.
+            pub fn lookup<'a>(&'a self, index: u16, subindex: u8) -> Result<(&'static ParameterInfo, &'a [u8]), ParameterError> {
+                let info = &PARAMETER_TABLE[Self::find(index, subindex)?];
+                Ok((info, &self.arena[info.offset..info.offset + info.length]))
             }
 
             /// Reads the value of a parameter as a byte slice.
@@ -1802,19 +2108,14 @@ pub fn declare_parameter_storage(input: TokenStream) -> TokenStream {
             /// Returns a reference to the parameter's value if it exists and is readable,
             /// or an appropriate `ParameterError`.
             pub fn get_parameter<'a>(&'a self, index: u16, subindex: u8) -> Result<(u8, &'a [u8]), ParameterError> {
-                let info = self.get_parameter_info(index, subindex)?;
+                let (info, field_data) = self.lookup(index, subindex)?;
 
                 if !matches!(info.access, AccessRight::ReadOnly | AccessRight::ReadWrite) {
                     return Err(ParameterError::AccessDenied);
                 }
 
-                // Get the data based on index and subindex
-                let (length, field_data): (u8, &[u8]) = match (index, subindex) {
-                    #(#get_match_arms)*
-                    _ => return Err(ParameterError::IndexNotAvailable),
-                };
                 // Return the field data as bytes
-                Ok((length, field_data))
+                Ok((field_data.len() as u8, field_data))
             }
 
             /// Writes a value to a parameter.
@@ -1822,7 +2123,8 @@ pub fn declare_parameter_storage(input: TokenStream) -> TokenStream {
             /// The provided data must match the parameter's length and access rights.
             /// Returns `Ok(())` on success, or an appropriate `ParameterError`.
             pub fn set_parameter(&mut self, index: u16, subindex: u8, data: &[u8]) -> Result<(), ParameterError> {
-                let info = self.get_parameter_info(index, subindex)?;
+                let position = Self::find(index, subindex)?;
+                let info = &PARAMETER_TABLE[position];
 
                 if !matches!(info.access, AccessRight::WriteOnly | AccessRight::ReadWrite) {
                     return Err(ParameterError::AccessDenied);
@@ -1834,98 +2136,227 @@ pub fn declare_parameter_storage(input: TokenStream) -> TokenStream {
                     return Err(ParameterError::LengthUnderrun);
                 }
 
-                // Set the data based on index and subindex
-                match (index, subindex) {
-                    #(#set_match_arms)*
-                    _ => return Err(ParameterError::IndexNotAvailable),
+                self.write_value(position, data);
+                Ok(())
+            }
+
+            /// Reads the concatenated values of all subindexes for a given index.
+            ///
+            /// Returns a slice of the arena with the values of all subindexes,
+            /// or an appropriate `ParameterError` if any of them is not readable.
+            pub fn read_index_slice(&self, index: u16) -> Result<&[u8], ParameterError> {
+                let infos = &PARAMETER_TABLE[Self::index_positions(index)?];
+                if infos
+                    .iter()
+                    .any(|info| !matches!(info.access, AccessRight::ReadOnly | AccessRight::ReadWrite))
+                {
+                    return Err(ParameterError::AccessDenied);
                 }
+                Ok(&self.arena[Self::index_range(infos)])
             }
 
             /// Reads the concatenated values of all subindexes for a given index.
             ///
             /// Returns a buffer containing the values of all readable subindexes,
             /// or an appropriate `ParameterError`.
-            pub fn read_index_memory(&self, index: u16) -> Result<heapless::Vec<u8, #max_parameter_length>, ParameterError> {
-                let mut memory = heapless::Vec::new();
-
-                // Find all subindexes for this index
-                let param_infos = [
-                    #(#parameter_map),*
-                ];
-
-                let mut found = false;
-                for info in &param_infos {
-                    if info.index == index {
-                        found = true;
-                        if !matches!(info.access, AccessRight::ReadOnly | AccessRight::ReadWrite) {
-                            return Err(ParameterError::AccessDenied);
-                        }
+            pub fn read_index_memory(&self, index: u16) -> Result<heapless::Vec<u8, MAX_INDEX_LENGTH>, ParameterError> {
+                heapless::Vec::from_slice(self.read_index_slice(index)?)
+                    .map_err(|_| ParameterError::LengthOverrun)
+            }
 
-                        // Get the parameter data
-                        let (_, data) = self.get_parameter(index, info.subindex)?;
-                        memory.extend_from_slice(&data).map_err(|_| ParameterError::LengthOverrun)?;
-                    }
+            /// Writes values to all subindexes of a given index in one operation.
+            ///
+            /// The provided data must match the total length of all writable subindexes.
+            /// Returns `Ok(())` on success, or an appropriate `ParameterError`.
+            pub fn write_index_memory(&mut self, index: u16, data: &[u8]) -> Result<(), ParameterError> {
+                let positions = Self::index_positions(index)?;
+                let infos = &PARAMETER_TABLE[positions.clone()];
+                if infos
+                    .iter()
+                    .any(|info| !matches!(info.access, AccessRight::WriteOnly | AccessRight::ReadWrite))
+                {
+                    return Err(ParameterError::AccessDenied);
                 }
 
-                if !found {
-                    return Err(ParameterError::IndexNotAvailable);
+                let range = Self::index_range(infos);
+                if data.len() != range.len() {
+                    return Err(ParameterError::LengthOverrun);
                 }
 
-                Ok(memory)
+                for position in positions {
+                    let info = &PARAMETER_TABLE[position];
+                    let start = info.offset - range.start;
+                    self.write_value(position, &data[start..start + info.length]);
+                }
+                Ok(())
             }
 
-            /// Writes values to all subindexes of a given index in one operation.
+            /// Returns the arena with the values of all parameters.
             ///
-            /// The provided data must match the total length of all writable subindexes.
-            /// Returns `Ok(())` on success, or an appropriate `ParameterError`.
-            pub fn write_index_memory(&mut self, index: u16, data: &[u8]) -> Result<(), ParameterError> {
-                let param_infos = [
-                    #(#parameter_map),*
-                ];
-
-                let mut found = false;
-                let mut total_length = 0;
-
-                // Calculate total length needed
-                for info in &param_infos {
-                    if info.index == index {
-                        found = true;
-                        if !matches!(info.access, AccessRight::WriteOnly | AccessRight::ReadWrite) {
-                            return Err(ParameterError::AccessDenied);
-                        }
-                        total_length += info.length;
-                    }
+            /// The layout is given by `ParameterInfo::offset` of `get_all_parameters`.
+            pub fn arena(&self) -> &[u8; PARAMETER_ARENA_SIZE] {
+                &self.arena
+            }
+
+            /// Replaces the arena, e.g. to restore it from flash.
+            ///
+            /// Access rights and ranges are not checked. The Parameter_Checksum is
+            /// recomputed, the dirty and unsaved bits are kept.
+            pub fn load_arena(&mut self, arena: &[u8; PARAMETER_ARENA_SIZE]) {
+                self.arena = *arena;
+                self.checksum = parameter_checksum_of(&self.arena);
+                self.write_checksum();
+            }
+
+            /// Returns the Parameter_Checksum of the Data Storage parameter set.
+            pub fn parameter_checksum(&self) -> u32 {
+                self.checksum
+            }
+
+            /// Returns `true` if the value of a Data Storage parameter changed since the
+            /// last [`ParameterStorage::clear_dirty`].
+            pub fn is_data_storage_dirty(&self) -> bool {
+                self.dirty
+                    .iter()
+                    .zip(DATA_STORAGE_DIRTY_MASK.iter())
+                    .any(|(dirty, mask)| dirty & mask != 0)
+            }
+
+            /// Returns the parameters whose value changed since the last
+            /// [`ParameterStorage::clear_dirty`].
+            pub fn dirty_parameters(&self) -> impl Iterator<Item = &'static ParameterInfo> + '_ {
+                PARAMETER_TABLE
+                    .iter()
+                    .enumerate()
+                    .filter(|(position, _)| self.dirty[position / 32] & (1 << (position % 32)) != 0)
+                    .map(|(_, info)| info)
+            }
+
+            /// Clears all dirty bits, e.g. when the Data Storage parameter set was
+            /// uploaded to or downloaded from the Master.
+            pub fn clear_dirty(&mut self) {
+                self.dirty = [0; DIRTY_WORDS];
+            }
+
+            /// Returns the first persistent parameter whose value is not yet saved,
+            /// together with its value.
+            pub fn next_unsaved(&self) -> Option<(&'static ParameterInfo, &[u8])> {
+                let position = (0..PARAMETER_COUNT)
+                    .find(|position| self.unsaved[position / 32] & (1 << (position % 32)) != 0)?;
+                let info = &PARAMETER_TABLE[position];
+                Some((info, &self.arena[info.offset..info.offset + info.length]))
+            }
+
+            /// Returns `true` if the value of a persistent parameter is not yet saved.
+            pub fn has_unsaved(&self) -> bool {
+                self.unsaved.iter().any(|word| *word != 0)
+            }
+
+            /// Clears the unsaved bit of a parameter once its current value is saved.
+            pub fn mark_saved(&mut self, index: u16, subindex: u8) {
+                if let Ok(position) = Self::find(index, subindex) {
+                    self.unsaved[position / 32] &= !(1 << (position % 32));
                 }
+            }
 
-                if !found {
-                    return Err(ParameterError::IndexNotAvailable);
+            /// Sets the unsaved bit of a persistent parameter again, e.g. when saving its
+            /// value failed.
+            pub fn mark_unsaved(&mut self, index: u16, subindex: u8) {
+                if let Ok(position) = Self::find(index, subindex)
+                    && PARAMETER_TABLE[position].persistent
+                {
+                    self.unsaved[position / 32] |= 1 << (position % 32);
                 }
+            }
 
-                if data.len() != total_length {
+            /// Restores the saved value of a parameter, e.g. from a non-volatile journal.
+            ///
+            /// Access rights are not checked and neither the dirty nor the unsaved bit is
+            /// set, the value is what the non-volatile memory holds already.
+            pub fn restore_parameter(&mut self, index: u16, subindex: u8, data: &[u8]) -> Result<(), ParameterError> {
+                let position = Self::find(index, subindex)?;
+                if data.len() != PARAMETER_TABLE[position].length {
                     return Err(ParameterError::LengthOverrun);
                 }
+                self.store_value(position, data);
+                Ok(())
+            }
+
+            /// Writes the value of the parameter at `position` of `PARAMETER_TABLE`.
+            ///
+            /// Writing the value it already has does not set the dirty or unsaved bit.
+            fn write_value(&mut self, position: usize, data: &[u8]) {
+                if !self.store_value(position, data) {
+                    return;
+                }
+                self.dirty[position / 32] |= 1 << (position % 32);
+                if PARAMETER_TABLE[position].persistent {
+                    self.unsaved[position / 32] |= 1 << (position % 32);
+                }
+            }
 
-                // Write data to each subindex
-                let mut offset = 0;
-                for info in &param_infos {
-                    if info.index == index {
-                        let subindex_data = &data[offset..offset + info.length];
-                        self.set_parameter(index, info.subindex, subindex_data)?;
-                        offset += info.length;
+            /// Stores the value of the parameter at `position` of `PARAMETER_TABLE` and keeps
+            /// the Parameter_Checksum up to date, returns `false` if the value is unchanged.
+            fn store_value(&mut self, position: usize, data: &[u8]) -> bool {
+                let info = &PARAMETER_TABLE[position];
+                let value = &mut self.arena[info.offset..info.offset + info.length];
+                if *value == *data {
+                    return false;
+                }
+                if info.data_storage {
+                    for (i, (old, new)) in value.iter().zip(data.iter()).enumerate() {
+                        self.checksum =
+                            update_parameter_checksum(self.checksum, info.offset + i, *old, *new);
                     }
                 }
+                value.copy_from_slice(data);
+                if info.data_storage {
+                    self.write_checksum();
+                }
+                true
+            }
 
-                Ok(())
+            /// Writes the cached checksum into the Parameter_Checksum parameter
+            fn write_checksum(&mut self) {
+                if let Some(offset) = PARAMETER_CHECKSUM_OFFSET {
+                    self.arena[offset..offset + 4].copy_from_slice(&self.checksum.to_be_bytes());
+                }
             }
 
-            /// Returns a static slice of all parameter metadata.
+            /// Returns a static slice of all parameter metadata, sorted by index and subindex.
             ///
             /// This can be used for introspection, diagnostics, or documentation.
             pub fn get_all_parameters(&self) -> &'static [ParameterInfo] {
-                static PARAM_INFOS: &[ParameterInfo] = &[
-                    #(#parameter_map),*
-                ];
-                PARAM_INFOS
+                &PARAMETER_TABLE
+            }
+
+            /// Returns the position of a parameter in [`Self::get_all_parameters`].
+            pub fn position(&self, index: u16, subindex: u8) -> Result<usize, ParameterError> {
+                Self::find(index, subindex)
+            }
+
+            /// Returns the position of a parameter in `PARAMETER_TABLE`, found by binary search
+            fn find(index: u16, subindex: u8) -> Result<usize, ParameterError> {
+                PARAMETER_TABLE
+                    .binary_search_by(|info| (info.index, info.subindex).cmp(&(index, subindex)))
+                    .map_err(|_| ParameterError::IndexNotAvailable)
+            }
+
+            /// Returns the positions of all subindexes of `index`, they are adjacent in `PARAMETER_TABLE`
+            fn index_positions(index: u16) -> Result<core::ops::Range<usize>, ParameterError> {
+                let start = PARAMETER_TABLE.partition_point(|info| info.index < index);
+                let end = PARAMETER_TABLE.partition_point(|info| info.index <= index);
+                if start == end {
+                    return Err(ParameterError::IndexNotAvailable);
+                }
+                Ok(start..end)
+            }
+
+            /// Returns the arena range of the adjacent parameters `infos`
+            fn index_range(infos: &[ParameterInfo]) -> core::ops::Range<usize> {
+                let start = infos[0].offset;
+                let last = &infos[infos.len() - 1];
+                start..last.offset + last.length
             }
 
             /// Validates parameter constraints for the storage.
@@ -2081,3 +2512,388 @@ pub fn bitfield_support(_attr: TokenStream, item: TokenStream) -> TokenStream {
 
     TokenStream::from(expanded)
 }
+
+/// Generates the typed codec of a Process Data layout (see IODD `ProcessDataIn` /
+/// `ProcessDataOut` `RecordItem`s).
+///
+/// Each field carries its `bit_offset` and optional `bit_length` (defaults to the width of
+/// its type). As in the IODD, bit offset 0 is the least significant bit of the last octet
+/// of the Process Data. The offsets are checked and turned into shifts and masks at compile
+/// time, so `pack` and `unpack` are straight-line code without branches or loops.
+///
+/// Supported field types are `bool`, `u8`, `u16`, `u32`, `i8`, `i16`, `i32` and `f32`.
+/// Integer fields may be narrower than their type, signed fields are sign extended and
+/// values are truncated to `bit_length` by `pack`.
+///
+/// # Example
+///
+/// ```ignore
+/// #[process_data_layout(length = 3)]
+/// #[repr(C)]
+/// #[derive(Debug, Clone, Copy, Default, PartialEq)]
+/// pub struct PdIn {
+///     #[pd_field(bit_offset = 0)]
+///     pub alarm: bool,
+///     #[pd_field(bit_offset = 4, bit_length = 4)]
+///     pub level: u8,
+///     #[pd_field(bit_offset = 8)]
+///     pub temperature: i16,
+/// }
+///
+/// let mut pd = [0u8; PdIn::LENGTH];
+/// PdIn { alarm: true, level: 5, temperature: -2 }.pack(&mut pd);
+/// assert_eq!(pd, [0xFF, 0xFE, 0x51]);
+/// assert_eq!(PdIn::TEMPERATURE_BIT_OFFSET, 8);
+/// ```
+#[proc_macro_attribute]
+pub fn process_data_layout(attr: TokenStream, item: TokenStream) -> TokenStream {
+    let mut input = parse_macro_input!(item as syn::ItemStruct);
+    let mut length: Option<syn::LitInt> = None;
+    let attr_parser = syn::meta::parser(|meta| {
+        if meta.path.is_ident("length") {
+            length = Some(meta.value()?.parse()?);
+            Ok(())
+        } else {
+            Err(meta.error("expected `length = <octets>`"))
+        }
+    });
+    parse_macro_input!(attr with attr_parser);
+
+    match expand_process_data_layout(&mut input, length) {
+        Ok(expanded) => expanded.into(),
+        Err(error) => error.to_compile_error().into(),
+    }
+}
+
+/// Value representation of a Process Data field
+#[derive(Clone, Copy)]
+enum PdFieldKind {
+    Bool,
+    Unsigned,
+    Signed,
+    Float,
+}
+
+/// One Process Data field with its position, offsets in bits
+struct PdField {
+    ident: syn::Ident,
+    ty: Type,
+    kind: PdFieldKind,
+    bit_offset: u16,
+    bit_length: u16,
+}
+
+fn expand_process_data_layout(
+    input: &mut syn::ItemStruct,
+    length: Option<syn::LitInt>,
+) -> Result<proc_macro2::TokenStream> {
+    let length_lit = length.ok_or_else(|| {
+        syn::Error::new(
+            input.ident.span(),
+            "missing Process Data length, use `#[process_data_layout(length = <octets>)]`",
+        )
+    })?;
+    let length = length_lit.base10_parse::<usize>()?;
+    if length > 32 {
+        return Err(syn::Error::new(
+            length_lit.span(),
+            "Process Data length must be 0-32 octets (IO-Link Table B.6)",
+        ));
+    }
+    if !input.generics.params.is_empty() {
+        return Err(syn::Error::new_spanned(
+            &input.generics,
+            "Process Data layouts cannot be generic",
+        ));
+    }
+    let syn::Fields::Named(named_fields) = &mut input.fields else {
+        return Err(syn::Error::new_spanned(
+            &input.ident,
+            "Process Data layouts need named fields",
+        ));
+    };
+
+    let total_bits = (length * 8) as u16;
+    let mut used_bits = vec![None::<syn::Ident>; total_bits as usize];
+    let mut fields = Vec::new();
+    for field in named_fields.named.iter_mut() {
+        let ident = field.ident.clone().expect("named field");
+        let position = field
+            .attrs
+            .iter()
+            .position(|attr| attr.path().is_ident("pd_field"))
+            .ok_or_else(|| {
+                syn::Error::new_spanned(&ident, "missing `#[pd_field(bit_offset = ..)]`")
+            })?;
+        let pd_attr = field.attrs.remove(position);
+
+        let (kind, width) = pd_field_kind(&field.ty)?;
+        let mut bit_offset: Option<u16> = None;
+        let mut bit_length: Option<u16> = None;
+        pd_attr.parse_nested_meta(|meta| {
+            let value: syn::LitInt = meta.value()?.parse()?;
+            if meta.path.is_ident("bit_offset") {
+                bit_offset = Some(value.base10_parse()?);
+            } else if meta.path.is_ident("bit_length") {
+                bit_length = Some(value.base10_parse()?);
+            } else {
+                return Err(meta.error("expected `bit_offset` or `bit_length`"));
+            }
+            Ok(())
+        })?;
+        let bit_offset =
+            bit_offset.ok_or_else(|| syn::Error::new_spanned(&pd_attr, "missing `bit_offset`"))?;
+        let bit_length = bit_length.unwrap_or(width);
+        let valid_length = match kind {
+            PdFieldKind::Bool => bit_length == 1,
+            PdFieldKind::Float => bit_length == 32,
+            PdFieldKind::Unsigned => (1..=width).contains(&bit_length),
+            PdFieldKind::Signed => (2..=width).contains(&bit_length),
+        };
+        if !valid_length {
+            return Err(syn::Error::new_spanned(
+                &pd_attr,
+                format!("`bit_length = {bit_length}` does not fit the type of `{ident}`"),
+            ));
+        }
+        if bit_offset as u32 + bit_length as u32 > total_bits as u32 {
+            return Err(syn::Error::new_spanned(
+                &pd_attr,
+                format!("`{ident}` exceeds the Process Data length of {length}"),
+            ));
+        }
+        for bit in bit_offset..bit_offset + bit_length {
+            if let Some(other) = &used_bits[bit as usize] {
+                return Err(syn::Error::new_spanned(
+                    &pd_attr,
+                    format!("`{ident}` overlaps `{other}` at bit {bit}"),
+                ));
+            }
+            used_bits[bit as usize] = Some(ident.clone());
+        }
+        fields.push(PdField {
+            ident,
+            ty: field.ty.clone(),
+            kind,
+            bit_offset,
+            bit_length,
+        });
+    }
+
+    // Field bits per octet: (field, shift of the raw value, octet mask)
+    let octet_parts = |octet: usize| -> Vec<(usize, i32, u8)> {
+        // Octet 0 is the most significant one, it holds the highest bits
+        let first_bit = ((length - 1 - octet) * 8) as u32;
+        fields
+            .iter()
+            .enumerate()
+            .filter_map(|(index, field)| {
+                let start = (field.bit_offset as u32).max(first_bit);
+                let end = (field.bit_offset as u32 + field.bit_length as u32).min(first_bit + 8);
+                (start < end).then(|| {
+                    let mask = (((1u32 << (end - start)) - 1) << (start - first_bit)) as u8;
+                    (index, first_bit as i32 - field.bit_offset as i32, mask)
+                })
+            })
+            .collect()
+    };
+    let raw_idents: Vec<syn::Ident> = fields
+        .iter()
+        .map(|field| quote::format_ident!("raw_{}", field.ident))
+        .collect();
+
+    let pack_raw = fields.iter().zip(&raw_idents).map(|(field, raw)| {
+        let ident = &field.ident;
+        match field.kind {
+            PdFieldKind::Float => quote! { let #raw = self.#ident.to_bits(); },
+            _ => quote! { let #raw = self.#ident as u32; },
+        }
+    });
+    let pack_octets = (0..length).map(|octet| {
+        let parts = octet_parts(octet).into_iter().map(|(index, shift, mask)| {
+            let raw = &raw_idents[index];
+            let shifted = match shift {
+                0 => quote! { #raw },
+                shift if shift > 0 => {
+                    let shift = shift as u32;
+                    quote! { (#raw >> #shift) }
+                }
+                shift => {
+                    let shift = -shift as u32;
+                    quote! { (#raw << #shift) }
+                }
+            };
+            quote! { (#shifted as u8 & #mask) }
+        });
+        let parts: Vec<_> = parts.collect();
+        if parts.is_empty() {
+            quote! { pd[#octet] = 0; }
+        } else {
+            quote! { pd[#octet] = #(#parts)|*; }
+        }
+    });
+
+    let unpack_fields = fields.iter().enumerate().map(|(index, field)| {
+        let ident = &field.ident;
+        let ty = &field.ty;
+        let parts: Vec<_> = (0..length)
+            .flat_map(|octet| {
+                octet_parts(octet)
+                    .into_iter()
+                    .filter(|(part_index, _, _)| *part_index == index)
+                    .map(move |(_, shift, mask)| {
+                        let octet_bits = quote! { ((pd[#octet] & #mask) as u32) };
+                        match shift {
+                            0 => octet_bits,
+                            shift if shift > 0 => {
+                                let shift = shift as u32;
+                                quote! { (#octet_bits << #shift) }
+                            }
+                            shift => {
+                                let shift = -shift as u32;
+                                quote! { (#octet_bits >> #shift) }
+                            }
+                        }
+                    })
+            })
+            .collect();
+        let raw = quote! { (#(#parts)|*) };
+        let value = match field.kind {
+            PdFieldKind::Bool => quote! { #raw != 0 },
+            PdFieldKind::Float => quote! { f32::from_bits(#raw) },
+            PdFieldKind::Unsigned => quote! { #raw as #ty },
+            PdFieldKind::Signed => {
+                let extend = 32 - field.bit_length as u32;
+                quote! { ((#raw << #extend) as i32 >> #extend) as #ty }
+            }
+        };
+        quote! { #ident: #value, }
+    });
+
+    let field_consts = fields.iter().map(|field| {
+        let name = field.ident.to_string().to_uppercase();
+        let offset_ident = quote::format_ident!("{}_BIT_OFFSET", name);
+        let length_ident = quote::format_ident!("{}_BIT_LENGTH", name);
+        let offset_doc = format!("Bit offset of `{}`", field.ident);
+        let length_doc = format!("Bit length of `{}`", field.ident);
+        let bit_offset = field.bit_offset;
+        let bit_length = field.bit_length;
+        quote! {
+            #[doc = #offset_doc]
+            pub const #offset_ident: u16 = #bit_offset;
+            #[doc = #length_doc]
+            pub const #length_ident: u16 = #bit_length;
+        }
+    });
+
+    let ident = &input.ident;
+    Ok(quote! {
+        #input
+
+        impl #ident {
+            /// Process Data length in octets
+            pub const LENGTH: usize = #length;
+
+            #(#field_consts)*
+
+            /// Writes the fields into the Process Data `pd`, all octets are written
+            #[inline]
+            pub const fn pack(&self, pd: &mut [u8; #length]) {
+                #(#pack_raw)*
+                #(#pack_octets)*
+            }
+
+            /// Reads the fields from the Process Data `pd`
+            #[inline]
+            pub const fn unpack(pd: &[u8; #length]) -> Self {
+                Self {
+                    #(#unpack_fields)*
+                }
+            }
+        }
+    })
+}
+
+/// Returns the representation and the bit width of a Process Data field type
+fn pd_field_kind(ty: &Type) -> Result<(PdFieldKind, u16)> {
+    let name = match ty {
+        Type::Path(path) if path.qself.is_none() => {
+            path.path.get_ident().map(|ident| ident.to_string())
+        }
+        _ => None,
+    };
+    match name.as_deref() {
+        Some("bool") => Ok((PdFieldKind::Bool, 1)),
+        Some("u8") => Ok((PdFieldKind::Unsigned, 8)),
+        Some("u16") => Ok((PdFieldKind::Unsigned, 16)),
+        Some("u32") => Ok((PdFieldKind::Unsigned, 32)),
+        Some("i8") => Ok((PdFieldKind::Signed, 8)),
+        Some("i16") => Ok((PdFieldKind::Signed, 16)),
+        Some("i32") => Ok((PdFieldKind::Signed, 32)),
+        Some("f32") => Ok((PdFieldKind::Float, 32)),
+        _ => Err(syn::Error::new_spanned(
+            ty,
+            "Process Data fields must be bool, u8, u16, u32, i8, i16, i32 or f32",
+        )),
+    }
+}
+
+/// Derives `iolinke_util::trace::TraceId` for a state or event enum.
+///
+/// The variants are numbered in declaration order and their names become the symbol
+/// table used to decode the binary trace. Variants may carry fields, only the variant
+/// is recorded. At most 255 variants are supported, `0xFF` marks a rejected event.
+///
+/// # Example
+///
+/// ```ignore
+/// #[derive(Debug, Clone, Copy, PartialEq, Eq, TraceId)]
+/// enum Event {
+///     Start,
+///     Data(u8),
+/// }
+///
+/// assert_eq!(Event::Data(7).trace_id(), 1);
+/// assert_eq!(Event::TRACE_NAMES, &["Start", "Data"]);
+/// ```
+#[proc_macro_derive(TraceId)]
+pub fn trace_id(input: TokenStream) -> TokenStream {
+    let input = parse_macro_input!(input as ItemEnum);
+    let enum_ident = &input.ident;
+
+    if input.variants.len() >= u8::MAX as usize {
+        return syn::Error::new_spanned(enum_ident, "TraceId supports at most 255 variants")
+            .to_compile_error()
+            .into();
+    }
+
+    let names = input
+        .variants
+        .iter()
+        .map(|variant| variant.ident.to_string());
+    let arms = input.variants.iter().enumerate().map(|(index, variant)| {
+        let ident = &variant.ident;
+        let index = index as u8;
+        let pattern = match &variant.fields {
+            syn::Fields::Unit => quote! { Self::#ident },
+            syn::Fields::Unnamed(_) => quote! { Self::#ident(..) },
+            syn::Fields::Named(_) => quote! { Self::#ident { .. } },
+        };
+        quote! { #pattern => #index, }
+    });
+    let (impl_generics, ty_generics, where_clause) = input.generics.split_for_impl();
+
+    let expanded = quote! {
+        impl #impl_generics ::iolinke_util::trace::TraceId for #enum_ident #ty_generics #where_clause {
+            const TRACE_NAMES: &'static [&'static str] = &[#(#names),*];
+
+            #[inline]
+            fn trace_id(&self) -> u8 {
+                match self {
+                    #(#arms)*
+                }
+            }
+        }
+    };
+    expanded.into()
+}
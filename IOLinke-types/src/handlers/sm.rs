@@ -325,7 +325,7 @@ impl Default for DeviceMode {
 ///
 /// - IO-Link v1.1.4 Annex B.1: Direct Parameter Page 1
 /// - Section B.1.1: Communication Parameters
-#[derive(Clone, Debug)]
+#[derive(Clone, Copy, Debug)]
 pub struct DeviceCom {
     /// Supported SIO mode configuration
     pub suppported_sio_mode: SioMode,
@@ -0,0 +1,153 @@
+//! Lock-free double buffer (ping-pong) for Process Data snapshots.
+//!
+//! One side (the writer) fills the back slot and commits it, the other side (the reader)
+//! always sees the last committed slot. Writer and reader never touch the same slot, so
+//! every snapshot is consistent without disabling interrupts.
+//!
+//! The synchronisation only uses atomic loads and stores, which are available on every
+//! target including ARMv6-M (Cortex-M0+) that has no compare-and-swap instructions.
+//!
+//! # Example
+//!
+//! ```rust
+//! use iolinke_util::double_buffer::DoubleBuffer;
+//!
+//! let pd_in: DoubleBuffer<2> = DoubleBuffer::new();
+//! if let Some(slot) = pd_in.acquire() {
+//!     unsafe { (*slot) = [0x12, 0x34] };
+//!     pd_in.commit();
+//! }
+//! pd_in.read(|pd| assert_eq!(pd, &[0x12, 0x34]));
+//! ```
+
+use core::cell::UnsafeCell;
+use core::ops::FnOnce;
+use core::option::{
+    Option,
+    Option::{None, Some},
+};
+use core::sync::atomic::{AtomicU8, Ordering};
+
+/// Value of `reading` while the reader does not hold a slot
+const NOT_READING: u8 = 0xFF;
+
+/// Lock-free single writer / single reader double buffer
+///
+/// - The writer calls [`DoubleBuffer::acquire`], fills the returned slot and calls
+///   [`DoubleBuffer::commit`] to publish it.
+/// - The reader calls [`DoubleBuffer::read`] (or the split [`DoubleBuffer::read_begin`] /
+///   [`DoubleBuffer::read_end`] pair) to access the last committed slot.
+///
+/// `acquire` fails only if the reader is still holding the slot which would be handed
+/// to the writer, i.e. a snapshot is being read while two commits happened.
+pub struct DoubleBuffer<const N: usize> {
+    slots: [UnsafeCell<[u8; N]>; 2],
+    /// Slot that was committed last, written only by the writer
+    front: AtomicU8,
+    /// Slot held by the reader or `NOT_READING`, written only by the reader
+    reading: AtomicU8,
+}
+
+impl<const N: usize> DoubleBuffer<N> {
+    /// Creates a new zero filled double buffer
+    pub const fn new() -> Self {
+        Self {
+            slots: [UnsafeCell::new([0; N]), UnsafeCell::new([0; N])],
+            front: AtomicU8::new(0),
+            reading: AtomicU8::new(NOT_READING),
+        }
+    }
+
+    /// Returns the back slot to the writer.
+    ///
+    /// # Returns
+    /// - `Some(slot)` pointer to the slot that will be published by the next `commit`.
+    /// - `None` if the reader still holds that slot, try again later.
+    ///
+    /// The slot must only be written until [`DoubleBuffer::commit`] is called.
+    pub fn acquire(&self) -> Option<*mut [u8; N]> {
+        let back = self.front.load(Ordering::SeqCst) ^ 0x01;
+        if self.reading.load(Ordering::SeqCst) == back {
+            return None;
+        }
+        Some(self.slots[back as usize].get())
+    }
+
+    /// Publishes the slot returned by the last [`DoubleBuffer::acquire`] to the reader
+    pub fn commit(&self) {
+        let back = self.front.load(Ordering::Relaxed) ^ 0x01;
+        self.front.store(back, Ordering::SeqCst);
+    }
+
+    /// Copies `data` into the back slot and publishes it. Missing bytes are zero filled.
+    ///
+    /// # Returns
+    /// - `true` if the data was published.
+    /// - `false` if the back slot is held by the reader.
+    pub fn write(&self, data: &[u8]) -> bool {
+        let Some(slot) = self.acquire() else {
+            return false;
+        };
+        // SAFETY: The back slot is owned by the writer until it is committed.
+        let slot = unsafe { &mut *slot };
+        let length = data.len().min(N);
+        slot[..length].copy_from_slice(&data[..length]);
+        slot[length..].fill(0);
+        self.commit();
+        true
+    }
+
+    /// Marks the last committed slot as held by the reader and returns it.
+    ///
+    /// The slot stays valid and unchanged until [`DoubleBuffer::read_end`] is called.
+    pub fn read_begin(&self) -> *const [u8; N] {
+        let mut front = self.front.load(Ordering::SeqCst);
+        loop {
+            self.reading.store(front, Ordering::SeqCst);
+            // A commit between the load and the store may have handed this slot back
+            // to the writer, so check it is still the front slot.
+            let current = self.front.load(Ordering::SeqCst);
+            if current == front {
+                return self.slots[front as usize].get();
+            }
+            front = current;
+        }
+    }
+
+    /// Releases the slot returned by [`DoubleBuffer::read_begin`]
+    pub fn read_end(&self) {
+        self.reading.store(NOT_READING, Ordering::SeqCst);
+    }
+
+    /// Calls `f` with the last committed slot, only to be called by the writer.
+    ///
+    /// Only the writer changes the slots, so its last committed slot stays unchanged
+    /// while the writer reads it. Unlike [`DoubleBuffer::read`] the slot held by the
+    /// reader is left marked as held.
+    pub fn read_committed<R, F: FnOnce(&[u8; N]) -> R>(&self, f: F) -> R {
+        let front = self.front.load(Ordering::Relaxed);
+        // SAFETY: The front slot is only written after a later `acquire` of the writer,
+        // which is the caller.
+        f(unsafe { &*self.slots[front as usize].get() })
+    }
+
+    /// Calls `f` with a consistent snapshot of the last committed slot
+    pub fn read<R, F: FnOnce(&[u8; N]) -> R>(&self, f: F) -> R {
+        // SAFETY: The slot is held by the reader until `read_end`, the writer never
+        // acquires a slot held by the reader.
+        let snapshot = unsafe { &*self.read_begin() };
+        let result = f(snapshot);
+        self.read_end();
+        result
+    }
+}
+
+impl<const N: usize> core::default::Default for DoubleBuffer<N> {
+    fn default() -> Self {
+        Self::new()
+    }
+}
+
+// SAFETY: Access to the slots is coordinated through `front` and `reading`, writer and
+// reader never access the same slot at the same time.
+unsafe impl<const N: usize> core::marker::Sync for DoubleBuffer<N> {}
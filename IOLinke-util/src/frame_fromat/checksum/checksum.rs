@@ -0,0 +1,146 @@
+//! # IO-Link Checksum Engine
+//!
+//! This module implements the checksum algorithms used by the IO-Link frame formats.
+//!
+//! ## Features
+//!
+//! - **M-sequence checksum (A.1.6):** The 8 bit XOR of all frame bytes seeded with `0x52`
+//!   and compressed to 6 bits. The seed and the 8-to-6 bit compression are folded into a
+//!   const generated 256 entry lookup table, so the compression costs one table access.
+//! - **ISDU checksum (CHKPDU, A.5.6):** The plain 8 bit XOR of all ISDU bytes.
+//! - **Word-at-a-time XOR fold:** Both checksums are built on an XOR fold that consumes
+//!   the data in 32 bit words and reduces the word to a byte in a final step.
+//! - **Incremental calculation:** [`MsequenceChecksum`] keeps the running XOR state, so the
+//!   checksum can be updated while the bytes of a frame are still arriving.
+//!
+//! ## References
+//!
+//! - IO-Link Specification v1.1.4, Annex A.1.6: Calculation of the checksum
+//! - IO-Link Specification v1.1.4, Annex A.5.6: Data integrity of the ISDU (CHKPDU)
+
+/// Seed value of the M-sequence checksum
+/// See A.1.6 Calculation of the checksum
+pub const M_SEQUENCE_CHECKSUM_SEED: u8 = 0x52;
+
+/// Lookup table mapping the unseeded 8 bit XOR of a frame to its 6 bit checksum.
+/// The seed `0x52` is already folded into every entry.
+const M_SEQUENCE_CHECKSUM_TABLE: [u8; 256] = generate_m_sequence_checksum_table();
+
+/// Generates the M-sequence checksum lookup table at compile time
+const fn generate_m_sequence_checksum_table() -> [u8; 256] {
+    let mut table = [0u8; 256];
+    let mut i = 0;
+    while i < 256 {
+        table[i] = compress_8_to_6_bits(i as u8 ^ M_SEQUENCE_CHECKSUM_SEED);
+        i += 1;
+    }
+    table
+}
+
+/// Compresses the 8 bit checksum to 6 bits
+/// See Figure A.18 – Principle of the checksum calculation
+const fn compress_8_to_6_bits(d: u8) -> u8 {
+    let c0 = bit(d, 1) ^ bit(d, 0);
+    let c1 = bit(d, 3) ^ bit(d, 2);
+    let c2 = bit(d, 5) ^ bit(d, 4);
+    let c3 = bit(d, 7) ^ bit(d, 6);
+    let c4 = bit(d, 6) ^ bit(d, 4) ^ bit(d, 2) ^ bit(d, 0);
+    let c5 = bit(d, 7) ^ bit(d, 5) ^ bit(d, 3) ^ bit(d, 1);
+    c0 | (c1 << 1) | (c2 << 2) | (c3 << 3) | (c4 << 4) | (c5 << 5)
+}
+
+/// Returns bit `n` of `d`
+const fn bit(d: u8, n: u8) -> u8 {
+    (d >> n) & 0x01
+}
+
+/// Reduces a 32 bit XOR accumulator to a single byte
+const fn fold_word(word: u32) -> u8 {
+    let word = word ^ (word >> 16);
+    (word ^ (word >> 8)) as u8
+}
+
+/// XORs all bytes of `data` together, 32 bit words at a time
+/// # Parameters
+/// - `data`: The bytes to fold.
+/// # Returns
+/// - The 8 bit XOR of all bytes in `data`.
+pub const fn xor_fold(data: &[u8]) -> u8 {
+    let words_end = data.len() & !0x03;
+    let mut word = 0u32;
+    let mut i = 0;
+    while i < words_end {
+        word ^= u32::from_ne_bytes([data[i], data[i + 1], data[i + 2], data[i + 3]]);
+        i += 4;
+    }
+    let mut acc = fold_word(word);
+    while i < data.len() {
+        acc ^= data[i];
+        i += 1;
+    }
+    acc
+}
+
+/// Limits `data` to its first `length` bytes, without going out of bounds
+const fn limit_to_length(length: usize, data: &[u8]) -> &[u8] {
+    if length < data.len() {
+        data.split_at(length).0
+    } else {
+        data
+    }
+}
+
+/// See A.1.6 Calculation of the checksum
+/// Calculate the 6 bit M-sequence checksum of the first `length` bytes of `data`.
+/// The checksum bits of the CKT/CKS byte must already be cleared in `data`.
+pub const fn calculate_m_sequence_checksum(length: usize, data: &[u8]) -> u8 {
+    M_SEQUENCE_CHECKSUM_TABLE[xor_fold(limit_to_length(length, data)) as usize]
+}
+
+/// See A.5.6 Data integrity
+/// Calculate the ISDU checksum (CHKPDU) of the first `length` bytes of `data`.
+pub const fn calculate_isdu_checksum(length: usize, data: &[u8]) -> u8 {
+    xor_fold(limit_to_length(length, data))
+}
+
+/// Incremental M-sequence checksum
+///
+/// Keeps the running (unseeded) XOR of all bytes seen so far. The seed and the
+/// 6 bit compression are applied only in [`MsequenceChecksum::finish`].
+#[derive(Debug, Clone, Copy, PartialEq, Eq, Default)]
+pub struct MsequenceChecksum {
+    state: u8,
+}
+
+impl MsequenceChecksum {
+    /// Creates a new checksum with no bytes accumulated
+    pub const fn new() -> Self {
+        Self { state: 0 }
+    }
+
+    /// Resets the checksum to its initial state
+    pub const fn reset(&mut self) {
+        self.state = 0;
+    }
+
+    /// Adds a single byte to the checksum
+    pub const fn update(&mut self, byte: u8) {
+        self.state ^= byte;
+    }
+
+    /// Adds a slice of bytes to the checksum
+    pub const fn update_slice(&mut self, data: &[u8]) {
+        self.state ^= xor_fold(data);
+    }
+
+    /// Replaces a byte already added to the checksum by a new value.
+    /// As the checksum is a plain XOR, the order of the bytes does not matter.
+    pub const fn replace(&mut self, old: u8, new: u8) {
+        self.state ^= old ^ new;
+    }
+
+    /// Returns the 6 bit checksum of all bytes accumulated so far
+    pub const fn finish(&self) -> u8 {
+        M_SEQUENCE_CHECKSUM_TABLE[self.state as usize]
+    }
+}
@@ -0,0 +1,6 @@
+//! This module provides the checksum engine shared by the M-sequence and ISDU frame formats.
+//!
+//! It re-exports all items from the `checksum` submodule, which contains the
+//! table driven M-sequence checksum and the word-at-a-time XOR fold.
+mod checksum;
+pub use checksum::*;
@@ -8,6 +8,8 @@
 //!
 //! - **Transmit Buffer (`TxIsduMessageBuffer`)**: Provides methods to compile various ISDU responses
 //!   (success, failure, busy, no service) and manage the transmission buffer.
+//! - **Segment Encoder (`IsduSegmentEncoder`)**: Produces an ISDU response one OD segment at a
+//!   time from an `IsduResponseSource`, without buffering the complete response.
 //! - **Receive Buffer (`RxIsduMessageBuffer`)**: Handles incoming ISDU requests, including parsing
 //!   service codes, extracting indices, subindices, and data, and validating checksums.
 //! - **Error Handling**: Defines comprehensive error types for buffer operations and parsing.
@@ -41,6 +43,8 @@ use iolinke_types::{
     handlers::isdu::MAX_ISDU_LENGTH,
 };
 
+use crate::frame_fromat::checksum;
+
 use core::option::{
     Option,
     Option::{None, Some},
@@ -262,6 +266,217 @@ impl IndexMut<usize> for TxIsduMessageBuffer {
     }
 }
 
+/// ISDU busy response, see Table A.14
+pub const ISDU_BUSY_RESPONSE: [u8; 1] = isdu_busy_rsp();
+
+/// ISDU "no service" response, see Table A.12 and Table A.14
+pub const ISDU_NO_SERVICE_RESPONSE: [u8; 1] = isdu_no_service_rsp();
+
+/// Source of the data octets of an ISDU read response.
+///
+/// The [`IsduSegmentEncoder`] pulls the data from the source segment by segment, so the
+/// data can stay where it is stored, e.g. in the parameter storage arena.
+pub trait IsduResponseSource {
+    /// Copies the data octets starting at `offset` into `out`.
+    ///
+    /// # Returns
+    /// - The number of octets copied, less than `out.len()` if the data ends early.
+    fn read_data(&self, offset: usize, out: &mut [u8]) -> usize;
+}
+
+impl IsduResponseSource for [u8] {
+    fn read_data(&self, offset: usize, out: &mut [u8]) -> usize {
+        let available = self.get(offset..).unwrap_or_default();
+        let length = out.len().min(available.len());
+        out[..length].copy_from_slice(&available[..length]);
+        length
+    }
+}
+
+/// Maximum number of fixed octets of an ISDU response (failure responses)
+const MAX_ISDU_PREFIX_LENGTH: usize = 4;
+
+/// Encoder producing an ISDU response one OD segment at a time.
+///
+/// Instead of building the whole response in a buffer, the encoder only keeps the fixed
+/// octets of the response (I-Service, extended length or the complete short responses)
+/// and a cursor. The data octets of a read response are taken from an
+/// [`IsduResponseSource`] when a segment is requested, and the checksum is accumulated
+/// while the segments are produced.
+#[derive(Clone, Debug, PartialEq, Eq)]
+pub struct IsduSegmentEncoder {
+    /// Fixed octets at the start of the response
+    prefix: [u8; MAX_ISDU_PREFIX_LENGTH],
+    prefix_length: u8,
+    /// Number of data octets taken from the source after the prefix
+    data_length: u8,
+    /// `true` if a checksum octet follows the data octets
+    has_checksum: bool,
+    /// Number of response octets produced so far
+    position: usize,
+    /// Checksum of the response octets produced so far
+    checksum: u8,
+    ready: bool,
+}
+
+impl IsduSegmentEncoder {
+    /// Creates a new encoder with no response
+    pub const fn new() -> Self {
+        Self {
+            prefix: [0; MAX_ISDU_PREFIX_LENGTH],
+            prefix_length: 0,
+            data_length: 0,
+            has_checksum: false,
+            position: 0,
+            checksum: 0,
+            ready: false,
+        }
+    }
+
+    /// Drops the current response
+    pub fn clear(&mut self) {
+        *self = Self::new();
+    }
+
+    /// Checks if a response is ready for transmission.
+    pub fn is_ready(&self) -> bool {
+        self.ready
+    }
+
+    /// Returns the length of the complete response.
+    pub fn len(&self) -> usize {
+        self.prefix_length as usize + self.data_length as usize + self.has_checksum as usize
+    }
+
+    /// Starts an ISDU read success response with `length` data octets.
+    ///
+    /// The data octets are taken from the source given to [`Self::encode_segment`].
+    pub fn start_read_success_response(&mut self, length: u8) -> IoLinkResult<()> {
+        if length as usize > MAX_ISDU_LENGTH - 3 {
+            return Err(IoLinkError::InvalidLength);
+        }
+        let mut i_service = IsduService::new();
+        i_service.set_i_service(IsduIServiceCode::ReadSuccess);
+        if (2..=15).contains(&(length + 2/* +2 for iservice and checksum */)) {
+            i_service.set_length(length + 2);
+            self.start(&[i_service.into_bits()], length, true);
+        } else {
+            i_service.set_length(IsduLengthCode::Extended.into());
+            // isdu service byte + Length byte + checksum byte
+            self.start(&[i_service.into_bits(), 3 + length], length, true);
+        }
+        Ok(())
+    }
+
+    /// Starts an ISDU write success response.
+    pub fn start_write_success_response(&mut self) {
+        const BUFFER: [u8; 3] = isdu_write_success_rsp();
+        self.start(&BUFFER, 0, false);
+    }
+
+    /// Starts an ISDU read failure response.
+    pub fn start_read_failure_response(&mut self, error_code: u8, additional_error_code: u8) {
+        let buffer =
+            isdu_failure_rsp(IsduIServiceCode::ReadFailure, error_code, additional_error_code);
+        self.start(&buffer, 0, false);
+    }
+
+    /// Starts an ISDU write failure response.
+    pub fn start_write_failure_response(&mut self, error_code: u8, additional_error_code: u8) {
+        let buffer =
+            isdu_failure_rsp(IsduIServiceCode::WriteFailure, error_code, additional_error_code);
+        self.start(&buffer, 0, false);
+    }
+
+    fn start(&mut self, prefix: &[u8], data_length: u8, has_checksum: bool) {
+        self.clear();
+        self.prefix[..prefix.len()].copy_from_slice(prefix);
+        self.prefix_length = prefix.len() as u8;
+        self.data_length = data_length;
+        self.has_checksum = has_checksum;
+        self.ready = true;
+    }
+
+    /// Writes the response octets starting at `offset` into `out`.
+    ///
+    /// Segments are expected in order, then every octet is produced exactly once.
+    /// A segment before the cursor (a repeated segment) restarts the checksum from the
+    /// first octet. Octets past the end of the response are set to 0.
+    ///
+    /// # Errors
+    /// - `IoLinkError::InvalidLength` if `offset` is past the end of the response or
+    ///   the source has less data than announced.
+    pub fn encode_segment<S: IsduResponseSource + ?Sized>(
+        &mut self,
+        source: &S,
+        offset: usize,
+        out: &mut [u8],
+    ) -> IoLinkResult<()> {
+        if offset >= self.len() {
+            return Err(IoLinkError::InvalidLength);
+        }
+        if out.is_empty() {
+            return Ok(());
+        }
+        if offset < self.position {
+            self.position = 0;
+            self.checksum = 0;
+        }
+        // Skip the octets up to `offset` through `out`, only to update the checksum
+        while self.position < offset {
+            let length = out.len().min(offset - self.position);
+            self.produce(source, &mut out[..length])?;
+        }
+        let written = self.produce(source, out)?;
+        out[written..].fill(0);
+        Ok(())
+    }
+
+    /// Produces the next octets of the response into `out`
+    ///
+    /// # Returns
+    /// - The number of octets produced, less than `out.len()` at the end of the response.
+    fn produce<S: IsduResponseSource + ?Sized>(
+        &mut self,
+        source: &S,
+        out: &mut [u8],
+    ) -> IoLinkResult<usize> {
+        let prefix_end = self.prefix_length as usize;
+        let data_end = prefix_end + self.data_length as usize;
+        let mut written = 0;
+        while written < out.len() && self.position < self.len() {
+            let remaining = &mut out[written..];
+            let length = if self.position < prefix_end {
+                let prefix = &self.prefix[self.position..prefix_end];
+                let length = remaining.len().min(prefix.len());
+                remaining[..length].copy_from_slice(&prefix[..length]);
+                length
+            } else if self.position < data_end {
+                let length = remaining.len().min(data_end - self.position);
+                let copied = source.read_data(self.position - prefix_end, &mut remaining[..length]);
+                if copied != length {
+                    return Err(IoLinkError::InvalidLength);
+                }
+                length
+            } else {
+                // Checksum octet, the checksum of all octets before it
+                remaining[0] = self.checksum;
+                1
+            };
+            self.checksum ^= checksum::xor_fold(&remaining[..length]);
+            self.position += length;
+            written += length;
+        }
+        Ok(written)
+    }
+}
+
+impl Default for IsduSegmentEncoder {
+    fn default() -> Self {
+        Self::new()
+    }
+}
+
 impl RxIsduMessageBuffer {
     /// Creates a new instance of the RxIsduMessageBuffer.
     pub fn new() -> Self {
@@ -481,6 +696,20 @@ const fn isdu_write_success_rsp() -> [u8; 3] {
     buffer
 }
 
+const fn isdu_failure_rsp(
+    i_service_code: IsduIServiceCode,
+    error_code: u8,
+    additional_error_code: u8,
+) -> [u8; 4] {
+    const FAILURE_RSP_LEN: u8 = 1 + 2 + 1; // iservice + error code + additional error code + checksum
+    let mut i_service = IsduService::new();
+    i_service.set_i_service(i_service_code);
+    i_service.set_length(FAILURE_RSP_LEN);
+    let mut buffer = [i_service.into_bits(), error_code, additional_error_code, 0];
+    buffer[3] = calculate_checksum(4, &buffer);
+    buffer
+}
+
 const fn isdu_busy_rsp() -> [u8; 1] {
     const BUSY_RSP_LEN: u8 = 1 + 0 + 0; // iservice + no data + no checksum
     let mut i_service = IsduService::new();
@@ -546,7 +775,11 @@ fn parse_write_request_with_index(
         return Err(IoLinkError::InvalidData);
     }
     let index = buffer[1];
-    Ok((i_service, index as u16, 0, &buffer[2..3 - length as usize]))
+    // I-Service, Index, Data and CHKPDU
+    let data = buffer
+        .get(2..length as usize - 1)
+        .ok_or(IoLinkError::InvalidLength)?;
+    Ok((i_service, index as u16, 0, data))
 }
 
 fn parse_write_request_with_index_subindex(
@@ -612,16 +845,7 @@ fn parse_write_request_with_index_index_subindex(
 }
 
 const fn calculate_checksum(length: usize, data: &[u8]) -> u8 {
-    let mut checkpdu = 0;
-    let mut i = 0;
-    while i < length {
-        // Avoid out-of-bounds access
-        if i < data.len() {
-            checkpdu ^= data[i];
-        }
-        i += 1;
-    }
-    checkpdu
+    checksum::calculate_isdu_checksum(length, data)
 }
 
 /// Calculates the checksum for testing purposes.
@@ -11,10 +11,14 @@
 //!   for IO-Link frames, using fixed-size heapless vectors.
 //! - **Object Dictionary (OD) and Process Data (PD):** Insertion and extraction of OD and PD data
 //!   according to the current device mode.
+//! - **Operate Mode Templates:** Operate mode responses are kept pre-built per read/write
+//!   direction, each cycle only patches the OD, PD and CKS octets and fixes up the checksum.
 //! - **Checksum Calculation and Validation:** Implements IO-Link v1.1.4 Annex A checksum algorithm
 //!   for frame integrity.
 //! - **Trait-based Mode Handling:** Traits for mode-specific buffer operations, enabling
 //!   compile-time enforcement of protocol rules.
+//! - **Per-mode Codecs:** [`FrameCodec`] selects the functions of a mode once, when the
+//!   mode changes, instead of matching the mode for every frame.
 //! - **Error Handling:** Rich error types for buffer operations, including invalid length, data,
 //!   checksum, and device mode errors.
 //! - **Timing Utilities:** Calculation of maximum UART frame transmission time based on baud rate.
@@ -35,14 +39,14 @@
 //! use iolinke_util::frame_format::message::*;
 //!
 //! let mut tx_buffer = TxMessageBuffer::<MAX_TX_FRAME_SIZE>::new();
-//! tx_buffer.insert_od(od_length, &od_data, DeviceOperationMode::Operate)?;
-//! tx_buffer.insert_pd(&pd_data, DeviceOperationMode::Operate)?;
-//! tx_buffer.compile_message_rsp(DeviceOperationMode::Operate, RwDirection::Read, true, PdStatus::Ok)?;
+//! let codec = FrameCodec::<MAX_RX_FRAME_SIZE, MAX_TX_FRAME_SIZE>::of(DeviceOperationMode::Operate);
+//! codec.insert_od(&mut tx_buffer, od_length, &od_data)?;
+//! codec.insert_pd(&mut tx_buffer, &pd_data)?;
+//! codec.compile_message_rsp(&mut tx_buffer, RwDirection::Read, true, PdStatus::Ok)?;
 //! let frame = tx_buffer.get_as_slice();
 //! ```
 //!
 
-use bitfields::bitfield;
 use heapless::Vec;
 use iolinke_derived_config::device as derived_config;
 use iolinke_types::{
@@ -53,13 +57,19 @@ use iolinke_types::{
     },
 };
 
+use crate::clear_checksum_bits_0_to_5;
+use crate::frame_fromat::checksum::{self, MsequenceChecksum};
+
 use core::convert::From;
 use core::default::Default;
+use core::option::{
+    Option,
+    Option::{None, Some},
+};
 use core::result::{
     Result,
     Result::{Err, Ok},
 };
-use core::stringify;
 
 /// Header size in any IO-Link frame
 pub const HEADER_SIZE_IN_FRAME: u8 = 2; // Header size is 2 bytes (MC and length)
@@ -71,6 +81,8 @@ pub const MAX_POSSIBLE_OD_LEN_IN_FRAME: u8 = derived_config::on_req_data::max_po
 pub const PD_IN_LENGTH: u8 = derived_config::process_data::pd_in::config_length_in_bytes();
 /// Maximum message buffer size for PD
 pub const PD_OUT_LENGTH: u8 = derived_config::process_data::pd_out::config_length_in_bytes();
+/// Index of the CKT byte in a Master message
+const CKT_INDEX: usize = 1;
 /// Maximum frame size for IO-Link messages
 pub const MAX_RX_FRAME_SIZE: usize =
     (MAX_POSSIBLE_OD_LEN_IN_FRAME + PD_OUT_LENGTH + HEADER_SIZE_IN_FRAME) as usize;
@@ -206,6 +218,125 @@ pub struct TxMessageBuffer<const BUFF_LEN: usize> {
     od_ready: bool,
     pd_ready: bool,
     tx_ready: bool,
+    /// Pre-built Operate mode responses, indexed by [`operate_template_index`]
+    operate_templates: [TxFrameTemplate<BUFF_LEN>; 2],
+    /// Operate mode response compiled for transmission, if any
+    operate_rsp: Option<RwDirection>,
+}
+
+/// Position of the OD, PD and CKS octets in a Device response message
+/// See A.1.2 M-sequence types and Figure A.2 – M-sequence TYPE_2_x
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+struct TxFrameLayout {
+    od_start: usize,
+    od_length: usize,
+    pd_start: usize,
+    pd_length: usize,
+    cks_index: usize,
+    frame_length: usize,
+}
+
+/// OD length of a Device response message in Operate mode
+const OPERATE_OD_LENGTH: usize = derived_config::on_req_data::operate::od_length() as usize;
+
+/// Device response to a read request in Operate mode: OD, PD and CKS
+const OPERATE_READ_RSP_LAYOUT: TxFrameLayout = TxFrameLayout {
+    od_start: 0,
+    od_length: OPERATE_OD_LENGTH,
+    pd_start: OPERATE_OD_LENGTH,
+    pd_length: PD_IN_LENGTH as usize,
+    cks_index: OPERATE_OD_LENGTH + PD_IN_LENGTH as usize,
+    frame_length: OPERATE_OD_LENGTH + PD_IN_LENGTH as usize + 1,
+};
+
+/// Device response to a write request in Operate mode: PD and CKS
+const OPERATE_WRITE_RSP_LAYOUT: TxFrameLayout = TxFrameLayout {
+    od_start: 0,
+    od_length: 0,
+    pd_start: 0,
+    pd_length: PD_IN_LENGTH as usize,
+    cks_index: PD_IN_LENGTH as usize,
+    frame_length: PD_IN_LENGTH as usize + 1,
+};
+
+/// Index of the Operate mode response template of the given direction
+const fn operate_template_index(rw_direction: RwDirection) -> usize {
+    match rw_direction {
+        RwDirection::Read => 0,
+        RwDirection::Write => 1,
+    }
+}
+
+/// Pre-built Device response message with a fixed layout
+///
+/// The frame and the checksum of the frame are kept across cycles. Updating the
+/// message only patches the changed octets and fixes up the checksum, the
+/// checksum over the whole frame is never recalculated.
+#[derive(Debug, Clone)]
+struct TxFrameTemplate<const BUFF_LEN: usize> {
+    frame: [u8; BUFF_LEN],
+    layout: TxFrameLayout,
+    /// Checksum of the frame with the checksum bits of the CKS octet cleared
+    checksum: MsequenceChecksum,
+}
+
+impl<const BUFF_LEN: usize> TxFrameTemplate<BUFF_LEN> {
+    /// Creates a zero filled template with the given layout
+    const fn new(layout: TxFrameLayout) -> Self {
+        Self {
+            frame: [0; BUFF_LEN],
+            layout,
+            checksum: MsequenceChecksum::new(),
+        }
+    }
+
+    /// Overwrites the octets starting at `offset`, keeping the checksum up to date
+    fn patch(&mut self, offset: usize, data: &[u8]) {
+        for (slot, &new) in self.frame[offset..offset + data.len()]
+            .iter_mut()
+            .zip(data.iter())
+        {
+            self.checksum.replace(*slot, new);
+            *slot = new;
+        }
+    }
+
+    /// Writes the OD octets, unused octets are filled with zeros
+    fn patch_od(&mut self, od: &[u8]) {
+        let od_length = od.len().min(self.layout.od_length);
+        self.patch(self.layout.od_start, &od[..od_length]);
+        let padding_start = self.layout.od_start + od_length;
+        let padding_end = self.layout.od_start + self.layout.od_length;
+        for index in padding_start..padding_end {
+            self.checksum.replace(self.frame[index], 0);
+            self.frame[index] = 0;
+        }
+    }
+
+    /// Writes the PD octets
+    fn patch_pd(&mut self, pd: &[u8]) {
+        self.patch(self.layout.pd_start, pd);
+    }
+
+    /// Writes the CKS octet with the event flag, PD status and the checksum of the frame
+    fn patch_cks(&mut self, event_flag: bool, pd_status: PdStatus) {
+        let index = self.layout.cks_index;
+        let mut cks = ChecksumStatus::new();
+        cks.set_event_flag(event_flag);
+        cks.set_pd_status(pd_status);
+        let cks_bits = cks.into_bits();
+        // The checksum bits of the CKS octet are not at the position of the CKT ones
+        let mut cleared_cks = ChecksumStatus::from_bits(self.frame[index]);
+        cleared_cks.set_checksum(0);
+        self.checksum.replace(cleared_cks.into_bits(), cks_bits);
+        cks.set_checksum(self.checksum.finish());
+        self.frame[index] = cks.into_bits();
+    }
+
+    /// Returns the frame as a slice
+    fn as_slice(&self) -> &[u8] {
+        &self.frame[..self.layout.frame_length]
+    }
 }
 
 /// Message buffer for receiving IO-Link messages
@@ -213,6 +344,10 @@ pub struct TxMessageBuffer<const BUFF_LEN: usize> {
 pub struct RxMessageBuffer<const BUFF_LEN: usize> {
     buffer: Vec<u8, BUFF_LEN>,
     length: usize,
+    /// Running checksum of the received bytes, CKT checksum bits cleared
+    checksum: MsequenceChecksum,
+    /// Checksum received in the CKT byte
+    received_checksum: u8,
 }
 
 impl<const BUFF_LEN: usize> TxMessageBuffer<BUFF_LEN> {
@@ -228,15 +363,22 @@ impl<const BUFF_LEN: usize> TxMessageBuffer<BUFF_LEN> {
             od_ready: false,
             pd_ready: false,
             tx_ready: false,
+            operate_templates: [
+                TxFrameTemplate::new(OPERATE_READ_RSP_LAYOUT),
+                TxFrameTemplate::new(OPERATE_WRITE_RSP_LAYOUT),
+            ],
+            operate_rsp: None,
         }
     }
 
     /// Clears the message buffer and resets its state.
+    /// The Operate mode templates are kept, they are patched by the next cycle.
     pub fn clear(&mut self) {
         self.length = 0;
         self.od_ready = false;
         self.pd_ready = false;
         self.tx_ready = false;
+        self.operate_rsp = None;
         self.buffer.clear();
         let _ = self.buffer.extend_from_slice(&[0; BUFF_LEN]);
     }
@@ -248,106 +390,13 @@ impl<const BUFF_LEN: usize> TxMessageBuffer<BUFF_LEN> {
 
     /// Returns the message buffer as a slice.
     pub fn get_as_slice(&self) -> &[u8] {
-        &self.buffer[0..self.length]
-    }
-
-    /// Inserts Object Dictionary (OD) data into the message buffer based on the device operation mode.
-    ///
-    /// # Parameters
-    /// - `od_length`: Length of the OD data to insert.
-    /// - `od`: Slice containing the OD data.
-    /// - `device_mode`: Current device operation mode.
-    ///
-    /// # Returns
-    /// - `Ok(())` if the operation is successful.
-    /// - `Err(MessageBufferError)` if an error occurs (e.g., invalid length or mode).
-    pub fn insert_od(
-        &mut self,
-        od_length: usize,
-        od: &[u8],
-        device_mode: DeviceOperationMode,
-    ) -> MessageBufferResult<()> {
-        match device_mode {
-            DeviceOperationMode::Startup => {
-                <Self as StartupTxMessageBuffer>::insert_od(self, od_length, od)
-            }
-            DeviceOperationMode::PreOperate => {
-                <Self as PreOperateTxMessageBuffer>::insert_od(self, od_length, od)
+        match self.operate_rsp {
+            Some(rw_direction) => {
+                self.operate_templates[operate_template_index(rw_direction)].as_slice()
             }
-            DeviceOperationMode::Operate => {
-                <Self as OperateTxMessageBuffer>::insert_od(self, od_length, od)
-            }
-        }
-    }
-
-    /// Inserts Process Data (PD) into the message buffer in Operate mode.
-    ///
-    /// # Parameters
-    /// - `pd`: Slice containing the PD data.
-    /// - `device_mode`: Current device operation mode.
-    ///
-    /// # Returns
-    /// - `Ok(())` if the operation is successful.
-    /// - `Err(MessageBufferError)` if an error occurs (e.g., invalid length or mode).
-    pub fn insert_pd(
-        &mut self,
-        pd: &[u8],
-        device_mode: DeviceOperationMode,
-    ) -> MessageBufferResult<()> {
-        match device_mode {
-            DeviceOperationMode::Operate => <Self as OperateTxMessageBuffer>::insert_pd(self, pd),
-            _ => Err(MessageBufferError::InvalidDeviceOperationMode),
+            None => &self.buffer[0..self.length],
         }
     }
-
-    /// Checks if the message buffer is ready for transmission based on the device operation mode.
-    pub fn is_ready(&self, device_mode: DeviceOperationMode) -> bool {
-        match device_mode {
-            DeviceOperationMode::Startup => self.od_ready,
-            DeviceOperationMode::PreOperate => self.od_ready,
-            DeviceOperationMode::Operate => self.od_ready && self.pd_ready,
-        }
-    }
-
-    /// Compile IO-Link message from buffer
-    /// See IO-Link v1.1.4 `Annex A` (normative)
-    /// Codings, timing constraints, and errors
-    /// A.1 General structure and encoding of M-sequences
-    pub fn compile_message_rsp(
-        &mut self,
-        operation_mode: DeviceOperationMode,
-        rw_req_dir: RwDirection,
-        event_flag: bool,
-        pd_status: PdStatus,
-    ) -> IoLinkResult<()> {
-        let _length = match (operation_mode, rw_req_dir) {
-            (DeviceOperationMode::Startup, RwDirection::Read) => {
-                <Self as StartupTxMessageBuffer>::compile_read_rsp(self, event_flag, pd_status)
-                    .map_err(|_| IoLinkError::InvalidParameter)?
-            }
-            (DeviceOperationMode::PreOperate, RwDirection::Read) => {
-                <Self as PreOperateTxMessageBuffer>::compile_read_rsp(self, event_flag, pd_status)
-                    .map_err(|_| IoLinkError::InvalidParameter)?
-            }
-            (DeviceOperationMode::Operate, RwDirection::Read) => {
-                <Self as OperateTxMessageBuffer>::compile_read_rsp(self, event_flag, pd_status)
-                    .map_err(|_| IoLinkError::InvalidParameter)?
-            }
-            (DeviceOperationMode::Startup, RwDirection::Write) => {
-                <Self as StartupTxMessageBuffer>::compile_write_rsp(self, event_flag, pd_status)
-                    .map_err(|_| IoLinkError::InvalidParameter)?
-            }
-            (DeviceOperationMode::PreOperate, RwDirection::Write) => {
-                <Self as PreOperateTxMessageBuffer>::compile_write_rsp(self, event_flag, pd_status)
-                    .map_err(|_| IoLinkError::InvalidParameter)?
-            }
-            (DeviceOperationMode::Operate, RwDirection::Write) => {
-                <Self as OperateTxMessageBuffer>::compile_write_rsp(self, event_flag, pd_status)
-                    .map_err(|_| IoLinkError::InvalidParameter)?
-            }
-        };
-        Ok(())
-    }
 }
 
 impl<const BUFF_LEN: usize> RxMessageBuffer<BUFF_LEN> {
@@ -360,12 +409,16 @@ impl<const BUFF_LEN: usize> RxMessageBuffer<BUFF_LEN> {
         Self {
             buffer: buffer,
             length: 0,
+            checksum: MsequenceChecksum::new(),
+            received_checksum: 0,
         }
     }
 
     /// Clears the message buffer and resets its state.
     pub fn clear(&mut self) {
         self.length = 0;
+        self.checksum.reset();
+        self.received_checksum = 0;
         self.buffer.clear();
         let _ = self.buffer.extend_from_slice(&[0; BUFF_LEN]);
     }
@@ -376,49 +429,69 @@ impl<const BUFF_LEN: usize> RxMessageBuffer<BUFF_LEN> {
     }
 
     /// Pushes a byte into the message buffer.
+    ///
+    /// The checksum of the frame is updated with every byte, so the frame is
+    /// already validated when its last byte is received. The checksum bits of
+    /// the CKT byte (second byte) are taken as received checksum and are
+    /// cleared before they are added to the running checksum (see A.1.6).
     pub fn push(&mut self, data: u8) -> MessageBufferResult<()> {
         if self.length + 1 > BUFF_LEN {
             return Err(MessageBufferError::InvalidLength);
         }
         self.buffer[self.length] = data;
+        if self.length == CKT_INDEX {
+            self.received_checksum = ChecksumMsequenceType::from(data).checksum();
+            self.checksum.update(clear_checksum_bits_0_to_5!(data));
+        } else {
+            self.checksum.update(data);
+        }
         self.length += 1;
         Ok(())
     }
 
-    /// Extracts the M-sequence control byte from the message buffer.
-    pub fn extract_mc(&self) -> MessageBufferResult<MsequenceControl> {
-        let mc = MsequenceControl::from(self.buffer[0]);
-        Ok(mc)
+    /// Appends a span of received bytes to the message buffer.
+    ///
+    /// Behaves like calling [`RxMessageBuffer::push`] for every byte of `data`,
+    /// but copies the span as a whole and updates the running checksum in one
+    /// pass. Bytes that do not fit into the buffer are dropped.
+    ///
+    /// # Returns
+    /// - `Ok(())` if all bytes were appended.
+    /// - `Err(MessageBufferError::InvalidLength)` if the buffer is full, the bytes
+    ///   that fit are appended.
+    pub fn push_slice(&mut self, data: &[u8]) -> MessageBufferResult<()> {
+        let count = data.len().min(BUFF_LEN - self.length);
+        let start = self.length;
+        let end = start + count;
+        let data_to_copy = &data[..count];
+        self.buffer[start..end].copy_from_slice(data_to_copy);
+        self.checksum.update_slice(data_to_copy);
+        if start <= CKT_INDEX && CKT_INDEX < end {
+            let ckt = data_to_copy[CKT_INDEX - start];
+            self.received_checksum = ChecksumMsequenceType::from(ckt).checksum();
+            // The CKT byte is part of the checksum with its checksum bits cleared
+            self.checksum.replace(ckt, clear_checksum_bits_0_to_5!(ckt));
+        }
+        self.length = end;
+        if count < data.len() {
+            return Err(MessageBufferError::InvalidLength);
+        }
+        Ok(())
     }
 
-    /// Validates the received request based on the device operation mode.
-    pub fn valid_req(
-        &mut self,
-        device_mode: DeviceOperationMode,
-    ) -> MessageBufferResult<RwDirection> {
-        match device_mode {
-            DeviceOperationMode::Startup => <Self as StartupRxMessageBuffer>::valid_req(self),
-            DeviceOperationMode::PreOperate => <Self as PreOperateRxMessageBuffer>::valid_req(self),
-            DeviceOperationMode::Operate => <Self as OperateRxMessageBuffer>::valid_req(self),
-        }
+    /// Checks the running checksum against the checksum received in the CKT byte.
+    ///
+    /// # Returns
+    /// - `true` if the checksum of all received bytes matches.
+    /// - `false` if the checksum is invalid or the CKT byte is not yet received.
+    pub fn is_checksum_valid(&self) -> bool {
+        self.length > CKT_INDEX && self.checksum.finish() == self.received_checksum
     }
 
-    /// Extracts Object Dictionary (OD) data from a write request based on the device operation mode.
-    pub fn extract_od_from_write_req(
-        &mut self,
-        device_mode: DeviceOperationMode,
-    ) -> MessageBufferResult<&[u8]> {
-        match device_mode {
-            DeviceOperationMode::Startup => {
-                <Self as StartupRxMessageBuffer>::extract_od_from_write_req(self)
-            }
-            DeviceOperationMode::PreOperate => {
-                <Self as PreOperateRxMessageBuffer>::extract_od_from_write_req(self)
-            }
-            DeviceOperationMode::Operate => {
-                <Self as OperateRxMessageBuffer>::extract_od_from_write_req(self)
-            }
-        }
+    /// Extracts the M-sequence control byte from the message buffer.
+    pub fn extract_mc(&self) -> MessageBufferResult<MsequenceControl> {
+        let mc = MsequenceControl::from(self.buffer[0]);
+        Ok(mc)
     }
 
     /// Extracts Process Data (PD) from the message buffer in Operate mode.
@@ -430,30 +503,6 @@ impl<const BUFF_LEN: usize> RxMessageBuffer<BUFF_LEN> {
         <Self as OperateRxMessageBuffer>::extract_pd(self)
     }
 
-    /// Calculates the expected number of bytes to receive based on the device operation mode.
-    pub fn calculate_expected_rx_bytes(&self, device_mode: DeviceOperationMode) -> u8 {
-        match device_mode {
-            DeviceOperationMode::Startup => {
-                match <Self as StartupRxMessageBuffer>::expected_bytes(self) {
-                    Ok(bytes) => bytes,
-                    Err(_) => HEADER_SIZE_IN_FRAME,
-                }
-            }
-            DeviceOperationMode::PreOperate => {
-                match <Self as PreOperateRxMessageBuffer>::expected_bytes(self) {
-                    Ok(bytes) => bytes,
-                    Err(_) => HEADER_SIZE_IN_FRAME,
-                }
-            }
-            DeviceOperationMode::Operate => {
-                match <Self as OperateRxMessageBuffer>::expected_bytes(self) {
-                    Ok(bytes) => bytes,
-                    Err(_) => HEADER_SIZE_IN_FRAME,
-                }
-            }
-        }
-    }
-
     /// Returns the message buffer as a slice.
     pub fn get_as_slice(&self) -> &[u8] {
         &self.buffer[0..self.length]
@@ -577,40 +626,24 @@ impl<const BUFF_LEN: usize> PreOperateTxMessageBuffer for TxMessageBuffer<BUFF_L
 
 impl<const BUFF_LEN: usize> OperateTxMessageBuffer for TxMessageBuffer<BUFF_LEN> {
     fn insert_od(&mut self, od_length: usize, od: &[u8]) -> MessageBufferResult<()> {
-        if self.length + od.len() > BUFF_LEN {
+        if od_length > od.len() {
             return Err(MessageBufferError::InvalidLength);
         }
-        const OD_LENGTH: usize = derived_config::on_req_data::operate::od_length() as usize;
-        if od_length > 0 {
-            const OD_START: usize = 0;
-            const OD_END: usize = OD_LENGTH;
-            for index in OD_START..OD_END {
-                if index >= od.len() {
-                    self.buffer[index] = 0;
-                    continue;
-                }
-                self.buffer[index] = od[index];
-            }
-            self.length += OD_LENGTH;
-        }
+        // OD is only part of the response to a read request, octets beyond
+        // the Operate OD length are dropped and missing octets are zero filled
+        self.operate_templates[operate_template_index(RwDirection::Read)]
+            .patch_od(&od[..od_length]);
         self.od_ready = true;
         Ok(())
     }
 
     fn insert_pd(&mut self, pd: &[u8]) -> MessageBufferResult<()> {
-        if self.length + pd.len() > BUFF_LEN {
-            return Err(MessageBufferError::InvalidLength);
-        }
-        const PD_LENGTH: usize =
-            derived_config::process_data::pd_in::config_length_in_bytes() as usize;
-        const OD_LENGTH: usize = derived_config::on_req_data::operate::od_length() as usize;
-        if PD_LENGTH != pd.len() {
+        if PD_IN_LENGTH as usize != pd.len() {
             return Err(MessageBufferError::InvalidData);
         }
-        const PD_START: usize = OD_LENGTH;
-        const PD_END: usize = OD_LENGTH + PD_LENGTH;
-        self.buffer[PD_START..PD_END].copy_from_slice(pd);
-        self.length += PD_LENGTH;
+        for template in self.operate_templates.iter_mut() {
+            template.patch_pd(pd);
+        }
         self.pd_ready = true;
         Ok(())
     }
@@ -626,20 +659,7 @@ impl<const BUFF_LEN: usize> OperateTxMessageBuffer for TxMessageBuffer<BUFF_LEN>
         if !self.pd_ready {
             return Err(MessageBufferError::PdNotSet);
         }
-        const OD_LENGTH: usize = derived_config::on_req_data::operate::od_length() as usize;
-        const PD_LENGTH: usize =
-            derived_config::process_data::pd_out::config_length_in_bytes() as usize;
-        const CKS_INDEX: usize = OD_LENGTH + PD_LENGTH - 1;
-        let mut cks = ChecksumStatus::new();
-        cks.set_event_flag(event_flag);
-        cks.set_pd_status(pd_status);
-        self.buffer[CKS_INDEX] = cks.into_bits();
-        self.length += 1;
-        let checksum = calculate_checksum(self.length, &self.buffer);
-        cks.set_checksum(checksum);
-        self.buffer[CKS_INDEX] = cks.into_bits();
-        self.tx_ready = true;
-        Ok(&self.buffer[0..self.length])
+        Ok(self.compile_operate_rsp(RwDirection::Read, event_flag, pd_status))
     }
 
     fn compile_write_rsp(
@@ -650,25 +670,30 @@ impl<const BUFF_LEN: usize> OperateTxMessageBuffer for TxMessageBuffer<BUFF_LEN>
         if !self.pd_ready {
             return Err(MessageBufferError::PdNotSet);
         }
-        const PD_LENGTH: usize =
-            derived_config::process_data::pd_out::config_length_in_bytes() as usize;
-        const CKS_INDEX: usize = PD_LENGTH - 1;
-        let mut cks = ChecksumStatus::new();
-        cks.set_event_flag(event_flag);
-        cks.set_pd_status(pd_status);
-        self.buffer[CKS_INDEX] = cks.into_bits();
-        self.length += 1;
-        let checksum = calculate_checksum(self.length, &self.buffer);
-        cks.set_checksum(checksum);
-        self.buffer[CKS_INDEX] = cks.into_bits();
+        Ok(self.compile_operate_rsp(RwDirection::Write, event_flag, pd_status))
+    }
+}
+
+impl<const BUFF_LEN: usize> TxMessageBuffer<BUFF_LEN> {
+    /// Finalizes the Operate mode template of the given direction for transmission
+    fn compile_operate_rsp(
+        &mut self,
+        rw_direction: RwDirection,
+        event_flag: bool,
+        pd_status: PdStatus,
+    ) -> &[u8] {
+        let template = &mut self.operate_templates[operate_template_index(rw_direction)];
+        template.patch_cks(event_flag, pd_status);
+        self.length = template.layout.frame_length;
+        self.operate_rsp = Some(rw_direction);
         self.tx_ready = true;
-        Ok(&self.buffer[0..self.length])
+        template.as_slice()
     }
 }
 
 impl<const BUFF_LEN: usize> StartupRxMessageBuffer for RxMessageBuffer<BUFF_LEN> {
     fn valid_req(&mut self) -> MessageBufferResult<RwDirection> {
-        if validate_master_frame_checksum(self.length, self.buffer.as_mut_slice()) {
+        if self.is_checksum_valid() {
             let (mc, ckt) = extract_mc_ckt_bytes(self.buffer.as_slice())
                 .map_err(|_| MessageBufferError::InvalidChecksum)?;
             if ckt.m_seq_type() != MsequenceBaseType::Type0 {
@@ -706,7 +731,7 @@ impl<const BUFF_LEN: usize> StartupRxMessageBuffer for RxMessageBuffer<BUFF_LEN>
 
 impl<const BUFF_LEN: usize> PreOperateRxMessageBuffer for RxMessageBuffer<BUFF_LEN> {
     fn valid_req(&mut self) -> MessageBufferResult<RwDirection> {
-        if validate_master_frame_checksum(self.length, self.buffer.as_mut_slice()) {
+        if self.is_checksum_valid() {
             const PRE_OP_MSEQ_BASE_TYPE: MsequenceBaseType =
                 derived_config::m_seq_capability::pre_operate_m_sequence::m_sequence_base_type();
             let (mc, ckt) = extract_mc_ckt_bytes(self.buffer.as_slice())
@@ -747,7 +772,7 @@ impl<const BUFF_LEN: usize> PreOperateRxMessageBuffer for RxMessageBuffer<BUFF_L
 
 impl<const BUFF_LEN: usize> OperateRxMessageBuffer for RxMessageBuffer<BUFF_LEN> {
     fn valid_req(&mut self) -> MessageBufferResult<RwDirection> {
-        if validate_master_frame_checksum(self.length, self.buffer.as_mut_slice()) {
+        if self.is_checksum_valid() {
             const OP_MSEQ_BASE_TYPE: MsequenceBaseType =
                 derived_config::m_seq_capability::operate_m_sequence::m_sequence_base_type();
             let (mc, ckt) = extract_mc_ckt_bytes(self.buffer.as_slice())
@@ -797,6 +822,164 @@ impl<const BUFF_LEN: usize> OperateRxMessageBuffer for RxMessageBuffer<BUFF_LEN>
     }
 }
 
+/// Frame codec of one device operation mode
+///
+/// Holds the mode specific frame functions of [`RxMessageBuffer`] and [`TxMessageBuffer`],
+/// so the mode is resolved once when it changes (see DL_Mode) and not matched for every
+/// frame. The frame lengths and the M-sequence type of each mode are compile-time
+/// constants of its functions.
+#[derive(Debug)]
+pub struct FrameCodec<const RX_LEN: usize, const TX_LEN: usize> {
+    mode: DeviceOperationMode,
+    /// OD octets of the M-sequence in this mode
+    od_length: u8,
+    valid_req: fn(&mut RxMessageBuffer<RX_LEN>) -> MessageBufferResult<RwDirection>,
+    expected_bytes: fn(&RxMessageBuffer<RX_LEN>) -> MessageBufferResult<u8>,
+    extract_od_from_write_req:
+        for<'a> fn(&'a RxMessageBuffer<RX_LEN>) -> MessageBufferResult<&'a [u8]>,
+    insert_od: fn(&mut TxMessageBuffer<TX_LEN>, usize, &[u8]) -> MessageBufferResult<()>,
+    insert_pd: fn(&mut TxMessageBuffer<TX_LEN>, &[u8]) -> MessageBufferResult<()>,
+    is_ready: fn(&TxMessageBuffer<TX_LEN>) -> bool,
+    compile_read_rsp: for<'a> fn(
+        &'a mut TxMessageBuffer<TX_LEN>,
+        bool,
+        PdStatus,
+    ) -> MessageBufferResult<&'a [u8]>,
+    compile_write_rsp: for<'a> fn(
+        &'a mut TxMessageBuffer<TX_LEN>,
+        bool,
+        PdStatus,
+    ) -> MessageBufferResult<&'a [u8]>,
+}
+
+impl<const RX_LEN: usize, const TX_LEN: usize> FrameCodec<RX_LEN, TX_LEN> {
+    const STARTUP: Self = Self {
+        mode: DeviceOperationMode::Startup,
+        od_length: 1,
+        valid_req: <RxMessageBuffer<RX_LEN> as StartupRxMessageBuffer>::valid_req,
+        expected_bytes: <RxMessageBuffer<RX_LEN> as StartupRxMessageBuffer>::expected_bytes,
+        extract_od_from_write_req:
+            <RxMessageBuffer<RX_LEN> as StartupRxMessageBuffer>::extract_od_from_write_req,
+        insert_od: <TxMessageBuffer<TX_LEN> as StartupTxMessageBuffer>::insert_od,
+        insert_pd: |_, _| Err(MessageBufferError::InvalidDeviceOperationMode),
+        is_ready: |tx_buffer| tx_buffer.od_ready,
+        compile_read_rsp: <TxMessageBuffer<TX_LEN> as StartupTxMessageBuffer>::compile_read_rsp,
+        compile_write_rsp: <TxMessageBuffer<TX_LEN> as StartupTxMessageBuffer>::compile_write_rsp,
+    };
+
+    const PRE_OPERATE: Self = Self {
+        mode: DeviceOperationMode::PreOperate,
+        od_length: derived_config::on_req_data::pre_operate::od_length(),
+        valid_req: <RxMessageBuffer<RX_LEN> as PreOperateRxMessageBuffer>::valid_req,
+        expected_bytes: <RxMessageBuffer<RX_LEN> as PreOperateRxMessageBuffer>::expected_bytes,
+        extract_od_from_write_req:
+            <RxMessageBuffer<RX_LEN> as PreOperateRxMessageBuffer>::extract_od_from_write_req,
+        insert_od: <TxMessageBuffer<TX_LEN> as PreOperateTxMessageBuffer>::insert_od,
+        insert_pd: |_, _| Err(MessageBufferError::InvalidDeviceOperationMode),
+        is_ready: |tx_buffer| tx_buffer.od_ready,
+        compile_read_rsp: <TxMessageBuffer<TX_LEN> as PreOperateTxMessageBuffer>::compile_read_rsp,
+        compile_write_rsp:
+            <TxMessageBuffer<TX_LEN> as PreOperateTxMessageBuffer>::compile_write_rsp,
+    };
+
+    const OPERATE: Self = Self {
+        mode: DeviceOperationMode::Operate,
+        od_length: derived_config::on_req_data::operate::od_length(),
+        valid_req: <RxMessageBuffer<RX_LEN> as OperateRxMessageBuffer>::valid_req,
+        expected_bytes: <RxMessageBuffer<RX_LEN> as OperateRxMessageBuffer>::expected_bytes,
+        extract_od_from_write_req:
+            <RxMessageBuffer<RX_LEN> as OperateRxMessageBuffer>::extract_od_from_write_req,
+        insert_od: <TxMessageBuffer<TX_LEN> as OperateTxMessageBuffer>::insert_od,
+        insert_pd: <TxMessageBuffer<TX_LEN> as OperateTxMessageBuffer>::insert_pd,
+        is_ready: |tx_buffer| tx_buffer.od_ready && tx_buffer.pd_ready,
+        compile_read_rsp: <TxMessageBuffer<TX_LEN> as OperateTxMessageBuffer>::compile_read_rsp,
+        compile_write_rsp: <TxMessageBuffer<TX_LEN> as OperateTxMessageBuffer>::compile_write_rsp,
+    };
+
+    /// Returns the codec of `mode`
+    pub const fn of(mode: DeviceOperationMode) -> &'static Self {
+        match mode {
+            DeviceOperationMode::Startup => &Self::STARTUP,
+            DeviceOperationMode::PreOperate => &Self::PRE_OPERATE,
+            DeviceOperationMode::Operate => &Self::OPERATE,
+        }
+    }
+
+    /// Returns the device operation mode of the codec
+    pub const fn mode(&self) -> DeviceOperationMode {
+        self.mode
+    }
+
+    /// Returns the number of OD octets of the M-sequence in this mode
+    pub const fn od_length(&self) -> u8 {
+        self.od_length
+    }
+
+    /// Validates the received request
+    pub fn valid_req(
+        &self,
+        rx_buffer: &mut RxMessageBuffer<RX_LEN>,
+    ) -> MessageBufferResult<RwDirection> {
+        (self.valid_req)(rx_buffer)
+    }
+
+    /// Returns the number of octets of the Master message, from its first two octets
+    pub fn expected_rx_bytes(&self, rx_buffer: &RxMessageBuffer<RX_LEN>) -> u8 {
+        match (self.expected_bytes)(rx_buffer) {
+            Ok(bytes) => bytes,
+            Err(_) => HEADER_SIZE_IN_FRAME,
+        }
+    }
+
+    /// Extracts the OD octets of a write request
+    pub fn extract_od_from_write_req<'a>(
+        &self,
+        rx_buffer: &'a RxMessageBuffer<RX_LEN>,
+    ) -> MessageBufferResult<&'a [u8]> {
+        (self.extract_od_from_write_req)(rx_buffer)
+    }
+
+    /// Inserts the OD octets of the response
+    pub fn insert_od(
+        &self,
+        tx_buffer: &mut TxMessageBuffer<TX_LEN>,
+        od_length: usize,
+        od: &[u8],
+    ) -> MessageBufferResult<()> {
+        (self.insert_od)(tx_buffer, od_length, od)
+    }
+
+    /// Inserts the PD octets of the response, Operate mode only
+    pub fn insert_pd(
+        &self,
+        tx_buffer: &mut TxMessageBuffer<TX_LEN>,
+        pd: &[u8],
+    ) -> MessageBufferResult<()> {
+        (self.insert_pd)(tx_buffer, pd)
+    }
+
+    /// Returns `true` once the response has all its OD and PD octets
+    pub fn is_ready(&self, tx_buffer: &TxMessageBuffer<TX_LEN>) -> bool {
+        (self.is_ready)(tx_buffer)
+    }
+
+    /// Compiles the response to a request in direction `rw_req_dir`
+    pub fn compile_message_rsp(
+        &self,
+        tx_buffer: &mut TxMessageBuffer<TX_LEN>,
+        rw_req_dir: RwDirection,
+        event_flag: bool,
+        pd_status: PdStatus,
+    ) -> IoLinkResult<()> {
+        let compile_rsp = match rw_req_dir {
+            RwDirection::Read => self.compile_read_rsp,
+            RwDirection::Write => self.compile_write_rsp,
+        };
+        compile_rsp(tx_buffer, event_flag, pd_status).map_err(|_| IoLinkError::InvalidParameter)?;
+        Ok(())
+    }
+}
+
 /// Calculate the maximum time required to transmit a UART frame based on the transmission rate.
 /// This function calculates the maximum time required to transmit a UART frame,
 /// including the time for the transmission of a UART frame (11 TBIT) plus the maximum of t1 (1 TBIT),
@@ -856,69 +1039,7 @@ pub fn calculate_checksum_for_testing(length: usize, data: &[u8]) -> u8 {
 }
 
 fn calculate_checksum(length: usize, data: &[u8]) -> u8 {
-    #[bitfield(u8)]
-    struct FullChecksumBits {
-        #[bits(1)]
-        bit0: u8,
-        #[bits(1)]
-        bit1: u8,
-        #[bits(1)]
-        bit2: u8,
-        #[bits(1)]
-        bit3: u8,
-        #[bits(1)]
-        bit4: u8,
-        #[bits(1)]
-        bit5: u8,
-        #[bits(1)]
-        bit6: u8,
-        #[bits(1)]
-        bit7: u8,
-    }
-
-    #[bitfield(u8)]
-    struct ChecksumBits {
-        #[bits(1)]
-        bit0: u8,
-        #[bits(1)]
-        bit1: u8,
-        #[bits(1)]
-        bit2: u8,
-        #[bits(1)]
-        bit3: u8,
-        #[bits(1)]
-        bit4: u8,
-        #[bits(1)]
-        bit5: u8,
-        #[bits(2)]
-        __: u8,
-    }
-    // Seed value as per IO-Link spec
-    let mut checksum = 0x52u8;
-    for i in 0..length {
-        if i < data.len() {
-            checksum ^= data[i];
-        }
-    }
-    let full_checksum_bits = FullChecksumBits::from(checksum);
-    let d_bit0 = full_checksum_bits.bit0();
-    let d_bit1 = full_checksum_bits.bit1();
-    let d_bit2 = full_checksum_bits.bit2();
-    let d_bit3 = full_checksum_bits.bit3();
-    let d_bit4 = full_checksum_bits.bit4();
-    let d_bit5 = full_checksum_bits.bit5();
-    let d_bit6 = full_checksum_bits.bit6();
-    let d_bit7 = full_checksum_bits.bit7();
-
-    let mut checksum_bits = ChecksumBits::new();
-    checksum_bits.set_bit0(d_bit1 ^ d_bit0);
-    checksum_bits.set_bit1(d_bit3 ^ d_bit2);
-    checksum_bits.set_bit2(d_bit5 ^ d_bit4);
-    checksum_bits.set_bit3(d_bit7 ^ d_bit6);
-    checksum_bits.set_bit4(d_bit6 ^ d_bit4 ^ d_bit2 ^ d_bit0);
-    checksum_bits.set_bit5(d_bit7 ^ d_bit5 ^ d_bit3 ^ d_bit1);
-
-    checksum_bits.into_bits()
+    checksum::calculate_m_sequence_checksum(length, data)
 }
 
 /// Mask to set bits 0-5 to zero while preserving bits 6-7
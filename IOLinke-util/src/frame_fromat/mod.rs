@@ -2,8 +2,10 @@
 //!
 //! It contains submodules for ISDU (Indexed Service Data Unit) and general message processing.
 //!
+//! - `checksum`: The checksum engine shared by M-sequence and ISDU frames.
 //! - `isdu`: Functions and types for working with ISDU frames.
 //! - `message`: Utilities for parsing and constructing IO-Link messages.
 
+pub mod checksum;
 pub mod isdu;
 pub mod message;
@@ -11,6 +11,9 @@
 //! - **Bitwise Operations**: Bit manipulation and bitfield utilities
 //! - **Frame Format**: IO-Link frame parsing and formatting
 //! - **Event Handling**: Event processing and management utilities
+//! - **Double Buffer**: Lock-free ping-pong buffer for Process Data snapshots
+//! - **SPSC Ring**: Lock-free single producer / single consumer queue, e.g. for Events
+//! - **Trace**: Binary ring of the state transitions, with the `trace` feature
 //!
 //! ## Specification Compliance
 //!
@@ -18,6 +21,13 @@
 //! - Annex A: Protocol Details and Bit Definitions
 //! - Section 8.3: Event Handling and Processing
 
+#[cfg(feature = "std")]
+extern crate std;
+
+pub mod double_buffer;
 pub mod event;
 pub mod frame_fromat;
 pub mod log_utils;
+pub mod spsc_ring;
+#[cfg(feature = "trace")]
+pub mod trace;
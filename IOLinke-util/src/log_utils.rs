@@ -26,12 +26,70 @@
 //! When the `std` feature is enabled, logs are printed to the standard output
 //! with a timestamp. In `no_std` environments, the macro does nothing.
 //!
+//! The output can be switched off at runtime with [`set_log_enabled`]. With the `std`
+//! feature, [`suppress_log`] switches it off only while the returned guard lives, e.g.
+//! for high rate simulations which would otherwise print every state transition. The
+//! `trace` feature
+//! records the state transitions into a binary ring instead, see `iolinke_util::trace`.
+//!
 //! # Example Output
 //!
 //! ```text
 //! [1681234567] [IoLinkDevice] [poll] [Idle] [Active] Polling all protocol layers
 //! ```
 
+#[cfg(feature = "std")]
+use core::ops::Drop;
+#[cfg(feature = "std")]
+use core::sync::atomic::AtomicUsize;
+use core::sync::atomic::{AtomicBool, Ordering};
+
+/// Runtime switch of the log output, enabled by default
+static LOG_ENABLED: AtomicBool = AtomicBool::new(true);
+
+/// Number of live [`LogSuppression`] guards, the output is off while it is not 0
+#[cfg(feature = "std")]
+static LOG_SUPPRESSIONS: AtomicUsize = AtomicUsize::new(0);
+
+/// Enables or disables the output of the log macros at runtime.
+pub fn set_log_enabled(enabled: bool) {
+    LOG_ENABLED.store(enabled, Ordering::Relaxed);
+}
+
+/// Returns `true` if the log macros print their output.
+pub fn is_log_enabled() -> bool {
+    #[cfg(feature = "std")]
+    if LOG_SUPPRESSIONS.load(Ordering::Relaxed) != 0 {
+        return false;
+    }
+    LOG_ENABLED.load(Ordering::Relaxed)
+}
+
+/// Switches the log output off until the returned guard is dropped.
+///
+/// Guards may overlap, the output is back once the last one is dropped. The switch is
+/// process wide, other threads do not print while a guard lives either.
+#[cfg(feature = "std")]
+pub fn suppress_log() -> LogSuppression {
+    LOG_SUPPRESSIONS.fetch_add(1, Ordering::Relaxed);
+    LogSuppression { _private: () }
+}
+
+/// Guard of [`suppress_log`], the log output is off while it lives
+#[cfg(feature = "std")]
+#[must_use = "the log output is switched on again when the guard is dropped"]
+#[derive(Debug)]
+pub struct LogSuppression {
+    _private: (),
+}
+
+#[cfg(feature = "std")]
+impl Drop for LogSuppression {
+    fn drop(&mut self) {
+        LOG_SUPPRESSIONS.fetch_sub(1, Ordering::Relaxed);
+    }
+}
+
 /// Log a function call and state transition.
 ///
 /// This macro logs a function call and the transition from one state to another.
@@ -67,22 +125,24 @@ macro_rules! log_fn_call {
     ) => {
         #[cfg(feature = "std")]
         {
-            let now = std::time::SystemTime::now();
-            let timestamp = now
-                .duration_since(std::time::SystemTime::UNIX_EPOCH)
-                .unwrap()
-                .as_secs();
-            let timestamp = timestamp.to_string();
+            if $crate::log_utils::is_log_enabled() {
+                let now = std::time::SystemTime::now();
+                let timestamp = now
+                    .duration_since(std::time::SystemTime::UNIX_EPOCH)
+                    .unwrap()
+                    .as_secs();
+                let timestamp = timestamp.to_string();
 
-            std::println!(
-                "[{}] [{}] [{}] [{}] [{}] {}",
-                timestamp,
-                $module,
-                $event,
-                $source_state,
-                $target_state,
-                $details
-            );
+                std::println!(
+                    "[{}] [{}] [{}] [{}] [{}] {}",
+                    timestamp,
+                    $module,
+                    $event,
+                    $source_state,
+                    $target_state,
+                    $details
+                );
+            }
         }
     };
 }
@@ -98,7 +158,11 @@ macro_rules! log_fn_call {
 /// - `$event`: The name of the function or event being logged.
 /// - `$source_state`: The state the system was in before the call.
 /// - `$target_state`: The state the system is in after the call.
-/// - `$details`: Additional details or context about the call.
+/// - `$details`: The event handled by the state machine.
+///
+/// With the `trace` feature of the calling crate, the transition is also written into
+/// the binary trace ring, see `iolinke_util::trace`. `$module` must then be a constant
+/// expression and the states and `$details` implement `TraceId`.
 ///
 /// # Example
 ///
@@ -122,27 +186,39 @@ macro_rules! log_state_transition {
     ) => {
         #[cfg(feature = "std")]
         {
-            let now = std::time::SystemTime::now();
-            let timestamp = now
-                .duration_since(std::time::SystemTime::UNIX_EPOCH)
-                .unwrap()
-                .as_secs();
-            let timestamp = timestamp.to_string();
+            if $crate::log_utils::is_log_enabled() {
+                let now = std::time::SystemTime::now();
+                let timestamp = now
+                    .duration_since(std::time::SystemTime::UNIX_EPOCH)
+                    .unwrap()
+                    .as_secs();
+                let timestamp = timestamp.to_string();
 
-            std::println!(
-                "[{}] [{}] [{}] [{:?}] [{:?}] [{:?}]",
-                timestamp,
-                $module,
-                $event,
-                $source_state,
-                $target_state,
-                $details
-            );
+                std::println!(
+                    "[{}] [{}] [{}] [{:?}] [{:?}] [{:?}]",
+                    timestamp,
+                    $module,
+                    $event,
+                    $source_state,
+                    $target_state,
+                    $details
+                );
+            }
         }
+        #[cfg(feature = "trace")]
+        $crate::trace::record(
+            const { $crate::trace::module_id($module) },
+            $crate::trace::TraceId::trace_id(&$source_state),
+            $crate::trace::TraceId::trace_id(&$target_state),
+            $crate::trace::TraceId::trace_id(&$details),
+        );
     };
 }
 
 /// Log a state transition error.
+///
+/// With the `trace` feature of the calling crate, the rejected event is also written
+/// into the binary trace ring, see [`log_state_transition!`].
 #[macro_export]
 macro_rules! log_state_transition_error {
     (
@@ -153,21 +229,30 @@ macro_rules! log_state_transition_error {
     ) => {
         #[cfg(feature = "std")]
         {
-            let now = std::time::SystemTime::now();
-            let timestamp = now
-                .duration_since(std::time::SystemTime::UNIX_EPOCH)
-                .unwrap()
-                .as_secs();
-            let timestamp = timestamp.to_string();
+            if $crate::log_utils::is_log_enabled() {
+                let now = std::time::SystemTime::now();
+                let timestamp = now
+                    .duration_since(std::time::SystemTime::UNIX_EPOCH)
+                    .unwrap()
+                    .as_secs();
+                let timestamp = timestamp.to_string();
 
-            std::eprintln!(
-                "[{}] [{}] [{}] [{:?}] [{:?}]",
-                timestamp,
-                $module,
-                $event,
-                $current_state,
-                $details
-            );
+                std::eprintln!(
+                    "[{}] [{}] [{}] [{:?}] [{:?}]",
+                    timestamp,
+                    $module,
+                    $event,
+                    $current_state,
+                    $details
+                );
+            }
         }
+        #[cfg(feature = "trace")]
+        $crate::trace::record(
+            const { $crate::trace::module_id($module) },
+            $crate::trace::TraceId::trace_id(&$current_state),
+            $crate::trace::TRACE_REJECTED,
+            $crate::trace::TraceId::trace_id(&$details),
+        );
     };
 }
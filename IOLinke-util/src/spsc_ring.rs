@@ -0,0 +1,163 @@
+//! Lock-free single producer / single consumer ring buffer.
+//!
+//! The producer (e.g. an interrupt handler of the device application) pushes
+//! elements, the consumer (the poll loop of the device stack) pops them in the same
+//! order. Producer and consumer never touch the same slot, so neither side has to
+//! disable interrupts.
+//!
+//! The synchronisation only uses atomic loads and stores, which are available on every
+//! target including ARMv6-M (Cortex-M0+) that has no compare-and-swap instructions.
+//! Elements pushed while the ring is full are dropped and counted.
+//!
+//! # Example
+//!
+//! ```rust
+//! use iolinke_util::spsc_ring::SpscRing;
+//!
+//! let ring: SpscRing<[u8; 3], 2> = SpscRing::new();
+//! assert!(ring.push([0x01, 0x02, 0x03]));
+//! assert!(ring.push([0x04, 0x05, 0x06]));
+//! assert!(!ring.push([0x07, 0x08, 0x09]));
+//! assert_eq!(ring.overflow_count(), 1);
+//! assert_eq!(ring.pop(), Some([0x01, 0x02, 0x03]));
+//! ```
+
+use core::cell::UnsafeCell;
+use core::marker::Copy;
+use core::mem::MaybeUninit;
+use core::option::{
+    Option,
+    Option::{None, Some},
+};
+use core::sync::atomic::{AtomicU32, AtomicUsize, Ordering};
+
+/// Lock-free single producer / single consumer ring of `N` elements
+///
+/// - Only one context may call [`SpscRing::push`] (the producer).
+/// - Only one context may call [`SpscRing::pop`] and [`SpscRing::clear`] (the consumer).
+///
+/// `head` and `tail` run from 0 to `2 * N - 1`, so a full ring (`head - tail == N`)
+/// can be told apart from an empty one without a spare slot.
+pub struct SpscRing<T: Copy, const N: usize> {
+    slots: [UnsafeCell<MaybeUninit<T>>; N],
+    /// Position of the next push, written only by the producer
+    head: AtomicUsize,
+    /// Position of the next pop, written only by the consumer
+    tail: AtomicUsize,
+    /// Number of dropped pushes, written only by the producer
+    overflow_count: AtomicU32,
+}
+
+impl<T: Copy, const N: usize> SpscRing<T, N> {
+    /// Creates a new, empty ring
+    pub const fn new() -> Self {
+        Self {
+            slots: [const { UnsafeCell::new(MaybeUninit::uninit()) }; N],
+            head: AtomicUsize::new(0),
+            tail: AtomicUsize::new(0),
+            overflow_count: AtomicU32::new(0),
+        }
+    }
+
+    const fn advance(position: usize) -> usize {
+        if position + 1 == 2 * N { 0 } else { position + 1 }
+    }
+
+    const fn distance(head: usize, tail: usize) -> usize {
+        if head >= tail {
+            head - tail
+        } else {
+            head + 2 * N - tail
+        }
+    }
+
+    /// Appends `element`, producer side.
+    ///
+    /// # Returns
+    /// - `true` if the element was queued.
+    /// - `false` if the ring is full, the element is dropped and counted.
+    pub fn push(&self, element: T) -> bool {
+        let head = self.head.load(Ordering::Relaxed);
+        let tail = self.tail.load(Ordering::Acquire);
+        if Self::distance(head, tail) == N {
+            let overflow_count = self.overflow_count.load(Ordering::Relaxed);
+            self.overflow_count
+                .store(overflow_count.wrapping_add(1), Ordering::Relaxed);
+            return false;
+        }
+        // SAFETY: The slot at `head` is not visible to the consumer until `head` is advanced
+        unsafe { (*self.slots[head % N].get()).write(element) };
+        self.head.store(Self::advance(head), Ordering::Release);
+        true
+    }
+
+    /// Returns the oldest element without removing it, consumer side.
+    ///
+    /// # Returns
+    /// - `Some(element)` the oldest queued element.
+    /// - `None` if the ring is empty.
+    pub fn peek(&self) -> Option<T> {
+        let tail = self.tail.load(Ordering::Relaxed);
+        let head = self.head.load(Ordering::Acquire);
+        if head == tail {
+            return None;
+        }
+        // SAFETY: The slot at `tail` was written by the producer before `head` was
+        // advanced past it and is not written again until `tail` is advanced
+        Some(unsafe { (*self.slots[tail % N].get()).assume_init() })
+    }
+
+    /// Removes the oldest element, consumer side.
+    ///
+    /// # Returns
+    /// - `Some(element)` the oldest queued element.
+    /// - `None` if the ring is empty.
+    pub fn pop(&self) -> Option<T> {
+        let element = self.peek()?;
+        let tail = self.tail.load(Ordering::Relaxed);
+        self.tail.store(Self::advance(tail), Ordering::Release);
+        Some(element)
+    }
+
+    /// Drops all queued elements, consumer side
+    pub fn clear(&self) {
+        self.tail
+            .store(self.head.load(Ordering::Acquire), Ordering::Release);
+    }
+
+    /// Returns the number of queued elements
+    pub fn len(&self) -> usize {
+        Self::distance(
+            self.head.load(Ordering::Acquire),
+            self.tail.load(Ordering::Acquire),
+        )
+    }
+
+    /// Returns `true` if no element is queued
+    pub fn is_empty(&self) -> bool {
+        self.len() == 0
+    }
+
+    /// Returns the maximum number of queued elements
+    pub const fn capacity(&self) -> usize {
+        N
+    }
+
+    /// Returns the number of elements dropped because the ring was full.
+    ///
+    /// The counter is never reset and wraps around.
+    pub fn overflow_count(&self) -> u32 {
+        self.overflow_count.load(Ordering::Relaxed)
+    }
+}
+
+// SAFETY: A slot is only written by the producer while it is outside `tail..head` and
+// only read by the consumer while it is inside, producer and consumer never access the
+// same slot at the same time.
+unsafe impl<T: Copy + core::marker::Send, const N: usize> core::marker::Sync for SpscRing<T, N> {}
+
+impl<T: Copy, const N: usize> core::default::Default for SpscRing<T, N> {
+    fn default() -> Self {
+        Self::new()
+    }
+}
@@ -0,0 +1,290 @@
+//! Binary trace of the state transitions of the IO-Link Device Stack.
+//!
+//! With the `trace` feature of the crate calling [`log_state_transition!`] and
+//! [`log_state_transition_error!`], every event handled by a state machine writes one
+//! [`TraceRecord`] into a static ring of `IODevice.Trace.RingLength` records, the
+//! oldest records are overwritten. A record holds no strings: the module is a hash of
+//! its `module_path!()`, computed at compile time, and the states and the event are the
+//! variant indices of [`TraceId`]. A transition costs the timestamp and four stores, so
+//! the trace can stay enabled at high cycle rates where the text log cannot.
+//!
+//! The names are kept in a [`TraceModule`] per state machine. [`dump`] copies the ring,
+//! e.g. to be sent to a host, where [`TraceModule::decode`] with the symbol tables of
+//! the same firmware turns the records back into the text of the log.
+//!
+//! ## Timestamp
+//!
+//! The clock is registered with [`set_trace_clock`] and must return a free running,
+//! wrapping 32 bit counter, e.g. a microsecond timer or the DWT `CYCCNT` register.
+//! With the `std` feature and no clock registered, the microseconds of a monotonic
+//! `std::time::Instant` are used. Without either, all timestamps are 0.
+//!
+//! ## Concurrency
+//!
+//! A record is claimed by advancing the write position with `fetch_add` on targets with
+//! atomic read-modify-write instructions. On ARMv6-M (Cortex-M0+) the position is loaded
+//! and stored, so a transition in an interrupt which preempts another transition between
+//! the two may overwrite its record. A reader may see a record which is partially written.
+//! The ring is shared by all devices of the firmware.
+//!
+//! [`log_state_transition!`]: crate::log_state_transition
+//! [`log_state_transition_error!`]: crate::log_state_transition_error
+
+use iolinke_derived_config::device::trace;
+
+use core::cmp::Ord;
+use core::fmt;
+use core::iter::Iterator;
+use core::option::{
+    Option,
+    Option::{None, Some},
+};
+use core::sync::atomic::{AtomicPtr, AtomicU8, AtomicU32, Ordering};
+
+/// Number of records in the trace ring
+pub const TRACE_RING_LENGTH: usize = trace::ring_length();
+
+/// Target state of a record whose event was rejected by the state machine
+pub const TRACE_REJECTED: u8 = u8::MAX;
+
+/// Clock of the trace, returns a free running wrapping 32 bit counter
+pub type TraceClock = extern "C" fn() -> u32;
+
+/// Index of the variant of a state or event enum, recorded instead of its name.
+///
+/// Implemented with `#[derive(TraceId)]` of `iolinke_macros`.
+pub trait TraceId {
+    /// Names of the variants, indexed by [`TraceId::trace_id`]
+    const TRACE_NAMES: &'static [&'static str];
+
+    /// Returns the index of the variant
+    fn trace_id(&self) -> u8;
+}
+
+/// One state transition, 12 octets
+#[repr(C)]
+#[derive(Debug, Clone, Copy, PartialEq, Eq, Default)]
+pub struct TraceRecord {
+    /// Value of the trace clock
+    pub timestamp: u32,
+    /// Hash of the module of the state machine, see [`module_id`]
+    pub module: u16,
+    /// Event handled by the state machine
+    pub event: u8,
+    /// State before the event
+    pub source_state: u8,
+    /// State after the event, [`TRACE_REJECTED`] if the event was rejected
+    pub target_state: u8,
+}
+
+/// Returns the 16 bit FNV-1a hash of `module_path` which identifies a state machine in
+/// the [`TraceRecord`]s
+pub const fn module_id(module_path: &str) -> u16 {
+    let bytes = module_path.as_bytes();
+    let mut hash: u32 = 0x811C_9DC5;
+    let mut i = 0;
+    while i < bytes.len() {
+        hash ^= bytes[i] as u32;
+        hash = hash.wrapping_mul(0x0100_0193);
+        i += 1;
+    }
+    ((hash >> 16) ^ (hash & 0xFFFF)) as u16
+}
+
+/// Symbol table of one state machine, the names of its module, states and events
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub struct TraceModule {
+    /// Hash of `path`, see [`module_id`]
+    pub id: u16,
+    /// `module_path!()` of the state machine
+    pub path: &'static str,
+    /// Names of the states, indexed by [`TraceRecord::source_state`]
+    pub states: &'static [&'static str],
+    /// Names of the events, indexed by [`TraceRecord::event`]
+    pub events: &'static [&'static str],
+}
+
+impl TraceModule {
+    /// Symbol table of the state machine in `path` with the states `S` and events `E`
+    pub const fn new<S: TraceId, E: TraceId>(path: &'static str) -> Self {
+        Self {
+            id: module_id(path),
+            path,
+            states: S::TRACE_NAMES,
+            events: E::TRACE_NAMES,
+        }
+    }
+
+    /// Looks up the names of `record` in the symbol tables of `modules`.
+    ///
+    /// # Returns
+    /// - The decoded record.
+    /// - `None` if the module, a state or the event is not in the tables, e.g. the
+    ///   record was dumped from another firmware.
+    pub fn decode(modules: &[TraceModule], record: &TraceRecord) -> Option<TraceEntry> {
+        let module = modules.iter().find(|module| module.id == record.module)?;
+        let target_state = match record.target_state {
+            TRACE_REJECTED => None,
+            target_state => Some(*module.states.get(target_state as usize)?),
+        };
+        Some(TraceEntry {
+            timestamp: record.timestamp,
+            module: module.path,
+            event: module.events.get(record.event as usize)?,
+            source_state: module.states.get(record.source_state as usize)?,
+            target_state,
+        })
+    }
+}
+
+/// [`TraceRecord`] with the names of its symbol table
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub struct TraceEntry {
+    /// Value of the trace clock
+    pub timestamp: u32,
+    /// `module_path!()` of the state machine
+    pub module: &'static str,
+    /// Event handled by the state machine
+    pub event: &'static str,
+    /// State before the event
+    pub source_state: &'static str,
+    /// State after the event, `None` if the event was rejected
+    pub target_state: Option<&'static str>,
+}
+
+impl fmt::Display for TraceEntry {
+    /// Formats the entry like the log of [`crate::log_state_transition!`]
+    fn fmt(&self, f: &mut fmt::Formatter<'_>) -> fmt::Result {
+        write!(
+            f,
+            "[{}] [{}] [{}] ",
+            self.timestamp, self.module, self.source_state
+        )?;
+        match self.target_state {
+            Some(target_state) => write!(f, "[{}] [{}]", target_state, self.event),
+            None => write!(f, "[rejected] [{}]", self.event),
+        }
+    }
+}
+
+/// One record of the ring, the fields of [`TraceRecord`] in atomics
+struct TraceSlot {
+    timestamp: AtomicU32,
+    /// `module | event << 16 | source_state << 24`
+    transition: AtomicU32,
+    target_state: AtomicU8,
+}
+
+impl TraceSlot {
+    const fn new() -> Self {
+        Self {
+            timestamp: AtomicU32::new(0),
+            transition: AtomicU32::new(0),
+            target_state: AtomicU8::new(0),
+        }
+    }
+
+    fn record(&self) -> TraceRecord {
+        let transition = self.transition.load(Ordering::Relaxed);
+        TraceRecord {
+            timestamp: self.timestamp.load(Ordering::Relaxed),
+            module: transition as u16,
+            event: (transition >> 16) as u8,
+            source_state: (transition >> 24) as u8,
+            target_state: self.target_state.load(Ordering::Relaxed),
+        }
+    }
+}
+
+static TRACE_CLOCK: AtomicPtr<()> = AtomicPtr::new(core::ptr::null_mut());
+
+static TRACE_RING: [TraceSlot; TRACE_RING_LENGTH] = [const { TraceSlot::new() }; TRACE_RING_LENGTH];
+
+/// Number of records written since the last [`reset`], wraps around
+static TRACE_WRITE_COUNT: AtomicU32 = AtomicU32::new(0);
+
+/// Registers the clock of the trace timestamps
+///
+/// # Example
+///
+/// ```ignore
+/// extern "C" fn read_cyccnt() -> u32 {
+///     cortex_m::peripheral::DWT::cycle_count()
+/// }
+/// iolinke_util::trace::set_trace_clock(read_cyccnt);
+/// ```
+pub fn set_trace_clock(clock: TraceClock) {
+    TRACE_CLOCK.store(clock as *mut (), Ordering::Release);
+}
+
+fn timestamp() -> u32 {
+    let clock = TRACE_CLOCK.load(Ordering::Acquire);
+    if !clock.is_null() {
+        // SAFETY: Only `TraceClock` function pointers are stored in `TRACE_CLOCK`
+        let clock = unsafe { core::mem::transmute::<*mut (), TraceClock>(clock) };
+        return clock();
+    }
+    default_timestamp()
+}
+
+#[cfg(feature = "std")]
+fn default_timestamp() -> u32 {
+    static START: std::sync::OnceLock<std::time::Instant> = std::sync::OnceLock::new();
+    START
+        .get_or_init(std::time::Instant::now)
+        .elapsed()
+        .as_micros() as u32
+}
+
+#[cfg(not(feature = "std"))]
+fn default_timestamp() -> u32 {
+    0
+}
+
+/// Claims the slot of the next record
+#[cfg(target_has_atomic = "32")]
+fn claim() -> u32 {
+    TRACE_WRITE_COUNT.fetch_add(1, Ordering::Relaxed)
+}
+
+/// Claims the slot of the next record, see the module documentation
+#[cfg(not(target_has_atomic = "32"))]
+fn claim() -> u32 {
+    let count = TRACE_WRITE_COUNT.load(Ordering::Relaxed);
+    TRACE_WRITE_COUNT.store(count.wrapping_add(1), Ordering::Relaxed);
+    count
+}
+
+/// Writes one record into the ring, called by [`crate::log_state_transition!`] and
+/// [`crate::log_state_transition_error!`]
+#[inline]
+pub fn record(module: u16, source_state: u8, target_state: u8, event: u8) {
+    let slot = &TRACE_RING[claim() as usize & (TRACE_RING_LENGTH - 1)];
+    slot.timestamp.store(timestamp(), Ordering::Relaxed);
+    slot.transition.store(
+        module as u32 | (event as u32) << 16 | (source_state as u32) << 24,
+        Ordering::Relaxed,
+    );
+    slot.target_state.store(target_state, Ordering::Relaxed);
+}
+
+/// Copies the newest records of the ring into `records`, the oldest first.
+///
+/// # Returns
+/// The number of records copied, at most the length of `records` and
+/// [`TRACE_RING_LENGTH`].
+pub fn dump(records: &mut [TraceRecord]) -> usize {
+    let count = TRACE_WRITE_COUNT.load(Ordering::Acquire);
+    let length = (count as usize).min(TRACE_RING_LENGTH).min(records.len());
+    let first = count.wrapping_sub(length as u32);
+    for (i, record) in records[..length].iter_mut().enumerate() {
+        let position = first.wrapping_add(i as u32) as usize & (TRACE_RING_LENGTH - 1);
+        *record = TRACE_RING[position].record();
+    }
+    length
+}
+
+/// Discards all records of the ring
+pub fn reset() {
+    TRACE_WRITE_COUNT.store(0, Ordering::Release);
+}
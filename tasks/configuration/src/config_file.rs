@@ -19,6 +19,18 @@ pub struct IODevice {
     pub timing: Timing,
     #[serde(rename = "Vendor")]
     pub vendor: Vendor,
+    #[serde(rename = "Ports", default)]
+    pub ports: Ports,
+    #[serde(rename = "Events", default)]
+    pub events: Events,
+    #[serde(rename = "OutputIndication", default)]
+    pub output_indication: OutputIndication,
+    #[serde(rename = "Services", default)]
+    pub services: Services,
+    #[serde(rename = "Trace", default)]
+    pub trace: Trace,
+    #[serde(rename = "Budget", default)]
+    pub budget: Budget,
 }
 
 #[derive(Debug, Clone, Serialize, Deserialize)]
@@ -35,6 +47,98 @@ pub struct Operate {
     pub pd_in_length: ProcessDataLength,
     #[serde(rename = "PdOutLength")]
     pub pd_out_length: ProcessDataLength,
+    #[serde(rename = "PdIn", default)]
+    pub pd_in: Vec<ProcessDataField>,
+    #[serde(rename = "PdOut", default)]
+    pub pd_out: Vec<ProcessDataField>,
+}
+
+/// One `RecordItem` of the typed Process Data layout, see `process_data_layout!`
+#[derive(Debug, Clone, Serialize, Deserialize)]
+pub struct ProcessDataField {
+    #[serde(rename = "Name")]
+    pub name: String,
+    #[serde(rename = "Type")]
+    pub data_type: String,
+    #[serde(rename = "BitOffset: i")]
+    pub bit_offset: u16,
+    #[serde(rename = "BitLength: i")]
+    pub bit_length: u16,
+}
+
+impl ProcessDataField {
+    /// Type name and bit width of the supported field types
+    const TYPES: [(&'static str, u16); 8] = [
+        ("bool", 1),
+        ("u8", 8),
+        ("u16", 16),
+        ("u32", 32),
+        ("i8", 8),
+        ("i16", 16),
+        ("i32", 32),
+        ("f32", 32),
+    ];
+
+    /// Checks the field is a valid identifier of a supported type, the macro checks
+    /// the same again at compile time
+    fn validate(&self, path: &str) -> io::Result<()> {
+        let name = self.name.trim();
+        let valid_name = name
+            .chars()
+            .next()
+            .is_some_and(|ch| ch.is_ascii_lowercase() || ch == '_')
+            && name
+                .chars()
+                .all(|ch| ch.is_ascii_lowercase() || ch.is_ascii_digit() || ch == '_');
+        if !valid_name {
+            return Err(invalid_data(
+                path,
+                &format!("Name `{name}` must be a snake_case identifier."),
+            ));
+        }
+        let data_type = self.data_type.trim();
+        let width = Self::TYPES
+            .iter()
+            .find(|(type_name, _)| *type_name == data_type)
+            .map(|(_, width)| *width)
+            .ok_or_else(|| {
+                invalid_data(
+                    path,
+                    &format!("Type of `{name}` must be bool, u8, u16, u32, i8, i16, i32 or f32."),
+                )
+            })?;
+        let valid_length = match data_type {
+            "bool" => self.bit_length == 1,
+            "f32" => self.bit_length == 32,
+            "i8" | "i16" | "i32" => (2..=width).contains(&self.bit_length),
+            _ => (1..=width).contains(&self.bit_length),
+        };
+        valid_length.then_some(()).ok_or_else(|| {
+            invalid_data(
+                path,
+                &format!(
+                    "BitLength {} does not fit `{name}` of type {data_type}.",
+                    self.bit_length
+                ),
+            )
+        })
+    }
+
+    pub fn to_macro_field(&self) -> String {
+        let last_bit = self.bit_offset + self.bit_length - 1;
+        let doc = if self.bit_length == 1 {
+            format!("/// Bit {}", self.bit_offset)
+        } else {
+            format!("/// Bits {}-{last_bit}", self.bit_offset)
+        };
+        format!(
+            "{doc}\n#[pd_field(bit_offset = {}, bit_length = {})]\npub {}: {},",
+            self.bit_offset,
+            self.bit_length,
+            self.name.trim(),
+            self.data_type.trim()
+        )
+    }
 }
 
 #[derive(Debug, Clone, Serialize, Deserialize)]
@@ -43,6 +147,88 @@ pub struct Timing {
     pub min_cycle_time: f32,
 }
 
+#[derive(Debug, Clone, Serialize, Deserialize)]
+pub struct Ports {
+    #[serde(rename = "Count", deserialize_with = "deserialize_u8")]
+    pub count: u8,
+}
+
+impl Default for Ports {
+    fn default() -> Self {
+        Self { count: 1 }
+    }
+}
+
+#[derive(Debug, Clone, Serialize, Deserialize)]
+pub struct Events {
+    #[serde(rename = "QueueDepth", deserialize_with = "deserialize_u8")]
+    pub queue_depth: u8,
+    #[serde(rename = "RateLimitCycles")]
+    pub rate_limit_cycles: u32,
+}
+
+impl Default for Events {
+    fn default() -> Self {
+        Self {
+            queue_depth: 8,
+            rate_limit_cycles: 0,
+        }
+    }
+}
+
+/// Change detection and throttling of AL_NewOutput, all off by default
+#[derive(Debug, Clone, Default, Serialize, Deserialize)]
+pub struct OutputIndication {
+    #[serde(rename = "OnChange")]
+    pub on_change: bool,
+    #[serde(rename = "MinIntervalCycles")]
+    pub min_interval_cycles: u32,
+    #[serde(rename = "CoalescePdCycle")]
+    pub coalesce_pd_cycle: bool,
+}
+
+#[derive(Debug, Clone, Serialize, Deserialize)]
+pub struct Services {
+    #[serde(rename = "Isdu")]
+    pub isdu: bool,
+    #[serde(rename = "Events")]
+    pub events: bool,
+    #[serde(rename = "DataStorage")]
+    pub data_storage: bool,
+}
+
+impl Default for Services {
+    fn default() -> Self {
+        Self {
+            isdu: true,
+            events: true,
+            data_storage: true,
+        }
+    }
+}
+
+/// Binary state transition trace of the `trace` feature
+#[derive(Debug, Clone, Serialize, Deserialize)]
+pub struct Trace {
+    #[serde(rename = "RingLength")]
+    pub ring_length: u16,
+}
+
+impl Default for Trace {
+    fn default() -> Self {
+        Self { ring_length: 64 }
+    }
+}
+
+/// Memory budget of the device stacks, 0 is not checked
+#[derive(Debug, Clone, Default, Serialize, Deserialize)]
+pub struct Budget {
+    #[serde(rename = "RamBytes")]
+    pub ram_bytes: u32,
+    #[serde(rename = "FlashBytes")]
+    pub flash_bytes: u32,
+}
+
 #[derive(Debug, Clone, Serialize, Deserialize)]
 pub struct Vendor {
     #[serde(rename = "MajorRevisionID", deserialize_with = "deserialize_u8")]
@@ -90,6 +276,33 @@ pub struct VendorStorageEntry {
 }
 
 impl VendorStorageEntry {
+    /// Checks the default value fits the parameter, the storage arena reserves
+    /// exactly `Length` bytes for it
+    pub fn validate(&self, path: &str) -> io::Result<()> {
+        if self.data_type.trim() != "StringT" {
+            return Ok(());
+        }
+        let raw = self.default_value.trim();
+        let raw = raw
+            .strip_prefix("b\"")
+            .or_else(|| raw.strip_prefix("B\""))
+            .unwrap_or(raw);
+        let default_length = raw.trim_matches('"').len();
+        (default_length <= self.length as usize)
+            .then_some(())
+            .ok_or_else(|| {
+                invalid_data(
+                    path,
+                    &format!(
+                        "DefaultValue of index {} is {} bytes, longer than its Length {}.",
+                        self.index.trim(),
+                        default_length,
+                        self.length
+                    ),
+                )
+            })
+    }
+
     pub fn to_macro_row(&self) -> String {
         let index = self.index.trim();
         let subindex = self.subindex.trim();
@@ -158,6 +371,10 @@ impl IODevice {
         self.pre_operate.validate()?;
         self.operate.validate()?;
         self.timing.validate()?;
+        self.ports.validate()?;
+        self.events.validate()?;
+        self.services.validate()?;
+        self.trace.validate()?;
         self.vendor.validate()
     }
 }
@@ -172,7 +389,9 @@ impl Operate {
     pub fn validate(&self) -> io::Result<()> {
         validate_od_length(self.od_length, "IODevice.Operate.OdLength")?;
         validate_process_data_length(self.pd_in_length, "IODevice.Operate.PdInLength")?;
-        validate_process_data_length(self.pd_out_length, "IODevice.Operate.PdOutLength")
+        validate_process_data_length(self.pd_out_length, "IODevice.Operate.PdOutLength")?;
+        validate_process_data_layout(&self.pd_in, self.pd_in_length, "IODevice.Operate.PdIn")?;
+        validate_process_data_layout(&self.pd_out, self.pd_out_length, "IODevice.Operate.PdOut")
     }
 }
 
@@ -182,6 +401,36 @@ impl Timing {
     }
 }
 
+impl Ports {
+    pub fn validate(&self) -> io::Result<()> {
+        validate_port_count(self.count, "IODevice.Ports.Count")
+    }
+}
+
+impl Events {
+    pub fn validate(&self) -> io::Result<()> {
+        validate_event_queue_depth(self.queue_depth, "IODevice.Events.QueueDepth")
+    }
+}
+
+impl Services {
+    pub fn validate(&self) -> io::Result<()> {
+        if self.data_storage && !(self.isdu && self.events) {
+            return Err(invalid_data(
+                "IODevice.Services.DataStorage",
+                "Data Storage requires the Isdu and Events services.",
+            ));
+        }
+        Ok(())
+    }
+}
+
+impl Trace {
+    pub fn validate(&self) -> io::Result<()> {
+        validate_trace_ring_length(self.ring_length, "IODevice.Trace.RingLength")
+    }
+}
+
 impl Vendor {
     pub fn validate(&self) -> io::Result<()> {
         validate_revision_nibble(self.major_revision_id, "IODevice.Vendor.MajorRevisionID")?;
@@ -191,7 +440,10 @@ impl Vendor {
             "IODevice.Vendor.DeviceID",
         )?;
         validate_name(&self.vendor_name, "IODevice.Vendor.VendorName")?;
-        validate_name(&self.product_name, "IODevice.Vendor.ProductName")
+        validate_name(&self.product_name, "IODevice.Vendor.ProductName")?;
+        self.storage
+            .iter()
+            .try_for_each(|entry| entry.validate("IODevice.Vendor.Storage"))
     }
 }
 
@@ -250,6 +502,41 @@ fn validate_process_data_length(length: ProcessDataLength, path: &str) -> io::Re
     }
 }
 
+fn validate_process_data_layout(
+    fields: &[ProcessDataField],
+    length: ProcessDataLength,
+    path: &str,
+) -> io::Result<()> {
+    let total_bits = u16::from(length.in_bytes()) * 8;
+    let mut used_bits = vec![false; total_bits as usize];
+    for field in fields {
+        field.validate(path)?;
+        let end = field.bit_offset as u32 + field.bit_length as u32;
+        if end > total_bits as u32 {
+            return Err(invalid_data(
+                path,
+                &format!(
+                    "`{}` does not fit the {} octets of Process Data.",
+                    field.name.trim(),
+                    length.in_bytes()
+                ),
+            ));
+        }
+        for bit in field.bit_offset..field.bit_offset + field.bit_length {
+            if std::mem::replace(&mut used_bits[bit as usize], true) {
+                return Err(invalid_data(
+                    path,
+                    &format!(
+                        "`{}` overlaps another field at bit {bit}.",
+                        field.name.trim()
+                    ),
+                ));
+            }
+        }
+    }
+    Ok(())
+}
+
 fn validate_revision_nibble(value: u8, path: &str) -> io::Result<()> {
     (value <= 0x0F).then_some(()).ok_or_else(|| {
         invalid_data(
@@ -284,6 +571,31 @@ fn validate_min_cycle_time(value: f32, path: &str) -> io::Result<()> {
     })
 }
 
+fn validate_port_count(value: u8, path: &str) -> io::Result<()> {
+    (1..=16)
+        .contains(&value)
+        .then_some(())
+        .ok_or_else(|| invalid_data(path, "Port count must be within 1–16 device ports."))
+}
+
+fn validate_event_queue_depth(value: u8, path: &str) -> io::Result<()> {
+    (1..=64)
+        .contains(&value)
+        .then_some(())
+        .ok_or_else(|| invalid_data(path, "Event queue depth must be within 1–64 events."))
+}
+
+fn validate_trace_ring_length(value: u16, path: &str) -> io::Result<()> {
+    (value.is_power_of_two() && value <= 1024)
+        .then_some(())
+        .ok_or_else(|| {
+            invalid_data(
+                path,
+                "Trace ring length must be a power of two within 1–1024 records.",
+            )
+        })
+}
+
 fn invalid_data(path: &str, msg: &str) -> io::Error {
     io::Error::new(ErrorKind::InvalidData, format!("{path}: {msg}"))
 }
@@ -83,6 +83,14 @@ fn parse_from_str(raw: &str) -> Option<ProcessDataLength> {
 }
 
 impl ProcessDataLength {
+    /// Length in octets, bit-oriented Process Data takes up whole octets
+    pub fn in_bytes(self) -> u8 {
+        match self {
+            ProcessDataLength::Bit(bits) => bits.div_ceil(8),
+            ProcessDataLength::Octet(octets) => octets,
+        }
+    }
+
     fn validate(self, key: &str) -> io::Result<Self> {
         match self {
             ProcessDataLength::Bit(bits) if bits <= 16 => Ok(self),
@@ -0,0 +1,101 @@
+//! Memory footprint report of the configured device stack
+//!
+//! The RAM of the device stack depends on the written configuration, so it is measured
+//! by the `footprint` example of `IOLinke-Examples`, which is built against it with the
+//! configured `IODevice.Services`. The
+//! flash is measured from the firmware image, the sum of the ELF sections which are
+//! loaded to the target and not zero initialized (`.text`, `.rodata`, `.data`, ...).
+
+use std::io::{self, ErrorKind};
+use std::path::Path;
+use std::process::Command;
+
+/// ELF section flag: the section occupies memory on the target
+const SHF_ALLOC: u64 = 0x2;
+/// ELF section type: the section has no data in the image (`.bss`)
+const SHT_NOBITS: u32 = 8;
+
+/// Prints the RAM of every device stack component, fails if the RAM budget is exceeded.
+/// `services` are the features of the enabled services, e.g. `["isdu", "events"]`.
+pub fn report_ram(workspace_root: &Path, services: &[&str]) -> io::Result<()> {
+    let status = Command::new("cargo")
+        .arg("run")
+        .arg("-q")
+        .args(["-p", "iolinke-examples"])
+        .args(["--example", "footprint"])
+        .arg("--no-default-features")
+        .args(["--features", &services.join(",")])
+        .current_dir(workspace_root)
+        .status()?;
+    if !status.success() {
+        return Err(io::Error::other(
+            "The device stacks do not fit IODevice.Budget.RamBytes or failed to build",
+        ));
+    }
+    Ok(())
+}
+
+/// Prints the flash of the firmware image `elf`, fails if it exceeds `flash_budget`.
+/// A budget of 0 is not checked.
+pub fn check_flash(elf: &Path, flash_budget: u32) -> io::Result<()> {
+    let image = std::fs::read(elf)?;
+    let flash = elf_flash_size(&image)?;
+    println!("Firmware flash: {flash} octets ({})", elf.display());
+    if flash_budget != 0 {
+        println!("Flash budget: {flash_budget} octets");
+        if flash > flash_budget as u64 {
+            return Err(io::Error::other(format!(
+                "IODevice.Budget.FlashBytes exceeded by {} octets",
+                flash - flash_budget as u64
+            )));
+        }
+    }
+    Ok(())
+}
+
+/// Sums the sizes of the sections of an ELF32 or ELF64 image which are stored in flash
+fn elf_flash_size(image: &[u8]) -> io::Result<u64> {
+    let invalid = || io::Error::new(ErrorKind::InvalidData, "Not a valid ELF file");
+    if image.get(..4) != Some(&[0x7F, b'E', b'L', b'F'][..]) {
+        return Err(invalid());
+    }
+    let is_64 = match image.get(4) {
+        Some(1) => false,
+        Some(2) => true,
+        _ => return Err(invalid()),
+    };
+    let little_endian = match image.get(5) {
+        Some(1) => true,
+        Some(2) => false,
+        _ => return Err(invalid()),
+    };
+    let read = |offset: usize, length: usize| -> io::Result<u64> {
+        let bytes = image.get(offset..offset + length).ok_or_else(invalid)?;
+        let value = |value: u64, (i, byte): (usize, &u8)| {
+            let shift = if little_endian { i } else { length - 1 - i };
+            value | (*byte as u64) << (8 * shift)
+        };
+        Ok(bytes.iter().enumerate().fold(0, value))
+    };
+
+    // Section header table of the ELF header, see the System V ABI
+    let (section_offset, entry_size, entry_count) = if is_64 {
+        (read(0x28, 8)?, read(0x3A, 2)?, read(0x3C, 2)?)
+    } else {
+        (read(0x20, 4)?, read(0x2E, 2)?, read(0x30, 2)?)
+    };
+    let mut flash = 0;
+    for entry in 0..entry_count {
+        let header = (section_offset + entry * entry_size) as usize;
+        let section_type = read(header + 4, 4)? as u32;
+        let (flags, size) = if is_64 {
+            (read(header + 8, 8)?, read(header + 32, 8)?)
+        } else {
+            (read(header + 8, 4)?, read(header + 20, 4)?)
+        };
+        if flags & SHF_ALLOC != 0 && section_type != SHT_NOBITS {
+            flash += size;
+        }
+    }
+    Ok(flash)
+}
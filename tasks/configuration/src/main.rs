@@ -1,11 +1,22 @@
 mod config_file;
 mod config_struct;
+mod footprint;
 mod utils;
 mod write_config;
 
 const CONFIG_FILE_NAME: &str = "device_config.toon";
 const CRATE_NAME: &str = "IOLinke-Dev-config";
 fn main() {
+    // `--elf <firmware>` checks the firmware image against IODevice.Budget.FlashBytes
+    let mut args = std::env::args().skip(1);
+    let mut firmware_elf = None;
+    while let Some(arg) = args.next() {
+        match arg.as_str() {
+            "--elf" => firmware_elf = Some(args.next().expect("--elf requires a firmware path")),
+            _ => panic!("Unknown argument: {arg}"),
+        }
+    }
+
     let workspace_root = utils::get_workspace_root();
     let config_file_path = workspace_root.join(CRATE_NAME).join(CONFIG_FILE_NAME);
     let config_content =
@@ -16,7 +27,7 @@ fn main() {
     parser.validate().expect("Config validation failed");
     println!("Configuration validated successfully");
 
-    let config_writer = write_config::ConfigurationWriter::new(workspace_root);
+    let config_writer = write_config::ConfigurationWriter::new(workspace_root.clone());
     config_writer
         .write_on_req_data_config(
             parser.io_device.pre_operate.od_length,
@@ -31,10 +42,57 @@ fn main() {
         )
         .expect("Failed to write process data config");
 
+    config_writer
+        .write_process_data_layout_config(
+            parser.io_device.operate.pd_in_length,
+            &parser.io_device.operate.pd_in,
+            parser.io_device.operate.pd_out_length,
+            &parser.io_device.operate.pd_out,
+        )
+        .expect("Failed to write process data layout config");
+
     config_writer
         .write_timings_config(parser.io_device.timing.min_cycle_time)
         .expect("Failed to write timings config");
 
+    config_writer
+        .write_ports_config(parser.io_device.ports.count)
+        .expect("Failed to write ports config");
+
+    config_writer
+        .write_events_config(
+            parser.io_device.events.queue_depth,
+            parser.io_device.events.rate_limit_cycles,
+        )
+        .expect("Failed to write events config");
+
+    config_writer
+        .write_output_indication_config(
+            parser.io_device.output_indication.on_change,
+            parser.io_device.output_indication.min_interval_cycles,
+            parser.io_device.output_indication.coalesce_pd_cycle,
+        )
+        .expect("Failed to write output indication config");
+
+    config_writer
+        .write_services_config(
+            parser.io_device.services.isdu,
+            parser.io_device.services.events,
+            parser.io_device.services.data_storage,
+        )
+        .expect("Failed to write services config");
+
+    config_writer
+        .write_trace_config(parser.io_device.trace.ring_length)
+        .expect("Failed to write trace config");
+
+    config_writer
+        .write_budget_config(
+            parser.io_device.budget.ram_bytes,
+            parser.io_device.budget.flash_bytes,
+        )
+        .expect("Failed to write budget config");
+
     config_writer
         .write_vendor_specifics_config(
             parser.io_device.vendor.major_revision_id,
@@ -55,4 +113,23 @@ fn main() {
         .write_vendor_parameter_storage_config(&parser.io_device.vendor.storage)
         .expect("Failed to write vendor parameter storage config");
     println!("Configuration written to the stack project");
+
+    let services = &parser.io_device.services;
+    let enabled_services: Vec<&str> = [
+        (services.isdu, "isdu"),
+        (services.events, "events"),
+        (services.data_storage, "data_storage"),
+    ]
+    .into_iter()
+    .filter_map(|(enabled, feature)| enabled.then_some(feature))
+    .collect();
+    footprint::report_ram(&workspace_root, &enabled_services)
+        .expect("Memory footprint check failed");
+    if let Some(firmware_elf) = firmware_elf {
+        footprint::check_flash(
+            std::path::Path::new(&firmware_elf),
+            parser.io_device.budget.flash_bytes,
+        )
+        .expect("Flash footprint check failed");
+    }
 }
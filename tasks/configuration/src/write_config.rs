@@ -1,4 +1,4 @@
-use crate::config_file::VendorStorageEntry;
+use crate::config_file::{ProcessDataField, VendorStorageEntry};
 use crate::config_struct::ProcessDataLength;
 
 pub struct ConfigurationWriter {
@@ -9,6 +9,13 @@ const CONFIG_ON_REQ_DATA_FILE_NAME: &str = "on_req_data.rs";
 const CONFIG_PROCESS_DATA_FILE_NAME: &str = "process_data.rs";
 const CONFIG_VENDOR_SPECIFICS_FILE_NAME: &str = "vendor_specifics.rs";
 const CONFIG_TIMINGS_FILE_NAME: &str = "timings.rs";
+const CONFIG_PORTS_FILE_NAME: &str = "ports.rs";
+const CONFIG_EVENTS_FILE_NAME: &str = "events.rs";
+const CONFIG_OUTPUT_INDICATION_FILE_NAME: &str = "output_indication.rs";
+const CONFIG_SERVICES_FILE_NAME: &str = "services.rs";
+const CONFIG_TRACE_FILE_NAME: &str = "trace.rs";
+const CONFIG_BUDGET_FILE_NAME: &str = "budget.rs";
+const DERIVED_PROCESS_DATA_LAYOUT_FILE_NAME: &str = "process_data_layout.rs";
 
 const CONFIG_FILES_RELATIVE_PATH: &str = "IOLinke-Dev-config/src/device";
 const DERIVED_CONFIG_FILES_RELATIVE_PATH: &str = "IOLinke-Derived-config/src/device";
@@ -43,6 +50,33 @@ impl ConfigurationWriter {
         Ok(())
     }
 
+    pub fn write_process_data_layout_config(
+        &self,
+        pd_in_len: ProcessDataLength,
+        pd_in: &[ProcessDataField],
+        pd_out_len: ProcessDataLength,
+        pd_out: &[ProcessDataField],
+    ) -> std::io::Result<()> {
+        let layout_path = self
+            .workspace_path
+            .join(DERIVED_CONFIG_FILES_RELATIVE_PATH)
+            .join(DERIVED_PROCESS_DATA_LAYOUT_FILE_NAME);
+        let layouts = [("PD_IN", pd_in_len, pd_in), ("PD_OUT", pd_out_len, pd_out)];
+        for (name, length, fields) in layouts {
+            write_config_param_to_file(
+                &layout_path,
+                &format!("{name}_LAYOUT_LENGTH"),
+                &length.in_bytes().to_string(),
+            )?;
+            write_config_param_to_file(
+                &layout_path,
+                &format!("{name}_LAYOUT"),
+                &process_data_fields_block(fields),
+            )?;
+        }
+        Ok(())
+    }
+
     pub fn write_timings_config(&self, min_cycle_time: f32) -> std::io::Result<()> {
         let config_file_path = self.device_config_path(CONFIG_TIMINGS_FILE_NAME);
         write_config_param_to_file(
@@ -52,6 +86,92 @@ impl ConfigurationWriter {
         )
     }
 
+    pub fn write_ports_config(&self, port_count: u8) -> std::io::Result<()> {
+        let config_file_path = self.device_config_path(CONFIG_PORTS_FILE_NAME);
+        write_config_param_to_file(&config_file_path, "PORT_COUNT", &port_count.to_string())
+    }
+
+    pub fn write_events_config(
+        &self,
+        queue_depth: u8,
+        rate_limit_cycles: u32,
+    ) -> std::io::Result<()> {
+        let config_file_path = self.device_config_path(CONFIG_EVENTS_FILE_NAME);
+        write_config_param_to_file(
+            &config_file_path,
+            "EVENT_QUEUE_DEPTH",
+            &queue_depth.to_string(),
+        )?;
+        write_config_param_to_file(
+            &config_file_path,
+            "EVENT_RATE_LIMIT_CYCLES",
+            &rate_limit_cycles.to_string(),
+        )
+    }
+
+    pub fn write_output_indication_config(
+        &self,
+        on_change: bool,
+        min_interval_cycles: u32,
+        coalesce_pd_cycle: bool,
+    ) -> std::io::Result<()> {
+        let config_file_path = self.device_config_path(CONFIG_OUTPUT_INDICATION_FILE_NAME);
+        write_config_param_to_file(
+            &config_file_path,
+            "PD_OUT_ON_CHANGE",
+            &on_change.to_string(),
+        )?;
+        write_config_param_to_file(
+            &config_file_path,
+            "PD_OUT_MIN_INTERVAL_CYCLES",
+            &min_interval_cycles.to_string(),
+        )?;
+        write_config_param_to_file(
+            &config_file_path,
+            "PD_CYCLE_COALESCE",
+            &coalesce_pd_cycle.to_string(),
+        )
+    }
+
+    pub fn write_services_config(
+        &self,
+        isdu: bool,
+        events: bool,
+        data_storage: bool,
+    ) -> std::io::Result<()> {
+        let config_file_path = self.device_config_path(CONFIG_SERVICES_FILE_NAME);
+        write_config_param_to_file(&config_file_path, "SERVICE_ISDU", &isdu.to_string())?;
+        write_config_param_to_file(&config_file_path, "SERVICE_EVENTS", &events.to_string())?;
+        write_config_param_to_file(
+            &config_file_path,
+            "SERVICE_DATA_STORAGE",
+            &data_storage.to_string(),
+        )
+    }
+
+    pub fn write_trace_config(&self, ring_length: u16) -> std::io::Result<()> {
+        let config_file_path = self.device_config_path(CONFIG_TRACE_FILE_NAME);
+        write_config_param_to_file(
+            &config_file_path,
+            "TRACE_RING_LENGTH",
+            &ring_length.to_string(),
+        )
+    }
+
+    pub fn write_budget_config(&self, ram_bytes: u32, flash_bytes: u32) -> std::io::Result<()> {
+        let config_file_path = self.device_config_path(CONFIG_BUDGET_FILE_NAME);
+        write_config_param_to_file(
+            &config_file_path,
+            "RAM_BUDGET_BYTES",
+            &ram_bytes.to_string(),
+        )?;
+        write_config_param_to_file(
+            &config_file_path,
+            "FLASH_BUDGET_BYTES",
+            &flash_bytes.to_string(),
+        )
+    }
+
     pub fn write_vendor_specifics_config(
         &self,
         major_revision_id: u8,
@@ -127,6 +247,26 @@ impl ConfigurationWriter {
     }
 }
 
+/// Field declarations of a `process_data_layout` struct body
+fn process_data_fields_block(fields: &[ProcessDataField]) -> String {
+    if fields.is_empty() {
+        return String::new();
+    }
+
+    let indent = "    ";
+    let mut block = String::new();
+    for field in fields {
+        for line in field.to_macro_field().lines() {
+            block.push('\n');
+            block.push_str(indent);
+            block.push_str(line);
+        }
+    }
+    block.push('\n');
+    block.push_str(indent);
+    block
+}
+
 fn write_config_param_to_file(
     file_path: &std::path::Path,
     param_name: &str,